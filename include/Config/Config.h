@@ -7,6 +7,11 @@
 // Configuration constants for the Automated Table Saw - Stage 1
 // Motor settings, servo positions, timing, and operational parameters
 
+// Values marked CONFIG_TUNABLE are writable globals: the config registry
+// (Config/ConfigRegistry.h) sets them at runtime and the simulator's
+// parameter sweep rewrites them between runs. Everything else is const.
+#define CONFIG_TUNABLE
+
 //* ************************************************************************
 //* ************************ SERVO CONFIGURATION **************************
 //* ************************************************************************
@@ -15,7 +20,7 @@ extern const int CATCHER_SERVO_HOME_POSITION;     // Home position (degrees)
 extern const int CATCHER_SERVO_ACTIVE_POSITION;   // Position when activated (degrees)
 
 // Catcher servo early activation offset
-extern const float CATCHER_SERVO_EARLY_ACTIVATION_OFFSET_INCHES; // Early activation offset for servo rotation
+extern CONFIG_TUNABLE float CATCHER_SERVO_EARLY_ACTIVATION_OFFSET_INCHES; // Early activation offset for servo rotation
 
 //* ************************************************************************
 //* ************************ MOTOR CONFIGURATION **************************
@@ -24,84 +29,124 @@ extern const float CATCHER_SERVO_EARLY_ACTIVATION_OFFSET_INCHES; // Early activa
 extern const int CUT_MOTOR_MIN_PULSE_WIDTH;
 extern const int POSITION_MOTOR_MIN_PULSE_WIDTH;
 
-// Motor step calculations and travel distances
-extern const int CUT_MOTOR_STEPS_PER_INCH;  // 4x increase from 38
-extern const int POSITION_MOTOR_STEPS_PER_INCH; // Steps per inch for position motor
-extern const float CUT_TRAVEL_DISTANCE; // inches
-extern const float POSITION_TRAVEL_DISTANCE; // inches
-extern const float CUT_MOTOR_INCREMENTAL_MOVE_INCHES; // Inches for incremental reverse
-extern const float CUT_MOTOR_MAX_INCREMENTAL_MOVE_INCHES; // Max inches for incremental reverse before error
+// Motor step calculations
+constexpr int CUT_MOTOR_STEPS_PER_INCH = 500;
+constexpr int POSITION_MOTOR_STEPS_PER_INCH = 1000; // Steps per inch for position motor
+constexpr float CUT_MOTOR_INCREMENTAL_MOVE_INCHES = 0.1f; // Inches for incremental reverse
+constexpr float CUT_MOTOR_MAX_INCREMENTAL_MOVE_INCHES = 0.4f; // Max inches for incremental reverse before error
+
+// Travel distances - set per stock by the cutting recipe (Config/Recipes.h)
+extern CONFIG_TUNABLE float CUT_TRAVEL_DISTANCE; // inches
+extern CONFIG_TUNABLE float POSITION_TRAVEL_DISTANCE; // inches
 
 // Motor homing direction constants
-extern const int CUT_HOMING_DIRECTION;
-extern const int POSITION_HOMING_DIRECTION;
+constexpr int CUT_HOMING_DIRECTION = -1;
+constexpr int POSITION_HOMING_DIRECTION = 1;
 
 // Motor homing distance constants
-extern const long CUT_MOTOR_HOMING_DISTANCE;      // Maximum distance to travel during homing
-extern const long POSITION_MOTOR_HOMING_DISTANCE; // Maximum distance to travel during homing
+constexpr long CUT_MOTOR_HOMING_DISTANCE = 10000;      // Maximum distance to travel during homing
+constexpr long POSITION_MOTOR_HOMING_DISTANCE = 10000; // Maximum distance to travel during homing (in steps)
 
-// Calculated motor positions
-extern const long CUT_MOTOR_CUT_POSITION;  // = CUT_TRAVEL_DISTANCE * CUT_MOTOR_STEPS_PER_INCH
-extern const long POSITION_MOTOR_TRAVEL_POSITION;  // = POSITION_TRAVEL_DISTANCE * POSITION_MOTOR_STEPS_PER_INCH
-extern const float STEPS_PER_INCH_POSITION;  // = POSITION_MOTOR_STEPS_PER_INCH
+//* ************************************************************************
+//* ************************ STEP-DOMAIN POSITIONS ************************
+//* ************************************************************************
+// Everything the loop compares against cutMotor/positionMotor.currentPosition()
+// is a whole step count, so the per-pass checks are a single integer compare
+// with no float conversion. Fixed points are worked out at compile time.
+
+// Inches to the nearest step
+constexpr long inchesToSteps(float inches, int stepsPerInch) {
+    return (long)(inches * stepsPerInch + (inches >= 0 ? 0.5f : -0.5f));
+}
+
+// Wood suction safety check point on the cut stroke (0.3 inches)
+constexpr long CUT_MOTOR_SAFETY_CHECK_POSITION = inchesToSteps(0.3f, CUT_MOTOR_STEPS_PER_INCH);  // = 150
+
+// The motion plan: positions that follow the travel distances and the
+// CONFIG_TUNABLE offsets. updateDerivedConfig() recomputes them whenever one
+// of those changes (recipe selected, config set), never per cycle.
+extern long CUT_MOTOR_CUT_POSITION;             // = CUT_TRAVEL_DISTANCE in steps (4500)
+extern long POSITION_MOTOR_TRAVEL_POSITION;     // = POSITION_TRAVEL_DISTANCE in steps (3400)
+extern long POSITION_MOTOR_ADVANCE_POSITION;    // 0.1 inches short of travel, before the clamp swap (3300)
+extern long POSITION_MOTOR_HOME_SWITCH_POSITION; // Position motor coordinate at its homing switch, 1 inch past travel (4400)
+extern long CATCHER_CLAMP_ACTIVATION_POSITION;  // = CUT_MOTOR_CUT_POSITION - clamp offset in steps
+extern long CATCHER_SERVO_ACTIVATION_POSITION;  // = CUT_MOTOR_CUT_POSITION - servo offset in steps
+
+// Recomputes the motion plan above from the CONFIG_TUNABLE values
+void updateDerivedConfig();
 
 //* ************************************************************************
 //* ************************ CUT MOTOR SPEED SETTINGS ********************
 //* ************************************************************************
 // Normal Cutting Operation (Cutting State)
-extern const float CUT_MOTOR_CUTTING_SPEED;      // Speed for the cutting pass (steps/sec)
-extern const float CUT_MOTOR_NORMAL_ACCELERATION; // Acceleration for the cutting pass (steps/sec^2)
+extern CONFIG_TUNABLE float CUT_MOTOR_CUTTING_SPEED;      // Speed for the cutting pass (steps/sec)
+extern CONFIG_TUNABLE float CUT_MOTOR_NORMAL_ACCELERATION; // Acceleration for the cutting pass (steps/sec^2)
 
 // Return Stroke (Returning State / End of Cutting State)
-extern const float CUT_MOTOR_RETURN_SPEED;     // Speed for returning after a cut (steps/sec)
-extern const float CUT_MOTOR_RETURN_ACCELERATION; // Acceleration for return moves (steps/sec^2)
+extern CONFIG_TUNABLE float CUT_MOTOR_RETURN_SPEED;     // Speed for returning after a cut (steps/sec)
+extern CONFIG_TUNABLE float CUT_MOTOR_RETURN_ACCELERATION; // Acceleration for return moves (steps/sec^2)
 
 // Homing Operation (Homing State)
-extern const float CUT_MOTOR_HOMING_SPEED;      // Speed for homing the cut motor (steps/sec)
+extern CONFIG_TUNABLE float CUT_MOTOR_HOMING_SPEED;      // Speed for homing the cut motor (steps/sec)
 
 //* ************************************************************************
 //* ************************ POSITION MOTOR SPEED SETTINGS ***************
 //* ************************************************************************
 // Normal Positioning Operation (Positioning State / Parts of Cutting State)
-extern const float POSITION_MOTOR_NORMAL_SPEED;    // Speed for normal positioning moves (steps/sec)
-extern const float POSITION_MOTOR_NORMAL_ACCELERATION; // Acceleration for normal positioning (steps/sec^2)
+extern CONFIG_TUNABLE float POSITION_MOTOR_NORMAL_SPEED;    // Speed for normal positioning moves (steps/sec)
+extern CONFIG_TUNABLE float POSITION_MOTOR_NORMAL_ACCELERATION; // Acceleration for normal positioning (steps/sec^2)
 
 // Return to Home/Start (Returning State / End of Cutting State / Homing after initial move)
-extern const float POSITION_MOTOR_RETURN_SPEED;    // Speed for returning to home or start position (steps/sec)
-extern const float POSITION_MOTOR_RETURN_ACCELERATION; // Acceleration for return moves (steps/sec^2)
+extern CONFIG_TUNABLE float POSITION_MOTOR_RETURN_SPEED;    // Speed for returning to home or start position (steps/sec)
+extern CONFIG_TUNABLE float POSITION_MOTOR_RETURN_ACCELERATION; // Acceleration for return moves (steps/sec^2)
 
 // Homing Operation (Homing State)
-extern const float POSITION_MOTOR_HOMING_SPEED;     // Speed for homing the position motor (steps/sec)
+extern CONFIG_TUNABLE float POSITION_MOTOR_HOMING_SPEED;     // Speed for homing the position motor (steps/sec)
 
 //* ************************************************************************
 //* ************************ TIMING CONFIGURATION *************************
 //* ************************************************************************
 // Servo timing configuration
-extern const unsigned long CATCHER_SERVO_ACTIVE_HOLD_DURATION_MS;
+extern CONFIG_TUNABLE unsigned long CATCHER_SERVO_ACTIVE_HOLD_DURATION_MS;   // Hold at the active position, from arrival
+extern CONFIG_TUNABLE unsigned long CATCHER_SERVO_MOVE_DURATION_MS;   // Ramp time of a catcher move (LEDC fade), 0 = jump
+extern const unsigned long CATCHER_SERVO_SETTLE_MS;   // Horn catch-up after the return fade, before ready
 
 // Catcher clamp timing
-extern const unsigned long CATCHER_CLAMP_ENGAGE_DURATION_MS; // 1.5 seconds
+extern CONFIG_TUNABLE unsigned long CATCHER_CLAMP_ENGAGE_DURATION_MS; // 1.5 seconds
 
-// Cylinder timing constants
-extern const unsigned long CYLINDER_EXTEND_TIME;
-extern const unsigned long CYLINDER_RETRACT_TIME;
-
-// Wood caught error check timing
-extern const unsigned long WOOD_CAUGHT_CHECK_DELAY_MS; // 1 second delay to check if wood was caught
+// Valve latencies - command to clamp fully extended / fully open (StateMachine/Pneumatics.h)
+extern CONFIG_TUNABLE unsigned long POSITION_CLAMP_EXTEND_MS;
+extern CONFIG_TUNABLE unsigned long POSITION_CLAMP_RETRACT_MS;
+extern CONFIG_TUNABLE unsigned long WOOD_SECURE_CLAMP_EXTEND_MS;
+extern CONFIG_TUNABLE unsigned long WOOD_SECURE_CLAMP_RETRACT_MS;
+extern CONFIG_TUNABLE unsigned long CATCHER_CLAMP_EXTEND_MS;
+extern CONFIG_TUNABLE unsigned long CATCHER_CLAMP_RETRACT_MS;
 
 // Cut motor homing timeout
-extern const unsigned long CUT_HOME_TIMEOUT; // 5 seconds timeout
+extern CONFIG_TUNABLE unsigned long CUT_HOME_TIMEOUT; // 5 seconds timeout
+
+// YESWOOD cut motor home check - the homing switch must close this soon after the return ends
+extern const unsigned long CUT_HOME_SWITCH_SETTLE_MS;     // Switch given this long before it is read
+extern const unsigned long CUT_HOME_CONFIRM_TIMEOUT_MS;   // Still open after this: cut motor home error
 
 // Position motor homing timeout
-extern const unsigned long POSITION_HOME_TIMEOUT; // Timeout for position motor homing
+extern CONFIG_TUNABLE unsigned long POSITION_HOME_TIMEOUT; // Timeout for position motor homing
 
 // Signal timing
-extern const unsigned long TA_SIGNAL_DURATION; // Duration for Transfer Arm signal (ms)
+extern CONFIG_TUNABLE unsigned long TA_SIGNAL_DURATION; // Duration for Transfer Arm signal (ms)
+
+// PUSHWOODFORWARDONE settle delays
+extern CONFIG_TUNABLE unsigned long PUSHWOOD_SWAP_DELAY_MS;  // After swapping clamps, before advancing
+extern CONFIG_TUNABLE unsigned long PUSHWOOD_FINAL_DELAY_MS; // Before the final move to travel position
+
+// Fast stop (StateMachine/FastStop.h)
+extern const unsigned long LOOP_WATCHDOG_TIMEOUT_MS;   // Longest loop pass while a stroke is driven
+extern CONFIG_TUNABLE bool EMERGENCY_STOP_INSTALLED;   // NC loop wired to EMERGENCY_STOP_SWITCH
 
 //* ************************************************************************
 //* ************************ OPERATIONAL CONSTANTS ***********************
 //* ************************************************************************
 // Catcher clamp early activation offset
-extern const float CATCHER_CLAMP_EARLY_ACTIVATION_OFFSET_INCHES;
+extern CONFIG_TUNABLE float CATCHER_CLAMP_EARLY_ACTIVATION_OFFSET_INCHES;
 
 #endif // CONFIG_H 
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef CONFIG_REGISTRY_H
+#define CONFIG_REGISTRY_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ CONFIG REGISTRY HEADER ***********************
+//* ************************************************************************
+//! Runtime tuning of the CONFIG_TUNABLE values in Config.cpp
+//! Every tunable has a name (the Config.h constant), a unit and hard
+//! bounds. Setting one writes the Config.cpp global in place, so the state
+//! machine keeps reading plain globals - nothing is looked up by name on
+//! the hot path. Console and HTTP changes are queued and written by the
+//! loop task between cycles (handleConfigRequests()), which then recomputes
+//! the motion plan once; a new speed is picked up by the next move.
+//!
+//! Changes live in RAM until saved; a save writes all values to NVS as one
+//! blob, loaded again at boot. The blob is tied to the table layout, so a
+//! firmware with a different set of tunables boots on Config.cpp defaults.
+//!
+//! USAGE:
+//! - Serial console: "config", "config set CUT_MOTOR_CUTTING_SPEED 800",
+//!   "config save", "config reset [NAME]"
+//! - curl http://192.168.1.254/config
+//! - curl -X POST 'http://192.168.1.254/config?CUT_MOTOR_CUTTING_SPEED=800&save'
+
+enum ConfigValueType {
+    CONFIG_FLOAT,   // float
+    CONFIG_MILLIS   // unsigned long, whole milliseconds
+};
+
+struct ConfigParameter {
+    const char* name;   // Config.h constant
+    const char* unit;
+    ConfigValueType type;
+    void* value;        // The Config.cpp global
+    float minimum;
+    float maximum;
+};
+
+// Setup - remembers the Config.cpp defaults, loads saved values from NVS
+// and registers "config"
+void initConfigRegistry();
+
+// Lookup (names are matched case-insensitively)
+int configParameterCount();
+const ConfigParameter* configParameter(int index);
+const ConfigParameter* findConfigParameter(const char* name);
+float configValue(const ConfigParameter& parameter);
+float configDefaultValue(const ConfigParameter& parameter);   // The Config.cpp value
+
+// Loop task only. Returns false (with a message in error) when value is out
+// of bounds, not a whole number of milliseconds, or a catcher offset that
+// would put its activation before the 0.3" suction check on the current cut
+// stroke. setConfigValue() recomputes the motion plan; writeConfigValue()
+// leaves that to a caller writing several values (updateDerivedConfig())
+bool setConfigValue(const ConfigParameter& parameter, float value, char* error, size_t errorSize);
+bool writeConfigValue(const ConfigParameter& parameter, float value, char* error, size_t errorSize);
+
+// Back to the Config.cpp default (parameter == nullptr: all of them)
+void resetConfigValue(const ConfigParameter* parameter);
+
+// Runtime - applies queued console/HTTP changes once the machine is not cutting
+void handleConfigRequests();
+
+// Writes every value to NVS (blocking - one blob write)
+bool saveConfigValues();
+
+// "name value unit [min..max]" lines, "*" marking values off their default
+void renderConfigValues(Print& out);
+
+// Queues "NAME=VALUE&save&reset=NAME" from a request query, then renders
+void handleConfigQuery(const char* query, Print& out);
+
+#endif // CONFIG_REGISTRY_H
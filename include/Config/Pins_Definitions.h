@@ -38,6 +38,11 @@ extern const int FIX_POSITION_BUTTON;
 extern const int WOOD_SENSOR;
 extern const int WAS_WOOD_SUCTIONED_SENSOR;
 
+// Emergency stop (normally closed loop to ground - input pullup, HIGH = stop)
+// Only read once EMERGENCY_STOP_INSTALLED is set: an unconnected pin reads
+// HIGH, which would latch an emergency stop at power-on
+extern const int EMERGENCY_STOP_SWITCH;
+
 //* ************************************************************************
 //* ************************ CLAMP PINS ***********************************
 //* ************************************************************************
@@ -0,0 +1,61 @@
+#ifndef RECIPES_H
+#define RECIPES_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ CUTTING RECIPES HEADER ***********************
+//* ************************************************************************
+//! Named cutting profiles, one per stock
+//! A recipe holds the cut stroke (CUT_TRAVEL_DISTANCE, from the stock
+//! width), the feed (POSITION_TRAVEL_DISTANCE, from the piece length), the
+//! motor speeds and accelerations, and the catcher activation offsets.
+//! Selecting one writes those values through the config registry and
+//! recomputes the motion plan (updateDerivedConfig()) once; the cycle itself
+//! only reads the precomputed step positions.
+//!
+//! A recipe is only applied while the machine is not cutting (IDLE, or
+//! before homing). A new feed moves the position motor's coordinate origin,
+//! so a homed machine has its position re-based rather than re-homed; the
+//! carriage does not move.
+//!
+//! "default" is the Config.cpp values and cannot be changed. Saved recipes
+//! and the active recipe's name are kept in NVS; the active recipe is
+//! applied again at boot, after the saved config values.
+//!
+//! USAGE:
+//! - Serial console: "recipe", "recipe use NAME", "recipe save NAME
+//!   [stroke_in feed_in]" (current values), "recipe delete NAME"
+//! - curl http://192.168.1.254/recipes
+//! - curl -X POST 'http://192.168.1.254/recipes?use=NAME'
+
+const int RECIPE_NAME_LENGTH = 16;    // Including the terminator
+const int MAX_SAVED_RECIPES = 8;
+
+// Travel bounds (inches) - the stroke must clear the blade, the feed must
+// keep the carriage off its homing switch
+extern const float RECIPE_MIN_CUT_TRAVEL_INCHES;
+extern const float RECIPE_MAX_CUT_TRAVEL_INCHES;
+extern const float RECIPE_MIN_POSITION_TRAVEL_INCHES;
+extern const float RECIPE_MAX_POSITION_TRAVEL_INCHES;
+
+// Setup - loads saved recipes, applies the active one, registers "recipe"
+// (call after initConfigRegistry())
+void initRecipes();
+
+// Asks for a recipe by name from any task; false if there is no such recipe
+bool requestRecipe(const char* name);
+
+// Runtime - applies a requested recipe once the machine is not cutting
+void handleRecipeRequests();
+
+const char* activeRecipeName();
+
+// Recipe list and the active motion plan
+void renderRecipes(Print& out);
+
+// Applies "use=NAME" / "save=NAME" / "delete=NAME" from a request query,
+// then renders
+void handleRecipeQuery(const char* query, Print& out);
+
+#endif // RECIPES_H
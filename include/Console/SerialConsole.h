@@ -0,0 +1,30 @@
+#ifndef SERIAL_CONSOLE_H
+#define SERIAL_CONSOLE_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ SERIAL CONSOLE HEADER ************************
+//* ************************************************************************
+//! Line-based command console on the USB serial port
+//! Modules register their own commands; the loop polls the console, which
+//! never blocks - it only consumes bytes that have already arrived
+
+// Handler receives everything after the command name (may be empty)
+typedef void (*ConsoleCommandHandler)(const char* args, Print& out);
+
+const int CONSOLE_MAX_COMMANDS = 24;
+const int CONSOLE_LINE_LENGTH = 96;
+
+// Setup
+void initSerialConsole();
+bool registerConsoleCommand(const char* name, ConsoleCommandHandler handler, const char* help);
+
+// Runtime
+void handleSerialConsole();
+
+// Runs one command line against the registered commands (also used by
+// non-serial front ends). Returns false if the command is unknown.
+bool executeConsoleLine(const char* line, Print& out);
+
+#endif // SERIAL_CONSOLE_H
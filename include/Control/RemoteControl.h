@@ -0,0 +1,61 @@
+#ifndef REMOTE_CONTROL_H
+#define REMOTE_CONTROL_H
+
+#include <Arduino.h>
+#include "StateMachine/StateMachine.h"
+
+//* ************************************************************************
+//* ************************ REMOTE CONTROL HEADER ************************
+//* ************************************************************************
+//! Cycle control from the line controller over TCP
+//! One text line per command, one line back ("OK ..." or "ERR ..."):
+//!   start [N]       run N pieces (no N: until "stop"), from IDLE
+//!   stop            finish the piece being cut, then IDLE
+//!   reload on|off   hold RELOAD (from IDLE) / release the hold
+//!   ack             acknowledge an ERROR, as the RELOAD switch does
+//!   recipe NAME     select a recipe (applied between cycles)
+//!   status          state, batch progress, recipe, switches, catcher
+//!   help            command list
+//!
+//! The server task (core 0) only parses; each command is handed to the loop
+//! task, which checks it against the current state and posts an event the
+//! state machine takes on its next pass - the same place it reads the
+//! START_CYCLE and RELOAD switches. The reply is sent once the loop has
+//! taken the command, so "OK" means accepted, not queued. Nagle is off on
+//! the socket and the task polls every couple of milliseconds while a
+//! client is connected, so a command costs about one loop pass plus the
+//! WiFi round trip.
+//!
+//! The switches keep working alongside: a start switch left ON keeps the
+//! machine cycling whatever "stop" says, and the reload switch still enters
+//! and holds RELOAD on its own.
+//!
+//! USAGE:
+//! - printf 'start 10\n' | nc 192.168.1.254 2323
+//! - sim control --host 192.168.1.254 status "start 10"
+//! - Serial console: "cycle start 10" (same grammar, no network)
+
+extern const uint16_t REMOTE_CONTROL_PORT;       // TCP port of the command endpoint
+extern const int REMOTE_CONTROL_CORE;            // Core the server task is pinned to
+
+// Events the state machine takes from a remote command
+enum RemoteEvent {
+    REMOTE_EVENT_NONE,
+    REMOTE_EVENT_START,     // IDLE -> CUTTING
+    REMOTE_EVENT_RELOAD,    // IDLE -> RELOAD
+    REMOTE_EVENT_ACK        // ERROR -> ERROR_RESET
+};
+
+// Setup - starts the server task and registers "cycle"
+// (call after initMetricsServer())
+void initRemoteControl();
+
+// Runtime - applies a command waiting from the server task (loop task)
+void handleRemoteCommands();
+
+// State machine hooks (loop task)
+bool takeRemoteEvent(RemoteEvent event);   // True once per posted event
+bool continueRemoteBatch();                // YESWOOD: counts the piece, true if the batch wants another
+bool remoteReloadHeld();                   // RELOAD: true while "reload on" holds it
+
+#endif // REMOTE_CONTROL_H
@@ -0,0 +1,99 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <Arduino.h>
+#include <esp_attr.h>
+#include <atomic>
+
+//* ************************************************************************
+//* ************************ FLIGHT RECORDER HEADER ***********************
+//* ************************************************************************
+//! Crash-surviving event log in RTC slow memory
+//! The ring lives in RTC_NOINIT memory, so a watchdog, panic, brownout or
+//! software reset leaves it intact. At boot the previous run is copied aside
+//! for dumping (serial "flight" command or /flight) and recording continues.
+//!
+//! Recording is inline: one timer read and an 8-byte store. The loop task
+//! is the only writer, so there is no lock; other tasks (on either core)
+//! read the live ring through copyFlightEvents(), which checks the head
+//! before and after its copy and retries if the loop overwrote events it
+//! had copied. The head is atomic: its release store publishes an event to
+//! the other core, and a fence keeps the next event's stores behind it.
+
+// Event types
+enum FlightEventType : uint8_t {
+    FLIGHT_BOOT = 1,     // subject: reset reason
+    FLIGHT_STATE,        // subject: from state, value: to state
+    FLIGHT_ERROR,        // subject: ErrorCounterType
+    FLIGHT_MOVE_START,   // subject: MotorType, value: target steps
+    FLIGHT_MOVE_END,     // subject: MotorType, value: position steps
+    FLIGHT_CLAMP,        // subject: clamp ID, value: 1 extended / 0 retracted
+    FLIGHT_SENSOR,       // subject: FlightSensor, value: debounced pin level
+    FLIGHT_SERVO,        // value: angle in degrees
+    FLIGHT_SIGNAL        // value: Transfer Arm signal level
+};
+
+// Inputs watched for edges
+enum FlightSensor : uint8_t {
+    FLIGHT_SENSOR_WOOD,
+    FLIGHT_SENSOR_WOOD_SUCTION,
+    FLIGHT_SENSOR_CUT_HOME,
+    FLIGHT_SENSOR_POSITION_HOME,
+    FLIGHT_SENSOR_START_SWITCH,
+    FLIGHT_SENSOR_RELOAD_SWITCH,
+    FLIGHT_SENSOR_FIX_BUTTON,
+    FLIGHT_SENSOR_COUNT
+};
+
+struct FlightEvent {
+    uint32_t timeUs;   // micros() at record time (wraps after ~71 minutes)
+    uint8_t type;      // FlightEventType
+    uint8_t subject;
+    int16_t value;     // Saturated to the int16 range
+};
+
+const uint32_t FLIGHT_RECORDER_CAPACITY = 256; // Must be a power of two
+
+struct FlightRecorderRing {
+    uint32_t magic;
+    std::atomic<uint32_t> head;   // Total events written; index = head % capacity
+    FlightEvent events[FLIGHT_RECORDER_CAPACITY];
+};
+
+extern RTC_NOINIT_ATTR FlightRecorderRing flightRecorderRing;
+
+inline void recordFlightEvent(FlightEventType type, uint8_t subject, int32_t value) {
+    uint32_t head = flightRecorderRing.head.load(std::memory_order_relaxed);   // Only this task writes it
+    FlightEvent& event = flightRecorderRing.events[head & (FLIGHT_RECORDER_CAPACITY - 1)];
+    event.timeUs = (uint32_t)micros();
+    event.type = type;
+    event.subject = subject;
+    event.value = (int16_t)(value > INT16_MAX ? INT16_MAX : (value < INT16_MIN ? INT16_MIN : value));
+    flightRecorderRing.head.store(head + 1, std::memory_order_release);   // Event visible before the head
+    std::atomic_thread_fence(std::memory_order_release);                  // Head visible before the next event
+}
+
+// Setup - validates the ring, keeps a copy of the previous run, logs BOOT
+void initFlightRecorder();
+
+// Moves - the end is recorded by sampleFlightRecorder() once the motor
+// arrives, or explicitly by code that runs a blocking move
+void recordMoveStart(uint8_t motor, long target);
+void recordMoveEnd(uint8_t motor);
+
+// Runtime - records sensor edges and move completions seen since last call
+void sampleFlightRecorder();
+
+// Copies events oldest first; returns how many were copied. Safe from any
+// task; the live ring yields at most FLIGHT_RECORDER_CAPACITY - 1 events
+// (the slot the next record lands in is left out)
+uint32_t copyFlightEvents(bool previousRun, FlightEvent* out, uint32_t maxEvents);
+
+// Names used by the dumps ("wood", "catcher", ...)
+const char* flightSensorName(uint8_t sensor);
+const char* flightClampName(uint8_t clamp);
+
+// Text dump of the previous run (if any) followed by the current one
+void renderFlightRecorderLog(Print& out);
+
+#endif // FLIGHT_RECORDER_H
@@ -0,0 +1,54 @@
+#ifndef SENSOR_TRACE_H
+#define SENSOR_TRACE_H
+
+#include <Arduino.h>
+#include "Diagnostics/FlightRecorder.h"
+
+//* ************************************************************************
+//* ************************ SENSOR TRACE HEADER **************************
+//* ************************************************************************
+//! Timestamped raw edge trace of the machine inputs, for replay in the
+//! host simulator (sim --replay FILE)
+//! Unlike the flight recorder's debounced SENSOR events, this records the
+//! level on the pin itself, so sensor bounce and late edges are kept. The
+//! inputs are the flight recorder's (FlightSensor), with the same names.
+//!
+//! The loop task samples every input once per pass and is the only writer,
+//! so there is no lock; the blocking homing loops sample it too. Edges that
+//! happen while the loop is in delay() are seen late or, if they bounce
+//! back, not at all.
+//!
+//! USAGE:
+//! - curl http://192.168.1.254/sensors.trace > floor.trace
+//! - Serial console: "sensortrace" (dump) or "sensortrace clear"
+//!
+//! Text format, one line per level change, oldest first; a level holds
+//! until the next line for the same input:
+//!   # table-saw sensor trace v1
+//!   <time_us since boot> <input name> <0|1>
+
+struct SensorTraceEdge {
+    int64_t timeUs;    // esp_timer_get_time() - does not wrap
+    uint8_t input;     // FlightSensor
+    uint8_t level;     // Raw pin level
+    uint8_t initial;   // 1 = level at the start of recording, not an edge
+};
+
+const uint32_t SENSOR_TRACE_CAPACITY = 2048; // Must be a power of two
+
+// Setup - records the starting level of every input, registers "sensortrace"
+void initSensorTrace();
+
+// Runtime - records inputs whose pin level changed since the last call
+void sampleSensorTrace();
+
+// Drops the trace and starts again from the current levels
+void clearSensorTrace();
+
+// Text dump in the replay format
+void renderSensorTrace(Print& out);
+
+// GPIO behind each FlightSensor input
+int sensorTracePin(uint8_t input);
+
+#endif // SENSOR_TRACE_H
@@ -0,0 +1,34 @@
+#ifndef STEP_RATE_BENCHMARK_H
+#define STEP_RATE_BENCHMARK_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ STEP RATE BENCHMARK HEADER *******************
+//* ************************************************************************
+//! Maintenance mode that measures the step rate the firmware really
+//! delivers. Each axis runs out and back over its travel at increasing
+//! commanded speeds, once with logging off (a bare run() loop) and once
+//! with a Serial log line every few milliseconds. The cruise rate is timed
+//! from the step pulses and compared with the commanded speed.
+//!
+//! The report ends with the highest speed each motor sustains and, for
+//! every configured move, the peak speed its acceleration ramp can reach
+//! over the move distance.
+//!
+//! USAGE (machine homed and IDLE, start switch OFF, saw blade off):
+//! - Serial console: "steprate", "steprate cut" or "steprate position",
+//!   optionally followed by the log interval in ms (default 10)
+//! - Boot: hold the fix position button and the reload switch while
+//!   powering on; the benchmark runs once homing is done
+//!
+//! The position clamp is retracted while the position carriage is tested,
+//! so the wood does not move. The run blocks the loop until it is done.
+
+// Setup - registers the "steprate" console command and checks the boot combo
+void initStepRateBenchmark();
+
+// Runtime - runs a requested benchmark once the machine is IDLE
+void handleStepRateBenchmark();
+
+#endif // STEP_RATE_BENCHMARK_H
@@ -0,0 +1,27 @@
+#ifndef TRACE_EXPORT_H
+#define TRACE_EXPORT_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ TRACE EXPORT HEADER **************************
+//* ************************************************************************
+//! Converts flight recorder events into Chrome trace JSON
+//! Open the output in chrome://tracing or https://ui.perfetto.dev to see the
+//! state machine, both motors, the clamps and the sensors on one timeline.
+//!
+//! USAGE:
+//! - curl http://192.168.1.254/trace.json > cycle.json
+//! - Serial console: "trace" (current run) or "trace prev" (previous run)
+
+// Setup - registers the "trace" console command
+void initTraceExport();
+
+// Renders one run as {"traceEvents":[...]}
+void renderChromeTrace(Print& out, bool previousRun);
+
+// Route-table friendly wrappers
+void renderCurrentRunTrace(Print& out);
+void renderPreviousRunTrace(Print& out);
+
+#endif // TRACE_EXPORT_H
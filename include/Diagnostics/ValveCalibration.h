@@ -0,0 +1,38 @@
+#ifndef VALVE_CALIBRATION_H
+#define VALVE_CALIBRATION_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ VALVE CALIBRATION HEADER *********************
+//* ************************************************************************
+//! Maintenance mode that measures the clamp valve latencies the sequencing
+//! relies on (StateMachine/Pneumatics.h)
+//! There is no position feedback on the cylinders, so the measurement is
+//! indirect: a clamp seating on the board, or letting go of it, shakes the
+//! board, and WOOD_SENSOR / WAS_WOOD_SUCTIONED_SENSOR chatter for a moment.
+//! Each valve is switched out and back a few times while both inputs are
+//! polled raw (no debounce); the latency is the time from the command to
+//! the first edge, the settling time how long the chatter lasts after it.
+//!
+//! Medians go into the *_CLAMP_EXTEND_MS / *_CLAMP_RETRACT_MS tunables and
+//! are saved to NVS with the rest of the config. Each result is reported
+//! against the value it replaces, so a slow valve or a drop in air
+//! pressure shows up as drift; "check" measures and reports without
+//! saving. A valve that gives no signal keeps its current value.
+//!
+//! USAGE (machine homed and IDLE, start switch OFF, board loaded, saw
+//! blade off):
+//! - Serial console: "valvecal" (measure and save), "valvecal check"
+//!   (measure only), optionally followed by the repetitions (default 5)
+//!
+//! The holding clamps are cycled one at a time, so the board is always held
+//! by the other one. The run blocks the loop until it is done.
+
+// Setup - registers the "valvecal" console command
+void initValveCalibration();
+
+// Runtime - runs a requested calibration once the machine is IDLE
+void handleValveCalibration();
+
+#endif // VALVE_CALIBRATION_H
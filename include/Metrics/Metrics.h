@@ -0,0 +1,59 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+#include "StateMachine/StateMachine.h"
+
+//* ************************************************************************
+//* ************************ METRICS HEADER *******************************
+//* ************************************************************************
+//! Production and performance counters for the metrics endpoint
+//! Recording functions are called from the state machine (core 1) and only
+//! touch RAM; rendering runs from the metrics server task (core 0)
+
+// Error counter identifiers
+enum ErrorCounterType {
+    ERROR_COUNTER_WOOD_SUCTION,
+    ERROR_COUNTER_WOOD_CAUGHT,          // No catch sensor on this machine; kept in the stored totals layout
+    ERROR_COUNTER_CUT_MOTOR_HOME,
+    ERROR_COUNTER_POSITION_MOTOR_HOME,
+    ERROR_COUNTER_EMERGENCY_STOP,
+    ERROR_COUNTER_LOOP_WATCHDOG,
+    ERROR_COUNTER_COUNT
+};
+
+// Number of recent cycles kept for the cycle time quantiles
+const int CYCLE_TIME_WINDOW = 64;
+
+// Snapshot of every counter, copied out under the metrics lock
+struct MetricsSnapshot {
+    uint32_t piecesCut;
+    uint32_t yeswoodCount;
+    uint32_t nowoodCount;
+    uint32_t errorCounts[ERROR_COUNTER_COUNT];
+    uint32_t cyclesCompleted;
+    uint64_t cycleTimeSumUs;
+    uint32_t cycleTimeP50Us;
+    uint32_t cycleTimeP95Us;
+    uint32_t loopIterations;
+    uint64_t loopPeriodSumUs;
+    uint32_t loopPeriodMaxUs;
+    SystemState currentState;
+};
+
+// Setup
+void initMetrics();
+
+// Recording (state machine side - RAM only)
+void recordLoopIteration();
+void recordStateTransition(SystemState fromState, SystemState toState);
+void recordErrorEvent(ErrorCounterType error);
+
+// Prometheus label for an error counter ("wood_suction", ...)
+const char* errorCounterLabel(ErrorCounterType error);
+
+// Reading (metrics server side)
+void getMetricsSnapshot(MetricsSnapshot& snapshot);
+void renderPrometheusMetrics(Print& out);
+
+#endif // METRICS_H
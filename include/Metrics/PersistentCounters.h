@@ -0,0 +1,50 @@
+#ifndef PERSISTENT_COUNTERS_H
+#define PERSISTENT_COUNTERS_H
+
+#include <Arduino.h>
+#include "Metrics/Metrics.h"
+
+//* ************************************************************************
+//* ************************ PERSISTENT COUNTERS HEADER *******************
+//* ************************************************************************
+//! Lifetime production counters that survive reboots
+//! Counts accumulate in RAM and are written to NVS in batches by a flush
+//! task on core 0, so the state machine never waits on flash
+
+//* ************************************************************************
+//* ************************ FLUSH POLICY *********************************
+//* ************************************************************************
+extern const unsigned long PERSIST_FLUSH_INTERVAL_MS;     // Flush pending counts at least this often
+extern const uint32_t PERSIST_FLUSH_PIECE_THRESHOLD;      // Flush early after this many pieces
+extern const unsigned long PERSIST_MIN_WRITE_INTERVAL_MS; // Flash wear bound between periodic writes
+
+// Lifetime totals (persisted + pending)
+struct PersistentTotals {
+    uint32_t bootCount;
+    uint32_t piecesCut;
+    uint32_t yeswoodCount;
+    uint32_t nowoodCount;
+    uint32_t errorCounts[ERROR_COUNTER_COUNT];
+    uint64_t cutMotorTravelSteps;
+    uint64_t positionMotorTravelSteps;
+    uint32_t nvsWrites;
+};
+
+// Setup - loads totals from NVS and starts the flush task
+void initPersistentCounters();
+
+// Recording (state machine side - RAM only)
+void persistCountCut(bool woodPresent);
+void persistCountError(ErrorCounterType error);
+void sampleMotorTravel();       // Call every loop and before re-zeroing a motor
+void rebaseMotorTravel();       // Call right after setCurrentPosition() re-zeroes a motor
+
+// Flushing
+void requestPersistentFlush();  // Asks the flush task to write soon (non-blocking)
+void flushPersistentCounters(); // Writes pending counts now (blocking - OTA start / shutdown)
+
+// Reading
+void getPersistentTotals(PersistentTotals& totals);
+void renderPersistentMetrics(Print& out);
+
+#endif // PERSISTENT_COUNTERS_H
@@ -0,0 +1,21 @@
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+//* ************************************************************************
+//* ************************ METRICS SERVER CONFIGURATION ***************
+//* ************************************************************************
+extern const uint16_t METRICS_SERVER_PORT;       // HTTP port for /metrics
+extern const int METRICS_SERVER_CORE;            // Core the server task is pinned to
+extern const unsigned long METRICS_SERVER_POLL_MS; // Idle poll interval of the server task
+
+//* ************************************************************************
+//* ************************ FUNCTION DECLARATIONS **********************
+//* ************************************************************************
+
+// Starts the HTTP server task; the server comes up once WiFi is connected
+void initMetricsServer();
+
+#endif
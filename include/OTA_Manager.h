@@ -11,17 +11,39 @@
 // Update these credentials if using different network
 extern const char* WIFI_SSID;
 extern const char* WIFI_PASSWORD;
+extern const int WIFI_TASK_CORE;                      // Core the WiFi task is pinned to (the WiFi stack's core)
+extern const unsigned long WIFI_CONNECT_TIMEOUT_MS;   // One connection attempt gives up after this
+extern const unsigned long WIFI_RETRY_MIN_MS;         // First wait before retrying
+extern const unsigned long WIFI_RETRY_MAX_MS;         // Retry wait doubles up to this
+extern const unsigned long OTA_HANDLE_INTERVAL_MS;    // ArduinoOTA.handle() period in the WiFi task
+extern const unsigned long OTA_PARK_TIMEOUT_MS;       // An update waits this long for the axes to park
 
 //* ************************************************************************
 //* ************************ FUNCTION DECLARATIONS **********************
 //* ************************************************************************
 
-// WiFi connection functions
+// Starts the WiFi task - returns at once; the task connects, reconnects
+// with backoff, starts ArduinoOTA when the link first comes up and services
+// it from then on. No network work runs on the loop task.
 void initWiFi();
 
 // OTA setup and management functions
 void initOTA();
-void handleOTA();
+
+// Update handshake for any update path (ArduinoOTA, POST /update), called
+// from the task that receives the image: begin parks the axes (waits up to
+// OTA_PARK_TIMEOUT_MS) and saves the counters; end restarts on success or
+// releases the loop task
+void beginOTAUpdate();
+void endOTAUpdate(bool success);
+
+// True from the start of an update until it fails (a good update restarts)
+bool isOTAUpdateActive();
+
+// Runtime (loop task) - when an update starts, stops both axes and holds the
+// loop until the update ends. A failed update that interrupted a cycle or
+// homing sends the machine back through homing.
+void handleOTAParkRequest();
 void displayIP();
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef CATCHER_SERVO_H
+#define CATCHER_SERVO_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ CATCHER SERVO HEADER *************************
+//* ************************************************************************
+//! Non-blocking sequencer for the catcher servo
+//! CUTTING fires it at CATCHER_SERVO_ACTIVATION_POSITION; from there it runs
+//! on its own from the loop, alongside the return stroke and the next feed:
+//!
+//!   HOME -> MOVING_OUT -> HOLDING -> RETURNING -> SETTLING -> HOME
+//!
+//! Moves are LEDC fades (CATCHER_SERVO_MOVE_DURATION_MS), so a phase ends
+//! when the hardware duty reaches its target rather than on a fixed worst
+//! case timer. The hold (CATCHER_SERVO_ACTIVE_HOLD_DURATION_MS) counts
+//! from arrival at the active position, and SETTLING gives the horn
+//! CATCHER_SERVO_SETTLE_MS to catch up with the pulse before the catcher
+//! reports ready.
+//!
+//! A trigger that arrives before the catcher is home is counted as late:
+//! while out, the hold restarts; while returning, the catcher goes back
+//! out once the return fade ends (a new fade never interrupts one in
+//! flight - the LEDC driver would block the loop until it ends).
+//!
+//! USAGE:
+//! - Serial console: "catcher" (phase and counters), "catcher fire",
+//!   "catcher home"
+
+enum CatcherServoPhase {
+    CATCHER_SERVO_HOME,          // At home and settled - ready
+    CATCHER_SERVO_MOVING_OUT,    // Fading to the active position
+    CATCHER_SERVO_HOLDING,       // At the active position
+    CATCHER_SERVO_RETURNING,     // Fading back home
+    CATCHER_SERVO_SETTLING       // Pulse at home, horn catching up
+};
+
+struct CatcherServoStats {
+    uint32_t activations;        // Triggers, including late ones
+    uint32_t lateActivations;    // Triggers that found the catcher away from home
+    uint32_t lastReadyMs;        // Trigger to ready again, last complete sequence
+    uint32_t maxReadyMs;         // Longest trigger to ready
+};
+
+// Setup - attaches the servo at home, registers "catcher"
+void initCatcherServo();
+
+// Runtime - advances the sequence (loop task, every pass)
+void updateCatcherServo();
+
+// Sequence control (loop task)
+void triggerCatcherServo();      // Out, hold, home
+void returnCatcherServoHome();   // Cut the hold short
+
+// Status - readable from any task
+bool catcherServoReady();
+CatcherServoPhase getCatcherServoPhase();
+const char* getCatcherServoPhaseName(CatcherServoPhase phase);
+void getCatcherServoStats(CatcherServoStats& stats);
+
+#endif // CATCHER_SERVO_H
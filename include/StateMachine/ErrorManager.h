@@ -0,0 +1,88 @@
+#ifndef ERROR_MANAGER_H
+#define ERROR_MANAGER_H
+
+#include <Arduino.h>
+#include "Metrics/Metrics.h"
+
+//* ************************************************************************
+//* ************************ ERROR MANAGER HEADER *************************
+//* ************************************************************************
+//! One place for every machine error
+//! Detection code (ERRORS/*.cpp, the states) calls raiseError() with a
+//! code. The manager stops the machine according to the code's severity,
+//! counts it (Metrics.h) and keeps a timestamped history ring.
+//!
+//! Active errors are a bit mask, so the loop checks them with one load:
+//! anyErrorActive(), isErrorActive(code).
+//!
+//! Recovery runs in ERROR_RESET, after the operator acknowledges (reload
+//! switch or the line controller's "ack"). Each error class has its own
+//! non-blocking recovery, advanced one step per loop pass:
+//! - wood suction: the suction sensor has to read clear for a while
+//! - emergency stop: the stop loop has to read closed for a while
+//! - cut / position motor home: the axis seeks its home switch again
+//! - loop watchdog: cleared by the acknowledge itself
+//! When every error has cleared the machine goes to IDLE (HOMING if it lost
+//! its home); a recovery that fails leaves its error active and goes back
+//! to ERROR for another acknowledge. A recovered error that latched a fast
+//! stop (FastStop.h) clears the latch, so blocking moves may run again.
+//!
+//! USAGE:
+//! - Serial console: "errors" (active errors and history), "errors raise
+//!   <name>" (test an error path)
+
+// Error codes - also the bit in the active mask
+enum ErrorCode : uint8_t {
+    ERROR_CODE_WOOD_SUCTION,          // Piece suctioned early in the cut stroke
+    ERROR_CODE_CUT_MOTOR_HOME,        // Cut motor did not find its home switch
+    ERROR_CODE_POSITION_MOTOR_HOME,   // Position motor did not find its home switch
+    ERROR_CODE_EMERGENCY_STOP,        // Emergency stop pressed (fast stop)
+    ERROR_CODE_LOOP_WATCHDOG,         // Loop stalled while driving a stroke (fast stop)
+    ERROR_CODE_COUNT
+};
+
+enum ErrorSeverity : uint8_t {
+    ERROR_SEVERITY_FAULT,     // Motors stopped, holding clamps released, ERROR state
+    ERROR_SEVERITY_CRITICAL   // As FAULT, all cylinders retracted; an axis has lost its position
+};
+
+// History entries
+enum ErrorEventType : uint8_t {
+    ERROR_EVENT_RAISED,
+    ERROR_EVENT_ACKNOWLEDGED,
+    ERROR_EVENT_RECOVERED,
+    ERROR_EVENT_RECOVERY_FAILED
+};
+
+struct ErrorRecord {
+    uint32_t timeMs;    // millis() at the event
+    uint8_t code;       // ErrorCode
+    uint8_t event;      // ErrorEventType
+    uint8_t state;      // SystemState when it happened
+};
+
+const uint32_t ERROR_HISTORY_CAPACITY = 16;   // Must be a power of two
+
+// Active errors, one bit per ErrorCode (loop task writes, anyone reads)
+extern volatile uint32_t activeErrorMask;
+
+inline bool anyErrorActive() { return activeErrorMask != 0; }
+inline bool isErrorActive(ErrorCode code) { return (activeErrorMask & (1UL << code)) != 0; }
+
+// Setup - registers the "errors" console command
+void initErrorManager();
+
+// Detection side - stops the machine and enters ERROR; a code that is
+// already active is not raised again
+void raiseError(ErrorCode code);
+
+// Recovery side (ERROR / ERROR_RESET states)
+void acknowledgeErrors();        // Operator acknowledge - starts the recoveries
+bool updateErrorRecovery();      // One step of each recovery; true while any runs
+
+// Status
+ErrorCode firstActiveError();    // ERROR_CODE_COUNT when none
+const char* errorCodeName(ErrorCode code);
+uint32_t getErrorHistory(ErrorRecord records[], uint32_t maxRecords);   // Oldest first
+
+#endif // ERROR_MANAGER_H
@@ -0,0 +1,76 @@
+#ifndef FAST_STOP_H
+#define FAST_STOP_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ FAST STOP HEADER *****************************
+//* ************************************************************************
+//! Hardware safety path that does not wait for the loop
+//! A trigger halts both axes and opens every clamp from interrupt context,
+//! with two GPIO bank register writes:
+//! - the step outputs are driven LOW (GPIO_OUT W1TC) - still driven, so
+//!   the driver STEP inputs never float; every blocking move loop ends on
+//!   fastStopTripped(), so at most the step in flight when the trip lands
+//!   goes out before handleFastStop() stops both motors
+//! - every valve goes to its safe state, retracted (GPIO_OUT W1TS)
+//! The masks are worked out once at setup, so the trip itself is a few
+//! stores - microseconds from the edge, not the next loop pass.
+//!
+//! Triggers:
+//! - emergency stop input (normally closed, any state, always armed), once
+//!   a machine opts in with EMERGENCY_STOP_INSTALLED
+//! - suction sensor edge, armed by CUTTING for the stroke from the 0.3 inch
+//!   check to the catcher clamp firing; a sensor that is already active
+//!   when armed trips at once
+//! - loop watchdog, an esp_timer checking every 10 ms that the loop pass
+//!   count still moves while a stroke is driven from it (CUTTING, YESWOOD,
+//!   NOWOOD); the loop only increments the count, it reads no clock
+//!
+//! The trip is latched. The loop picks it up with handleFastStop(): it
+//! brings the motor and valve bookkeeping in line, drops isHomed (a stop
+//! without deceleration can lose steps) and raises the matching error. The
+//! latch - and with it clamp extension - clears only once that error has
+//! recovered (ErrorManager.h), and the machine homes again.
+//!
+//! USAGE:
+//! - Wiring: a normally closed emergency stop loop from EMERGENCY_STOP_SWITCH
+//!   (GPIO 7) to GND. Pressed or broken reads HIGH. The pin has a pullup, so
+//!   with nothing wired it reads pressed. The input is off by default (the
+//!   current saw has no loop); set EMERGENCY_STOP_INSTALLED = true in
+//!   Config.cpp only once the loop is wired, or the machine latches an
+//!   emergency stop at power-on.
+//! - Serial console: "faststop" (latch, trips, inputs, longest watched loop stall)
+
+enum FastStopReason : uint8_t {
+    FAST_STOP_NONE,
+    FAST_STOP_EMERGENCY_STOP,
+    FAST_STOP_SUCTION,
+    FAST_STOP_LOOP_WATCHDOG
+};
+
+// Latched trip (written from interrupt context)
+extern volatile uint8_t fastStopReason;
+
+inline bool fastStopTripped() { return fastStopReason != FAST_STOP_NONE; }
+
+// Setup - after the motor, valve and sensor pins are configured
+void initFastStop();
+
+// Trigger from anywhere, interrupt context included
+void tripFastStop(FastStopReason reason);
+
+// Loop side
+void feedLoopWatchdog();         // Top of every loop pass
+void pauseLoopWatchdog();        // Before the loop is held on purpose (OTA park)
+bool handleFastStop();           // Raises a new trip as an error; true if it did
+void releaseFastStop();          // Clears the latch (ErrorManager, once recovered)
+
+// CUTTING - suction window; arming returns false if it tripped instead
+bool armSuctionFastStop();
+void disarmSuctionFastStop();
+
+// Emergency stop input, raw (HIGH = pressed or loop broken); false when not installed
+bool emergencyStopActive();
+
+#endif // FAST_STOP_H
@@ -0,0 +1,44 @@
+#ifndef PNEUMATICS_H
+#define PNEUMATICS_H
+
+#include <Arduino.h>
+#include <AccelStepper.h>
+#include "StateMachine/StateMachine.h"
+
+//* ************************************************************************
+//* ************************ PNEUMATICS HEADER ****************************
+//* ************************************************************************
+//! Valve latency model for the three clamps
+//! Every clamp command goes through the individual clamp functions
+//! (CLAMPS_FUNCTIONS.cpp), which note when the valve was switched. A clamp
+//! is settled once its extend or retract latency has passed since then
+//! (Config.h: *_CLAMP_EXTEND_MS / *_CLAMP_RETRACT_MS); a command that does
+//! not change the valve does not restart the count.
+//!
+//! Lead-time scheduling: a move that ends with a clamp change fires the
+//! valve while the carriage is still running, once the time left in the
+//! move is down to the valve latency, so the clamp settles as the carriage
+//! stops. The next move still waits for clampSettled(); the wait is
+//! whatever the lead could not hide.
+//!
+//! USAGE (YESWOOD):
+//! - fireClampBeforeMoveEnds(WOOD_SECURE_CLAMP_ENUM, true, positionMotor)
+//!   every pass of the advance; true once the valve is switched
+//! - start the return only when clampSettled() for both holding clamps
+
+// Valve state - commanded position and settle time
+bool clampExtended(ClampType clamp);
+bool clampSettled(ClampType clamp);
+unsigned long clampSettleRemainingMs(ClampType clamp);
+unsigned long clampLatencyMs(ClampType clamp, bool extend);
+bool holdingClampsSettled();    // Position and wood secure clamps
+
+// Lead-time scheduling - switches the valve once the move has no more
+// time left than the valve needs; true once it is in the commanded state
+bool fireClampBeforeMoveEnds(ClampType clamp, bool extend, AccelStepper& motor);
+
+// Time for an AccelStepper move to stop at its target from where it is now
+// (trapezoid from the current speed; 0 when the move is done)
+unsigned long msUntilMoveEnds(AccelStepper& motor);
+
+#endif // PNEUMATICS_H
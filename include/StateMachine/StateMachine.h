@@ -66,6 +66,8 @@ void initializeStateMachine();
 void updateStateMachine();
 void changeState(SystemState newState);
 void transitionToState(SystemState newState);
+const char* getStateName(SystemState state);
+bool stateJustEntered();    // First pass of the current state's visit
 
 // State Functions
 void executeIDLE();
@@ -88,6 +90,7 @@ void executeReloadSequence();
 bool checkTransitionConditions();
 bool areAllSystemsReady();
 bool isHomingComplete();
+bool machineIsAtRest();     // Between cycles (IDLE or STARTUP) with both carriages stopped
 
 // Utility Functions
 void printStateChange();
@@ -0,0 +1,107 @@
+#ifndef COMPRESSED_UPDATE_H
+#define COMPRESSED_UPDATE_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ COMPRESSED UPDATE HEADER *********************
+//* ************************************************************************
+//! Firmware updates sent as a heatshrink (LZSS) compressed image and
+//! decompressed into the OTA partition as they arrive
+//! The axes stay parked for the whole transfer, so the bytes sent are the
+//! downtime; a packed image cuts both by its compression ratio. The
+//! decoder keeps only the 2^W byte window in RAM and does a few operations
+//! per output byte, well below the cost of the flash write it feeds.
+//!
+//! Packed image: a 16 byte header, then a stream in heatshrink's bit
+//! format (no container of its own):
+//!   "TSZ1"   magic
+//!   u8       window bits W
+//!   u8       lookahead bits L
+//!   u16      reserved, 0
+//!   u32 LE   image size
+//!   u32 LE   image CRC-32
+//! Stream bits are MSB first: 1 + 8 bit literal, or 0 + W bit (distance - 1)
+//! + L bit (length - 1) back-reference into the last 2^W output bytes.
+//!
+//! USAGE:
+//! - sim ota-pack .pio/build/esp32s3/firmware.bin firmware.tsz
+//! - curl --data-binary @firmware.tsz http://192.168.1.254/update
+//! - sim ota-check .pio/build/esp32s3/firmware.bin (pack, decode into a
+//!   mock partition, compare)
+
+const size_t COMPRESSED_IMAGE_HEADER_SIZE = 16;
+const uint8_t COMPRESSED_MIN_WINDOW_BITS = 4;
+const uint8_t COMPRESSED_MAX_WINDOW_BITS = 14;     // 16 KB window on the board
+const uint8_t COMPRESSED_MIN_LOOKAHEAD_BITS = 3;
+
+struct CompressedImageHeader {
+    uint8_t windowBits;
+    uint8_t lookaheadBits;      // Less than windowBits
+    uint32_t imageSize;
+    uint32_t imageCrc;
+};
+
+// Header encoding - false if the bytes are not a packed image this decoder takes
+void writeCompressedImageHeader(const CompressedImageHeader& header, uint8_t* out);
+bool parseCompressedImageHeader(const uint8_t* in, CompressedImageHeader& header);
+
+// Standard CRC-32 (zlib), chained: crc = updateCrc32(crc, data, size), starting at 0
+uint32_t updateCrc32(uint32_t crc, const uint8_t* data, size_t size);
+
+// Streaming decoder in front of Update - feed the packed image in chunks of
+// any size; the header starts the partition write, end() checks the image
+// and finishes it
+class CompressedUpdate {
+   public:
+    CompressedUpdate();
+    ~CompressedUpdate();
+
+    bool write(const uint8_t* data, size_t size);   // false = failed, see error(); Update aborted
+    bool end();
+    void abort();
+
+    const char* error() const { return _error; }
+    uint32_t imageSize() const { return _header.imageSize; }
+    uint32_t decodedSize() const { return _decoded; }
+
+   private:
+    bool fail(const char* error);
+    bool start();
+    bool takeBits(uint8_t count, uint16_t& value);
+    bool emit(uint8_t value);
+    bool flushOutput();
+
+    enum DecodeState { READ_HEADER, READ_TAG, READ_LITERAL, READ_INDEX, READ_COUNT, DONE, FAILED };
+
+    DecodeState _state;
+    CompressedImageHeader _header;
+    uint8_t _headerBytes[COMPRESSED_IMAGE_HEADER_SIZE];
+    size_t _headerUsed;
+
+    const uint8_t* _input;      // Chunk being decoded
+    size_t _inputLeft;
+    uint32_t _bitBuffer;
+    uint8_t _bitCount;
+
+    uint8_t* _window;           // Last 2^W output bytes
+    uint16_t _windowMask;
+    uint16_t _windowHead;
+    uint16_t _backrefIndex;
+
+    uint8_t _output[512];       // Decoded bytes waiting for Update.write()
+    size_t _outputUsed;
+    uint32_t _decoded;
+    uint32_t _crc;
+    const char* _error;
+};
+
+// Body of POST /update, in two steps so a bad upload is refused before the
+// axes are parked: read the header off the front of the length byte body and
+// check it (magic, window, image fits the OTA slot), then decode the rest into
+// the OTA partition. Both return false with a message in error; the caller
+// handles the park handshake and the restart (OTA_Manager.h)
+bool readCompressedUpdateHeader(Stream& in, size_t length, uint8_t* header, char* error, size_t errorSize);
+bool receiveCompressedUpdate(Stream& in, size_t length, const uint8_t* header, char* error, size_t errorSize);
+
+#endif // COMPRESSED_UPDATE_H
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ NATIVE ACCELSTEPPER **************************
+//* ************************************************************************
+//! Host implementation of the AccelStepper API used by the firmware.
+//! Same public behaviour as the real library: run() emits at most one step
+//! per call, speed follows the Austin constant-acceleration ramp, and
+//! DRIVER mode pulses the step pin through digitalWrite() so a hardware
+//! model sees every step with the configured minimum pulse width.
+
+class AccelStepper {
+   public:
+    typedef enum {
+        FUNCTION = 0,
+        DRIVER = 1,
+        FULL2WIRE = 2,
+        FULL3WIRE = 3,
+        FULL4WIRE = 4,
+        HALF3WIRE = 6,
+        HALF4WIRE = 8
+    } MotorInterfaceType;
+
+    AccelStepper(uint8_t interface = AccelStepper::FULL4WIRE, uint8_t pin1 = 2, uint8_t pin2 = 3,
+                 uint8_t pin3 = 4, uint8_t pin4 = 5, bool enable = true);
+
+    void moveTo(long absolute);
+    void move(long relative);
+    bool run();
+    bool runSpeed();
+    void setMaxSpeed(float speed);
+    float maxSpeed();
+    void setAcceleration(float acceleration);
+    float acceleration();
+    void setSpeed(float speed);
+    float speed();
+    long distanceToGo();
+    long targetPosition();
+    long currentPosition();
+    void setCurrentPosition(long position);
+    void runToPosition();
+    bool runSpeedToPosition();
+    void runToNewPosition(long position);
+    void stop();
+    bool isRunning();
+    void setMinPulseWidth(unsigned int minWidth);
+    void enableOutputs() {}
+    void disableOutputs() {}
+
+    // Host-only: total steps emitted, for step-rate accounting
+    unsigned long stepCount() const { return _stepCount; }
+
+   protected:
+    typedef enum { DIRECTION_CCW = 0, DIRECTION_CW = 1 } Direction;
+
+    void computeNewSpeed();
+    void step(long step);
+
+   private:
+    uint8_t _interface;
+    uint8_t _pin[2];
+    long _currentPos;
+    long _targetPos;
+    float _speed;
+    float _maxSpeed;
+    float _acceleration;
+    unsigned long _stepInterval;
+    unsigned long _lastStepTime;
+    unsigned int _minPulseWidth;
+    long _n;
+    float _c0;
+    float _cn;
+    float _cmin;
+    bool _direction;
+    unsigned long _stepCount;
+};
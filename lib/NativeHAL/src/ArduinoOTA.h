@@ -0,0 +1,48 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include "Update.h"
+
+//* ************************************************************************
+//* ************************ NATIVE ARDUINOOTA ****************************
+//* ************************************************************************
+//! Accepts the full configuration API; handle() never sees an upload.
+
+typedef enum {
+    OTA_AUTH_ERROR,
+    OTA_BEGIN_ERROR,
+    OTA_CONNECT_ERROR,
+    OTA_RECEIVE_ERROR,
+    OTA_END_ERROR
+} ota_error_t;
+
+class ArduinoOTAClass {
+   public:
+    typedef std::function<void(void)> THandlerFunction;
+    typedef std::function<void(ota_error_t)> THandlerFunction_Error;
+    typedef std::function<void(unsigned int, unsigned int)> THandlerFunction_Progress;
+
+    ArduinoOTAClass& setHostname(const char* hostname) { (void)hostname; return *this; }
+    ArduinoOTAClass& setPort(uint16_t port) { (void)port; return *this; }
+    ArduinoOTAClass& setPassword(const char* password) { (void)password; return *this; }
+    ArduinoOTAClass& setRebootOnSuccess(bool reboot) { (void)reboot; return *this; }
+    ArduinoOTAClass& onStart(THandlerFunction fn) { _start = fn; return *this; }
+    ArduinoOTAClass& onEnd(THandlerFunction fn) { _end = fn; return *this; }
+    ArduinoOTAClass& onError(THandlerFunction_Error fn) { _error = fn; return *this; }
+    ArduinoOTAClass& onProgress(THandlerFunction_Progress fn) { _progress = fn; return *this; }
+
+    void begin() { _begun = true; }
+    void end() { _begun = false; }
+    void handle() {}
+    int getCommand() { return U_FLASH; }
+
+   private:
+    bool _begun = false;
+    THandlerFunction _start;
+    THandlerFunction _end;
+    THandlerFunction_Error _error;
+    THandlerFunction_Progress _progress;
+};
+
+extern ArduinoOTAClass ArduinoOTA;
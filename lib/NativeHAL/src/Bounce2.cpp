@@ -0,0 +1,37 @@
+#include "Bounce2.h"
+
+//* ************************************************************************
+//* ************************ NATIVE BOUNCE2 IMPLEMENTATION ***************
+//* ************************************************************************
+
+void Bounce::attach(int pin) {
+    _pin = pin;
+    _debouncedState = _unstableState = digitalRead(pin);
+    _previousMillis = _stateChangeMillis = millis();
+    _changed = false;
+}
+
+void Bounce::attach(int pin, int mode) {
+    pinMode(pin, mode);
+    attach(pin);
+}
+
+bool Bounce::update() {
+    _changed = false;
+    bool currentState = digitalRead(_pin);
+
+    if (currentState != _unstableState) {
+        // Input moved - restart the stability window
+        _previousMillis = millis();
+        _unstableState = currentState;
+    } else if (millis() - _previousMillis >= _intervalMillis) {
+        // Stable for the full interval - accept it
+        if (currentState != _debouncedState) {
+            _previousMillis = millis();
+            _stateChangeMillis = _previousMillis;
+            _debouncedState = currentState;
+            _changed = true;
+        }
+    }
+    return _changed;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ NATIVE BOUNCE2 *******************************
+//* ************************************************************************
+//! Host implementation of Bounce2's default stable-interval debouncer
+
+class Bounce {
+   public:
+    Bounce() {}
+
+    void attach(int pin);
+    void attach(int pin, int mode);
+    void interval(uint16_t intervalMillis) { _intervalMillis = intervalMillis; }
+
+    bool update();
+    bool read() const { return _debouncedState; }
+    bool fell() const { return _changed && !_debouncedState; }
+    bool rose() const { return _changed && _debouncedState; }
+    bool changed() const { return _changed; }
+    unsigned long currentDuration() const { return millis() - _stateChangeMillis; }
+    unsigned long duration() const { return currentDuration(); }
+
+   private:
+    int _pin = -1;
+    uint16_t _intervalMillis = 10;
+    unsigned long _previousMillis = 0;
+    unsigned long _stateChangeMillis = 0;
+    bool _debouncedState = false;
+    bool _unstableState = false;
+    bool _changed = false;
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdint.h>
+
+//* ************************************************************************
+//* ************************ NATIVE ESP CLASS *****************************
+//* ************************************************************************
+
+class EspClass {
+   public:
+    uint32_t getFreeHeap() { return 200000; }
+    uint32_t getMinFreeHeap() { return 180000; }
+    uint32_t getMaxAllocHeap() { return 110000; }
+    uint32_t getHeapSize() { return 320000; }
+    uint32_t getCpuFreqMHz() { return 240; }
+    uint32_t getFreeSketchSpace() { return 0x140000; }   // App slot of the default partition table
+    const char* getSdkVersion() { return "native"; }
+    void restart();
+};
+
+extern EspClass ESP;
@@ -0,0 +1,366 @@
+#include "Hal.h"
+#include <Arduino.h>
+#include <soc/gpio_reg.h>
+#include "WiFi.h"
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+//* ************************************************************************
+//* ************************ NATIVE HAL IMPLEMENTATION *******************
+//* ************************************************************************
+
+namespace hal {
+
+namespace {
+
+bool virtualTime = false;
+std::atomic<uint64_t> virtualNowNs{0};
+uint64_t busyNs = 0;        // Loop thread only
+const auto realEpoch = std::chrono::steady_clock::now();
+
+CostModel costModel = {
+    50,     // clockReadNs
+    100,    // pinReadNs
+    100,    // pinWriteNs
+    2000,   // yieldNs
+    115200, // uartBaud
+    128,    // uartFifoBytes
+    2000,   // interruptLatencyNs
+};
+
+struct PinState {
+    uint8_t mode = 0;
+    uint8_t output = LOW;
+    int8_t forced = -1;   // -1 = not driven from outside
+    bool enabled = true;  // Output driver on (GPIO_ENABLE bit)
+    uint8_t driven = LOW; // Level on the wire when the driver went off
+};
+PinState pins[MAX_PINS];
+
+struct PinInterrupt {
+    InterruptHandler handler = nullptr;
+    int mode = 0;
+    int level = LOW;      // Level at the last sample
+};
+PinInterrupt interrupts[MAX_PINS];
+bool anyInterrupt = false;
+uint64_t lastSampleNs = 0;
+
+struct Timer {
+    TimerCallback callback = nullptr;
+    void* arg = nullptr;
+    uint64_t periodNs = 0;
+    uint64_t dueNs = 0;
+    bool periodic = false;
+    bool running = false;
+};
+const int MAX_TIMERS = 8;
+Timer timers[MAX_TIMERS];
+int timerCount = 0;
+
+bool inHandler = false;
+
+Model* activeModel = nullptr;
+bool echo = true;
+bool network = true;
+bool tasks = true;
+
+std::mutex serialInputLock;
+std::deque<char> serialInput;
+
+std::thread::id loopThread = std::this_thread::get_id();
+
+bool validPin(int pin) { return pin >= 0 && pin < MAX_PINS; }
+
+bool edgeMatches(int mode, int from, int to) {
+    if (from == to) return false;
+    if (mode == CHANGE) return true;
+    return mode == (to == HIGH ? RISING : FALLING);
+}
+
+// Loop thread only - runs due pin handlers and timer callbacks
+void dispatchInterrupts() {
+    if (inHandler || (!anyInterrupt && timerCount == 0)) return;
+    inHandler = true;
+    uint64_t now = nowNanos();
+    if (anyInterrupt && now - lastSampleNs >= costModel.interruptLatencyNs) {
+        lastSampleNs = now;
+        for (int pin = 0; pin < MAX_PINS; pin++) {
+            PinInterrupt& interrupt = interrupts[pin];
+            if (interrupt.handler == nullptr) continue;
+            int level = readPin(pin);
+            int previous = interrupt.level;
+            interrupt.level = level;
+            if (edgeMatches(interrupt.mode, previous, level)) {
+                interrupt.handler();
+            }
+        }
+    }
+    for (int i = 0; i < timerCount; i++) {
+        Timer& timer = timers[i];
+        if (!timer.running || now < timer.dueNs) continue;
+        if (timer.periodic) {
+            while (timer.dueNs <= now) timer.dueNs += timer.periodNs;
+        } else {
+            timer.running = false;
+        }
+        timer.callback(timer.arg);
+    }
+    inHandler = false;
+}
+
+}  // namespace
+
+void setVirtualTime(bool enabled) { virtualTime = enabled; }
+bool isVirtualTime() { return virtualTime; }
+CostModel& costs() { return costModel; }
+
+uint64_t nowNanos() {
+    if (virtualTime) {
+        return virtualNowNs.load();
+    }
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - realEpoch).count();
+}
+
+void advanceNanos(uint64_t ns) {
+    if (!virtualTime) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(ns));
+        return;
+    }
+    if (!onLoopThread()) {
+        // Background tasks never move virtual time
+        return;
+    }
+    uint64_t now = virtualNowNs.fetch_add(ns) + ns;
+    if (activeModel) {
+        activeModel->onAdvance(now);
+    }
+    dispatchInterrupts();
+}
+
+void charge(uint32_t ns) {
+    if (!onLoopThread()) {
+        return;
+    }
+    if (!virtualTime) {
+        // Real time: handlers run whenever the firmware calls into the core
+        dispatchInterrupts();
+    } else if (ns) {
+        busyNs += ns;
+        advanceNanos(ns);
+    }
+}
+
+uint64_t busyNanos() { return busyNs; }
+
+int readPin(int pin) {
+    if (!validPin(pin)) return LOW;
+    const PinState& state = pins[pin];
+    int level;
+    if (state.forced >= 0) {
+        level = state.forced;
+    } else if (state.mode == OUTPUT) {
+        level = state.output;
+    } else {
+        level = (state.mode & PULLUP) ? HIGH : LOW;
+    }
+    if (activeModel) {
+        level = activeModel->onPinRead(pin, level);
+    }
+    return level;
+}
+
+int outputLevel(int pin) { return validPin(pin) ? pins[pin].output : LOW; }
+int pinModeOf(int pin) { return validPin(pin) ? pins[pin].mode : 0; }
+
+void setInputLevel(int pin, int level) {
+    if (validPin(pin)) pins[pin].forced = level ? HIGH : LOW;
+}
+
+void clearInputLevel(int pin) {
+    if (validPin(pin)) pins[pin].forced = -1;
+}
+
+void setModel(Model* model) { activeModel = model; }
+Model* model() { return activeModel; }
+
+void setSerialEcho(bool enabled) { echo = enabled; }
+bool serialEcho() { return echo; }
+
+void injectSerialInput(const char* text) {
+    std::lock_guard<std::mutex> guard(serialInputLock);
+    while (text && *text) serialInput.push_back(*text++);
+}
+
+int popSerialInput(bool consume) {
+    std::lock_guard<std::mutex> guard(serialInputLock);
+    if (serialInput.empty()) return -1;
+    int c = (unsigned char)serialInput.front();
+    if (consume) serialInput.pop_front();
+    return c;
+}
+
+int pendingSerialInput() {
+    std::lock_guard<std::mutex> guard(serialInputLock);
+    return (int)serialInput.size();
+}
+
+void setNetworkEnabled(bool enabled) {
+    if (enabled == network) return;
+    network = enabled;
+    WiFi.networkChanged(enabled);
+}
+bool networkEnabled() { return network; }
+
+void setTasksEnabled(bool enabled) { tasks = enabled; }
+bool tasksEnabled() { return tasks; }
+
+bool onLoopThread() { return std::this_thread::get_id() == loopThread; }
+void markLoopThread() { loopThread = std::this_thread::get_id(); }
+
+//* ************************************************************************
+//* ************************ GPIO PRIMITIVES ******************************
+//* ************************************************************************
+
+void writePin(int pin, int level) {
+    if (!validPin(pin)) return;
+    level = level ? HIGH : LOW;
+    bool changed = pins[pin].output != level;
+    pins[pin].output = (uint8_t)level;
+    if (!activeModel || !pins[pin].enabled) return;
+    if (changed) {
+        activeModel->onPinWrite(pin, level);
+    } else {
+        activeModel->onPinRefresh(pin, level);
+    }
+}
+
+void setPinMode(int pin, int mode) {
+    if (!validPin(pin)) return;
+    pins[pin].mode = (uint8_t)mode;
+    if (mode == OUTPUT) pins[pin].enabled = true;
+}
+
+void writeGpioRegister(uint32_t address, uint32_t value) {
+    int firstPin;
+    bool setOutput;      // OUT registers; otherwise ENABLE
+    bool set;            // W1TS; otherwise W1TC
+    switch (address) {
+        case GPIO_OUT_W1TS_REG: firstPin = 0; setOutput = true; set = true; break;
+        case GPIO_OUT_W1TC_REG: firstPin = 0; setOutput = true; set = false; break;
+        case GPIO_OUT1_W1TS_REG: firstPin = 32; setOutput = true; set = true; break;
+        case GPIO_OUT1_W1TC_REG: firstPin = 32; setOutput = true; set = false; break;
+        case GPIO_ENABLE_W1TS_REG: firstPin = 0; setOutput = false; set = true; break;
+        case GPIO_ENABLE_W1TC_REG: firstPin = 0; setOutput = false; set = false; break;
+        case GPIO_ENABLE1_W1TS_REG: firstPin = 32; setOutput = false; set = true; break;
+        case GPIO_ENABLE1_W1TC_REG: firstPin = 32; setOutput = false; set = false; break;
+        default: return;
+    }
+    charge(costModel.pinWriteNs);
+    for (int bit = 0; bit < 32; bit++) {
+        if (!(value & (1UL << bit))) continue;
+        int pin = firstPin + bit;
+        PinState& state = pins[pin];
+        if (setOutput) {
+            writePin(pin, set ? HIGH : LOW);
+        } else if (state.enabled != set) {
+            state.enabled = set;
+            if (!set) {
+                state.driven = state.output;
+            } else if (activeModel && state.output != state.driven) {
+                // Written while off - the wire changes as the driver comes back
+                activeModel->onPinWrite(pin, state.output);
+            }
+        }
+    }
+}
+
+bool outputEnabled(int pin) { return validPin(pin) && pins[pin].enabled; }
+
+void attachPinInterrupt(int pin, InterruptHandler handler, int mode) {
+    if (!validPin(pin)) return;
+    interrupts[pin].handler = handler;
+    interrupts[pin].mode = mode;
+    interrupts[pin].level = readPin(pin);
+    anyInterrupt = true;
+}
+
+void detachPinInterrupt(int pin) {
+    if (validPin(pin)) interrupts[pin].handler = nullptr;
+}
+
+int createTimer(TimerCallback callback, void* arg) {
+    if (timerCount >= MAX_TIMERS) return -1;
+    timers[timerCount].callback = callback;
+    timers[timerCount].arg = arg;
+    return timerCount++;
+}
+
+void startTimer(int timer, uint64_t periodNs, bool periodic) {
+    if (timer < 0 || timer >= timerCount) return;
+    timers[timer].periodNs = periodNs ? periodNs : 1;
+    timers[timer].dueNs = nowNanos() + timers[timer].periodNs;
+    timers[timer].periodic = periodic;
+    timers[timer].running = true;
+}
+
+void stopTimer(int timer) {
+    if (timer >= 0 && timer < timerCount) timers[timer].running = false;
+}
+
+}  // namespace hal
+
+//* ************************************************************************
+//* ************************ ARDUINO CORE FUNCTIONS ***********************
+//* ************************************************************************
+
+void pinMode(uint8_t pin, uint8_t mode) { hal::setPinMode(pin, mode); }
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    hal::charge(hal::costs().pinWriteNs);
+    hal::writePin(pin, val);
+}
+
+int digitalRead(uint8_t pin) {
+    hal::charge(hal::costs().pinReadNs);
+    return hal::readPin(pin);
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode) { hal::attachPinInterrupt(pin, handler, mode); }
+
+void detachInterrupt(uint8_t pin) { hal::detachPinInterrupt(pin); }
+
+unsigned long millis() {
+    hal::charge(hal::costs().clockReadNs);
+    return (unsigned long)(uint32_t)(hal::nowNanos() / 1000000ULL);
+}
+
+unsigned long micros() {
+    hal::charge(hal::costs().clockReadNs);
+    return (unsigned long)(uint32_t)(hal::nowNanos() / 1000ULL);
+}
+
+void delay(uint32_t ms) { hal::advanceNanos((uint64_t)ms * 1000000ULL); }
+
+void delayMicroseconds(uint32_t us) { hal::advanceNanos((uint64_t)us * 1000ULL); }
+
+void yield() {
+    if (hal::isVirtualTime()) {
+        hal::charge(hal::costs().yieldNs);
+    } else {
+        std::this_thread::yield();
+    }
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    const long run = in_max - in_min;
+    if (run == 0) return out_min;
+    return (x - in_min) * (out_max - out_min) / run + out_min;
+}
+
+long random(long howbig) { return howbig <= 0 ? 0 : rand() % howbig; }
+long random(long howsmall, long howbig) { return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall); }
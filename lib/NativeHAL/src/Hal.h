@@ -0,0 +1,134 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+//* ************************************************************************
+//* ************************ NATIVE HARDWARE ABSTRACTION LAYER ***********
+//* ************************************************************************
+//! Host-side replacement for the ESP32 Arduino core
+//! Owns the clock, the GPIO bank and the hooks a hardware model plugs into.
+//! The firmware never includes this header - only the native stand-ins for
+//! Arduino.h, AccelStepper.h, Bounce2.h, Servo.h, WiFi.h and friends do.
+//!
+//! Two clock modes:
+//!  - Real time (default): millis()/micros() follow the host monotonic clock
+//!    and delay() sleeps.
+//!  - Virtual time: the clock only moves when the firmware "spends" time.
+//!    Every HAL call charges a small, configurable cost and delay() jumps the
+//!    clock forward, so blocking loops still terminate and a run is fully
+//!    deterministic and much faster than real time.
+
+namespace hal {
+
+//* ************************************************************************
+//* ************************ CLOCK ****************************************
+//* ************************************************************************
+
+// Per-call cost model used in virtual time (nanoseconds)
+struct CostModel {
+    uint32_t clockReadNs;      // millis()/micros()
+    uint32_t pinReadNs;        // digitalRead()
+    uint32_t pinWriteNs;       // digitalWrite()
+    uint32_t yieldNs;          // yield() - one trip through the Arduino loop task
+    uint32_t uartBaud;         // Serial drain rate; 0 disables UART back-pressure
+    uint32_t uartFifoBytes;    // Bytes that can be queued before Serial.write() blocks
+    uint32_t interruptLatencyNs;   // Pin edge to handler entry - also how often interrupt pins are sampled
+};
+
+void setVirtualTime(bool enabled);
+bool isVirtualTime();
+CostModel& costs();
+
+uint64_t nowNanos();
+void advanceNanos(uint64_t ns);   // Virtual time: move the clock. Real time: sleep.
+void charge(uint32_t ns);         // Virtual time only: account for CPU work on the loop thread
+uint64_t busyNanos();             // Virtual time charged as CPU work (excludes delay())
+
+//* ************************************************************************
+//* ************************ GPIO *****************************************
+//* ************************************************************************
+
+static const int MAX_PINS = 64;
+
+int readPin(int pin);                    // What digitalRead() would return
+int outputLevel(int pin);                // Last level written with digitalWrite()
+int pinModeOf(int pin);
+void setInputLevel(int pin, int level);  // Drive an input from outside (tests, models)
+void clearInputLevel(int pin);           // Fall back to the pull-up/pull-down level
+
+// Register-level bank writes (soc/gpio_reg.h W1TS/W1TC addresses). An
+// output whose enable bit is cleared keeps its level but no longer drives
+// the model; pinMode(OUTPUT) enables it again.
+void writeGpioRegister(uint32_t address, uint32_t value);
+bool outputEnabled(int pin);
+
+//* ************************************************************************
+//* ************************ INTERRUPTS AND TIMERS ************************
+//* ************************************************************************
+//! Pin interrupts and esp_timer callbacks are dispatched on the loop thread
+//! whenever the clock moves. Pins with a handler are sampled (through the
+//! model) every interruptLatencyNs; timers fire once their deadline has
+//! passed. A handler runs to completion, and nothing else is dispatched
+//! while it does - as in an ISR on the chip.
+
+typedef void (*InterruptHandler)();
+typedef void (*TimerCallback)(void* arg);
+
+void attachPinInterrupt(int pin, InterruptHandler handler, int mode);   // RISING, FALLING or CHANGE
+void detachPinInterrupt(int pin);
+
+int createTimer(TimerCallback callback, void* arg);   // -1 when every slot is taken
+void startTimer(int timer, uint64_t periodNs, bool periodic);
+void stopTimer(int timer);
+
+//* ************************************************************************
+//* ************************ HARDWARE MODEL HOOK **************************
+//* ************************************************************************
+
+class Model {
+   public:
+    virtual ~Model() {}
+    // Output pin changed level
+    virtual void onPinWrite(int pin, int level) { (void)pin; (void)level; }
+    // Output pin written again with the level it already had (a repeated command)
+    virtual void onPinRefresh(int pin, int level) { (void)pin; (void)level; }
+    // Servo commanded to a new angle
+    virtual void onServoWrite(int pin, int angle) { (void)pin; (void)angle; }
+    // Input pin is being sampled; return the level the wire carries
+    virtual int onPinRead(int pin, int level) { (void)pin; return level; }
+    // Clock moved forward to nowNs
+    virtual void onAdvance(uint64_t nowNs) { (void)nowNs; }
+};
+
+void setModel(Model* model);
+Model* model();
+
+//* ************************************************************************
+//* ************************ HOST OPTIONS *********************************
+//* ************************************************************************
+
+void setSerialEcho(bool enabled);          // Copy Serial output to stdout
+bool serialEcho();
+void injectSerialInput(const char* text);  // Feed characters to Serial.read()
+
+void setNetworkEnabled(bool enabled);      // WiFi.begin() connects to the host network; a change raises station events
+bool networkEnabled();
+
+void setTasksEnabled(bool enabled);        // xTaskCreate*() spawns host threads
+bool tasksEnabled();
+
+bool onLoopThread();                       // True on the thread that runs setup()/loop()
+void markLoopThread();
+
+//* ************************************************************************
+//* ************************ CORE INTERNALS *******************************
+//* ************************************************************************
+// Used by the Arduino stand-ins; no cost is charged here
+
+void writePin(int pin, int level);
+void setPinMode(int pin, int mode);
+int popSerialInput(bool consume);
+int pendingSerialInput();
+
+}  // namespace hal
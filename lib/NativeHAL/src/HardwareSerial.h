@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Stream.h"
+
+//* ************************************************************************
+//* ************************ NATIVE SERIAL ********************************
+//* ************************************************************************
+//! UART stand-in. Output goes to stdout when echo is enabled; input comes
+//! from hal::injectSerialInput(). In virtual time the UART drains at the
+//! configured baud rate and a full FIFO stalls the caller, just like the
+//! blocking TX path on the ESP32.
+
+class HardwareSerial : public Stream {
+   public:
+    void begin(unsigned long baud) { _baud = baud; }
+    void end() {}
+    operator bool() const { return true; }
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+
+    int available() override;
+    int read() override;
+    int peek() override;
+
+    unsigned long baudRate() const { return _baud; }
+
+   private:
+    unsigned long _baud = 115200;
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Print.h"
+
+//* ************************************************************************
+//* ************************ NATIVE IPADDRESS *****************************
+//* ************************************************************************
+
+class IPAddress : public Printable {
+   public:
+    IPAddress() : _octets{0, 0, 0, 0} {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _octets{a, b, c, d} {}
+
+    uint8_t operator[](int index) const { return _octets[index]; }
+    String toString() const;
+    size_t printTo(Print& p) const override;
+
+   private:
+    uint8_t _octets[4];
+};
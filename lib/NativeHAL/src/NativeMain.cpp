@@ -0,0 +1,51 @@
+#include <Arduino.h>
+#include <esp_system.h>
+#include <stdio.h>
+#include <thread>
+#include "Hal.h"
+
+//* ************************************************************************
+//* ************************ NATIVE ENTRY POINT ***************************
+//* ************************************************************************
+//! Plays the role of the Arduino loop task: setup() once, then loop()
+//! forever. Programs with their own main() (the simulator) override this.
+//!
+//! Environment:
+//!   HAL_VIRTUAL_TIME=1   run on the virtual clock instead of wall time
+//!   HAL_MAX_SECONDS=N    clean exit (shutdown handlers run) after N seconds
+//!                        of virtual or real time
+//!   HAL_QUIET=1          do not echo Serial output
+//!   HAL_STDIN=1          forward stdin lines to Serial (serial console)
+
+namespace {
+
+void forwardStdinToSerial() {
+    char line[256];
+    while (fgets(line, sizeof(line), stdin) != nullptr) {
+        hal::injectSerialInput(line);
+    }
+}
+
+} // namespace
+
+__attribute__((weak)) int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    hal::markLoopThread();
+    hal::setVirtualTime(getenv("HAL_VIRTUAL_TIME") && atoi(getenv("HAL_VIRTUAL_TIME")));
+    hal::setSerialEcho(!(getenv("HAL_QUIET") && atoi(getenv("HAL_QUIET"))));
+    const char* maxSecondsText = getenv("HAL_MAX_SECONDS");
+    const uint64_t limitNs = maxSecondsText ? (uint64_t)atoll(maxSecondsText) * 1000000000ULL : 0;
+
+    if (getenv("HAL_STDIN") && atoi(getenv("HAL_STDIN"))) {
+        std::thread(forwardStdinToSerial).detach();
+    }
+
+    setup();
+    for (;;) {
+        loop();
+        if (limitNs && hal::nowNanos() >= limitNs) break;
+    }
+    esp_restart();
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include "Preferences.h"
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//* ************************************************************************
+//* ************************ NATIVE PREFERENCES IMPLEMENTATION ***********
+//* ************************************************************************
+//! File format (HAL_NVS_FILE): one "namespace key hexbytes" line per entry
+
+namespace {
+
+typedef std::map<std::string, std::vector<uint8_t>> Namespace;
+
+std::recursive_mutex storeLock;
+std::map<std::string, Namespace> store;
+bool storeLoaded = false;
+unsigned long committedWrites = 0;
+
+const char* storeFile() { return getenv("HAL_NVS_FILE"); }
+
+void loadStore() {
+    if (storeLoaded) return;
+    storeLoaded = true;
+    const char* path = storeFile();
+    FILE* file = path ? fopen(path, "r") : nullptr;
+    if (!file) return;
+    char ns[64], key[64], hex[1024];
+    while (fscanf(file, "%63s %63s %1023s", ns, key, hex) == 3) {
+        std::vector<uint8_t> bytes;
+        for (size_t i = 0; hex[i] && hex[i + 1]; i += 2) {
+            unsigned int byte;
+            sscanf(&hex[i], "%2x", &byte);
+            bytes.push_back((uint8_t)byte);
+        }
+        store[ns][key] = bytes;
+    }
+    fclose(file);
+}
+
+void saveStore() {
+    const char* path = storeFile();
+    FILE* file = path ? fopen(path, "w") : nullptr;
+    if (!file) return;
+    for (const auto& ns : store) {
+        for (const auto& entry : ns.second) {
+            fprintf(file, "%s %s ", ns.first.c_str(), entry.first.c_str());
+            for (uint8_t byte : entry.second) fprintf(file, "%02x", byte);
+            fprintf(file, "\n");
+        }
+    }
+    fclose(file);
+}
+
+}  // namespace
+
+bool Preferences::begin(const char* name, bool readOnly) {
+    std::lock_guard<std::recursive_mutex> guard(storeLock);
+    loadStore();
+    _namespace = name;
+    _readOnly = readOnly;
+    _open = true;
+    return true;
+}
+
+void Preferences::end() { _open = false; }
+
+bool Preferences::clear() {
+    std::lock_guard<std::recursive_mutex> guard(storeLock);
+    if (!_open || _readOnly) return false;
+    store[_namespace.c_str()].clear();
+    committedWrites++;
+    saveStore();
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    std::lock_guard<std::recursive_mutex> guard(storeLock);
+    if (!_open || _readOnly) return false;
+    bool removed = store[_namespace.c_str()].erase(key) > 0;
+    if (removed) {
+        committedWrites++;
+        saveStore();
+    }
+    return removed;
+}
+
+bool Preferences::isKey(const char* key) {
+    std::lock_guard<std::recursive_mutex> guard(storeLock);
+    if (!_open) return false;
+    const Namespace& ns = store[_namespace.c_str()];
+    return ns.find(key) != ns.end();
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+    std::lock_guard<std::recursive_mutex> guard(storeLock);
+    if (!_open || _readOnly || !key) return 0;
+    const uint8_t* bytes = (const uint8_t*)value;
+    std::vector<uint8_t>& slot = store[_namespace.c_str()][key];
+    std::vector<uint8_t> incoming(bytes, bytes + len);
+    if (slot != incoming) {
+        // NVS skips the flash write when the value is unchanged
+        slot = incoming;
+        committedWrites++;
+        saveStore();
+    }
+    return len;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    std::lock_guard<std::recursive_mutex> guard(storeLock);
+    if (!_open) return 0;
+    const Namespace& ns = store[_namespace.c_str()];
+    auto it = ns.find(key);
+    return it == ns.end() ? 0 : it->second.size();
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t maxLen) {
+    std::lock_guard<std::recursive_mutex> guard(storeLock);
+    if (!_open) return 0;
+    const Namespace& ns = store[_namespace.c_str()];
+    auto it = ns.find(key);
+    if (it == ns.end() || it->second.size() > maxLen) return 0;
+    memcpy(buffer, it->second.data(), it->second.size());
+    return it->second.size();
+}
+
+unsigned long Preferences::writeCount() {
+    std::lock_guard<std::recursive_mutex> guard(storeLock);
+    return committedWrites;
+}
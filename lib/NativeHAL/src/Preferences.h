@@ -0,0 +1,57 @@
+#pragma once
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ NATIVE PREFERENCES ***************************
+//* ************************************************************************
+//! NVS stand-in: an in-memory key/value store shared by every Preferences
+//! instance, optionally mirrored to the file named by HAL_NVS_FILE so
+//! values survive a restart of the native program. Every committed write is
+//! counted so flash wear can be measured on the host.
+
+class Preferences {
+   public:
+    bool begin(const char* name, bool readOnly = false);
+    void end();
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putUChar(const char* key, uint8_t value) { return putBytes(key, &value, sizeof(value)); }
+    size_t putBool(const char* key, bool value) { return putBytes(key, &value, sizeof(value)); }
+    size_t putInt(const char* key, int32_t value) { return putBytes(key, &value, sizeof(value)); }
+    size_t putUInt(const char* key, uint32_t value) { return putBytes(key, &value, sizeof(value)); }
+    size_t putLong(const char* key, int32_t value) { return putBytes(key, &value, sizeof(value)); }
+    size_t putULong(const char* key, uint32_t value) { return putBytes(key, &value, sizeof(value)); }
+    size_t putLong64(const char* key, int64_t value) { return putBytes(key, &value, sizeof(value)); }
+    size_t putULong64(const char* key, uint64_t value) { return putBytes(key, &value, sizeof(value)); }
+    size_t putFloat(const char* key, float value) { return putBytes(key, &value, sizeof(value)); }
+    size_t putBytes(const char* key, const void* value, size_t len);
+
+    uint8_t getUChar(const char* key, uint8_t def = 0) { return getValue(key, def); }
+    bool getBool(const char* key, bool def = false) { return getValue(key, def); }
+    int32_t getInt(const char* key, int32_t def = 0) { return getValue(key, def); }
+    uint32_t getUInt(const char* key, uint32_t def = 0) { return getValue(key, def); }
+    int32_t getLong(const char* key, int32_t def = 0) { return getValue(key, def); }
+    uint32_t getULong(const char* key, uint32_t def = 0) { return getValue(key, def); }
+    int64_t getLong64(const char* key, int64_t def = 0) { return getValue(key, def); }
+    uint64_t getULong64(const char* key, uint64_t def = 0) { return getValue(key, def); }
+    float getFloat(const char* key, float def = NAN) { return getValue(key, def); }
+    size_t getBytesLength(const char* key);
+    size_t getBytes(const char* key, void* buffer, size_t maxLen);
+
+    // Host-only: number of writes committed across all namespaces
+    static unsigned long writeCount();
+
+   private:
+    template <typename T>
+    T getValue(const char* key, T def) {
+        T value;
+        return getBytes(key, &value, sizeof(value)) == sizeof(value) ? value : def;
+    }
+
+    String _namespace;
+    bool _open = false;
+    bool _readOnly = false;
+};
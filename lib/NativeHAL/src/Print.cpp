@@ -0,0 +1,223 @@
+#include <Arduino.h>
+#include <IPAddress.h>
+#include <stdarg.h>
+#include "Hal.h"
+
+//* ************************************************************************
+//* ************************ NATIVE PRINT / STREAM / STRING **************
+//* ************************************************************************
+
+//* ************************************************************************
+//* ************************ PRINT ****************************************
+//* ************************************************************************
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        if (!write(*buffer++)) break;
+        n++;
+    }
+    return n;
+}
+
+size_t Print::write(const char* str) {
+    return str ? write((const uint8_t*)str, strlen(str)) : 0;
+}
+
+size_t Print::printf(const char* format, ...) {
+    char stackBuffer[128];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(stackBuffer, sizeof(stackBuffer), format, args);
+    va_end(args);
+    if (len < 0) return 0;
+    if ((size_t)len < sizeof(stackBuffer)) {
+        return write((const uint8_t*)stackBuffer, len);
+    }
+    char* heapBuffer = (char*)malloc(len + 1);
+    if (!heapBuffer) return 0;
+    va_start(args, format);
+    vsnprintf(heapBuffer, len + 1, format, args);
+    va_end(args);
+    size_t n = write((const uint8_t*)heapBuffer, len);
+    free(heapBuffer);
+    return n;
+}
+
+size_t Print::print(const char* s) { return write(s); }
+size_t Print::print(const String& s) { return write((const uint8_t*)s.c_str(), s.length()); }
+size_t Print::print(char c) { return write((uint8_t)c); }
+size_t Print::print(unsigned char v, int base) { return printUnsigned(v, base); }
+size_t Print::print(unsigned int v, int base) { return printUnsigned(v, base); }
+size_t Print::print(unsigned long v, int base) { return printUnsigned(v, base); }
+size_t Print::print(unsigned long long v, int base) { return printUnsigned(v, base); }
+size_t Print::print(int v, int base) { return print((long long)v, base); }
+size_t Print::print(long v, int base) { return print((long long)v, base); }
+
+size_t Print::print(long long v, int base) {
+    if (base == DEC && v < 0) {
+        return print('-') + printUnsigned((unsigned long long)(-(v + 1)) + 1, DEC);
+    }
+    return printUnsigned((unsigned long long)v, base);
+}
+
+size_t Print::printUnsigned(unsigned long long v, int base) {
+    char buffer[65];
+    char* p = &buffer[sizeof(buffer) - 1];
+    *p = '\0';
+    if (base < 2) base = DEC;
+    do {
+        int digit = (int)(v % base);
+        *--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+        v /= base;
+    } while (v);
+    return write(p);
+}
+
+size_t Print::print(double v, int digits) {
+    if (std::isnan(v)) return print("nan");
+    if (std::isinf(v)) return print("inf");
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "%.*f", digits, v);
+    return write(buffer);
+}
+
+size_t Print::print(const Printable& p) { return p.printTo(*this); }
+
+size_t Print::println() { return write("\r\n"); }
+
+//* ************************************************************************
+//* ************************ STREAM ***************************************
+//* ************************************************************************
+
+int Stream::timedRead() {
+    unsigned long start = millis();
+    do {
+        int c = read();
+        if (c >= 0) return c;
+        if (!hal::isVirtualTime()) delay(1);
+    } while (millis() - start < _timeoutMs);
+    return -1;
+}
+
+String Stream::readStringUntil(char terminator) {
+    String result;
+    int c = timedRead();
+    while (c >= 0 && c != terminator) {
+        result += (char)c;
+        c = timedRead();
+    }
+    return result;
+}
+
+size_t Stream::readBytes(uint8_t* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = timedRead();
+        if (c < 0) break;
+        *buffer++ = (uint8_t)c;
+        count++;
+    }
+    return count;
+}
+
+//* ************************************************************************
+//* ************************ HARDWARE SERIAL ******************************
+//* ************************************************************************
+
+HardwareSerial Serial;
+
+namespace {
+uint64_t uartBusyUntilNs = 0;
+
+void chargeUart(size_t bytes) {
+    const hal::CostModel& cost = hal::costs();
+    if (!hal::isVirtualTime() || !cost.uartBaud || !hal::onLoopThread()) return;
+    const uint64_t charNs = 10ULL * 1000000000ULL / cost.uartBaud;  // 8N1 = 10 bits per char
+    const uint64_t fifoNs = charNs * cost.uartFifoBytes;
+    for (size_t i = 0; i < bytes; i++) {
+        uint64_t now = hal::nowNanos();
+        if (uartBusyUntilNs < now) uartBusyUntilNs = now;
+        // Block until the FIFO has room for one more character
+        if (uartBusyUntilNs - now + charNs > fifoNs) {
+            hal::advanceNanos(uartBusyUntilNs - now + charNs - fifoNs);
+        }
+        uartBusyUntilNs += charNs;
+    }
+}
+}  // namespace
+
+size_t HardwareSerial::write(uint8_t c) { return write(&c, 1); }
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    chargeUart(size);
+    if (hal::serialEcho()) {
+        fwrite(buffer, 1, size, stdout);
+    }
+    return size;
+}
+
+int HardwareSerial::available() { return hal::pendingSerialInput(); }
+int HardwareSerial::read() { return hal::popSerialInput(true); }
+int HardwareSerial::peek() { return hal::popSerialInput(false); }
+
+//* ************************************************************************
+//* ************************ STRING ***************************************
+//* ************************************************************************
+
+String::String(float v, unsigned int decimals) : String((double)v, decimals) {}
+
+String::String(double v, unsigned int decimals) {
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "%.*f", (int)decimals, v);
+    _s = buffer;
+}
+
+bool String::equalsIgnoreCase(const String& o) const {
+    return strcasecmp(_s.c_str(), o._s.c_str()) == 0;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+    size_t pos = _s.find(c, from);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String& s, unsigned int from) const {
+    size_t pos = _s.find(s._s, from);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int from) const {
+    return from >= _s.size() ? String() : String(_s.substr(from));
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    if (from >= _s.size()) return String();
+    return String(_s.substr(from, to - from));
+}
+
+void String::trim() {
+    size_t begin = _s.find_first_not_of(" \t\r\n");
+    size_t end = _s.find_last_not_of(" \t\r\n");
+    _s = begin == std::string::npos ? std::string() : _s.substr(begin, end - begin + 1);
+}
+
+void String::toLowerCase() {
+    for (char& c : _s) c = (char)tolower((unsigned char)c);
+}
+
+long String::toInt() const { return strtol(_s.c_str(), nullptr, 10); }
+float String::toFloat() const { return strtof(_s.c_str(), nullptr); }
+
+//* ************************************************************************
+//* ************************ IPADDRESS ************************************
+//* ************************************************************************
+
+String IPAddress::toString() const {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", _octets[0], _octets[1], _octets[2], _octets[3]);
+    return String(buffer);
+}
+
+size_t IPAddress::printTo(Print& p) const { return p.print(toString()); }
@@ -0,0 +1,78 @@
+#include "Servo.h"
+#include "Hal.h"
+
+//* ************************************************************************
+//* ************************ NATIVE SERVO IMPLEMENTATION ******************
+//* ************************************************************************
+
+bool Servo::attach(int pin, int channel, int minAngle, int maxAngle, int minPulseWidthUs, int maxPulseWidthUs,
+                   int frequency) {
+    (void)channel;
+    if (1000000 / frequency <= maxPulseWidthUs) {
+        return false;
+    }
+    _pin = pin;
+    _minAngle = minAngle;
+    _maxAngle = maxAngle;
+    _minUs = minPulseWidthUs;
+    _maxUs = maxPulseWidthUs;
+    pinMode(pin, OUTPUT);
+    return true;
+}
+
+bool Servo::detach() {
+    if (!attached()) {
+        return false;
+    }
+    _pin = PIN_NOT_ATTACHED;
+    return true;
+}
+
+void Servo::write(int angle) {
+    angle = constrain(angle, _minAngle, _maxAngle);
+    writeMicroseconds(_angleToUs(angle));
+}
+
+void Servo::writeMicroseconds(int pulseWidthUs) {
+    if (!attached()) return;
+    _pulseUs = constrain(pulseWidthUs, _minUs, _maxUs);
+    _moveEndNs = 0;
+    hal::charge(hal::costs().pinWriteNs);
+    if (hal::model()) {
+        hal::model()->onServoWrite(_pin, read());
+    }
+}
+
+int Servo::readMicroseconds() const {
+    if (!attached()) return 0;
+    uint64_t now = hal::nowNanos();
+    if (now >= _moveEndNs) {
+        return _pulseUs;
+    }
+    double progress = (double)(now - _moveStartNs) / (double)(_moveEndNs - _moveStartNs);
+    return _fromUs + (int)((_pulseUs - _fromUs) * progress);
+}
+
+int Servo::read() const { return map(readMicroseconds(), _minUs, _maxUs, _minAngle, _maxAngle); }
+
+bool Servo::moveTo(int angle, uint32_t durationMs) {
+    if (!attached()) return false;
+    angle = constrain(angle, _minAngle, _maxAngle);
+    int targetUs = _angleToUs(angle);
+    if (durationMs == 0 || targetUs == _pulseUs) {
+        writeMicroseconds(targetUs);
+        return true;
+    }
+    //! The model sees the target when the move starts, as a plain write
+    _fromUs = readMicroseconds();
+    _pulseUs = targetUs;
+    _moveStartNs = hal::nowNanos();
+    _moveEndNs = _moveStartNs + (uint64_t)durationMs * 1000000ULL;
+    hal::charge(hal::costs().pinWriteNs);
+    if (hal::model()) {
+        hal::model()->onServoWrite(_pin, angle);
+    }
+    return true;
+}
+
+bool Servo::isMoving() const { return attached() && hal::nowNanos() < _moveEndNs; }
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ NATIVE SERVO *********************************
+//* ************************************************************************
+//! Host stand-in for lib/ServoESP32 (ServoTemplate<int>). Angle writes are
+//! forwarded to the hardware model; no pulse train is generated. A timed
+//! move stands in for the LEDC fade: the pulse width ramps linearly on the
+//! HAL clock, so read() and isMoving() follow it as on the board.
+
+class Servo {
+   public:
+    static const int DEFAULT_MIN_ANGLE = 0;
+    static const int DEFAULT_MAX_ANGLE = 180;
+    static const int DEFAULT_MIN_PULSE_WIDTH_US = 544;
+    static const int DEFAULT_MAX_PULSE_WIDTH_US = 2400;
+    static const int DEFAULT_FREQUENCY = 50;
+    static const int CHANNEL_NOT_ATTACHED = -1;
+    static const int PIN_NOT_ATTACHED = -1;
+
+    bool attach(int pin, int channel = CHANNEL_NOT_ATTACHED, int minAngle = DEFAULT_MIN_ANGLE,
+                int maxAngle = DEFAULT_MAX_ANGLE, int minPulseWidthUs = DEFAULT_MIN_PULSE_WIDTH_US,
+                int maxPulseWidthUs = DEFAULT_MAX_PULSE_WIDTH_US, int frequency = DEFAULT_FREQUENCY);
+    bool detach();
+    bool attached() const { return _pin != PIN_NOT_ATTACHED; }
+    int attachedPin() const { return _pin; }
+
+    void write(int angle);
+    void writeMicroseconds(int pulseWidthUs);
+    int read() const;
+    int readMicroseconds() const;
+
+    bool moveTo(int angle, uint32_t durationMs);
+    bool isMoving() const;
+
+   private:
+    int _angleToUs(int angle) const { return map(angle, _minAngle, _maxAngle, _minUs, _maxUs); }
+
+    int _pin = PIN_NOT_ATTACHED;
+    int _minAngle = DEFAULT_MIN_ANGLE;
+    int _maxAngle = DEFAULT_MAX_ANGLE;
+    int _minUs = DEFAULT_MIN_PULSE_WIDTH_US;
+    int _maxUs = DEFAULT_MAX_PULSE_WIDTH_US;
+    int _pulseUs = DEFAULT_MIN_PULSE_WIDTH_US;   // Target of the last write or move
+
+    // Timed move: _fromUs -> _pulseUs between _moveStartNs and _moveEndNs
+    int _fromUs = DEFAULT_MIN_PULSE_WIDTH_US;
+    uint64_t _moveStartNs = 0;
+    uint64_t _moveEndNs = 0;
+};
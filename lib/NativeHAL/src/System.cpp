@@ -0,0 +1,203 @@
+#include <Arduino.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+#include <pthread.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <freertos/event_groups.h>
+#include <freertos/semphr.h>
+#include "Hal.h"
+
+//* ************************************************************************
+//* ************************ NATIVE SYSTEM SERVICES ***********************
+//* ************************************************************************
+//! FreeRTOS tasks, reset reason and the ESP object
+
+EspClass ESP;
+
+void EspClass::restart() { esp_restart(); }
+
+esp_reset_reason_t esp_reset_reason(void) { return ESP_RST_POWERON; }
+
+namespace {
+std::vector<shutdown_handler_t>& shutdownHandlers() {
+    static std::vector<shutdown_handler_t> handlers;
+    return handlers;
+}
+} // namespace
+
+esp_err_t esp_register_shutdown_handler(shutdown_handler_t handler) {
+    if (shutdownHandlers().size() >= 5) {
+        return ESP_ERR_NO_MEM;
+    }
+    shutdownHandlers().push_back(handler);
+    return ESP_OK;
+}
+
+void esp_restart(void) {
+    for (auto it = shutdownHandlers().rbegin(); it != shutdownHandlers().rend(); ++it) {
+        (*it)();
+    }
+    fflush(stdout);
+    exit(0);
+}
+
+//* ************************************************************************
+//* ************************ TASKS ****************************************
+//* ************************************************************************
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char* name, uint32_t stackDepth,
+                                   void* parameter, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t coreId) {
+    (void)name;
+    (void)stackDepth;
+    (void)priority;
+    (void)coreId;
+    if (handle) *handle = nullptr;
+    if (!hal::tasksEnabled()) {
+        return pdPASS;
+    }
+    std::thread worker(task, parameter);
+    if (handle) *handle = (TaskHandle_t)(uintptr_t)worker.native_handle();
+    worker.detach();
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t task, const char* name, uint32_t stackDepth,
+                       void* parameter, UBaseType_t priority, TaskHandle_t* handle) {
+    return xTaskCreatePinnedToCore(task, name, stackDepth, parameter, priority, handle, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (task == nullptr && !hal::onLoopThread()) {
+        pthread_exit(nullptr);
+    }
+}
+
+void vTaskDelay(TickType_t ticks) {
+    if (hal::onLoopThread()) {
+        delay(ticks);
+    } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+    }
+}
+
+TickType_t xTaskGetTickCount() { return (TickType_t)(hal::nowNanos() / 1000000ULL); }
+
+BaseType_t xPortGetCoreID() { return hal::onLoopThread() ? 1 : 0; }
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    (void)task;
+    return 4096;
+}
+
+//* ************************************************************************
+//* ************************ SEMAPHORES ***********************************
+//* ************************************************************************
+
+struct HalSemaphore {
+    std::timed_mutex lock;
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) { return new HalSemaphore(); }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait) {
+    if (ticksToWait == portMAX_DELAY) {
+        semaphore->lock.lock();
+        return pdTRUE;
+    }
+    return semaphore->lock.try_lock_for(std::chrono::milliseconds(ticksToWait)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    semaphore->lock.unlock();
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) { delete semaphore; }
+
+//* ************************************************************************
+//* ************************ EVENT GROUPS *********************************
+//* ************************************************************************
+
+struct HalEventGroup {
+    std::mutex lock;
+    std::condition_variable changed;
+    EventBits_t bits = 0;
+};
+
+EventGroupHandle_t xEventGroupCreate(void) { return new HalEventGroup(); }
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits) {
+    std::lock_guard<std::mutex> guard(group->lock);
+    group->bits |= bits;
+    group->changed.notify_all();
+    return group->bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits) {
+    std::lock_guard<std::mutex> guard(group->lock);
+    EventBits_t before = group->bits;
+    group->bits &= ~bits;
+    return before;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group) {
+    std::lock_guard<std::mutex> guard(group->lock);
+    return group->bits;
+}
+
+// Returns the bits as they were when the wait ended, before any clear
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clearOnExit,
+                                BaseType_t waitForAll, TickType_t ticksToWait) {
+    std::unique_lock<std::mutex> guard(group->lock);
+    auto satisfied = [&]() {
+        return waitForAll ? (group->bits & bits) == bits : (group->bits & bits) != 0;
+    };
+    if (ticksToWait == portMAX_DELAY) {
+        group->changed.wait(guard, satisfied);
+    } else {
+        group->changed.wait_for(guard, std::chrono::milliseconds(ticksToWait), satisfied);
+    }
+    EventBits_t result = group->bits;
+    if (clearOnExit && satisfied()) {
+        group->bits &= ~bits;
+    }
+    return result;
+}
+
+void vEventGroupDelete(EventGroupHandle_t group) { delete group; }
+
+//* ************************************************************************
+//* ************************ ESP TIMER ************************************
+//* ************************************************************************
+
+int64_t esp_timer_get_time(void) { return (int64_t)(hal::nowNanos() / 1000ULL); }
+
+// Handles are the HAL timer slot + 1, so a null handle is never valid
+esp_err_t esp_timer_create(const esp_timer_create_args_t* create_args, esp_timer_handle_t* out_handle) {
+    int timer = hal::createTimer(create_args->callback, create_args->arg);
+    if (timer < 0) {
+        return ESP_ERR_NO_MEM;
+    }
+    *out_handle = (esp_timer_handle_t)(uintptr_t)(timer + 1);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period) {
+    hal::startTimer((int)(uintptr_t)timer - 1, period * 1000ULL, true);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+    hal::startTimer((int)(uintptr_t)timer - 1, timeout_us * 1000ULL, false);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    hal::stopTimer((int)(uintptr_t)timer - 1);
+    return ESP_OK;
+}
@@ -0,0 +1,87 @@
+#include "Update.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+//* ************************************************************************
+//* ************************ NATIVE UPDATE IMPLEMENTATION ****************
+//* ************************************************************************
+
+UpdateClass Update;
+
+namespace {
+// The ESP32-S3 app partition of the default 8 MB layout
+const size_t OTA_PARTITION_SIZE = 0x330000;
+}
+
+bool UpdateClass::begin(size_t size, int command, int ledPin, uint8_t ledOn, const char* label) {
+    (void)ledPin;
+    (void)ledOn;
+    (void)label;
+    _image.clear();
+    _running = false;
+    _size = 0;
+    if (command != U_FLASH || size == 0 || (size != UPDATE_SIZE_UNKNOWN && size > OTA_PARTITION_SIZE)) {
+        _error = UPDATE_ERROR_SIZE;
+        return false;
+    }
+    _error = UPDATE_ERROR_OK;
+    _size = size == UPDATE_SIZE_UNKNOWN ? OTA_PARTITION_SIZE : size;
+    _image.reserve(_size);
+    _running = true;
+    return true;
+}
+
+size_t UpdateClass::write(uint8_t* data, size_t len) {
+    if (!_running || hasError()) {
+        return 0;
+    }
+    if (_image.size() + len > _size) {
+        _error = UPDATE_ERROR_SIZE;
+        return 0;
+    }
+    _image.insert(_image.end(), data, data + len);
+    return len;
+}
+
+bool UpdateClass::end(bool evenIfRemaining) {
+    if (!_running || hasError()) {
+        return false;
+    }
+    _running = false;
+    if (!evenIfRemaining && _image.size() != _size) {
+        _error = UPDATE_ERROR_SIZE;
+        return false;
+    }
+    _size = _image.size();
+    const char* path = getenv("HAL_OTA_FILE");
+    if (path != nullptr) {
+        FILE* file = fopen(path, "wb");
+        if (file == nullptr || fwrite(_image.data(), 1, _image.size(), file) != _image.size()) {
+            _error = UPDATE_ERROR_WRITE;
+        }
+        if (file != nullptr) {
+            fclose(file);
+        }
+    }
+    return !hasError();
+}
+
+void UpdateClass::abort() {
+    _running = false;
+    _error = UPDATE_ERROR_ABORT;
+}
+
+const char* UpdateClass::errorString() const {
+    switch (_error) {
+        case UPDATE_ERROR_OK:
+            return "No Error";
+        case UPDATE_ERROR_WRITE:
+            return "Flash Write Failed";
+        case UPDATE_ERROR_SIZE:
+            return "Bad Size Given";
+        case UPDATE_ERROR_ABORT:
+            return "Update Aborted";
+        default:
+            return "Bad Argument";
+    }
+}
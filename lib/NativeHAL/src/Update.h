@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+
+//* ************************************************************************
+//* ************************ NATIVE UPDATE ********************************
+//* ************************************************************************
+//! OTA partition stand-in: written bytes are kept in memory (image()) and,
+//! when HAL_OTA_FILE is set, saved to that file by a successful end(), so a
+//! native build can take an update and the result can be compared.
+
+#define UPDATE_SIZE_UNKNOWN 0xFFFFFFFF
+
+#define U_FLASH 0
+#define U_SPIFFS 100
+
+#define UPDATE_ERROR_OK 0
+#define UPDATE_ERROR_WRITE 1
+#define UPDATE_ERROR_SIZE 4
+#define UPDATE_ERROR_ABORT 8
+#define UPDATE_ERROR_BAD_ARGUMENT 9
+
+class UpdateClass {
+   public:
+    bool begin(size_t size = UPDATE_SIZE_UNKNOWN, int command = U_FLASH, int ledPin = -1,
+               uint8_t ledOn = LOW, const char* label = nullptr);
+    size_t write(uint8_t* data, size_t len);
+    bool end(bool evenIfRemaining = false);
+    void abort();
+
+    bool isRunning() const { return _running; }
+    bool isFinished() const { return !_running && _error == UPDATE_ERROR_OK && _size > 0 && _image.size() == _size; }
+    bool hasError() const { return _error != UPDATE_ERROR_OK; }
+    uint8_t getError() const { return _error; }
+    const char* errorString() const;
+    size_t size() const { return _size; }
+    size_t progress() const { return _image.size(); }
+    size_t remaining() const { return _size - _image.size(); }
+
+    // Native only - the partition contents
+    const std::vector<uint8_t>& image() const { return _image; }
+
+   private:
+    std::vector<uint8_t> _image;
+    size_t _size = 0;
+    bool _running = false;
+    uint8_t _error = UPDATE_ERROR_OK;
+};
+
+extern UpdateClass Update;
@@ -0,0 +1,249 @@
+#include "WiFi.h"
+#include "ArduinoOTA.h"
+#include "Hal.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+//* ************************************************************************
+//* ************************ NATIVE WIFI IMPLEMENTATION ******************
+//* ************************************************************************
+
+WiFiClass WiFi;
+ArduinoOTAClass ArduinoOTA;
+
+//* ************************************************************************
+//* ************************ STATION **************************************
+//* ************************************************************************
+
+wl_status_t WiFiClass::begin(const char* ssid, const char* passphrase) {
+    (void)ssid;
+    (void)passphrase;
+    bool wasConnected = isConnected();
+    _begun = true;
+    if (!wasConnected && isConnected()) raiseLinkUp();
+    return status();
+}
+
+bool WiFiClass::disconnect(bool wifiOff) {
+    bool wasConnected = isConnected();
+    _begun = false;
+    if (wifiOff) _mode = WIFI_OFF;
+    if (wasConnected) raiseLinkDown();
+    return true;
+}
+
+bool WiFiClass::reconnect() {
+    bool wasConnected = isConnected();
+    _begun = true;
+    if (!wasConnected && isConnected()) raiseLinkUp();
+    return isConnected();
+}
+
+void WiFiClass::networkChanged(bool enabled) {
+    if (!_begun) return;
+    if (enabled) {
+        raiseLinkUp();
+    } else {
+        raiseLinkDown();
+    }
+}
+
+//* ************************************************************************
+//* ************************ EVENTS ***************************************
+//* ************************************************************************
+
+wifi_event_id_t WiFiClass::onEvent(WiFiEventCb callback, arduino_event_id_t event) {
+    for (size_t i = 0; i < MAX_EVENT_HANDLERS; i++) {
+        if (_handlers[i].callback == nullptr) {
+            _handlers[i].callback = callback;
+            _handlers[i].event = event;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+void WiFiClass::removeEvent(wifi_event_id_t id) {
+    if (id > 0 && id <= MAX_EVENT_HANDLERS) {
+        _handlers[id - 1].callback = nullptr;
+    }
+}
+
+void WiFiClass::raiseEvent(arduino_event_id_t event) {
+    for (size_t i = 0; i < MAX_EVENT_HANDLERS; i++) {
+        const EventHandler& handler = _handlers[i];
+        if (handler.callback != nullptr && (handler.event == ARDUINO_EVENT_MAX || handler.event == event)) {
+            handler.callback(event);
+        }
+    }
+}
+
+// Same order as the driver: association, then the address
+void WiFiClass::raiseLinkUp() {
+    raiseEvent(ARDUINO_EVENT_WIFI_STA_CONNECTED);
+    raiseEvent(ARDUINO_EVENT_WIFI_STA_GOT_IP);
+}
+
+void WiFiClass::raiseLinkDown() {
+    raiseEvent(ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+}
+
+wl_status_t WiFiClass::status() {
+    if (!_begun) return WL_IDLE_STATUS;
+    return hal::networkEnabled() ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+IPAddress WiFiClass::localIP() {
+    return isConnected() ? IPAddress(127, 0, 0, 1) : IPAddress();
+}
+
+//* ************************************************************************
+//* ************************ TCP CLIENT ***********************************
+//* ************************************************************************
+
+int WiFiClient::connect(const char* host, uint16_t port) {
+    stop();
+    struct addrinfo hints = {};
+    struct addrinfo* result = nullptr;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    char portText[8];
+    snprintf(portText, sizeof(portText), "%u", port);
+    if (getaddrinfo(host, portText, &hints, &result) != 0 || !result) return 0;
+    int fd = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    if (fd >= 0 && ::connect(fd, result->ai_addr, result->ai_addrlen) != 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(result);
+    _fd = fd;
+    return _fd >= 0 ? 1 : 0;
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port) { return connect(ip.toString().c_str(), port); }
+
+uint8_t WiFiClient::connected() {
+    if (_fd < 0) return 0;
+    if (_peeked >= 0) return 1;
+    char probe;
+    ssize_t n = recv(_fd, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0) return 0;
+    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) return 0;
+    return 1;
+}
+
+void WiFiClient::stop() {
+    if (_fd >= 0) ::close(_fd);
+    _fd = -1;
+    _peeked = -1;
+}
+
+void WiFiClient::setNoDelay(bool noDelay) {
+    if (_fd < 0) return;
+    int flag = noDelay ? 1 : 0;
+    setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+}
+
+size_t WiFiClient::write(uint8_t c) { return write(&c, 1); }
+
+size_t WiFiClient::write(const uint8_t* buffer, size_t size) {
+    if (_fd < 0) return 0;
+    size_t sent = 0;
+    while (sent < size) {
+        ssize_t n = send(_fd, buffer + sent, size - sent, MSG_NOSIGNAL);
+        if (n <= 0) break;
+        sent += (size_t)n;
+    }
+    return sent;
+}
+
+int WiFiClient::fill() {
+    if (_peeked >= 0) return _peeked;
+    if (_fd < 0) return -1;
+    uint8_t c;
+    ssize_t n = recv(_fd, &c, 1, MSG_DONTWAIT);
+    if (n == 1) _peeked = c;
+    return _peeked;
+}
+
+int WiFiClient::available() {
+    if (_fd < 0) return 0;
+    int pending = 0;
+    ioctl(_fd, FIONREAD, &pending);
+    return pending + (_peeked >= 0 ? 1 : 0);
+}
+
+int WiFiClient::read() {
+    int c = fill();
+    _peeked = -1;
+    return c;
+}
+
+int WiFiClient::peek() { return fill(); }
+
+int WiFiClient::read(uint8_t* buffer, size_t size) {
+    size_t count = 0;
+    while (count < size) {
+        int c = read();
+        if (c < 0) break;
+        buffer[count++] = (uint8_t)c;
+    }
+    return count ? (int)count : -1;
+}
+
+//* ************************************************************************
+//* ************************ TCP SERVER ***********************************
+//* ************************************************************************
+
+void WiFiServer::begin(uint16_t port) {
+    if (port) _port = port;
+    end();
+    const char* offsetText = getenv("HAL_PORT_OFFSET");
+    uint16_t hostPort = (uint16_t)(_port + (offsetText ? atoi(offsetText) : 0));
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return;
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(hostPort);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, _maxClients) != 0) {
+        fprintf(stderr, "[hal] WiFiServer: cannot listen on port %u: %s\n", hostPort, strerror(errno));
+        ::close(fd);
+        return;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    _fd = fd;
+}
+
+void WiFiServer::end() {
+    if (_fd >= 0) ::close(_fd);
+    _fd = -1;
+}
+
+bool WiFiServer::hasClient() {
+    if (_fd < 0) return false;
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(_fd, &readable);
+    struct timeval timeout = {0, 0};
+    return select(_fd + 1, &readable, nullptr, nullptr, &timeout) > 0;
+}
+
+WiFiClient WiFiServer::available() {
+    if (_fd < 0) return WiFiClient();
+    int fd = ::accept(_fd, nullptr, nullptr);
+    if (fd < 0) return WiFiClient();
+    WiFiClient client(fd);
+    if (_noDelay) client.setNoDelay(true);
+    return client;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <Arduino.h>
+#include "IPAddress.h"
+#include "WiFiClient.h"
+#include "WiFiServer.h"
+
+//* ************************************************************************
+//* ************************ NATIVE WIFI **********************************
+//* ************************************************************************
+//! The host network stands in for the station link. WiFi.begin() "connects"
+//! immediately when hal::networkEnabled() and never otherwise.
+//! Station events go to onEvent() handlers on the thread that caused them:
+//! begin(), disconnect(), or hal::setNetworkEnabled() while begun.
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6,
+    WL_NO_SHIELD = 255
+} wl_status_t;
+
+typedef enum {
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+    WIFI_AP = 2,
+    WIFI_AP_STA = 3
+} wifi_mode_t;
+
+// The station events the firmware uses (arduino-esp32 names)
+typedef enum {
+    ARDUINO_EVENT_WIFI_STA_START,
+    ARDUINO_EVENT_WIFI_STA_STOP,
+    ARDUINO_EVENT_WIFI_STA_CONNECTED,
+    ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+    ARDUINO_EVENT_WIFI_STA_GOT_IP,
+    ARDUINO_EVENT_WIFI_STA_LOST_IP,
+    ARDUINO_EVENT_MAX
+} arduino_event_id_t;
+
+typedef void (*WiFiEventCb)(arduino_event_id_t event);
+typedef size_t wifi_event_id_t;
+
+class WiFiClass {
+   public:
+    bool mode(wifi_mode_t mode) { _mode = mode; return true; }
+    wifi_mode_t getMode() const { return _mode; }
+    wl_status_t begin(const char* ssid, const char* passphrase = nullptr);
+    bool disconnect(bool wifiOff = false);
+    bool reconnect();
+    wl_status_t status();
+    bool isConnected() { return status() == WL_CONNECTED; }
+    bool setAutoReconnect(bool autoReconnect) { _autoReconnect = autoReconnect; return true; }
+    bool getAutoReconnect() const { return _autoReconnect; }
+    bool setHostname(const char* hostname) { (void)hostname; return true; }
+    IPAddress localIP();
+    int8_t RSSI() { return isConnected() ? -55 : 0; }
+
+    // event = ARDUINO_EVENT_MAX receives every event
+    wifi_event_id_t onEvent(WiFiEventCb callback, arduino_event_id_t event = ARDUINO_EVENT_MAX);
+    void removeEvent(wifi_event_id_t id);
+
+    // NativeHAL - hal::setNetworkEnabled() changed the host link
+    void networkChanged(bool enabled);
+
+   private:
+    static const size_t MAX_EVENT_HANDLERS = 4;
+    struct EventHandler {
+        WiFiEventCb callback;
+        arduino_event_id_t event;
+    };
+
+    void raiseEvent(arduino_event_id_t event);
+    void raiseLinkUp();
+    void raiseLinkDown();
+
+    EventHandler _handlers[MAX_EVENT_HANDLERS] = {};
+
+    wifi_mode_t _mode = WIFI_OFF;
+    bool _begun = false;
+    bool _autoReconnect = true;
+};
+
+extern WiFiClass WiFi;
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Stream.h"
+#include "IPAddress.h"
+
+//* ************************************************************************
+//* ************************ NATIVE WIFICLIENT ****************************
+//* ************************************************************************
+//! TCP client on a host socket, so network endpoints on a native build can
+//! be exercised with curl or a loopback client.
+
+class WiFiClient : public Stream {
+   public:
+    WiFiClient() {}
+    explicit WiFiClient(int fd) : _fd(fd) {}
+
+    int connect(const char* host, uint16_t port);
+    int connect(IPAddress ip, uint16_t port);
+    uint8_t connected();
+    operator bool() { return _fd >= 0; }
+    void stop();
+    void setNoDelay(bool noDelay);
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    int read(uint8_t* buffer, size_t size);
+
+    int fd() const { return _fd; }
+
+   private:
+    int fill();
+
+    int _fd = -1;
+    int _peeked = -1;
+};
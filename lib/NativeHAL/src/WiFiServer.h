@@ -0,0 +1,31 @@
+#pragma once
+
+#include "WiFiClient.h"
+
+//* ************************************************************************
+//* ************************ NATIVE WIFISERVER ****************************
+//* ************************************************************************
+//! Non-blocking TCP listener on a host socket. The port can be shifted with
+//! the HAL_PORT_OFFSET environment variable so an unprivileged user can run
+//! the native build (port 80 -> 8080 with HAL_PORT_OFFSET=8000).
+
+class WiFiServer {
+   public:
+    explicit WiFiServer(uint16_t port = 80, uint8_t maxClients = 4) : _port(port), _maxClients(maxClients) {}
+
+    void begin(uint16_t port = 0);
+    void end();
+    void close() { end(); }
+    bool hasClient();
+    WiFiClient available();
+    WiFiClient accept() { return available(); }
+    void setNoDelay(bool noDelay) { _noDelay = noDelay; }
+    operator bool() const { return _fd >= 0; }
+    uint16_t port() const { return _port; }
+
+   private:
+    uint16_t _port;
+    uint8_t _maxClients;
+    int _fd = -1;
+    bool _noDelay = false;
+};
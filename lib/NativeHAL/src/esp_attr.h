@@ -0,0 +1,15 @@
+#pragma once
+
+//* ************************************************************************
+//* ************************ NATIVE ESP_ATTR ******************************
+//* ************************************************************************
+//! Placement attributes are meaningless on the host; RTC_NOINIT data simply
+//! lives in ordinary zero-initialised memory, which behaves like a cold boot.
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+#define RTC_SLOW_ATTR
+#define RTC_FAST_ATTR
+#define __NOINIT_ATTR
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_system.h"
+
+//* ************************************************************************
+//* ************************ NATIVE ESP_TIMER *****************************
+//* ************************************************************************
+//! Timer callbacks run on the HAL clock, dispatched from the loop thread
+//! (Hal.h: interrupts and timers), whatever the dispatch method asked for
+
+typedef struct esp_timer* esp_timer_handle_t;
+typedef void (*esp_timer_cb_t)(void* arg);
+
+typedef enum {
+    ESP_TIMER_TASK,
+    ESP_TIMER_ISR,
+} esp_timer_dispatch_t;
+
+typedef struct {
+    esp_timer_cb_t callback;
+    void* arg;
+    esp_timer_dispatch_t dispatch_method;
+    const char* name;
+    bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+// Microseconds since boot, on the HAL clock
+int64_t esp_timer_get_time(void);
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* create_args, esp_timer_handle_t* out_handle);
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period);
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+//* ************************************************************************
+//* ************************ NATIVE FREERTOS TASKS ************************
+//* ************************************************************************
+//! Tasks run as detached host threads when hal::setTasksEnabled(true);
+//! otherwise creation succeeds but the task never runs (deterministic
+//! simulator runs). Core affinity and priority are accepted and ignored.
+
+typedef void (*TaskFunction_t)(void*);
+typedef void* TaskHandle_t;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char* name, uint32_t stackDepth,
+                                   void* parameter, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t coreId);
+BaseType_t xTaskCreate(TaskFunction_t task, const char* name, uint32_t stackDepth,
+                       void* parameter, UBaseType_t priority, TaskHandle_t* handle);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount();
+BaseType_t xPortGetCoreID();
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
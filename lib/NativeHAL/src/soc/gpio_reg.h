@@ -0,0 +1,19 @@
+#pragma once
+
+//* ************************************************************************
+//* ************************ NATIVE SOC/GPIO_REG **************************
+//* ************************************************************************
+//! The ESP32-S3 GPIO bank registers the firmware writes directly. Bank 0 is
+//! GPIO 0-31, bank 1 GPIO 32-48; W1TS sets and W1TC clears the bits written
+//! as 1 in one store. REG_WRITE (soc/soc.h) hands them to the HAL.
+
+#define DR_REG_GPIO_BASE 0x60004000
+
+#define GPIO_OUT_W1TS_REG (DR_REG_GPIO_BASE + 0x0008)
+#define GPIO_OUT_W1TC_REG (DR_REG_GPIO_BASE + 0x000C)
+#define GPIO_OUT1_W1TS_REG (DR_REG_GPIO_BASE + 0x0014)
+#define GPIO_OUT1_W1TC_REG (DR_REG_GPIO_BASE + 0x0018)
+#define GPIO_ENABLE_W1TS_REG (DR_REG_GPIO_BASE + 0x0024)
+#define GPIO_ENABLE_W1TC_REG (DR_REG_GPIO_BASE + 0x0028)
+#define GPIO_ENABLE1_W1TS_REG (DR_REG_GPIO_BASE + 0x0030)
+#define GPIO_ENABLE1_W1TC_REG (DR_REG_GPIO_BASE + 0x0034)
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <Hal.h>
+
+//* ************************************************************************
+//* ************************ NATIVE SOC/SOC *******************************
+//* ************************************************************************
+//! Peripheral register access. Only the GPIO bank is modelled
+//! (soc/gpio_reg.h); a write anywhere else is ignored.
+
+#define REG_WRITE(reg, val) hal::writeGpioRegister((uint32_t)(reg), (uint32_t)(val))
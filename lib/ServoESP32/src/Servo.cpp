@@ -33,4 +33,5 @@
 // Implementation is in Servo.h
 #include "Servo.h"
 
-int ServoBase::channel_next_free = 0;
\ No newline at end of file
+int ServoBase::channel_next_free = 0;
+bool ServoBase::fade_installed = false;
\ No newline at end of file
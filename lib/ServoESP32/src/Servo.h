@@ -35,12 +35,16 @@
 #pragma once
 
 #include "Arduino.h"
+#include "driver/ledc.h"
 
 class ServoBase {
    protected:
     // The main purpose of ServoBase is to make sure that multiple instances of
     // ServoTemplate class with different types share channel_next_free.
     static int channel_next_free;
+
+    // ledc_fade_func_install() is once per chip, shared by all instances
+    static bool fade_installed;
 };
 
 template <class T>
@@ -65,9 +69,10 @@ class ServoTemplate : public ServoBase {
 
     static const int DEFAULT_FREQUENCY = 50;
 
-    // Fixed from std::min to use a constant value
-    static const int TIMER_RESOLUTION = 16; // was: std::min(16, SOC_LEDC_TIMER_BIT_WIDE_NUM);
+    // std::min is not constexpr before C++14; the S3's LEDC timers are 14 bits wide
+    static const int TIMER_RESOLUTION = SOC_LEDC_TIMER_BIT_WIDE_NUM < 16 ? SOC_LEDC_TIMER_BIT_WIDE_NUM : 16;
     static const int PERIOD_TICKS = (1 << TIMER_RESOLUTION) - 1;
+    static_assert(TIMER_RESOLUTION <= 16, "Q16 duty scales need a timer of 16 bits or less");
 
     static const int CHANNEL_NOT_ATTACHED = -1;
 
@@ -120,24 +125,31 @@ class ServoTemplate : public ServoBase {
      *
      * @sideeffect May set pinMode(pin, PWM).
      *
-     * @return true if successful, false when pin doesn't support PWM.
+     * @return true if successful, false when pin doesn't support PWM or
+     *         the LEDC timer could not be set up.
      */
     bool attach(int pin, int channel = CHANNEL_NOT_ATTACHED, T minAngle = DEFAULT_MIN_ANGLE,
                 T maxAngle = DEFAULT_MAX_ANGLE, int minPulseWidthUs = DEFAULT_MIN_PULSE_WIDTH_US,
                 int maxPulseWidthUs = DEFAULT_MAX_PULSE_WIDTH_US, int frequency = DEFAULT_FREQUENCY) {
-        int tempPeriodUs = std::round(1000000.0 / frequency);
+        int tempPeriodUs = (1000000 + frequency / 2) / frequency;
         if (tempPeriodUs <= maxPulseWidthUs) {
             return false;
         }
-        if (channel == CHANNEL_NOT_ATTACHED) {
+        bool allocated = channel == CHANNEL_NOT_ATTACHED;
+        if (allocated) {
             if (channel_next_free == LEDC_CHANNELS) {
                 return false;
             }
-            _channel = channel_next_free;
+            channel = channel_next_free;
+        }
+        // ledcSetup() returns the frequency it set, 0 if the timer refused it
+        if (ledcSetup(channel, frequency, TIMER_RESOLUTION) == 0) {
+            return false;
+        }
+        if (allocated) {
             channel_next_free++;
-        } else {
-            _channel = channel;
         }
+        _channel = channel;
 
         _pin = pin;
         _minAngle = minAngle;
@@ -145,8 +157,8 @@ class ServoTemplate : public ServoBase {
         _minPulseWidthUs = minPulseWidthUs;
         _maxPulseWidthUs = maxPulseWidthUs;
         _periodUs = tempPeriodUs;
+        _setupConversions();
 
-        ledcSetup(_channel, frequency, TIMER_RESOLUTION);
         ledcAttachPin(_pin, _channel);
         return true;
     }
@@ -178,11 +190,17 @@ class ServoTemplate : public ServoBase {
      *              angle is outside the range specified at attach() time, it
      *              will be clamped to lie in that range.
      *
+     * Integer angles go straight to a duty through the fixed-point
+     * scale set up in attach(): a multiply and a shift, no floating point.
+     *
      * @see ServoTemplate::attach()
      */
     void write(T angle) {
+        if (!attached()) {
+            return;
+        }
         angle = constrain(angle, _minAngle, _maxAngle);
-        writeMicroseconds(_angleToUs(angle));
+        _writeTicks(_angleToTicks(angle));
     }
 
     /**
@@ -200,8 +218,66 @@ class ServoTemplate : public ServoBase {
             return;
         }
         pulseWidthUs = constrain(pulseWidthUs, _minPulseWidthUs, _maxPulseWidthUs);
-        _pulseWidthTicks = _usToTicks(pulseWidthUs);
-        ledcWrite(_channel, _pulseWidthTicks);
+        _writeTicks(_usToTicks(pulseWidthUs));
+    }
+
+    /**
+     * @brief Move to the target angle over a fixed time.
+     *
+     * The LEDC fade engine ramps the duty from the current pulse width to
+     * the target in hardware, so the move takes no CPU time after this call
+     * returns. readMicroseconds() and read() follow the ramp.
+     *
+     * A moveTo() or write() while a move is still running on this servo
+     * waits for that move to finish.
+     *
+     * @param angle Target angle, in degrees or radians.  Clamped like write().
+     * @param durationMs Time for the whole move, in milliseconds.  0 is the
+     *                   same as write().
+     *
+     * @return true if the move was started, false if the fade engine is not
+     *         available (the servo is then written directly).
+     *
+     * @see ServoTemplate::isMoving()
+     */
+    bool moveTo(T angle, uint32_t durationMs) {
+        if (!attached()) {
+            return false;
+        }
+        angle = constrain(angle, _minAngle, _maxAngle);
+        int targetTicks = _angleToTicks(angle);
+        if (durationMs == 0 || targetTicks == _pulseWidthTicks) {
+            _writeTicks(targetTicks);
+            return true;
+        }
+        if (!fade_installed) {
+            esp_err_t installed = ledc_fade_func_install(0);
+            fade_installed = installed == ESP_OK || installed == ESP_ERR_INVALID_STATE;   // Already installed elsewhere
+        }
+        if (!fade_installed ||
+            ledc_set_fade_with_time(_ledcMode(), _ledcChannel(), targetTicks, durationMs) != ESP_OK ||
+            ledc_fade_start(_ledcMode(), _ledcChannel(), LEDC_FADE_NO_WAIT) != ESP_OK) {
+            _writeTicks(targetTicks);
+            return false;
+        }
+        _pulseWidthTicks = targetTicks;
+        _moving = true;
+        return true;
+    }
+
+    /**
+     * @brief Check if a move started by moveTo() is still running.
+     *
+     * Reads the channel's duty from the LEDC hardware, so the answer is
+     * the pulse actually being sent, not an estimate from the clock.
+     *
+     * @return true until the duty has reached the moveTo() target.
+     */
+    bool isMoving() const {
+        if (!_moving || !attached()) {
+            return false;
+        }
+        return ledc_get_duty(_ledcMode(), _ledcChannel()) != (uint32_t)_pulseWidthTicks;
     }
 
     /**
@@ -210,7 +286,12 @@ class ServoTemplate : public ServoBase {
      *
      * @see ServoTemplate::attach()
      */
-    T read() const { return _usToAngle(readMicroseconds()); }
+    T read() const {
+        if (_ticksPerAngleQ16 != 0 && attached()) {
+            return _ticksToAngle(ledcRead(_channel));
+        }
+        return _usToAngle(readMicroseconds());
+    }
 
     /**
      * Get the current pulse width, in microseconds.  This will
@@ -251,8 +332,63 @@ class ServoTemplate : public ServoBase {
         _minPulseWidthUs = DEFAULT_MIN_PULSE_WIDTH_US;
         _maxPulseWidthUs = DEFAULT_MAX_PULSE_WIDTH_US;
         _periodUs = 1000000 / DEFAULT_FREQUENCY;
+        _moving = false;
+        _setupConversions();
     }
 
+    // Fixed-point scales for the write path, from the attach() parameters
+    // and TIMER_RESOLUTION. Q16 duty ticks per microsecond: the scale is
+    // PERIOD_TICKS * 2^16 / period, so us * scale stays below
+    // PERIOD_TICKS * 2^16 < 2^(TIMER_RESOLUTION + 16) <= 2^32 for any pulse
+    // shorter than the period. The per-angle scale is only used for integer
+    // angles over an increasing range; other types keep the generic
+    // conversion.
+    void _setupConversions() {
+        _ticksPerUsQ16 = (uint32_t)(((uint64_t)PERIOD_TICKS << 16) / (uint32_t)_periodUs);
+        _minTicks = _usToTicks(_minPulseWidthUs);
+        _ticksPerAngleQ16 = 0;
+        if (std::is_integral<T>::value && _maxAngle > _minAngle && _maxPulseWidthUs > _minPulseWidthUs) {
+            uint64_t spanTicks = (uint64_t)(_usToTicks(_maxPulseWidthUs) - _minTicks);
+            _ticksPerAngleQ16 = (uint32_t)((spanTicks << 16) / (uint64_t)(_maxAngle - _minAngle));
+        }
+    }
+
+    void _writeTicks(int ticks) {
+        _pulseWidthTicks = ticks;
+        if (fade_installed) {
+            // Keeps the fade driver's record in step with the duty; waits
+            // for a move still running on this channel
+            ledc_set_duty_and_update(_ledcMode(), _ledcChannel(), _pulseWidthTicks, 0);
+        } else {
+            ledcWrite(_channel, _pulseWidthTicks);
+        }
+        _moving = false;
+    }
+
+    // Duty for an angle already clamped to [_minAngle, _maxAngle]
+    int _angleToTicks(T angle) const {
+        if (_ticksPerAngleQ16 != 0) {
+            return _minTicks + (int)(((uint32_t)(angle - _minAngle) * _ticksPerAngleQ16 + 0x8000) >> 16);
+        }
+        return _usToTicks(_angleToUs(angle));
+    }
+
+    // Nearest angle for a duty; inverse of the fixed-point _angleToTicks(),
+    // so read() returns the written angle even when a tick is coarser than
+    // a microsecond (14 bit timers)
+    T _ticksToAngle(int ticks) const {
+        if (ticks <= _minTicks) {
+            return _minAngle;
+        }
+        T angle = _minAngle + (T)((((uint64_t)(ticks - _minTicks) << 16) + _ticksPerAngleQ16 / 2) / _ticksPerAngleQ16);
+        return angle > _maxAngle ? _maxAngle : angle;
+    }
+
+    // esp32-hal-ledc numbering: channels 0-7 are the first speed mode,
+    // 8-15 (where there is a high speed mode) the second
+    ledc_mode_t _ledcMode() const { return (ledc_mode_t)(_channel / 8); }
+    ledc_channel_t _ledcChannel() const { return (ledc_channel_t)(_channel % 8); }
+
     // Convert angle to pulse width in microseconds
     int _angleToUs(T angle) const {
         return map(angle, _minAngle, _maxAngle, _minPulseWidthUs, _maxPulseWidthUs);
@@ -263,14 +399,14 @@ class ServoTemplate : public ServoBase {
         return mapTemplate(us, _minPulseWidthUs, _maxPulseWidthUs, _minAngle, _maxAngle);
     }
 
-    // Convert microseconds to PWM duty cycle
+    // Convert microseconds (0 to the period) to PWM duty cycle, rounded
     inline int _usToTicks(int us) const {
-        return std::round((double)us * PERIOD_TICKS / _periodUs);
+        return (int)(((uint32_t)us * _ticksPerUsQ16 + 0x8000) >> 16);
     }
 
-    // Convert PWM duty cycle to microseconds
+    // Convert PWM duty cycle to microseconds, rounded
     inline int _ticksToUs(int duty) const {
-        return std::round((double)duty * _periodUs / PERIOD_TICKS);
+        return (int)(((uint64_t)duty * (uint32_t)_periodUs + PERIOD_TICKS / 2) / PERIOD_TICKS);
     }
 
     // Modified mapTemplate function to be C++11 compatible
@@ -290,6 +426,10 @@ class ServoTemplate : public ServoBase {
     int _minPulseWidthUs, _maxPulseWidthUs;
     int _periodUs;
     T _minAngle, _maxAngle;
+    bool _moving;   // A moveTo() fade was started; isMoving() asks the hardware
+    uint32_t _ticksPerUsQ16;
+    uint32_t _ticksPerAngleQ16;   // 0 = generic angle conversion
+    int _minTicks;
 };
 
 typedef ServoTemplate<int> Servo;
@@ -0,0 +1,288 @@
+#include "Benchmark.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Simulator.h"
+
+//* ************************************************************************
+//* ************************ THROUGHPUT BENCHMARK *************************
+//* ************************************************************************
+
+namespace {
+
+//* ************************************************************************
+//* ************************ SCENARIOS ************************************
+//* ************************************************************************
+
+void configureContinuous(SimulationOptions& options) {
+    // One full board, start switch left on: back-to-back YESWOOD cycles
+    options.boards = 1;
+}
+
+void configureAlternatingNowood(SimulationOptions& options) {
+    // Boards just under one piece long: every piece is followed by a NOWOOD
+    options.boards = 8;
+    options.machine.boardLengthInches = 3.0f;
+    options.reloadSeconds = 5.0;
+}
+
+void configureReloadInterrupt(SimulationOptions& options) {
+    // Operator stops for a RELOAD every 8 pieces
+    options.boards = 1;
+    options.reloadEveryPieces = 8;
+    options.reloadHoldSeconds = 10.0;
+}
+
+void configureErrorRecovery(SimulationOptions& options) {
+    // Cut motor home error at the start of the cycle after every 8 pieces, cleared by the operator
+    options.boards = 1;
+    options.errorEveryPieces = 8;
+}
+
+struct BenchmarkScenario {
+    const char* name;
+    void (*configure)(SimulationOptions& options);
+};
+
+const BenchmarkScenario BENCHMARK_SCENARIOS[] = {
+    {"continuous", configureContinuous},
+    {"alternating_nowood", configureAlternatingNowood},
+    {"reload_interrupt", configureReloadInterrupt},
+    {"error_recovery", configureErrorRecovery},
+};
+
+const int SCENARIO_COUNT = sizeof(BENCHMARK_SCENARIOS) / sizeof(BENCHMARK_SCENARIOS[0]);
+
+//* ************************************************************************
+//* ************************ METRICS **************************************
+//* ************************************************************************
+
+struct ScenarioResult {
+    bool completed;             // Child exited normally and the run did not stall
+    SimulationReport report;
+};
+
+double cyclesPerHour(const SimulationReport& report) { return piecesPerHour(report); }
+double cycleP50(const SimulationReport& report) { return report.cycleP50Ns / 1e9; }
+double cycleP95(const SimulationReport& report) { return report.cycleP95Ns / 1e9; }
+double cpuMsPerCycle(const SimulationReport& report) {
+    return report.pieces ? report.busyNs / 1e6 / report.pieces : 0.0;
+}
+double loopsPerCycle(const SimulationReport& report) {
+    return report.pieces ? (double)report.loopIterations / report.pieces : 0.0;
+}
+double recoverySeconds(const SimulationReport& report) { return meanRecoverySeconds(report); }
+double hostMsPerCycle(const SimulationReport& report) {
+    return report.pieces ? report.hostCpuSeconds * 1e3 / report.pieces : 0.0;
+}
+
+enum MetricDirection {
+    HIGHER_IS_BETTER,
+    LOWER_IS_BETTER,
+    NOT_COMPARED            // Host-dependent or informational
+};
+
+struct BenchmarkMetric {
+    const char* key;
+    const char* heading;
+    MetricDirection direction;
+    double (*value)(const SimulationReport& report);
+};
+
+const BenchmarkMetric BENCHMARK_METRICS[] = {
+    {"cycles_per_hour", "cycles/h", HIGHER_IS_BETTER, cyclesPerHour},
+    {"cycle_p50_s", "p50 s", LOWER_IS_BETTER, cycleP50},
+    {"cycle_p95_s", "p95 s", LOWER_IS_BETTER, cycleP95},
+    {"cpu_ms_per_cycle", "cpu ms/cyc", LOWER_IS_BETTER, cpuMsPerCycle},
+    {"loops_per_cycle", "loops/cyc", NOT_COMPARED, loopsPerCycle},
+    {"recovery_s", "recovery s", LOWER_IS_BETTER, recoverySeconds},
+    {"host_ms_per_cycle", "host ms/cyc", NOT_COMPARED, hostMsPerCycle},
+};
+
+const int METRIC_COUNT = sizeof(BENCHMARK_METRICS) / sizeof(BENCHMARK_METRICS[0]);
+
+//* ************************************************************************
+//* ************************ RUNNING **************************************
+//* ************************************************************************
+
+void setupScenario(int index, SimulationOptions& options, void* context) {
+    (void)context;
+    BENCHMARK_SCENARIOS[index].configure(options);
+}
+
+// Runs every scenario in its own child process, all in parallel
+void runScenarios(ScenarioResult results[]) {
+    SimulationReport reports[SCENARIO_COUNT];
+    bool completed[SCENARIO_COUNT];
+    runSimulationsForked(SCENARIO_COUNT, SCENARIO_COUNT, setupScenario, nullptr, reports, completed);
+    for (int i = 0; i < SCENARIO_COUNT; i++) {
+        results[i].completed = completed[i];
+        results[i].report = reports[i];
+    }
+}
+
+//* ************************************************************************
+//* ************************ BASELINE FILES *******************************
+//* ************************************************************************
+
+struct BaselineEntry {
+    char scenario[32];
+    char metric[32];
+    double value;
+};
+
+const int MAX_BASELINE_ENTRIES = 64;
+
+bool saveResults(const char* path, const ScenarioResult results[]) {
+    FILE* file = fopen(path, "w");
+    if (file == nullptr) {
+        return false;
+    }
+    fprintf(file, "# table-saw benchmark results: <scenario> <metric> <value>\n");
+    for (int i = 0; i < SCENARIO_COUNT; i++) {
+        if (!results[i].completed) {
+            continue;
+        }
+        for (int m = 0; m < METRIC_COUNT; m++) {
+            fprintf(file, "%s %s %.6f\n", BENCHMARK_SCENARIOS[i].name, BENCHMARK_METRICS[m].key,
+                    BENCHMARK_METRICS[m].value(results[i].report));
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+int loadBaseline(const char* path, BaselineEntry entries[]) {
+    FILE* file = fopen(path, "r");
+    if (file == nullptr) {
+        return -1;
+    }
+    int count = 0;
+    char line[128];
+    while (count < MAX_BASELINE_ENTRIES && fgets(line, sizeof(line), file)) {
+        if (line[0] == '#') {
+            continue;
+        }
+        BaselineEntry& entry = entries[count];
+        if (sscanf(line, "%31s %31s %lf", entry.scenario, entry.metric, &entry.value) == 3) {
+            count++;
+        }
+    }
+    fclose(file);
+    return count;
+}
+
+const BaselineEntry* findBaseline(const BaselineEntry entries[], int count, const char* scenario, const char* metric) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(entries[i].scenario, scenario) == 0 && strcmp(entries[i].metric, metric) == 0) {
+            return &entries[i];
+        }
+    }
+    return nullptr;
+}
+
+// Prints the comparison and returns the number of regressions
+int compareWithBaseline(const BenchmarkOptions& options, const ScenarioResult results[],
+                        const BaselineEntry entries[], int count) {
+    printf("\nAgainst baseline %s (tolerance %.1f%%):\n", options.baselinePath, options.tolerancePercent);
+    int regressions = 0;
+    for (int i = 0; i < SCENARIO_COUNT; i++) {
+        if (!results[i].completed) {
+            continue;
+        }
+        for (int m = 0; m < METRIC_COUNT; m++) {
+            const BenchmarkMetric& metric = BENCHMARK_METRICS[m];
+            if (metric.direction == NOT_COMPARED) {
+                continue;
+            }
+            const BaselineEntry* entry = findBaseline(entries, count, BENCHMARK_SCENARIOS[i].name, metric.key);
+            if (entry == nullptr) {
+                continue;
+            }
+            double value = metric.value(results[i].report);
+            double changePercent = entry->value != 0 ? 100.0 * (value - entry->value) / entry->value : 0.0;
+            double worsePercent = metric.direction == HIGHER_IS_BETTER ? -changePercent : changePercent;
+            const char* verdict = "same";
+            if (worsePercent > options.tolerancePercent) {
+                verdict = "REGRESSION";
+                regressions++;
+            } else if (worsePercent < -options.tolerancePercent) {
+                verdict = "better";
+            }
+            printf("  %-20s %-18s %12.3f -> %12.3f  %+7.2f%%  %s\n", BENCHMARK_SCENARIOS[i].name, metric.key,
+                   entry->value, value, changePercent, verdict);
+        }
+    }
+    return regressions;
+}
+
+//* ************************************************************************
+//* ************************ REPORT ***************************************
+//* ************************************************************************
+
+void printResults(const ScenarioResult results[]) {
+    printf("%-20s", "scenario");
+    for (int m = 0; m < METRIC_COUNT; m++) {
+        printf(" %12s", BENCHMARK_METRICS[m].heading);
+    }
+    printf("\n");
+    for (int i = 0; i < SCENARIO_COUNT; i++) {
+        printf("%-20s", BENCHMARK_SCENARIOS[i].name);
+        if (!results[i].completed) {
+            printf(" FAILED%s\n", results[i].report.stalled ? " (stalled)" : "");
+            continue;
+        }
+        for (int m = 0; m < METRIC_COUNT; m++) {
+            printf(" %12.3f", BENCHMARK_METRICS[m].value(results[i].report));
+        }
+        printf("\n");
+    }
+}
+
+} // namespace
+
+//* ************************************************************************
+//* ************************ ENTRY POINT **********************************
+//* ************************************************************************
+
+int runBenchmarks(const BenchmarkOptions& options) {
+    //! Step 1: Run every scenario
+    ScenarioResult results[SCENARIO_COUNT];
+    runScenarios(results);
+
+    //! Step 2: Report
+    printConfiguration(stdout);
+    printf("\n");
+    printResults(results);
+    int exitCode = 0;
+    for (int i = 0; i < SCENARIO_COUNT; i++) {
+        if (!results[i].completed) {
+            exitCode = 1;
+        }
+    }
+
+    //! Step 3: Compare against the previous build
+    if (options.baselinePath != nullptr) {
+        BaselineEntry entries[MAX_BASELINE_ENTRIES];
+        int count = loadBaseline(options.baselinePath, entries);
+        if (count < 0) {
+            fprintf(stderr, "Cannot read baseline %s\n", options.baselinePath);
+            exitCode = 1;
+        } else {
+            int regressions = compareWithBaseline(options, results, entries, count);
+            printf("Result: %s\n", regressions ? "REGRESSION" : "OK");
+            if (regressions) {
+                exitCode = 1;
+            }
+        }
+    }
+
+    //! Step 4: Save for the next comparison
+    if (options.savePath != nullptr) {
+        if (!saveResults(options.savePath, results)) {
+            fprintf(stderr, "Cannot write %s\n", options.savePath);
+            exitCode = 1;
+        }
+    }
+    return exitCode;
+}
@@ -0,0 +1,27 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <stdint.h>
+
+//* ************************************************************************
+//* ************************ THROUGHPUT BENCHMARK HEADER ******************
+//* ************************************************************************
+//! Fixed production scenarios run through the simulator, one forked child
+//! per scenario, with a stable plain-text report. The report can be saved
+//! and later used as the baseline for the next firmware build: any metric
+//! that gets worse by more than the tolerance fails the run.
+//!
+//! The simulator is deterministic, so unchanged firmware and Config.cpp
+//! always reproduce the baseline exactly (host CPU time aside, which is
+//! reported but never compared).
+
+struct BenchmarkOptions {
+    const char* savePath;       // Write the results here (nullptr = don't)
+    const char* baselinePath;   // Compare against these results (nullptr = don't)
+    double tolerancePercent;    // Allowed regression per metric
+};
+
+// Returns the process exit code: 0 = ok, 1 = regression or failed scenario
+int runBenchmarks(const BenchmarkOptions& options);
+
+#endif // BENCHMARK_H
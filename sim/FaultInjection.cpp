@@ -0,0 +1,177 @@
+#include "FaultInjection.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+//* ************************************************************************
+//* ************************ FAULT INJECTION ******************************
+//* ************************************************************************
+
+namespace {
+
+// Default phases: power-on, mid cut stroke, and the feed/return of YESWOOD
+const FaultPhase DEFAULT_PHASES[] = {
+    {STARTUP, 0.0},
+    {CUTTING, 0.5},
+    {YESWOOD, 0.2},
+};
+
+const int DEFAULT_PHASE_COUNT = sizeof(DEFAULT_PHASES) / sizeof(DEFAULT_PHASES[0]);
+
+struct FaultRun {
+    MachineFault fault;
+    FaultPhase phase;
+};
+
+struct FaultContext {
+    const FaultHarnessOptions* options;
+    const FaultRun* runs;
+};
+
+void setupFaultRun(int index, SimulationOptions& options, void* context) {
+    const FaultContext& harness = *(const FaultContext*)context;
+    const FaultRun& run = harness.runs[index];
+    // Short boards keep runs quick; enough of them that a stuck sensor cannot run out of wood first
+    options.boards = 4;
+    options.machine.boardLengthInches = 24.0f;
+    options.maxSeconds = 300.0;
+    options.fault.fault = run.fault;
+    options.fault.phase = run.phase.state;
+    options.fault.phaseDelaySeconds = run.phase.delaySeconds;
+    options.fault.afterPieces = run.phase.state == STARTUP ? 0 : harness.options->afterPieces;
+    options.fault.repairSeconds = harness.options->repairSeconds;
+}
+
+void formatPhase(const FaultPhase& phase, char* text, size_t size) {
+    if (phase.state == STARTUP) {
+        snprintf(text, size, "power-on");
+    } else {
+        snprintf(text, size, "%s+%.2fs", getStateName(phase.state), phase.delaySeconds);
+    }
+}
+
+void printRun(const FaultRun& run, const SimulationReport& report, bool completed) {
+    char phase[40];
+    formatPhase(run.phase, phase, sizeof(phase));
+    printf("%-26s %-16s", machineFaultName(run.fault), phase);
+    const FaultOutcome& fault = report.fault;
+    if (!completed && !report.stalled) {
+        printf(" FAILED\n");
+        return;
+    }
+    if (!fault.injected) {
+        printf(" not reached\n");
+        return;
+    }
+    printf(" %-12s %-5s %-11s", getStateName(fault.injectedIn), fault.errorCounted ? "yes" : "no",
+           safeStateName(fault.safeState));
+    if (fault.safeState != SAFE_NEVER) {
+        printf(" %8.2f", fault.safeSeconds);
+    } else {
+        printf(" %8s", "-");
+    }
+    printf(" %7u %7u", fault.piecesWhileFaulty, fault.piecesDropped);
+    if (fault.recovered) {
+        printf(" %10.2f %10.2f", fault.recoverySeconds, fault.downtimeSeconds);
+    } else {
+        printf(" %10s %10s", "-", "-");
+    }
+    if (report.stalled) {
+        printf("  stalled in %s", getStateName(report.finalState));
+    } else if (!fault.recovered) {
+        printf("  ended in %s", getStateName(report.finalState));
+    }
+    printf("\n");
+}
+
+} // namespace
+
+//* ************************************************************************
+//* ************************ OPTIONS **************************************
+//* ************************************************************************
+
+FaultHarnessOptions defaultFaultHarnessOptions() {
+    FaultHarnessOptions options;
+    options.only = FAULT_NONE;
+    options.phaseCount = 0;
+    options.afterPieces = 2;
+    options.repairSeconds = 20.0;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    options.jobs = cpus > 0 ? (int)cpus : 1;
+    return options;
+}
+
+bool parseFaultPhase(const char* text, FaultPhase& phase) {
+    char name[32];
+    const char* plus = strchr(text, '+');
+    size_t length = plus ? (size_t)(plus - text) : strlen(text);
+    if (length == 0 || length >= sizeof(name)) {
+        return false;
+    }
+    memcpy(name, text, length);
+    name[length] = '\0';
+    phase.delaySeconds = plus ? atof(plus + 1) : 0.0;
+    for (int i = 0; i < SIM_STATE_COUNT; i++) {
+        if (strcmp(name, getStateName((SystemState)i)) == 0) {
+            phase.state = (SystemState)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseMachineFault(const char* text, MachineFault& fault) {
+    for (int i = FAULT_NONE + 1; i < MACHINE_FAULT_COUNT; i++) {
+        if (strcmp(text, machineFaultName((MachineFault)i)) == 0) {
+            fault = (MachineFault)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+//* ************************************************************************
+//* ************************ ENTRY POINT **********************************
+//* ************************************************************************
+
+int runFaultInjection(const FaultHarnessOptions& options) {
+    //! Step 1: Build the fault x phase matrix
+    const FaultPhase* phases = options.phaseCount ? options.phases : DEFAULT_PHASES;
+    int phaseCount = options.phaseCount ? options.phaseCount : DEFAULT_PHASE_COUNT;
+    std::vector<FaultRun> runs;
+    for (int f = FAULT_NONE + 1; f < MACHINE_FAULT_COUNT; f++) {
+        if (options.only != FAULT_NONE && options.only != f) {
+            continue;
+        }
+        for (int p = 0; p < phaseCount; p++) {
+            runs.push_back({(MachineFault)f, phases[p]});
+        }
+    }
+
+    //! Step 2: Run every cell in its own child
+    printf("Fault injection: %zu runs, fault after %d pieces, repaired after %.1f s, %d jobs\n",
+           runs.size(), options.afterPieces, options.repairSeconds, options.jobs);
+    std::vector<SimulationReport> reports(runs.size());
+    bool* completed = new bool[runs.size()];
+    FaultContext context = {&options, runs.data()};
+    runSimulationsForked((int)runs.size(), options.jobs, setupFaultRun, &context, reports.data(), completed);
+
+    //! Step 3: Report
+    printf("\n");
+    printConfiguration(stdout);
+    printf("\nsafe = ERROR state, or both carriages stopped for 1 s; times from injection (safe, downtime)\n");
+    printf("or from the repair (recovery) to the next piece; faulty = pieces counted while faulty\n\n");
+    printf("%-26s %-16s %-12s %-5s %-11s %8s %7s %7s %10s %10s\n", "fault", "phase", "injected in",
+           "error", "safe", "safe s", "faulty", "dropped", "recovery s", "downtime s");
+    int exitCode = 0;
+    for (size_t i = 0; i < runs.size(); i++) {
+        printRun(runs[i], reports[i], completed[i]);
+        if (!completed[i] && !reports[i].stalled) {
+            exitCode = 1;
+        }
+    }
+    delete[] completed;
+    return exitCode;
+}
@@ -0,0 +1,46 @@
+#ifndef FAULT_INJECTION_H
+#define FAULT_INJECTION_H
+
+#include <stdint.h>
+#include "Simulator.h"
+
+//* ************************************************************************
+//* ************************ FAULT INJECTION HEADER ***********************
+//* ************************************************************************
+//! Runs a matrix of hardware faults x cycle phases through the simulator,
+//! one forked child per cell, and reports for each how the firmware
+//! reacted: whether it counted an error, how long it took to reach a safe
+//! state (ERROR, or both carriages stopped), and how long production was
+//! lost once the fault was repaired.
+//!
+//! Homing switch faults are also injected at power-on, since homing is the
+//! only time the firmware moves to the switches on purpose.
+
+const int MAX_FAULT_PHASES = 8;
+
+struct FaultPhase {
+    SystemState state;          // STARTUP = at power-on
+    double delaySeconds;        // After entering the state
+};
+
+struct FaultHarnessOptions {
+    MachineFault only;          // FAULT_NONE = every fault
+    FaultPhase phases[MAX_FAULT_PHASES];
+    int phaseCount;             // 0 = the default phases
+    int afterPieces;            // Pieces produced before the fault
+    double repairSeconds;       // Fault active this long
+    int jobs;                   // Runs in parallel
+};
+
+FaultHarnessOptions defaultFaultHarnessOptions();
+
+// Parses "STATE" or "STATE+SECONDS" (e.g. "CUTTING+0.5"); false if unknown
+bool parseFaultPhase(const char* text, FaultPhase& phase);
+
+// Parses a fault name as printed by machineFaultName(); false if unknown
+bool parseMachineFault(const char* text, MachineFault& fault);
+
+// Returns the process exit code: 0 = every run finished, 1 = a run failed to start
+int runFaultInjection(const FaultHarnessOptions& options);
+
+#endif // FAULT_INJECTION_H
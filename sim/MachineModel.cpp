@@ -0,0 +1,334 @@
+#include "MachineModel.h"
+#include "SensorReplay.h"
+#include <Arduino.h>
+#include "Config/Config.h"
+#include "Config/Pins_Definitions.h"
+
+//* ************************************************************************
+//* ************************ MACHINE MODEL ********************************
+//* ************************************************************************
+//! Carriage kinematics come from the firmware's own step pulses, so the
+//! configured speeds, accelerations and loop rate all show up unchanged.
+
+MachineParameters defaultMachineParameters() {
+    updateDerivedConfig();   // Called before setup(), which works out the plan
+    MachineParameters parameters;
+    parameters.cutStartSteps = CUT_MOTOR_STEPS_PER_INCH / 2;
+    parameters.positionStartSteps = POSITION_MOTOR_TRAVEL_POSITION / 2;
+    parameters.positionSwitchSteps = POSITION_MOTOR_HOME_SWITCH_POSITION;
+    parameters.clampExtendMs = 80;
+    parameters.clampRetractMs = 60;
+    parameters.settleChatterMs = 3;
+    parameters.bladeContactInches = 0.5f;
+    parameters.boardLengthInches = 96.0f;
+    parameters.sensorSetbackInches = 0.0f;
+    return parameters;
+}
+
+const char* machineFaultName(MachineFault fault) {
+    static const char* const FAULT_NAMES[] = {
+        "none", "wood-sensor-stuck-high", "wood-sensor-stuck-low", "suction-sensor-stuck-low",
+        "cut-home-switch-dead", "position-home-switch-dead", "wood-not-caught", "emergency-stop"
+    };
+    if (fault < FAULT_NONE || fault >= MACHINE_FAULT_COUNT) {
+        return "unknown";
+    }
+    return FAULT_NAMES[fault];
+}
+
+MachineModel::MachineModel(const MachineParameters& parameters)
+    : _parameters(parameters),
+      _observations(),
+      _cutSteps(parameters.cutStartSteps),
+      _positionSteps(parameters.positionStartSteps),
+      _cutStrokeChecked(false),
+      _nowNs(0),
+      _measuring(false),
+      _cutStrokeActive(false),
+      _lastCutForwardNs(0),
+      _catcherCommanded(false),
+      _catcherCommandNs(0),
+      _lastPositionStepNs(0),
+      _lastCutStepNs(0),
+      _fault(FAULT_NONE),
+      _replay(nullptr),
+      _startSwitchOn(false),
+      _reloadSwitchOn(false),
+      _boardLoaded(false),
+      _boardFedInches(0.0f),
+      _servoAngle(CATCHER_SERVO_HOME_POSITION) {
+    // Outputs power up LOW, which is "extended" for every clamp
+    _positionClamp = {true, 0};
+    _woodSecureClamp = {true, 0};
+    _catcherClamp = {true, 0};
+    _observations.minClampMarginMs = MARGIN_NOT_SEEN;
+    _observations.minCatcherMarginMs = MARGIN_NOT_SEEN;
+}
+
+void MachineModel::startProduction() {
+    _measuring = true;
+    _observations.minClampMarginMs = MARGIN_NOT_SEEN;
+    _observations.minCatcherMarginMs = MARGIN_NOT_SEEN;
+    _observations.clampViolations = 0;
+    _observations.catcherViolations = 0;
+}
+
+//* ************************************************************************
+//* ************************ OPERATOR *************************************
+//* ************************************************************************
+
+void MachineModel::loadBoard() {
+    _boardLoaded = true;
+    _boardFedInches = 0.0f;
+    _observations.boardsLoaded++;
+}
+
+uint64_t MachineModel::lastStepNs() const {
+    return _lastCutStepNs > _lastPositionStepNs ? _lastCutStepNs : _lastPositionStepNs;
+}
+
+bool MachineModel::boardPresentAtSensor() const {
+    return _boardLoaded &&
+           _boardFedInches < _parameters.boardLengthInches - _parameters.sensorSetbackInches;
+}
+
+//* ************************************************************************
+//* ************************ ACTUATORS ************************************
+//* ************************************************************************
+
+void MachineModel::commandCylinder(Cylinder& cylinder, bool extend) {
+    if (cylinder.commandedExtended == extend) {
+        return;
+    }
+    cylinder.commandedExtended = extend;
+    unsigned long latencyMs = extend ? _parameters.clampExtendMs : _parameters.clampRetractMs;
+    cylinder.settledAtNs = _nowNs + (uint64_t)latencyMs * 1000000ULL;
+    _observations.clampActuations++;
+}
+
+// The board shakes for settleChatterMs once the cylinder reaches the end of
+// its stroke; true while the sensor reads inverted (every other 0.5 ms)
+bool MachineModel::settleChatter(const Cylinder& cylinder) const {
+    if (cylinder.settledAtNs == 0 || _nowNs < cylinder.settledAtNs) {
+        return false;
+    }
+    uint64_t sinceNs = _nowNs - cylinder.settledAtNs;
+    if (sinceNs >= (uint64_t)_parameters.settleChatterMs * 1000000ULL) {
+        return false;
+    }
+    return (sinceNs / 500000ULL) % 2 == 0;
+}
+
+//* ************************************************************************
+//* ************************ SAFETY MARGINS *******************************
+//* ************************************************************************
+//! A carriage may only start moving once the clamps holding the wood have
+//! settled. The catcher clamp must be engaged before the cut stroke ends;
+//! that margin is taken from the stroke's own extend command, as if the
+//! catcher had been released after the previous piece.
+
+float MachineModel::holdingMarginMs(bool requireExtended) const {
+    if (requireExtended && (!_positionClamp.commandedExtended || !_woodSecureClamp.commandedExtended)) {
+        return -(float)_parameters.clampExtendMs;
+    }
+    uint64_t settledAtNs = _positionClamp.settledAtNs > _woodSecureClamp.settledAtNs
+                               ? _positionClamp.settledAtNs : _woodSecureClamp.settledAtNs;
+    return (float)((int64_t)(_nowNs - settledAtNs)) / 1e6f;
+}
+
+void MachineModel::recordClampMargin(float marginMs) {
+    if (!_measuring) {
+        return;
+    }
+    if (marginMs < _observations.minClampMarginMs) {
+        _observations.minClampMarginMs = marginMs;
+    }
+    if (marginMs < 0) {
+        _observations.clampViolations++;
+    }
+}
+
+void MachineModel::noteCatcherCommand(int level) {
+    if (level == LOW && _cutStrokeActive && !_catcherCommanded) {
+        _catcherCommanded = true;
+        _catcherCommandNs = _nowNs;
+    }
+}
+
+void MachineModel::endCutStroke() {
+    _cutStrokeActive = false;
+    if (!_measuring) {
+        return;
+    }
+
+    //! A piece was cut off if the board reached past the blade
+    if (boardPresentAtSensor()) {
+        if (_fault != FAULT_WOOD_NOT_CAUGHT && _catcherClamp.settledExtended(_lastCutForwardNs)) {
+            _observations.piecesCaught++;
+        } else {
+            _observations.piecesDropped++;
+        }
+    }
+    float marginMs;
+    if (_catcherCommanded) {
+        uint64_t engagedNs = _catcherCommandNs + (uint64_t)_parameters.clampExtendMs * 1000000ULL;
+        marginMs = (float)((int64_t)(_lastCutForwardNs - engagedNs)) / 1e6f;
+    } else {
+        marginMs = -(float)_parameters.clampExtendMs;    // Never commanded during the stroke
+    }
+    if (marginMs < _observations.minCatcherMarginMs) {
+        _observations.minCatcherMarginMs = marginMs;
+    }
+    if (marginMs < 0) {
+        _observations.catcherViolations++;
+    }
+}
+
+//* ************************************************************************
+//* ************************ CARRIAGES ************************************
+//* ************************************************************************
+
+void MachineModel::stepCutCarriage(int direction) {
+    _cutSteps += direction;
+    _observations.cutSteps++;
+    _lastCutStepNs = _nowNs;
+
+    if (direction > 0) {
+        if (!_cutStrokeActive) {
+            _cutStrokeActive = true;
+            _catcherCommanded = false;
+            recordClampMargin(holdingMarginMs(true));
+        }
+        _lastCutForwardNs = _nowNs;
+    } else if (_cutStrokeActive) {
+        endCutStroke();
+    }
+
+    //! The blade meets the wood bladeContactInches into the stroke; both
+    //! holding clamps must be fully closed by then
+    long contactSteps = (long)(_parameters.bladeContactInches * CUT_MOTOR_STEPS_PER_INCH);
+    if (direction > 0 && !_cutStrokeChecked && _cutSteps >= contactSteps) {
+        _cutStrokeChecked = true;
+        if (!_positionClamp.settledExtended(_nowNs) || !_woodSecureClamp.settledExtended(_nowNs)) {
+            _observations.cutsBeforeClamped++;
+        }
+    }
+    if (_cutSteps <= 0) {
+        _cutStrokeChecked = false;
+    }
+}
+
+void MachineModel::stepPositionCarriage(int direction) {
+    _positionSteps += direction;
+    _observations.positionSteps++;
+
+    // A new move: the clamps handing the wood over must have settled
+    const uint64_t MOVE_GAP_NS = 50000000ULL;      // Longer than the slowest first step of a ramp
+    if (_lastPositionStepNs == 0 || _nowNs - _lastPositionStepNs > MOVE_GAP_NS) {
+        recordClampMargin(holdingMarginMs(false));
+    }
+    _lastPositionStepNs = _nowNs;
+
+    //! The board travels with the carriage only while the position clamp grips it
+    float inches = 1.0f / POSITION_MOTOR_STEPS_PER_INCH;
+    if (_positionClamp.inTransit(_nowNs)) {
+        _observations.feedSlipInches += inches;
+    } else if (_positionClamp.commandedExtended) {
+        _boardFedInches += direction * inches;
+        _observations.woodFedInches += direction * inches;
+    }
+}
+
+//* ************************************************************************
+//* ************************ HAL HOOKS ************************************
+//* ************************************************************************
+
+void MachineModel::onPinWrite(int pin, int level) {
+    if (pin == CUT_MOTOR_PULSE_PIN && level == HIGH) {
+        stepCutCarriage(hal::outputLevel(CUT_MOTOR_DIR_PIN) == HIGH ? 1 : -1);
+    } else if (pin == POSITION_MOTOR_PULSE_PIN && level == HIGH) {
+        stepPositionCarriage(hal::outputLevel(POSITION_MOTOR_DIR_PIN) == HIGH ? 1 : -1);
+    } else if (pin == POSITION_CLAMP) {
+        commandCylinder(_positionClamp, level == LOW);
+    } else if (pin == WOOD_SECURE_CLAMP) {
+        commandCylinder(_woodSecureClamp, level == LOW);
+    } else if (pin == CATCHER_CLAMP_PIN) {
+        commandCylinder(_catcherClamp, level == LOW);
+        noteCatcherCommand(level);
+    }
+}
+
+void MachineModel::onPinRefresh(int pin, int level) {
+    if (pin == CATCHER_CLAMP_PIN) {
+        noteCatcherCommand(level);
+    }
+}
+
+void MachineModel::onServoWrite(int pin, int angle) {
+    if (pin == CATCHER_SERVO_PIN && angle != _servoAngle) {
+        _servoAngle = angle;
+        _observations.servoMoves++;
+    }
+}
+
+int MachineModel::onPinRead(int pin, int level) {
+    switch (_fault) {
+        case FAULT_WOOD_SENSOR_STUCK_HIGH:
+            if (pin == WOOD_SENSOR) return HIGH;
+            break;
+        case FAULT_WOOD_SENSOR_STUCK_LOW:
+            if (pin == WOOD_SENSOR) return LOW;
+            break;
+        case FAULT_SUCTION_SENSOR_STUCK_LOW:
+            if (pin == WAS_WOOD_SUCTIONED_SENSOR) return LOW;
+            break;
+        case FAULT_CUT_HOME_SWITCH_DEAD:
+            if (pin == CUT_MOTOR_HOMING_SWITCH) return LOW;
+            break;
+        case FAULT_POSITION_HOME_SWITCH_DEAD:
+            if (pin == POSITION_MOTOR_HOMING_SWITCH) return LOW;
+            break;
+        case FAULT_EMERGENCY_STOP:
+            if (pin == EMERGENCY_STOP_SWITCH) return HIGH;
+            break;
+        default:
+            break;
+    }
+    int replayed;
+    if (_replay != nullptr && _replay->level(pin, _nowNs, replayed)) {
+        return replayed;
+    }
+    if (pin == CUT_MOTOR_HOMING_SWITCH) {
+        return _cutSteps <= 0 ? HIGH : LOW;
+    }
+    if (pin == POSITION_MOTOR_HOMING_SWITCH) {
+        return _positionSteps >= _parameters.positionSwitchSteps ? HIGH : LOW;
+    }
+    if (pin == START_CYCLE_SWITCH) {
+        return _startSwitchOn ? HIGH : LOW;
+    }
+    if (pin == RELOAD_SWITCH) {
+        return _reloadSwitchOn ? HIGH : LOW;
+    }
+    if (pin == EMERGENCY_STOP_SWITCH) {
+        return LOW;                                     // Normally closed loop
+    }
+    if (pin == WOOD_SENSOR) {
+        bool present = boardPresentAtSensor();
+        if (present && (settleChatter(_positionClamp) || settleChatter(_woodSecureClamp))) {
+            present = false;
+        }
+        return present ? LOW : HIGH;                    // Active LOW
+    }
+    if (pin == WAS_WOOD_SUCTIONED_SENSOR) {
+        if (_boardLoaded && settleChatter(_catcherClamp)) {
+            return LOW;                                 // Catcher clamp shaking the board
+        }
+        return HIGH;                                    // Never suctioned in the base model
+    }
+    return level;
+}
+
+void MachineModel::onAdvance(uint64_t nowNs) {
+    _nowNs = nowNs;
+}
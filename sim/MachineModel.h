@@ -0,0 +1,152 @@
+#ifndef MACHINE_MODEL_H
+#define MACHINE_MODEL_H
+
+#include <Hal.h>
+#include <stdint.h>
+
+//* ************************************************************************
+//* ************************ MACHINE MODEL HEADER *************************
+//* ************************************************************************
+//! Modelled hardware for the simulator
+//! Plugs into the native HAL and plays the saw: step pulses move the two
+//! carriages, clamp outputs drive pneumatic cylinders with a latency, the
+//! homing switches close at the ends of travel, the wood sensor follows
+//! how far the current board has been fed and the emergency stop loop is
+//! closed. A clamp reaching the end of its
+//! stroke shakes the board, so the wood and suction sensors chatter for a
+//! few milliseconds (inside their debounce) when it does.
+
+// Physical parameters of the modelled machine
+struct MachineParameters {
+    long cutStartSteps;               // Cut carriage offset from its home switch at power-on
+    long positionStartSteps;          // Position carriage at power-on (switch side is positive)
+    long positionSwitchSteps;         // Position carriage coordinate where its home switch closes
+    unsigned long clampExtendMs;      // Valve + cylinder time to reach full clamping force
+    unsigned long clampRetractMs;     // Time until the cylinder releases the wood
+    unsigned long settleChatterMs;    // Board sensor chatter when a clamp seats or lets go
+    float bladeContactInches;         // Cut carriage travel before the blade reaches the wood
+    float boardLengthInches;          // Length of each board loaded by the operator
+    float sensorSetbackInches;        // Board still present but already past the wood sensor
+};
+
+MachineParameters defaultMachineParameters();
+
+// Injected hardware faults
+enum MachineFault {
+    FAULT_NONE,
+    FAULT_WOOD_SENSOR_STUCK_HIGH,       // Reads "no wood" with a board there
+    FAULT_WOOD_SENSOR_STUCK_LOW,        // Reads "wood" with none there
+    FAULT_SUCTION_SENSOR_STUCK_LOW,     // Reports a suctioned piece all the time
+    FAULT_CUT_HOME_SWITCH_DEAD,         // Cut homing switch never trips
+    FAULT_POSITION_HOME_SWITCH_DEAD,    // Position homing switch never trips
+    FAULT_WOOD_NOT_CAUGHT,              // Catcher misses the cut piece (no sensor sees it - counted as dropped)
+    FAULT_EMERGENCY_STOP,               // Operator holds the emergency stop
+    MACHINE_FAULT_COUNT
+};
+
+const char* machineFaultName(MachineFault fault);
+
+// Things the model observed that the firmware cannot see
+struct MachineObservations {
+    uint64_t cutSteps;                // Step pulses seen on each motor
+    uint64_t positionSteps;
+    uint32_t cutsBeforeClamped;       // Blade reached wood before both clamps were fully closed
+    float feedSlipInches;             // Carriage travel with the position clamp still in transit
+    float woodFedInches;              // Total wood fed across all boards
+    uint32_t clampActuations;
+    uint32_t servoMoves;
+    uint32_t boardsLoaded;
+
+    // Safety margins, measured from MachineModel::startProduction()
+    float minClampMarginMs;           // Least settle time of the holding clamps when a carriage starts moving
+    float minCatcherMarginMs;         // Least time the catcher clamp was engaged before a cut stroke ended
+    uint32_t clampViolations;         // Carriage starts with a holding clamp open or in transit
+    uint32_t catcherViolations;       // Cut strokes that ended before the catcher clamp engaged
+    uint32_t piecesCaught;            // Cut pieces held by the catcher at the end of the stroke
+    uint32_t piecesDropped;
+};
+
+// Margin value until the first sample is taken
+const float MARGIN_NOT_SEEN = 1e9f;
+
+class SensorReplay;
+
+class MachineModel : public hal::Model {
+   public:
+    explicit MachineModel(const MachineParameters& parameters);
+
+    // Operator controls
+    void setStartSwitch(bool on) { _startSwitchOn = on; }
+    void setReloadSwitch(bool on) { _reloadSwitchOn = on; }
+    void loadBoard();
+    bool boardPresentAtSensor() const;
+
+    // Fault injection
+    void setFault(MachineFault fault) { _fault = fault; }
+    MachineFault fault() const { return _fault; }
+    uint64_t lastStepNs() const;      // Last step pulse on either carriage
+
+    // Recorded floor trace drives the inputs it covers (nullptr = model only)
+    void setReplay(SensorReplay* replay) { _replay = replay; }
+
+    // Start measuring safety margins (ignores power-on and homing)
+    void startProduction();
+
+    const MachineObservations& observations() const { return _observations; }
+    const MachineParameters& parameters() const { return _parameters; }
+
+    // hal::Model
+    void onPinWrite(int pin, int level) override;
+    void onPinRefresh(int pin, int level) override;
+    void onServoWrite(int pin, int angle) override;
+    int onPinRead(int pin, int level) override;
+    void onAdvance(uint64_t nowNs) override;
+
+   private:
+    // A pneumatic cylinder: commanded immediately, settled after a latency
+    struct Cylinder {
+        bool commandedExtended;
+        uint64_t settledAtNs;
+        bool settledExtended(uint64_t nowNs) const { return commandedExtended && nowNs >= settledAtNs; }
+        bool inTransit(uint64_t nowNs) const { return nowNs < settledAtNs; }
+    };
+
+    void commandCylinder(Cylinder& cylinder, bool extend);
+    void stepCutCarriage(int direction);
+    void stepPositionCarriage(int direction);
+    void noteCatcherCommand(int level);
+    bool settleChatter(const Cylinder& cylinder) const;
+    float holdingMarginMs(bool requireExtended) const;
+    void recordClampMargin(float marginMs);
+    void endCutStroke();
+
+    MachineParameters _parameters;
+    MachineObservations _observations;
+
+    long _cutSteps;             // Physical carriage positions in steps
+    long _positionSteps;
+    bool _cutStrokeChecked;     // Blade-contact check done for the current stroke
+    uint64_t _nowNs;
+
+    bool _measuring;            // Production started - margins are being recorded
+    bool _cutStrokeActive;      // Cut carriage moving forward
+    uint64_t _lastCutForwardNs;
+    bool _catcherCommanded;     // Catcher extend commanded during this stroke
+    uint64_t _catcherCommandNs;
+    uint64_t _lastPositionStepNs;
+    uint64_t _lastCutStepNs;
+    MachineFault _fault;
+    SensorReplay* _replay;
+
+    Cylinder _positionClamp;
+    Cylinder _woodSecureClamp;
+    Cylinder _catcherClamp;
+
+    bool _startSwitchOn;
+    bool _reloadSwitchOn;
+    bool _boardLoaded;
+    float _boardFedInches;
+    int _servoAngle;
+};
+
+#endif // MACHINE_MODEL_H
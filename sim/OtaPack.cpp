@@ -0,0 +1,295 @@
+#include "OtaPack.h"
+#include <Arduino.h>
+#include <Update.h>
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <string.h>
+#include "Update/CompressedUpdate.h"
+
+//* ************************************************************************
+//* ************************ OTA IMAGE PACKER *****************************
+//* ************************************************************************
+
+OtaPackOptions defaultOtaPackOptions() {
+    OtaPackOptions options;
+    options.windowBits = 12;
+    options.lookaheadBits = 5;
+    options.linkKBytesPerSecond = 100.0;   // espota over shop WiFi
+    options.seed = 1;
+    return options;
+}
+
+namespace {
+
+const int HASH_BITS = 16;
+const int MAX_CHAIN_LENGTH = 256;
+const size_t TCP_SEGMENT_BYTES = 1460;
+
+//* ************************************************************************
+//* ************************ ENCODER **************************************
+//* ************************************************************************
+
+class BitWriter {
+   public:
+    explicit BitWriter(std::vector<uint8_t>& out) : _out(out), _byte(0), _count(0) {}
+
+    void put(uint32_t value, int bits) {
+        for (int i = bits - 1; i >= 0; i--) {
+            _byte = (uint8_t)((_byte << 1) | ((value >> i) & 1));
+            if (++_count == 8) {
+                _out.push_back(_byte);
+                _byte = 0;
+                _count = 0;
+            }
+        }
+    }
+
+    // Pads the last byte with zero bits
+    void finish() {
+        if (_count > 0) {
+            _out.push_back((uint8_t)(_byte << (8 - _count)));
+            _byte = 0;
+            _count = 0;
+        }
+    }
+
+   private:
+    std::vector<uint8_t>& _out;
+    uint8_t _byte;
+    int _count;
+};
+
+// Hash chains over 3-byte prefixes; positions are inserted in order, so a
+// chain walks from the nearest candidate outwards
+class MatchFinder {
+   public:
+    MatchFinder(const std::vector<uint8_t>& data, size_t window, size_t maxLength)
+        : _data(data), _window(window), _maxLength(maxLength), _head(1u << HASH_BITS, -1),
+          _previous(data.size(), -1), _inserted(0) {}
+
+    // Longest earlier match for position i, inserting everything before i first
+    size_t longest(size_t i, size_t& distance) {
+        while (_inserted < i) {
+            insert(_inserted++);
+        }
+        if (i + 3 > _data.size()) {
+            return 0;
+        }
+        size_t limit = std::min(_maxLength, _data.size() - i);
+        size_t best = 0;
+        int depth = 0;
+        for (long candidate = _head[hash(i)]; candidate >= 0 && i - candidate <= _window && depth < MAX_CHAIN_LENGTH;
+             candidate = _previous[candidate], depth++) {
+            size_t length = 0;
+            while (length < limit && _data[candidate + length] == _data[i + length]) {
+                length++;
+            }
+            if (length > best) {
+                best = length;
+                distance = i - candidate;
+                if (length == limit) {
+                    break;
+                }
+            }
+        }
+        return best;
+    }
+
+   private:
+    uint32_t hash(size_t i) const {
+        uint32_t key = ((uint32_t)_data[i] << 16) | ((uint32_t)_data[i + 1] << 8) | _data[i + 2];
+        return (key * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    void insert(size_t i) {
+        if (i + 3 <= _data.size()) {
+            uint32_t h = hash(i);
+            _previous[i] = _head[h];
+            _head[h] = (long)i;
+        }
+    }
+
+    const std::vector<uint8_t>& _data;
+    size_t _window;
+    size_t _maxLength;
+    std::vector<long> _head;
+    std::vector<long> _previous;
+    size_t _inserted;
+};
+
+//* ************************************************************************
+//* ************************ FILES AND CHECKS *****************************
+//* ************************************************************************
+
+bool readFile(const char* path, std::vector<uint8_t>& data) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) {
+        fprintf(stderr, "Cannot read %s\n", path);
+        return false;
+    }
+    data.clear();
+    uint8_t buffer[65536];
+    size_t got;
+    while ((got = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.insert(data.end(), buffer, buffer + got);
+    }
+    fclose(file);
+    return true;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Feeds the packed image to the firmware decoder in TCP-segment-sized
+// pieces of random length, as the HTTP task would; true if end() accepts it
+bool streamIntoPartition(const std::vector<uint8_t>& packed, uint32_t seed, const char*& error) {
+    std::mt19937 random(seed);
+    CompressedUpdate update;
+    size_t offset = 0;
+    while (offset < packed.size()) {
+        size_t chunk = std::min((size_t)(1 + random() % TCP_SEGMENT_BYTES), packed.size() - offset);
+        if (!update.write(packed.data() + offset, chunk)) {
+            error = update.error();
+            return false;
+        }
+        offset += chunk;
+    }
+    bool finished = update.end();
+    error = update.error();
+    return finished;
+}
+
+// A damaged upload must be refused, never written as a good image
+bool checkRefused(const char* name, const std::vector<uint8_t>& packed, uint32_t seed) {
+    const char* error = nullptr;
+    bool accepted = streamIntoPartition(packed, seed, error);
+    printf("%-28s %s", name, accepted ? "ACCEPTED - decoder did not catch it\n" : "refused (");
+    if (!accepted) {
+        printf("%s)\n", error);
+    }
+    return !accepted;
+}
+
+} // namespace
+
+//* ************************************************************************
+//* ************************ PACKER ***************************************
+//* ************************************************************************
+
+std::vector<uint8_t> packCompressedImage(const std::vector<uint8_t>& image, const OtaPackOptions& options) {
+    const size_t window = (size_t)1 << options.windowBits;
+    const size_t maxLength = (size_t)1 << options.lookaheadBits;
+    // A back-reference costs 1 + W + L bits, a literal 9 bits per byte
+    const size_t minLength = std::max((size_t)3, (size_t)(1 + options.windowBits + options.lookaheadBits) / 9 + 1);
+
+    //! Step 1: Header
+    std::vector<uint8_t> packed(COMPRESSED_IMAGE_HEADER_SIZE);
+    CompressedImageHeader header;
+    header.windowBits = options.windowBits;
+    header.lookaheadBits = options.lookaheadBits;
+    header.imageSize = (uint32_t)image.size();
+    header.imageCrc = updateCrc32(0, image.data(), image.size());
+    writeCompressedImageHeader(header, packed.data());
+
+    //! Step 2: Tokens - take a match unless the next position has a longer one
+    BitWriter bits(packed);
+    MatchFinder finder(image, window, maxLength);
+    size_t i = 0;
+    while (i < image.size()) {
+        size_t distance = 0;
+        size_t length = finder.longest(i, distance);
+        if (length >= minLength && i + 1 < image.size()) {
+            size_t nextDistance = 0;
+            if (finder.longest(i + 1, nextDistance) > length) {
+                length = 0;
+            }
+        }
+        if (length >= minLength) {
+            bits.put(0, 1);
+            bits.put((uint32_t)(distance - 1), options.windowBits);
+            bits.put((uint32_t)(length - 1), options.lookaheadBits);
+            i += length;
+        } else {
+            bits.put(1, 1);
+            bits.put(image[i], 8);
+            i++;
+        }
+    }
+    bits.finish();
+    return packed;
+}
+
+int runOtaPack(const char* imagePath, const char* outputPath, const OtaPackOptions& options) {
+    std::vector<uint8_t> image;
+    if (!readFile(imagePath, image)) {
+        return 2;
+    }
+    std::vector<uint8_t> packed = packCompressedImage(image, options);
+    FILE* file = fopen(outputPath, "wb");
+    if (file == nullptr || fwrite(packed.data(), 1, packed.size(), file) != packed.size()) {
+        fprintf(stderr, "Cannot write %s\n", outputPath);
+        if (file != nullptr) {
+            fclose(file);
+        }
+        return 2;
+    }
+    fclose(file);
+    printf("%s: %zu -> %zu bytes (%.1f%%), window 2^%u, lookahead 2^%u\n", outputPath, image.size(),
+           packed.size(), 100.0 * packed.size() / image.size(), options.windowBits, options.lookaheadBits);
+    return 0;
+}
+
+//* ************************************************************************
+//* ************************ ROUND TRIP CHECK *****************************
+//* ************************************************************************
+
+int runOtaCheck(const char* imagePath, const OtaPackOptions& options) {
+    //! Step 1: Image - a real firmware.bin, or this program as a stand-in
+    std::vector<uint8_t> image;
+    const char* path = imagePath != nullptr ? imagePath : "/proc/self/exe";
+    if (!readFile(path, image) || image.empty()) {
+        return 2;
+    }
+    printf("Image:                       %s, %zu bytes\n", path, image.size());
+
+    //! Step 2: Pack
+    auto packStart = std::chrono::steady_clock::now();
+    std::vector<uint8_t> packed = packCompressedImage(image, options);
+    printf("Packed:                      %zu bytes (%.1f%% of the image), window 2^%u, lookahead 2^%u, %.2f s\n",
+           packed.size(), 100.0 * packed.size() / image.size(), options.windowBits, options.lookaheadBits,
+           secondsSince(packStart));
+
+    //! Step 3: Decode into the mock partition and compare
+    bool ok = true;
+    const char* error = nullptr;
+    auto decodeStart = std::chrono::steady_clock::now();
+    bool finished = streamIntoPartition(packed, options.seed, error);
+    double decodeSeconds = secondsSince(decodeStart);
+    bool identical = finished && Update.image() == image;
+    if (identical) {
+        printf("Mock partition:              identical, %.1f MB/s decoded on this host\n",
+               image.size() / decodeSeconds / 1e6);
+    } else {
+        printf("Mock partition:              MISMATCH (%s)\n", finished ? "contents differ" : error);
+        ok = false;
+    }
+
+    //! Step 4: Damaged uploads
+    std::vector<uint8_t> truncated(packed.begin(), packed.end() - std::min((size_t)64, packed.size() / 2));
+    std::vector<uint8_t> corrupted = packed;
+    corrupted[COMPRESSED_IMAGE_HEADER_SIZE + (corrupted.size() - COMPRESSED_IMAGE_HEADER_SIZE) / 2] ^= 0x10;
+    ok = checkRefused("Truncated upload:", truncated, options.seed) && ok;
+    ok = checkRefused("Corrupted upload:", corrupted, options.seed) && ok;
+    ok = checkRefused("Uncompressed image:", image, options.seed) && ok;
+
+    //! Step 5: Downtime - the axes are parked for the whole transfer
+    double rawSeconds = image.size() / (options.linkKBytesPerSecond * 1024.0);
+    double packedSeconds = packed.size() / (options.linkKBytesPerSecond * 1024.0);
+    printf("Transfer at %.0f KB/s:         raw %.1f s, packed %.1f s (%.0f%% less downtime)\n",
+           options.linkKBytesPerSecond, rawSeconds, packedSeconds, 100.0 * (1.0 - packedSeconds / rawSeconds));
+
+    printf("Result: %s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,34 @@
+#ifndef OTA_PACK_H
+#define OTA_PACK_H
+
+#include <stdint.h>
+#include <vector>
+
+//* ************************************************************************
+//* ************************ OTA IMAGE PACKER HEADER **********************
+//* ************************************************************************
+//! Host side of compressed updates (Update/CompressedUpdate.h): packs a
+//! firmware image into the heatshrink format the board decodes, and checks
+//! the round trip through the firmware's own decoder into the native Update
+//! stand-in (a mock OTA partition held in memory).
+//!
+//! The encoder is LZSS with hash chains and one-step lazy matching; any
+//! heatshrink encoder with the same window and lookahead works as well.
+
+struct OtaPackOptions {
+    uint8_t windowBits;         // Decoder RAM is 2^windowBits bytes
+    uint8_t lookaheadBits;      // Longest match is 2^lookaheadBits bytes
+    double linkKBytesPerSecond; // Upload rate used for the downtime estimate
+    uint32_t seed;              // Chunk sizes fed to the decoder
+};
+
+OtaPackOptions defaultOtaPackOptions();
+
+// Header plus stream, ready to POST to /update
+std::vector<uint8_t> packCompressedImage(const std::vector<uint8_t>& image, const OtaPackOptions& options);
+
+// Return the process exit code: 0 = ok
+int runOtaPack(const char* imagePath, const char* outputPath, const OtaPackOptions& options);
+int runOtaCheck(const char* imagePath, const OtaPackOptions& options);   // nullptr = this program
+
+#endif // OTA_PACK_H
@@ -0,0 +1,322 @@
+#include "ParameterSweep.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+#include "Simulator.h"
+#include "Config/Config.h"
+
+//* ************************************************************************
+//* ************************ PARAMETER SWEEP ******************************
+//* ************************************************************************
+
+namespace {
+
+//* ************************************************************************
+//* ************************ SEARCH SPACE *********************************
+//* ************************************************************************
+//! Bounds keep each axis inside what the drives and the cut were set up
+//! for. Left out on purpose:
+//!  - POSITION_MOTOR_RETURN_ACCELERATION: moveMotorTo() always applies the
+//!    normal acceleration
+//!  - PUSHWOOD_*_DELAY_MS: PUSHWOODFORWARDONE is not reached in production
+
+struct TunableParameter {
+    const char* name;
+    const char* heading;
+    float* value;
+    float minimum;
+    float maximum;
+};
+
+const TunableParameter TUNABLE_PARAMETERS[] = {
+    {"CUT_MOTOR_CUTTING_SPEED", "cut v", &CUT_MOTOR_CUTTING_SPEED, 500, 1200},
+    {"CUT_MOTOR_NORMAL_ACCELERATION", "cut a", &CUT_MOTOR_NORMAL_ACCELERATION, 5000, 30000},
+    {"CUT_MOTOR_RETURN_SPEED", "ret v", &CUT_MOTOR_RETURN_SPEED, 10000, 30000},
+    {"CUT_MOTOR_RETURN_ACCELERATION", "ret a", &CUT_MOTOR_RETURN_ACCELERATION, 10000, 50000},
+    {"POSITION_MOTOR_NORMAL_SPEED", "pos v", &POSITION_MOTOR_NORMAL_SPEED, 10000, 30000},
+    {"POSITION_MOTOR_NORMAL_ACCELERATION", "pos a", &POSITION_MOTOR_NORMAL_ACCELERATION, 10000, 40000},
+    {"POSITION_MOTOR_RETURN_SPEED", "posret v", &POSITION_MOTOR_RETURN_SPEED, 10000, 30000},
+    {"CATCHER_CLAMP_EARLY_ACTIVATION_OFFSET_INCHES", "catch in", &CATCHER_CLAMP_EARLY_ACTIVATION_OFFSET_INCHES, 0.2f, 3.0f},
+    {"CATCHER_SERVO_EARLY_ACTIVATION_OFFSET_INCHES", "servo in", &CATCHER_SERVO_EARLY_ACTIVATION_OFFSET_INCHES, 0.2f, 3.0f},
+};
+
+const int PARAMETER_COUNT = sizeof(TUNABLE_PARAMETERS) / sizeof(TUNABLE_PARAMETERS[0]);
+
+struct SweepPoint {
+    float values[PARAMETER_COUNT];
+    bool completed;
+    double cycleSeconds;
+    float clampMarginMs;
+    float catcherMarginMs;
+    float servoMarginMs;
+    float marginMs;             // The one selected by SweepOptions::constraint
+    bool onFront;
+};
+
+struct SweepContext {
+    const SweepOptions* options;
+    const SweepPoint* points;
+};
+
+// xorshift32 - same sequence on every host
+uint32_t nextRandom(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+float randomUnit(uint32_t& state) {
+    return (nextRandom(state) >> 8) / 16777216.0f;
+}
+
+//! The servo is triggered once per cycle, so the shortest cycle is the least
+//! time it gets to come home; a trigger that found it away counts as violated
+float catcherServoMarginMs(const SimulationReport& report) {
+    if (report.catcherServo.activations == 0) {
+        return MARGIN_NOT_SEEN;
+    }
+    float marginMs = report.cycleMinNs / 1e6f - report.catcherServo.maxReadyMs;
+    if (report.catcherServo.lateActivations > 0 && marginMs > 0) {
+        marginMs = 0;
+    }
+    return marginMs;
+}
+
+float tighterMargin(float a, float b) {
+    return a < b ? a : b;
+}
+
+float clampToBounds(const TunableParameter& parameter, float value) {
+    if (value < parameter.minimum) return parameter.minimum;
+    if (value > parameter.maximum) return parameter.maximum;
+    return value;
+}
+
+//* ************************************************************************
+//* ************************ RUNS *****************************************
+//* ************************************************************************
+
+void setupSweepRun(int index, SimulationOptions& options, void* context) {
+    const SweepContext& sweep = *(const SweepContext*)context;
+    for (int p = 0; p < PARAMETER_COUNT; p++) {
+        *TUNABLE_PARAMETERS[p].value = sweep.points[index].values[p];
+    }
+    options.boards = 1;
+    options.machine.boardLengthInches = sweep.options->boardLengthInches;
+}
+
+void runPoints(const SweepOptions& options, std::vector<SweepPoint>& points, size_t first) {
+    size_t count = points.size() - first;
+    if (count == 0) {
+        return;
+    }
+    std::vector<SimulationReport> reports(count);
+    bool* completed = new bool[count];
+    SweepContext context = {&options, &points[first]};
+    runSimulationsForked((int)count, options.jobs, setupSweepRun, &context, reports.data(), completed);
+
+    for (size_t i = 0; i < count; i++) {
+        SweepPoint& point = points[first + i];
+        const SimulationReport& report = reports[i];
+        point.completed = completed[i] && report.yeswoodCycles > 0;
+        point.cycleSeconds = meanCycleSeconds(report);
+        point.clampMarginMs = report.machine.minClampMarginMs;
+        point.catcherMarginMs = report.machine.minCatcherMarginMs;
+        point.servoMarginMs = catcherServoMarginMs(report);
+        if (options.constraint == CONSTRAINT_CLAMPS) {
+            point.marginMs = point.clampMarginMs;
+        } else if (options.constraint == CONSTRAINT_CATCHER) {
+            point.marginMs = point.catcherMarginMs;
+        } else if (options.constraint == CONSTRAINT_CATCHER_SERVO) {
+            point.marginMs = point.servoMarginMs;
+        } else {
+            point.marginMs = tighterMargin(tighterMargin(point.clampMarginMs, point.catcherMarginMs), point.servoMarginMs);
+        }
+    }
+    delete[] completed;
+}
+
+//* ************************************************************************
+//* ************************ PARETO FRONT *********************************
+//* ************************************************************************
+
+bool dominates(const SweepPoint& a, const SweepPoint& b) {
+    return a.cycleSeconds <= b.cycleSeconds && a.marginMs >= b.marginMs &&
+           (a.cycleSeconds < b.cycleSeconds || a.marginMs > b.marginMs);
+}
+
+void markParetoFront(std::vector<SweepPoint>& points) {
+    for (SweepPoint& point : points) {
+        point.onFront = point.completed;
+        for (const SweepPoint& other : points) {
+            if (point.onFront && other.completed && dominates(other, point)) {
+                point.onFront = false;
+            }
+        }
+    }
+}
+
+//* ************************************************************************
+//* ************************ REPORT ***************************************
+//* ************************************************************************
+
+void printPointHeader() {
+    printf("  %4s %8s %10s %9s %10s %9s", "run", "cycle s", "margin ms", "clamp ms", "catcher ms", "servo ms");
+    for (int p = 0; p < PARAMETER_COUNT; p++) {
+        printf(" %9s", TUNABLE_PARAMETERS[p].heading);
+    }
+    printf("\n");
+}
+
+void printPoint(size_t index, const SweepPoint& point) {
+    printf("  %4zu %8.3f %10.1f %9.1f %10.1f %9.1f", index, point.cycleSeconds, point.marginMs,
+           point.clampMarginMs, point.catcherMarginMs, point.servoMarginMs);
+    for (int p = 0; p < PARAMETER_COUNT; p++) {
+        printf(" %9.2f", point.values[p]);
+    }
+    printf("\n");
+}
+
+void printCandidate(const SweepPoint& candidate, const SweepPoint& current) {
+    printf("\nCandidate config (cycle %.3f s -> %.3f s, margin %.1f ms -> %.1f ms) - verify on the machine:\n",
+           current.cycleSeconds, candidate.cycleSeconds, current.marginMs, candidate.marginMs);
+    for (int p = 0; p < PARAMETER_COUNT; p++) {
+        const char* format = TUNABLE_PARAMETERS[p].maximum > 100 ? "%.0f" : "%.2f";
+        char value[24];
+        char was[24];
+        snprintf(value, sizeof(value), format, candidate.values[p]);
+        snprintf(was, sizeof(was), format, current.values[p]);
+        printf("  CONFIG_TUNABLE float %s = %s;%s%s\n", TUNABLE_PARAMETERS[p].name, value,
+               strcmp(value, was) ? "  // was " : "", strcmp(value, was) ? was : "");
+    }
+    printf("Or live on the serial console (then 'config save'):\n");
+    for (int p = 0; p < PARAMETER_COUNT; p++) {
+        if (candidate.values[p] != current.values[p]) {
+            printf("  config set %s %g\n", TUNABLE_PARAMETERS[p].name, candidate.values[p]);
+        }
+    }
+}
+
+} // namespace
+
+//* ************************************************************************
+//* ************************ ENTRY POINT **********************************
+//* ************************************************************************
+
+SweepOptions defaultSweepOptions() {
+    SweepOptions options;
+    options.samples = 32;
+    options.refineSamples = 16;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    options.jobs = cpus > 0 ? (int)cpus : 1;
+    options.seed = 20240601;
+    options.boardLengthInches = 24.0f;
+    options.minMarginMs = 0.0f;
+    options.constraint = CONSTRAINT_ALL;
+    return options;
+}
+
+int runParameterSweep(const SweepOptions& options) {
+    std::vector<SweepPoint> points;
+    uint32_t random = options.seed ? options.seed : 1;
+
+    //! Step 1: The current Config.cpp, then random samples
+    SweepPoint current = {};
+    for (int p = 0; p < PARAMETER_COUNT; p++) {
+        current.values[p] = *TUNABLE_PARAMETERS[p].value;
+    }
+    points.push_back(current);
+    for (int i = 0; i < options.samples; i++) {
+        SweepPoint point = {};
+        for (int p = 0; p < PARAMETER_COUNT; p++) {
+            const TunableParameter& parameter = TUNABLE_PARAMETERS[p];
+            point.values[p] = parameter.minimum + randomUnit(random) * (parameter.maximum - parameter.minimum);
+        }
+        points.push_back(point);
+    }
+    printf("Parameter sweep: %d parameters, board %.1f in, %d jobs\n", PARAMETER_COUNT,
+           options.boardLengthInches, options.jobs);
+    printf("Round 1: %zu runs\n", points.size());
+    runPoints(options, points, 0);
+    markParetoFront(points);
+
+    //! Step 2: Refine - perturb front members by up to 10% of each range
+    std::vector<size_t> front;
+    for (size_t i = 0; i < points.size(); i++) {
+        if (points[i].onFront) front.push_back(i);
+    }
+    size_t refineStart = points.size();
+    for (int i = 0; i < options.refineSamples && !front.empty(); i++) {
+        SweepPoint point = points[front[i % front.size()]];
+        for (int p = 0; p < PARAMETER_COUNT; p++) {
+            const TunableParameter& parameter = TUNABLE_PARAMETERS[p];
+            float range = parameter.maximum - parameter.minimum;
+            point.values[p] = clampToBounds(parameter, point.values[p] + (randomUnit(random) - 0.5f) * 0.2f * range);
+        }
+        points.push_back(point);
+    }
+    printf("Round 2: %zu runs around %zu front points\n", points.size() - refineStart, front.size());
+    runPoints(options, points, refineStart);
+    markParetoFront(points);
+
+    //! Step 3: Report the front, fastest first
+    std::vector<size_t> order;
+    int completedRuns = 0;
+    for (size_t i = 0; i < points.size(); i++) {
+        if (points[i].completed) completedRuns++;
+        if (points[i].onFront) order.push_back(i);
+    }
+    for (size_t a = 0; a < order.size(); a++) {
+        for (size_t b = a + 1; b < order.size(); b++) {
+            if (points[order[b]].cycleSeconds < points[order[a]].cycleSeconds) {
+                size_t swap = order[a];
+                order[a] = order[b];
+                order[b] = swap;
+            }
+        }
+    }
+    printf("\n%d of %zu runs completed. Current config (run 0):\n", completedRuns, points.size());
+    printPointHeader();
+    printPoint(0, points[0]);
+    static const char* const CONSTRAINT_NAMES[] = {
+        "tightest of clamp settle, catcher engaged and catcher servo ready",
+        "clamp settle before motion",
+        "catcher engaged before cut end",
+        "catcher servo home before its next trigger"
+    };
+    printf("\nPareto front, cycle time vs safety margin (%s; negative = violated):\n",
+           CONSTRAINT_NAMES[options.constraint]);
+    printPointHeader();
+    for (size_t index : order) {
+        printPoint(index, points[index]);
+    }
+
+    //! Step 4: Candidate - the fastest front point that keeps the margin
+    for (size_t index : order) {
+        if (points[index].marginMs >= options.minMarginMs) {
+            printCandidate(points[index], points[0]);
+            return 0;
+        }
+    }
+    const SweepPoint* safest = nullptr;
+    for (size_t index : order) {
+        if (safest == nullptr || points[index].marginMs > safest->marginMs) safest = &points[index];
+    }
+    printf("\nNo run keeps a %.1f ms safety margin", options.minMarginMs);
+    if (safest != nullptr) {
+        const char* limit = "clamp settling before a carriage move";
+        float limitMs = safest->clampMarginMs;
+        if (safest->catcherMarginMs < limitMs) {
+            limit = "catcher engagement before the cut ends";
+            limitMs = safest->catcherMarginMs;
+        }
+        if (safest->servoMarginMs < limitMs) {
+            limit = "the catcher servo coming home before its next trigger";
+        }
+        printf(" - best is %.1f ms, limited by %s", safest->marginMs, limit);
+    }
+    printf(".\nThe searched speeds and offsets cannot reach it; the limit is in the state sequencing.\n");
+    return 1;
+}
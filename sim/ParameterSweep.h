@@ -0,0 +1,42 @@
+#ifndef PARAMETER_SWEEP_H
+#define PARAMETER_SWEEP_H
+
+#include <stdint.h>
+
+//* ************************************************************************
+//* ************************ PARAMETER SWEEP HEADER ***********************
+//* ************************************************************************
+//! Searches the tunable Config.cpp values (speeds, accelerations, catcher
+//! early-activation offsets) in the simulator and reports the Pareto front
+//! of cycle time against safety margin, plus a candidate config.
+//!
+//! Rewrites the CONFIG_TUNABLE globals directly; each run is a forked child.
+//!
+//! Search: the current config, then random samples inside each parameter's
+//! bounds, then a refinement round that perturbs the front found so far.
+//! The seed is fixed, so the same firmware always gives the same answer.
+
+// Which safety margin the front trades against cycle time
+enum SweepConstraint {
+    CONSTRAINT_ALL,             // Tightest of the three below
+    CONSTRAINT_CLAMPS,          // Clamps settled before a carriage moves
+    CONSTRAINT_CATCHER,         // Catcher engaged before the cut ends
+    CONSTRAINT_CATCHER_SERVO    // Catcher servo home before its next trigger (CatcherServoStats)
+};
+
+struct SweepOptions {
+    int samples;                // Random samples in the first round
+    int refineSamples;          // Perturbations of the front in the second round
+    int jobs;                   // Runs in parallel
+    uint32_t seed;
+    float boardLengthInches;    // One board per run
+    float minMarginMs;          // Candidate must keep at least this safety margin
+    SweepConstraint constraint;
+};
+
+SweepOptions defaultSweepOptions();
+
+// Returns the process exit code: 0 = candidate found, 1 = none satisfies the constraints
+int runParameterSweep(const SweepOptions& options);
+
+#endif // PARAMETER_SWEEP_H
@@ -0,0 +1,73 @@
+#include "RemoteClient.h"
+#include <WiFi.h>
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "Control/RemoteControl.h"
+
+//* ************************************************************************
+//* ************************ REMOTE CONTROL CLIENT ************************
+//* ************************************************************************
+
+namespace {
+
+const unsigned long REPLY_TIMEOUT_MS = 2000;
+
+} // namespace
+
+RemoteClientOptions defaultRemoteClientOptions() {
+    RemoteClientOptions options = {};
+    options.host = "127.0.0.1";
+    const char* offsetText = getenv("HAL_PORT_OFFSET");
+    options.port = (uint16_t)(REMOTE_CONTROL_PORT + (offsetText != nullptr ? atoi(offsetText) : 0));
+    options.repeat = 1;
+    return options;
+}
+
+int runRemoteClient(const RemoteClientOptions& options) {
+    //! Step 1: Connect - one connection for the whole list, as the line
+    //! controller keeps it open
+    WiFiClient client;
+    if (!client.connect(options.host, options.port)) {
+        fprintf(stderr, "Cannot connect to %s:%u\n", options.host, options.port);
+        return 2;
+    }
+    client.setNoDelay(true);
+    client.setTimeout(REPLY_TIMEOUT_MS);
+
+    //! Step 2: One line out, one line back
+    bool ok = true;
+    std::vector<double> roundTrips;
+    for (int round = 0; round < options.repeat; round++) {
+        for (int i = 0; i < options.commandCount; i++) {
+            auto sent = std::chrono::steady_clock::now();
+            client.print(options.commands[i]);
+            client.print("\n");
+            String reply = client.readStringUntil('\n');
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sent).count();
+            if (reply.length() == 0) {
+                fprintf(stderr, "%s: no reply within %lu ms\n", options.commands[i], REPLY_TIMEOUT_MS);
+                client.stop();
+                return 1;
+            }
+            roundTrips.push_back(ms);
+            ok = ok && strncmp(reply.c_str(), "OK", 2) == 0;
+            if (options.repeat == 1) {
+                printf("> %-20s %6.2f ms  %s\n", options.commands[i], ms, reply.c_str());
+            }
+        }
+    }
+    client.stop();
+
+    //! Step 3: Round trip statistics over repeated lists
+    if (options.repeat > 1 && !roundTrips.empty()) {
+        std::sort(roundTrips.begin(), roundTrips.end());
+        printf("%zu commands: round trip min %.2f ms, median %.2f ms, p95 %.2f ms, max %.2f ms\n",
+               roundTrips.size(), roundTrips.front(), roundTrips[roundTrips.size() / 2],
+               roundTrips[roundTrips.size() * 95 / 100], roundTrips.back());
+    }
+    return ok ? 0 : 1;
+}
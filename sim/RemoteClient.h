@@ -0,0 +1,30 @@
+#ifndef REMOTE_CLIENT_H
+#define REMOTE_CLIENT_H
+
+#include <stdint.h>
+
+//* ************************************************************************
+//* ************************ REMOTE CONTROL CLIENT HEADER *****************
+//* ************************************************************************
+//! Loopback client for the command endpoint (Control/RemoteControl.h):
+//! sends each command as a line, prints the reply and the round trip, as
+//! the line controller would see them. Run the native build alongside,
+//! e.g. HAL_PORT_OFFSET=8000 .pio/build/native/program, then
+//! "sim control status 'start 3'" (the same offset is added to the port).
+
+const int MAX_REMOTE_CLIENT_COMMANDS = 16;
+
+struct RemoteClientOptions {
+    const char* host;
+    uint16_t port;
+    const char* commands[MAX_REMOTE_CLIENT_COMMANDS];
+    int commandCount;
+    int repeat;                 // Sends the whole list this many times (latency statistics)
+};
+
+RemoteClientOptions defaultRemoteClientOptions();
+
+// Returns the process exit code: 0 = every reply was OK
+int runRemoteClient(const RemoteClientOptions& options);
+
+#endif // REMOTE_CLIENT_H
@@ -0,0 +1,120 @@
+#include "SensorReplay.h"
+#include <stdio.h>
+#include <string.h>
+#include "Diagnostics/SensorTrace.h"
+
+//* ************************************************************************
+//* ************************ SENSOR REPLAY ********************************
+//* ************************************************************************
+
+namespace {
+
+int inputByName(const char* name, size_t length) {
+    for (int i = 0; i < FLIGHT_SENSOR_COUNT; i++) {
+        const char* candidate = flightSensorName((uint8_t)i);
+        if (strlen(candidate) == length && strncmp(candidate, name, length) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+SensorReplay::SensorReplay() : _firstUs(0), _fromUs(0) {
+    for (int i = 0; i < FLIGHT_SENSOR_COUNT; i++) {
+        _cursor[i] = 0;
+        _selected[i] = true;
+    }
+}
+
+bool SensorReplay::load(const char* path, char* error, size_t errorSize) {
+    FILE* file = fopen(path, "r");
+    if (file == nullptr) {
+        snprintf(error, errorSize, "cannot read %s", path);
+        return false;
+    }
+    char line[128];
+    int lineNumber = 0;
+    bool first = true;
+    while (fgets(line, sizeof(line), file)) {
+        lineNumber++;
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') {
+            continue;
+        }
+        long long timeUs;
+        char name[32];
+        int level;
+        int input = -1;
+        if (sscanf(line, "%lld %31s %d", &timeUs, name, &level) == 3) {
+            input = inputByName(name, strlen(name));
+        }
+        if (input < 0 || (level != 0 && level != 1)) {
+            snprintf(error, errorSize, "%s:%d: expected \"<time_us> <input> <0|1>\"", path, lineNumber);
+            fclose(file);
+            return false;
+        }
+        if (first) {
+            _firstUs = timeUs;
+            first = false;
+        }
+        _edges[input].push_back({timeUs, level});
+    }
+    fclose(file);
+    _fromUs = _firstUs;
+    return true;
+}
+
+bool SensorReplay::selectInputs(const char* names, char* error, size_t errorSize) {
+    for (int i = 0; i < FLIGHT_SENSOR_COUNT; i++) {
+        _selected[i] = false;
+    }
+    while (*names) {
+        size_t length = strcspn(names, ",");
+        int input = inputByName(names, length);
+        if (input < 0) {
+            snprintf(error, errorSize, "unknown input \"%.*s\"", (int)length, names);
+            return false;
+        }
+        _selected[input] = true;
+        names += length;
+        if (*names == ',') {
+            names++;
+        }
+    }
+    return true;
+}
+
+size_t SensorReplay::edgeCount() const {
+    size_t count = 0;
+    for (int i = 0; i < FLIGHT_SENSOR_COUNT; i++) {
+        if (_selected[i]) {
+            count += _edges[i].size();
+        }
+    }
+    return count;
+}
+
+bool SensorReplay::level(int pin, uint64_t nowNs, int& level) {
+    for (uint8_t input = 0; input < FLIGHT_SENSOR_COUNT; input++) {
+        if (sensorTracePin(input) != pin) {
+            continue;
+        }
+        if (!replays(input)) {
+            return false;
+        }
+        //! The clock only moves forward, so each input keeps a cursor
+        const std::vector<Edge>& edges = _edges[input];
+        int64_t traceUs = _fromUs + (int64_t)(nowNs / 1000);
+        size_t& cursor = _cursor[input];
+        while (cursor < edges.size() && edges[cursor].timeUs <= traceUs) {
+            cursor++;
+        }
+        if (cursor == 0) {
+            return false;
+        }
+        level = edges[cursor - 1].level;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,53 @@
+#ifndef SENSOR_REPLAY_H
+#define SENSOR_REPLAY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "Diagnostics/FlightRecorder.h"
+
+//* ************************************************************************
+//* ************************ SENSOR REPLAY HEADER *************************
+//* ************************************************************************
+//! Drives machine inputs from a sensor trace recorded on the floor
+//! (/sensors.trace, "sensortrace" on the console) instead of the model.
+//!
+//! The trace is open loop: each input follows its recorded levels on the
+//! virtual clock, whatever the simulated carriages do. Trace time fromUs is
+//! simulator power-on; levels before it collapse into the starting level.
+//! An input is driven by the model until its first replayed line.
+
+class SensorReplay {
+   public:
+    SensorReplay();
+
+    // Returns false (with a message in error) on an unreadable file or line
+    bool load(const char* path, char* error, size_t errorSize);
+
+    // Only replay these inputs: comma-separated trace names ("wood,wood_suction")
+    bool selectInputs(const char* names, char* error, size_t errorSize);
+
+    // Trace time that lines up with simulator power-on (default: first line)
+    void alignTo(int64_t fromUs) { _fromUs = fromUs; }
+    int64_t firstTimeUs() const { return _firstUs; }
+
+    size_t edgeCount() const;
+    bool replays(uint8_t input) const { return _selected[input] && !_edges[input].empty(); }
+
+    // Level the trace gives pin at nowNs; false if the model drives it
+    bool level(int pin, uint64_t nowNs, int& level);
+
+   private:
+    struct Edge {
+        int64_t timeUs;
+        int level;
+    };
+
+    std::vector<Edge> _edges[FLIGHT_SENSOR_COUNT];
+    size_t _cursor[FLIGHT_SENSOR_COUNT];
+    bool _selected[FLIGHT_SENSOR_COUNT];
+    int64_t _firstUs;
+    int64_t _fromUs;
+};
+
+#endif // SENSOR_REPLAY_H
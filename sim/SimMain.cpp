@@ -0,0 +1,368 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Simulator.h"
+#include "Benchmark.h"
+#include "ParameterSweep.h"
+#include "FaultInjection.h"
+#include "OtaPack.h"
+#include "RemoteClient.h"
+#include "Update/CompressedUpdate.h"
+
+//* ************************************************************************
+//* ************************ SIMULATOR ENTRY POINT ************************
+//* ************************************************************************
+//! Replaces the native HAL's weak main(): runs one simulation and prints
+//! the report, or runs a tool. Build with `pio run -e sim` and run
+//! .pio/build/sim/program [command] [options].
+
+namespace {
+
+void printUsage(const char* program) {
+    printf("Usage: %s [options]           Run one simulation\n", program);
+    printf("       %s bench [--save FILE] [--baseline FILE] [--tolerance PCT]\n", program);
+    printf("                                  Throughput benchmark scenarios\n");
+    printf("       %s sweep [--samples N] [--refine N] [--jobs N] [--seed N]\n", program);
+    printf("             [--board-length IN] [--min-margin MS] [--constraint all|clamps|catcher|servo]\n");
+    printf("                                  Search speeds/offsets: cycle time vs safety margin\n");
+    printf("       %s faults [--fault NAME] [--phase STATE[+S]]... [--after-pieces N]\n", program);
+    printf("             [--repair-seconds S] [--jobs N]\n");
+    printf("                                  Fault x phase matrix: time to safe state and to recover\n");
+    printf("       %s ota-pack IMAGE OUTPUT [--window BITS] [--lookahead BITS]\n", program);
+    printf("                                  Compress a firmware image for POST /update\n");
+    printf("       %s ota-check [IMAGE] [--window BITS] [--lookahead BITS] [--link-kbps KB/S]\n", program);
+    printf("                                  Pack, decode into a mock partition, compare (default: this program)\n");
+    printf("       %s control [--host H] [--port P] [--repeat N] COMMAND...\n", program);
+    printf("                                  Send commands to a running board or native build's TCP endpoint\n");
+    printf("\nSimulation options:\n");
+    printf("  --boards N              Boards to cut (default 3)\n");
+    printf("  --seconds S             Virtual production time limit (default 3600)\n");
+    printf("  --reload-seconds S      Operator time to load a board (default 20)\n");
+    printf("  --board-length IN       Board length in inches (default 96)\n");
+    printf("  --clamp-extend-ms MS    Clamp extend latency (default 80)\n");
+    printf("  --clamp-retract-ms MS   Clamp retract latency (default 60)\n");
+    printf("  --settle-chatter-ms MS  Board sensor chatter as a clamp settles (default 3)\n");
+    printf("  --blade-contact IN      Cut travel before the blade meets wood (default 0.5)\n");
+    printf("  --reload-every N        Operator RELOAD after every N pieces\n");
+    printf("  --error-every N         Inject a cut motor home error after every N pieces\n");
+    printf("  --fault NAME            Inject a hardware fault:");
+    for (int f = FAULT_NONE + 1; f < MACHINE_FAULT_COUNT; f++) {
+        printf("%s %s", f == FAULT_NONE + 1 ? "" : ",", machineFaultName((MachineFault)f));
+    }
+    printf("\n");
+    printf("  --phase STATE[+S]       ... S seconds after entering STATE (default CUTTING; STARTUP = power-on)\n");
+    printf("  --after-pieces N        ... once N pieces are done (default 2)\n");
+    printf("  --repair-seconds S      ... and clear it S seconds later (default 20)\n");
+    printf("  --replay FILE           Drive the inputs from a recorded sensor trace (/sensors.trace)\n");
+    printf("  --replay-inputs LIST    ... only these, e.g. wood,wood_suction (default: all in the trace)\n");
+    printf("  --replay-from US        ... trace time that lines up with power-on (default: first line)\n");
+    printf("  --record-trace FILE     Write the simulated run's sensor trace\n");
+    printf("  --console LINE          Run a console command after homing (repeatable, max 8)\n");
+    printf("  --remote                Start and stop batches with 'cycle' commands, start switch left off\n");
+    printf("  --verbose               Echo the firmware's Serial output\n");
+}
+
+struct ReplayArguments {
+    const char* path;
+    const char* inputs;
+    long long fromUs;           // < 0 = first line of the trace
+};
+
+// Loads the trace into replay; false after printing the reason
+bool loadReplay(const ReplayArguments& arguments, SensorReplay& replay) {
+    char error[160];
+    if (!replay.load(arguments.path, error, sizeof(error)) ||
+        (arguments.inputs != nullptr && !replay.selectInputs(arguments.inputs, error, sizeof(error)))) {
+        fprintf(stderr, "Replay: %s\n", error);
+        return false;
+    }
+    if (arguments.fromUs >= 0) {
+        replay.alignTo(arguments.fromUs);
+    }
+    return true;
+}
+
+// Returns false on an unknown option or a missing value
+bool parseOption(int argc, char** argv, int& i, SimulationOptions& options, ReplayArguments& replay) {
+    const char* arg = argv[i];
+    if (strcmp(arg, "--verbose") == 0) {
+        options.verbose = true;
+        return true;
+    }
+    if (strcmp(arg, "--remote") == 0) {
+        options.remoteControl = true;
+        return true;
+    }
+    if (i + 1 >= argc) {
+        return false;
+    }
+    const char* value = argv[++i];
+    if (strcmp(arg, "--boards") == 0) {
+        options.boards = atoi(value);
+    } else if (strcmp(arg, "--seconds") == 0) {
+        options.maxSeconds = atof(value);
+    } else if (strcmp(arg, "--reload-seconds") == 0) {
+        options.reloadSeconds = atof(value);
+    } else if (strcmp(arg, "--board-length") == 0) {
+        options.machine.boardLengthInches = atof(value);
+    } else if (strcmp(arg, "--clamp-extend-ms") == 0) {
+        options.machine.clampExtendMs = strtoul(value, nullptr, 10);
+    } else if (strcmp(arg, "--clamp-retract-ms") == 0) {
+        options.machine.clampRetractMs = strtoul(value, nullptr, 10);
+    } else if (strcmp(arg, "--settle-chatter-ms") == 0) {
+        options.machine.settleChatterMs = strtoul(value, nullptr, 10);
+    } else if (strcmp(arg, "--reload-every") == 0) {
+        options.reloadEveryPieces = atoi(value);
+    } else if (strcmp(arg, "--error-every") == 0) {
+        options.errorEveryPieces = atoi(value);
+    } else if (strcmp(arg, "--blade-contact") == 0) {
+        options.machine.bladeContactInches = atof(value);
+    } else if (strcmp(arg, "--fault") == 0) {
+        return parseMachineFault(value, options.fault.fault);
+    } else if (strcmp(arg, "--phase") == 0) {
+        FaultPhase phase;
+        if (!parseFaultPhase(value, phase)) {
+            return false;
+        }
+        options.fault.phase = phase.state;
+        options.fault.phaseDelaySeconds = phase.delaySeconds;
+    } else if (strcmp(arg, "--replay") == 0) {
+        replay.path = value;
+    } else if (strcmp(arg, "--replay-inputs") == 0) {
+        replay.inputs = value;
+    } else if (strcmp(arg, "--replay-from") == 0) {
+        replay.fromUs = atoll(value);
+    } else if (strcmp(arg, "--record-trace") == 0) {
+        options.traceOutPath = value;
+    } else if (strcmp(arg, "--console") == 0) {
+        if (options.consoleLineCount == SIM_MAX_CONSOLE_LINES) {
+            return false;
+        }
+        options.consoleLines[options.consoleLineCount++] = value;
+    } else if (strcmp(arg, "--after-pieces") == 0) {
+        options.fault.afterPieces = atoi(value);
+    } else if (strcmp(arg, "--repair-seconds") == 0) {
+        options.fault.repairSeconds = atof(value);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+int benchMain(int argc, char** argv) {
+    BenchmarkOptions options = {nullptr, nullptr, 1.0};
+    for (int i = 2; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--save") == 0) {
+            options.savePath = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--baseline") == 0) {
+            options.baselinePath = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--tolerance") == 0) {
+            options.tolerancePercent = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "Unknown or incomplete bench option: %s\n", argv[i]);
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    return runBenchmarks(options);
+}
+
+int sweepMain(int argc, char** argv) {
+    SweepOptions options = defaultSweepOptions();
+    for (int i = 2; i < argc; i++) {
+        const char* arg = argv[i];
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Unknown or incomplete sweep option: %s\n", arg);
+            return 2;
+        }
+        const char* value = argv[++i];
+        if (strcmp(arg, "--samples") == 0) {
+            options.samples = atoi(value);
+        } else if (strcmp(arg, "--refine") == 0) {
+            options.refineSamples = atoi(value);
+        } else if (strcmp(arg, "--jobs") == 0) {
+            options.jobs = atoi(value);
+        } else if (strcmp(arg, "--seed") == 0) {
+            options.seed = strtoul(value, nullptr, 10);
+        } else if (strcmp(arg, "--board-length") == 0) {
+            options.boardLengthInches = atof(value);
+        } else if (strcmp(arg, "--min-margin") == 0) {
+            options.minMarginMs = atof(value);
+        } else if (strcmp(arg, "--constraint") == 0 && strcmp(value, "all") == 0) {
+            options.constraint = CONSTRAINT_ALL;
+        } else if (strcmp(arg, "--constraint") == 0 && strcmp(value, "clamps") == 0) {
+            options.constraint = CONSTRAINT_CLAMPS;
+        } else if (strcmp(arg, "--constraint") == 0 && strcmp(value, "catcher") == 0) {
+            options.constraint = CONSTRAINT_CATCHER;
+        } else if (strcmp(arg, "--constraint") == 0 && strcmp(value, "servo") == 0) {
+            options.constraint = CONSTRAINT_CATCHER_SERVO;
+        } else {
+            fprintf(stderr, "Unknown or incomplete sweep option: %s\n", arg);
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    return runParameterSweep(options);
+}
+
+int faultsMain(int argc, char** argv) {
+    FaultHarnessOptions options = defaultFaultHarnessOptions();
+    for (int i = 2; i < argc; i++) {
+        const char* arg = argv[i];
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Unknown or incomplete faults option: %s\n", arg);
+            return 2;
+        }
+        const char* value = argv[++i];
+        bool valid = true;
+        if (strcmp(arg, "--fault") == 0) {
+            valid = parseMachineFault(value, options.only);
+        } else if (strcmp(arg, "--phase") == 0 && options.phaseCount < MAX_FAULT_PHASES) {
+            valid = parseFaultPhase(value, options.phases[options.phaseCount++]);
+        } else if (strcmp(arg, "--after-pieces") == 0) {
+            options.afterPieces = atoi(value);
+        } else if (strcmp(arg, "--repair-seconds") == 0) {
+            options.repairSeconds = atof(value);
+        } else if (strcmp(arg, "--jobs") == 0) {
+            options.jobs = atoi(value);
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            fprintf(stderr, "Unknown or incomplete faults option: %s %s\n", arg, value);
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    return runFaultInjection(options);
+}
+
+// Shared by ota-pack and ota-check: positional paths, then options
+int otaMain(int argc, char** argv, bool pack) {
+    OtaPackOptions options = defaultOtaPackOptions();
+    const char* paths[2] = {nullptr, nullptr};
+    int pathCount = 0;
+    for (int i = 2; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strncmp(arg, "--", 2) != 0 && pathCount < 2) {
+            paths[pathCount++] = arg;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Unknown or incomplete %s option: %s\n", argv[1], arg);
+            return 2;
+        }
+        const char* value = argv[++i];
+        if (strcmp(arg, "--window") == 0) {
+            options.windowBits = (uint8_t)atoi(value);
+        } else if (strcmp(arg, "--lookahead") == 0) {
+            options.lookaheadBits = (uint8_t)atoi(value);
+        } else if (strcmp(arg, "--link-kbps") == 0 && !pack) {
+            options.linkKBytesPerSecond = atof(value);
+        } else {
+            fprintf(stderr, "Unknown or incomplete %s option: %s %s\n", argv[1], arg, value);
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (options.windowBits < COMPRESSED_MIN_WINDOW_BITS || options.windowBits > COMPRESSED_MAX_WINDOW_BITS ||
+        options.lookaheadBits < COMPRESSED_MIN_LOOKAHEAD_BITS || options.lookaheadBits >= options.windowBits) {
+        fprintf(stderr, "Window must be %u..%u bits, lookahead %u bits up to one less than the window\n",
+                COMPRESSED_MIN_WINDOW_BITS, COMPRESSED_MAX_WINDOW_BITS, COMPRESSED_MIN_LOOKAHEAD_BITS);
+        return 2;
+    }
+    if (pack) {
+        if (pathCount != 2) {
+            printUsage(argv[0]);
+            return 2;
+        }
+        return runOtaPack(paths[0], paths[1], options);
+    }
+    return runOtaCheck(paths[0], options);
+}
+
+int controlMain(int argc, char** argv) {
+    RemoteClientOptions options = defaultRemoteClientOptions();
+    for (int i = 2; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strncmp(arg, "--", 2) != 0) {
+            if (options.commandCount == MAX_REMOTE_CLIENT_COMMANDS) {
+                fprintf(stderr, "At most %d commands\n", MAX_REMOTE_CLIENT_COMMANDS);
+                return 2;
+            }
+            options.commands[options.commandCount++] = arg;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Unknown or incomplete control option: %s\n", arg);
+            return 2;
+        }
+        const char* value = argv[++i];
+        if (strcmp(arg, "--host") == 0) {
+            options.host = value;
+        } else if (strcmp(arg, "--port") == 0) {
+            options.port = (uint16_t)atoi(value);
+        } else if (strcmp(arg, "--repeat") == 0 && atoi(value) > 0) {
+            options.repeat = atoi(value);
+        } else {
+            fprintf(stderr, "Unknown or incomplete control option: %s %s\n", arg, value);
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (options.commandCount == 0) {
+        options.commands[options.commandCount++] = "status";
+    }
+    return runRemoteClient(options);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return benchMain(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "sweep") == 0) {
+        return sweepMain(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "faults") == 0) {
+        return faultsMain(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "ota-pack") == 0) {
+        return otaMain(argc, argv, true);
+    }
+    if (argc > 1 && strcmp(argv[1], "ota-check") == 0) {
+        return otaMain(argc, argv, false);
+    }
+    if (argc > 1 && strcmp(argv[1], "control") == 0) {
+        return controlMain(argc, argv);
+    }
+
+    SimulationOptions options = defaultSimulationOptions();
+    ReplayArguments replayArguments = {nullptr, nullptr, -1};
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--help") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (!parseOption(argc, argv, i, options, replayArguments)) {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", argv[i]);
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    SensorReplay replay;
+    if (replayArguments.path != nullptr) {
+        if (!loadReplay(replayArguments, replay)) {
+            return 2;
+        }
+        options.replay = &replay;
+    }
+
+    SimulationReport report;
+    bool completed = runSimulation(options, report);
+
+    printConfiguration(stdout);
+    printSimulationReport(options, report, stdout);
+    return completed ? 0 : 1;
+}
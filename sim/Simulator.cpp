@@ -0,0 +1,665 @@
+#include "Simulator.h"
+#include <Arduino.h>
+#include <Hal.h>
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#include "Config/Config.h"
+#include "Metrics/Metrics.h"
+#include "Diagnostics/SensorTrace.h"
+#include "Console/SerialConsole.h"
+
+//* ************************************************************************
+//* ************************ SIMULATOR ************************************
+//* ************************************************************************
+
+extern SystemState currentState;
+
+SimulationOptions defaultSimulationOptions() {
+    SimulationOptions options;
+    options.maxSeconds = 3600.0;
+    options.boards = 3;
+    options.reloadSeconds = 20.0;
+    options.stallSeconds = 120.0;
+    options.reloadEveryPieces = 0;
+    options.reloadHoldSeconds = 10.0;
+    options.errorEveryPieces = 0;
+    options.reactionSeconds = 2.0;
+    options.verbose = false;
+    options.remoteControl = false;
+    options.machine = defaultMachineParameters();
+    options.fault.fault = FAULT_NONE;
+    options.fault.phase = CUTTING;
+    options.fault.phaseDelaySeconds = 0.0;
+    options.fault.afterPieces = 2;
+    options.fault.repairSeconds = 20.0;
+    options.fault.safeHoldSeconds = 1.0;
+    options.replay = nullptr;
+    options.traceOutPath = nullptr;
+    options.consoleLineCount = 0;
+    return options;
+}
+
+namespace {
+
+const uint64_t NS_PER_SECOND = 1000000000ULL;
+
+uint64_t secondsToNs(double seconds) {
+    return (uint64_t)(seconds * NS_PER_SECOND);
+}
+
+double nsToSeconds(uint64_t ns) {
+    return ns / (double)NS_PER_SECOND;
+}
+
+uint32_t errorCountTotal() {
+    MetricsSnapshot snapshot;
+    getMetricsSnapshot(snapshot);
+    uint32_t total = 0;
+    for (int i = 0; i < ERROR_COUNTER_COUNT; i++) {
+        total += snapshot.errorCounts[i];
+    }
+    return total;
+}
+
+// Print into a host file, for the firmware's text renderers
+class FilePrint : public Print {
+   public:
+    explicit FilePrint(FILE* file) : _file(file) {}
+    size_t write(uint8_t c) override { return fputc(c, _file) == EOF ? 0 : 1; }
+    size_t write(const uint8_t* buffer, size_t size) override { return fwrite(buffer, 1, size, _file); }
+
+   private:
+    FILE* _file;
+};
+
+// Swallows replies nobody reads
+class NullPrint : public Print {
+   public:
+    size_t write(uint8_t c) override {
+        (void)c;
+        return 1;
+    }
+};
+
+// Where the injected fault is in its life
+enum FaultStage {
+    FAULT_STAGE_WAITING,        // Not injected yet
+    FAULT_STAGE_SCHEDULED,      // Phase reached, waiting out the delay
+    FAULT_STAGE_ACTIVE,
+    FAULT_STAGE_REPAIRED,       // Cleared, waiting for the next piece
+    FAULT_STAGE_DONE
+};
+
+// What the scripted operator is doing
+enum OperatorTask {
+    OPERATOR_RUNNING,           // Start switch on, machine cycling
+    OPERATOR_LOADING,           // Loading the next board after NOWOOD
+    OPERATOR_WAIT_FOR_IDLE,     // Start switch off, waiting for the cycle to finish
+    OPERATOR_PRESS_RELOAD,
+    OPERATOR_HOLD_RELOAD,
+    OPERATOR_WAIT_TO_RESTART,   // Reload released, waiting for IDLE
+    OPERATOR_RESTART,
+    OPERATOR_DONE
+};
+
+// Tracks state visits, cycles and the scripted operator
+class RunObserver {
+   public:
+    RunObserver(const SimulationOptions& options, MachineModel& machine, SimulationReport& report)
+        : _options(options), _machine(machine), _report(report),
+          _state(currentState), _stateSinceNs(0), _lastChangeNs(0),
+          _cycleStartNs(0), _cycleOpen(false),
+          _task(OPERATOR_RUNNING), _actionAtNs(0), _holdNs(0),
+          _errorAtNs(0), _errorOpen(false), _errorArmed(false),
+          _faultStage(options.fault.fault == FAULT_NONE ? FAULT_STAGE_DONE : FAULT_STAGE_WAITING),
+          _faultAtNs(0), _repairAtNs(0), _errorsBeforeFault(0) {}
+
+    // Power-on faults are in place before setup() runs
+    void beforeStartup() {
+        if (_faultStage == FAULT_STAGE_WAITING && _options.fault.phase == STARTUP) {
+            injectFault(0, STARTUP);
+        }
+    }
+
+    // Fault timing - also called between loop()s during startup
+    void checkFault(uint64_t nowNs) {
+        if (_faultStage == FAULT_STAGE_SCHEDULED && nowNs >= _faultAtNs) {
+            injectFault(nowNs, currentState);
+        }
+        if (_faultStage != FAULT_STAGE_ACTIVE) {
+            return;
+        }
+        FaultOutcome& outcome = _report.fault;
+        if (outcome.safeState == SAFE_NEVER) {
+            uint64_t stoppedNs = std::max(_machine.lastStepNs(), _faultAtNs);
+            if (currentState == ERROR) {
+                outcome.safeState = SAFE_ERROR_STATE;
+                outcome.safeSeconds = nsToSeconds(nowNs - _faultAtNs);
+            } else if (nowNs - stoppedNs >= secondsToNs(_options.fault.safeHoldSeconds)) {
+                outcome.safeState = SAFE_STOPPED;
+                outcome.safeSeconds = nsToSeconds(stoppedNs - _faultAtNs);
+            }
+        }
+        if (nowNs >= _repairAtNs) {
+            //! Repair: the hardware works again from here on
+            _machine.setFault(FAULT_NONE);
+            outcome.errorCounted = errorCountTotal() != _errorsBeforeFault;
+            _faultStage = FAULT_STAGE_REPAIRED;
+        }
+    }
+
+    // Power-on errors: the operator acknowledges them like any other, as
+    // often as the recovery fails
+    void runStartupOperator(uint64_t nowNs) {
+        if (currentState == ERROR && (_task == OPERATOR_RUNNING || _task == OPERATOR_WAIT_TO_RESTART)) {
+            _holdNs = secondsToNs(0.5);
+            schedule(OPERATOR_PRESS_RELOAD, nowNs, _options.reactionSeconds);
+        }
+        runOperator(nowNs);
+    }
+
+    void startProduction(uint64_t nowNs) {
+        _state = currentState;
+        _stateSinceNs = nowNs;
+        _lastChangeNs = nowNs;
+        _report.phases[_state].visits++;
+        if (_task == OPERATOR_RUNNING) {
+            setStart(true);
+        }
+    }
+
+    // Called after every loop(); returns false once the run is over
+    bool afterLoop(uint64_t nowNs) {
+        if (currentState != _state) {
+            onTransition(_state, currentState, nowNs);
+        }
+        checkFault(nowNs);
+        runOperator(nowNs);
+        if (nowNs - _lastChangeNs > secondsToNs(_options.stallSeconds)) {
+            _report.stalled = true;
+            return false;
+        }
+        return _task != OPERATOR_DONE && !_report.fault.recovered;
+    }
+
+    void finish(uint64_t nowNs) {
+        _report.phases[_state].totalNs += nowNs - _stateSinceNs;
+        if (_faultStage == FAULT_STAGE_ACTIVE) {
+            _report.fault.errorCounted = errorCountTotal() != _errorsBeforeFault;
+        }
+        if (_cycles.empty()) {
+            return;
+        }
+        std::sort(_cycles.begin(), _cycles.end());
+        _report.cycleP50Ns = _cycles[(_cycles.size() - 1) / 2];
+        _report.cycleP95Ns = _cycles[(_cycles.size() * 95 + 99) / 100 - 1];
+    }
+
+   private:
+    void onTransition(SystemState from, SystemState to, uint64_t nowNs) {
+        _report.phases[from].totalNs += nowNs - _stateSinceNs;
+        _report.phases[to].visits++;
+        _state = to;
+        _stateSinceNs = nowNs;
+        _lastChangeNs = nowNs;
+
+        if (from == YESWOOD && _cycleOpen) {
+            uint64_t cycleNs = nowNs - _cycleStartNs;
+            _cycles.push_back(cycleNs);
+            _report.yeswoodCycles++;
+            _report.cycleSumNs += cycleNs;
+            if (_report.cycleMinNs == 0 || cycleNs < _report.cycleMinNs) _report.cycleMinNs = cycleNs;
+            if (cycleNs > _report.cycleMaxNs) _report.cycleMaxNs = cycleNs;
+            _cycleOpen = false;
+        }
+        if (_faultStage == FAULT_STAGE_WAITING && to == _options.fault.phase &&
+            (int)_report.pieces >= _options.fault.afterPieces) {
+            _faultStage = FAULT_STAGE_SCHEDULED;
+            _faultAtNs = nowNs + secondsToNs(_options.fault.phaseDelaySeconds);
+        }
+        if (to == CUTTING) {
+            _cycleStartNs = nowNs;
+            _cycleOpen = true;
+            if (_errorArmed) {
+                //! Fault: fail the cycle before CUTTING runs its first step
+                _errorArmed = false;
+                _cycleOpen = false;
+                triggerCutMotorHomeError();
+            }
+        }
+        if (from == CUTTING && to == YESWOOD) {
+            onPiece(nowNs);
+        }
+        if (from == CUTTING && to == NOWOOD) {
+            _report.emptyCuts++;
+            _cycleOpen = false;
+            //! Operator: board used up - stop the machine before it re-cycles
+            setStart(false);
+        }
+        if (from == NOWOOD && to == IDLE) {
+            //! Operator: load the next board, or end the run
+            if ((int)_machine.observations().boardsLoaded < _options.boards) {
+                schedule(OPERATOR_LOADING, nowNs, _options.reloadSeconds);
+            } else {
+                _task = OPERATOR_DONE;
+            }
+        }
+        if (to == ERROR) {
+            //! Operator: stop, then clear the error with the reload switch
+            _report.errors++;
+            _errorAtNs = nowNs;
+            _errorOpen = true;
+            setStart(false);
+            _holdNs = secondsToNs(0.5);
+            schedule(OPERATOR_PRESS_RELOAD, nowNs, _options.reactionSeconds);
+        }
+        if (to == IDLE && _task == OPERATOR_WAIT_FOR_IDLE) {
+            _report.reloads++;
+            _holdNs = secondsToNs(_options.reloadHoldSeconds);
+            schedule(OPERATOR_PRESS_RELOAD, nowNs, _options.reactionSeconds);
+        }
+    }
+
+    void onPiece(uint64_t nowNs) {
+        _report.pieces++;
+        if (_faultStage == FAULT_STAGE_ACTIVE) {
+            _report.fault.piecesWhileFaulty++;
+        } else if (_faultStage == FAULT_STAGE_REPAIRED) {
+            //! Back in production - the fault run is over
+            _report.fault.recovered = true;
+            _report.fault.recoverySeconds = nsToSeconds(nowNs - _repairAtNs);
+            _report.fault.downtimeSeconds = nsToSeconds(nowNs - _faultAtNs);
+            _faultStage = FAULT_STAGE_DONE;
+        }
+        if (_errorOpen) {
+            _errorOpen = false;
+            _report.recoveries++;
+            _report.recoverySumNs += nowNs - _errorAtNs;
+        }
+        if (_options.errorEveryPieces > 0 && _report.pieces % _options.errorEveryPieces == 0) {
+            _errorArmed = true;
+        }
+        if (_options.reloadEveryPieces > 0 && _report.pieces % _options.reloadEveryPieces == 0) {
+            //! Operator: switch off and let YESWOOD finish, then RELOAD
+            setStart(false);
+            _task = OPERATOR_WAIT_FOR_IDLE;
+        }
+    }
+
+    void injectFault(uint64_t nowNs, SystemState state) {
+        _machine.setFault(_options.fault.fault);
+        _faultStage = FAULT_STAGE_ACTIVE;
+        _faultAtNs = nowNs;
+        _repairAtNs = nowNs + secondsToNs(_options.fault.repairSeconds);
+        _errorsBeforeFault = errorCountTotal();
+        _report.fault.injected = true;
+        _report.fault.injectedAtSeconds = nsToSeconds(nowNs);
+        _report.fault.injectedIn = state;
+    }
+
+    //! Operator start/stop: the start switch, or the line controller's
+    //! commands (Control/RemoteControl.h) with the switch left off
+    void setStart(bool on) {
+        if (!_options.remoteControl) {
+            _machine.setStartSwitch(on);
+            return;
+        }
+        NullPrint replies;
+        executeConsoleLine(on ? "cycle start" : "cycle stop", replies);
+    }
+
+    void schedule(OperatorTask task, uint64_t nowNs, double delaySeconds) {
+        _task = task;
+        _actionAtNs = nowNs + secondsToNs(delaySeconds);
+    }
+
+    void runOperator(uint64_t nowNs) {
+        if (nowNs < _actionAtNs) {
+            return;
+        }
+        switch (_task) {
+            case OPERATOR_LOADING:
+                _machine.loadBoard();
+                setStart(true);
+                _lastChangeNs = nowNs;
+                _task = OPERATOR_RUNNING;
+                break;
+            case OPERATOR_PRESS_RELOAD:
+                _machine.setReloadSwitch(true);
+                _lastChangeNs = nowNs;
+                schedule(OPERATOR_HOLD_RELOAD, nowNs, nsToSeconds(_holdNs));
+                break;
+            case OPERATOR_HOLD_RELOAD:
+                _machine.setReloadSwitch(false);
+                _task = OPERATOR_WAIT_TO_RESTART;
+                break;
+            case OPERATOR_WAIT_TO_RESTART:
+                if (currentState == IDLE) {
+                    schedule(OPERATOR_RESTART, nowNs, _options.reactionSeconds);
+                }
+                break;
+            case OPERATOR_RESTART:
+                setStart(true);
+                _lastChangeNs = nowNs;
+                _task = OPERATOR_RUNNING;
+                break;
+            default:
+                break;
+        }
+    }
+
+    const SimulationOptions& _options;
+    MachineModel& _machine;
+    SimulationReport& _report;
+    SystemState _state;
+    uint64_t _stateSinceNs;
+    uint64_t _lastChangeNs;
+    uint64_t _cycleStartNs;
+    bool _cycleOpen;
+    std::vector<uint64_t> _cycles;
+    OperatorTask _task;
+    uint64_t _actionAtNs;
+    uint64_t _holdNs;
+    uint64_t _errorAtNs;
+    bool _errorOpen;
+    bool _errorArmed;
+    FaultStage _faultStage;
+    uint64_t _faultAtNs;        // Scheduled, then actual injection time
+    uint64_t _repairAtNs;
+    uint32_t _errorsBeforeFault;
+};
+
+} // namespace
+
+//* ************************************************************************
+//* ************************ RUN ******************************************
+//* ************************************************************************
+
+bool runSimulation(const SimulationOptions& options, SimulationReport& report) {
+    report = SimulationReport();
+    auto wallStart = std::chrono::steady_clock::now();
+
+    //! Step 1: Host setup - virtual time, no background tasks, no sockets
+    hal::markLoopThread();
+    hal::setVirtualTime(true);
+    hal::setTasksEnabled(false);
+    hal::setNetworkEnabled(true);      // The link is up, but the WiFi and server tasks never run
+    hal::setSerialEcho(options.verbose);
+    EMERGENCY_STOP_INSTALLED = true;   // The model reads the stop loop closed (MachineModel.cpp)
+
+    MachineModel machine(options.machine);
+    machine.setReplay(options.replay);
+    hal::setModel(&machine);
+    machine.loadBoard();
+    RunObserver observer(options, machine, report);
+
+    //! Step 2: Power-on - setup() and homing until the first IDLE
+    observer.beforeStartup();
+    setup();
+    const uint64_t startupLimitNs = secondsToNs(options.stallSeconds);
+    while (currentState != IDLE) {
+        loop();
+        observer.checkFault(hal::nowNanos());
+        observer.runStartupOperator(hal::nowNanos());
+        if (hal::nowNanos() > startupLimitNs) {
+            report.stalled = true;
+            break;
+        }
+    }
+    FilePrint console(stdout);
+    for (int i = 0; i < options.consoleLineCount; i++) {
+        if (!executeConsoleLine(options.consoleLines[i], console)) {
+            printf("Unknown console command: %s\n", options.consoleLines[i]);
+        }
+    }
+    uint64_t productionStartNs = hal::nowNanos();
+    report.startupSeconds = nsToSeconds(productionStartNs);
+
+    //! Step 3: Production
+    machine.startProduction();
+    observer.startProduction(productionStartNs);
+    const uint64_t endNs = productionStartNs + secondsToNs(options.maxSeconds);
+    const uint64_t busyStartNs = hal::busyNanos();
+    const std::clock_t cpuStart = std::clock();
+    uint64_t lastLoopNs = productionStartNs;
+    while (!report.stalled) {
+        loop();
+        uint64_t nowNs = hal::nowNanos();
+        report.loopIterations++;
+        if (nowNs - lastLoopNs > report.loopMaxNs) {
+            report.loopMaxNs = nowNs - lastLoopNs;
+        }
+        lastLoopNs = nowNs;
+        if (!observer.afterLoop(nowNs) || nowNs >= endNs) {
+            break;
+        }
+    }
+
+    uint64_t productionEndNs = hal::nowNanos();
+    observer.finish(productionEndNs);
+    if (options.traceOutPath != nullptr) {
+        FILE* file = fopen(options.traceOutPath, "w");
+        if (file != nullptr) {
+            FilePrint out(file);
+            renderSensorTrace(out);
+            fclose(file);
+        } else {
+            fprintf(stderr, "Cannot write %s\n", options.traceOutPath);
+        }
+    }
+    hal::setModel(nullptr);
+
+    report.productionSeconds = nsToSeconds(productionEndNs - productionStartNs);
+    report.busyNs = hal::busyNanos() - busyStartNs;
+    report.hostCpuSeconds = (double)(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    report.finalState = currentState;
+    report.machine = machine.observations();
+    getCatcherServoStats(report.catcherServo);
+    report.fault.piecesDropped = report.machine.piecesDropped;
+    report.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    return !report.stalled;
+}
+
+//* ************************************************************************
+//* ************************ FORKED RUNS **********************************
+//* ************************************************************************
+//! The firmware's globals and statics allow one simulation per process,
+//! so every run gets a fresh child and sends its report back over a pipe.
+
+namespace {
+
+struct ForkedChild {
+    pid_t pid;
+    int pipe;
+    int index;
+};
+
+void collectChild(const ForkedChild& child, SimulationReport reports[], bool completed[]) {
+    size_t received = 0;
+    char* buffer = (char*)&reports[child.index];
+    ssize_t n;
+    while (received < sizeof(SimulationReport) &&
+           (n = read(child.pipe, buffer + received, sizeof(SimulationReport) - received)) > 0) {
+        received += n;
+    }
+    close(child.pipe);
+    int status = 0;
+    waitpid(child.pid, &status, 0);
+    completed[child.index] = received == sizeof(SimulationReport) && WIFEXITED(status) &&
+                             WEXITSTATUS(status) == 0 && !reports[child.index].stalled;
+}
+
+} // namespace
+
+void runSimulationsForked(int count, int jobs, ForkedRunSetup setup, void* context,
+                          SimulationReport reports[], bool completed[]) {
+    std::vector<ForkedChild> running;
+    if (jobs < 1) {
+        jobs = 1;
+    }
+    for (int i = 0; i < count; i++) {
+        completed[i] = false;
+        memset(&reports[i], 0, sizeof(SimulationReport));
+
+        //! Step 1: Wait for a free slot - oldest child first keeps it simple
+        if ((int)running.size() >= jobs) {
+            collectChild(running.front(), reports, completed);
+            running.erase(running.begin());
+        }
+
+        //! Step 2: Fork the run
+        int fds[2];
+        if (pipe(fds) != 0) {
+            continue;
+        }
+        fflush(stdout);
+        fflush(stderr);
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            SimulationOptions options = defaultSimulationOptions();
+            setup(i, options, context);
+            SimulationReport report;
+            runSimulation(options, report);
+            ssize_t written = write(fds[1], &report, sizeof(report));
+            _exit(written == (ssize_t)sizeof(report) ? 0 : 1);
+        }
+        close(fds[1]);
+        if (pid < 0) {
+            close(fds[0]);
+            continue;
+        }
+        running.push_back({pid, fds[0], i});
+    }
+
+    //! Step 3: Collect the rest
+    for (const ForkedChild& child : running) {
+        collectChild(child, reports, completed);
+    }
+}
+
+//* ************************************************************************
+//* ************************ RESULTS **************************************
+//* ************************************************************************
+
+double piecesPerHour(const SimulationReport& report) {
+    return report.productionSeconds > 0 ? report.pieces * 3600.0 / report.productionSeconds : 0.0;
+}
+
+double meanCycleSeconds(const SimulationReport& report) {
+    return report.yeswoodCycles ? nsToSeconds(report.cycleSumNs) / report.yeswoodCycles : 0.0;
+}
+
+double meanPhaseSeconds(const SimulationReport& report, SystemState state) {
+    const PhaseStats& phase = report.phases[state];
+    return phase.visits ? nsToSeconds(phase.totalNs) / phase.visits : 0.0;
+}
+
+double meanRecoverySeconds(const SimulationReport& report) {
+    return report.recoveries ? nsToSeconds(report.recoverySumNs) / report.recoveries : 0.0;
+}
+
+const char* safeStateName(SafeStateKind kind) {
+    switch (kind) {
+        case SAFE_ERROR_STATE: return "ERROR state";
+        case SAFE_STOPPED: return "stopped";
+        default: return "never";
+    }
+}
+
+void printConfiguration(FILE* out) {
+    fprintf(out, "Configuration (Config.cpp):\n");
+    fprintf(out, "  cut motor       cut %.0f steps/s @ %.0f steps/s^2, return %.0f @ %.0f, %d steps/in, stroke %.2f in\n",
+            CUT_MOTOR_CUTTING_SPEED, CUT_MOTOR_NORMAL_ACCELERATION, CUT_MOTOR_RETURN_SPEED,
+            CUT_MOTOR_RETURN_ACCELERATION, CUT_MOTOR_STEPS_PER_INCH, CUT_TRAVEL_DISTANCE);
+    fprintf(out, "  position motor  normal %.0f steps/s @ %.0f steps/s^2, return %.0f, %d steps/in, travel %.2f in\n",
+            POSITION_MOTOR_NORMAL_SPEED, POSITION_MOTOR_NORMAL_ACCELERATION, POSITION_MOTOR_RETURN_SPEED,
+            POSITION_MOTOR_STEPS_PER_INCH, POSITION_TRAVEL_DISTANCE);
+    fprintf(out, "  catcher         clamp offset %.2f in, servo offset %.2f in\n",
+            CATCHER_CLAMP_EARLY_ACTIVATION_OFFSET_INCHES, CATCHER_SERVO_EARLY_ACTIVATION_OFFSET_INCHES);
+}
+
+void printSimulationReport(const SimulationOptions& options, const SimulationReport& report, FILE* out) {
+    fprintf(out, "Machine model: board %.1f in, clamps extend %lu ms / retract %lu ms, blade contact %.2f in\n",
+            options.machine.boardLengthInches, options.machine.clampExtendMs, options.machine.clampRetractMs,
+            options.machine.bladeContactInches);
+    if (options.replay != nullptr) {
+        fprintf(out, "Replay: %zu recorded edges drive", options.replay->edgeCount());
+        for (uint8_t i = 0; i < FLIGHT_SENSOR_COUNT; i++) {
+            if (options.replay->replays(i)) {
+                fprintf(out, " %s", flightSensorName(i));
+            }
+        }
+        fprintf(out, "\n");
+    }
+    fprintf(out, "\n");
+    fprintf(out, "Virtual time: startup %.2f s, production %.2f s (wall %.2f s, %.0fx real time)%s\n",
+            report.startupSeconds, report.productionSeconds, report.wallSeconds,
+            report.wallSeconds > 0 ? (report.startupSeconds + report.productionSeconds) / report.wallSeconds : 0.0,
+            report.stalled ? "  ** STALLED **" : "");
+    fprintf(out, "Boards: %u, pieces: %u, empty cuts: %u, final state: %s\n",
+            report.machine.boardsLoaded, report.pieces, report.emptyCuts, getStateName(report.finalState));
+    fprintf(out, "Throughput: %.1f pieces/hour\n", piecesPerHour(report));
+    fprintf(out, "Cycle time (CUTTING -> end of YESWOOD): mean %.3f s, p50 %.3f s, p95 %.3f s, min %.3f s, max %.3f s over %u cycles\n",
+            meanCycleSeconds(report), nsToSeconds(report.cycleP50Ns), nsToSeconds(report.cycleP95Ns),
+            nsToSeconds(report.cycleMinNs), nsToSeconds(report.cycleMaxNs), report.yeswoodCycles);
+    if (report.reloads || report.errors) {
+        fprintf(out, "Interruptions: %u reloads, %u errors, mean error recovery %.2f s (ERROR -> next piece)\n",
+                report.reloads, report.errors, meanRecoverySeconds(report));
+    }
+
+    if (report.fault.injected) {
+        const FaultOutcome& fault = report.fault;
+        fprintf(out, "Fault: %s at %.2f s in %s; safe: %s", machineFaultName(options.fault.fault),
+                fault.injectedAtSeconds, getStateName(fault.injectedIn), safeStateName(fault.safeState));
+        if (fault.safeState != SAFE_NEVER) {
+            fprintf(out, " after %.2f s", fault.safeSeconds);
+        }
+        fprintf(out, "; error counted: %s; pieces while faulty: %u\n", fault.errorCounted ? "yes" : "no",
+                fault.piecesWhileFaulty);
+        if (fault.recovered) {
+            fprintf(out, "  repaired after %.1f s, back in production %.2f s later (%.2f s total downtime)\n",
+                    options.fault.repairSeconds, fault.recoverySeconds, fault.downtimeSeconds);
+        } else {
+            fprintf(out, "  no piece produced after the repair\n");
+        }
+    }
+
+    fprintf(out, "\nPhase times:\n");
+    fprintf(out, "  %-20s %8s %12s %12s %7s\n", "state", "visits", "mean s", "total s", "share");
+    for (int i = 0; i < SIM_STATE_COUNT; i++) {
+        const PhaseStats& phase = report.phases[i];
+        if (phase.visits == 0) {
+            continue;
+        }
+        fprintf(out, "  %-20s %8u %12.4f %12.2f %6.1f%%\n", getStateName((SystemState)i), phase.visits,
+                meanPhaseSeconds(report, (SystemState)i), nsToSeconds(phase.totalNs),
+                report.productionSeconds > 0 ? 100.0 * nsToSeconds(phase.totalNs) / report.productionSeconds : 0.0);
+    }
+
+    fprintf(out, "\nMachine:\n");
+    fprintf(out, "  steps: cut %llu, position %llu; clamp actuations %u; servo moves %u\n",
+            (unsigned long long)report.machine.cutSteps, (unsigned long long)report.machine.positionSteps,
+            report.machine.clampActuations, report.machine.servoMoves);
+    fprintf(out, "  wood fed %.1f in; feed slip (carriage moved while position clamp in transit) %.2f in\n",
+            report.machine.woodFedInches, report.machine.feedSlipInches);
+    fprintf(out, "  catcher servo: %u activations, %u before it was home; ready %.2f s after trigger (max %.2f s)\n",
+            report.catcherServo.activations, report.catcherServo.lateActivations,
+            report.catcherServo.lastReadyMs / 1000.0, report.catcherServo.maxReadyMs / 1000.0);
+    fprintf(out, "  blade reached wood before clamps closed: %u\n", report.machine.cutsBeforeClamped);
+    fprintf(out, "  pieces caught %u, dropped %u\n", report.machine.piecesCaught, report.machine.piecesDropped);
+    fprintf(out, "  safety margins: clamps settled %.1f ms before motion (%u violations), "
+                 "catcher engaged %.1f ms before cut end (%u violations)\n",
+            report.machine.minClampMarginMs, report.machine.clampViolations,
+            report.machine.minCatcherMarginMs, report.machine.catcherViolations);
+    fprintf(out, "  loop: %llu iterations, mean period %.2f us, max %.2f ms, CPU busy %.1f%%\n",
+            (unsigned long long)report.loopIterations,
+            report.loopIterations ? report.productionSeconds * 1e6 / report.loopIterations : 0.0,
+            report.loopMaxNs / 1e6,
+            report.productionSeconds > 0 ? 100.0 * nsToSeconds(report.busyNs) / report.productionSeconds : 0.0);
+}
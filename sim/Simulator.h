@@ -0,0 +1,141 @@
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "MachineModel.h"
+#include "SensorReplay.h"
+#include "StateMachine/StateMachine.h"
+#include "StateMachine/CatcherServo.h"
+
+//* ************************************************************************
+//* ************************ SIMULATOR HEADER *****************************
+//* ************************************************************************
+//! Runs the unchanged firmware (setup()/loop()) on virtual time against the
+//! machine model, with a scripted operator: the start switch stays on while
+//! there is wood, and a new board is loaded after every NOWOOD. Optionally
+//! the operator also stops for a RELOAD every few pieces, and a cut motor
+//! home error can be injected at the start of every few cycles; the
+//! operator then clears it with the reload switch and restarts.
+//!
+//! A fault plan breaks one piece of machine hardware (MachineFault) at a
+//! chosen point of the cycle, keeps it broken for a repair time and then
+//! measures how long the machine took to reach a safe state and to get
+//! back to producing pieces.
+//!
+//! A sensor trace recorded on the floor can replace the modelled inputs
+//! (SensorReplay), and the simulated run's own trace can be written out in
+//! the same format.
+//!
+//! The firmware keeps its state in globals and function statics, so one
+//! process runs exactly one simulation. Tools that need several runs fork.
+
+const int SIM_STATE_COUNT = ERROR_RESET + 1;
+
+// One hardware fault, injected once
+struct FaultPlan {
+    MachineFault fault;         // FAULT_NONE = no fault
+    SystemState phase;          // Inject on entering this state (STARTUP = at power-on)
+    double phaseDelaySeconds;   // ... this long after entering it
+    int afterPieces;            // ... once this many pieces are done
+    double repairSeconds;       // Fault cleared this long after injection
+    double safeHoldSeconds;     // Both carriages still this long counts as stopped
+};
+
+const int SIM_MAX_CONSOLE_LINES = 8;
+
+struct SimulationOptions {
+    double maxSeconds;          // Virtual production time limit
+    int boards;                 // Boards to cut before stopping
+    double reloadSeconds;       // Operator time to load the next board
+    double stallSeconds;        // Stop if the state does not change for this long
+    int reloadEveryPieces;      // Stop for a RELOAD after this many pieces (0 = never)
+    double reloadHoldSeconds;   // How long the reload switch is held for a RELOAD
+    int errorEveryPieces;       // Inject an error at the next CUTTING after this many pieces (0 = never)
+    double reactionSeconds;     // Operator delay before pressing a switch
+    bool verbose;               // Echo the firmware's Serial output
+    bool remoteControl;         // Operator starts and stops with "cycle" commands, start switch left off
+    MachineParameters machine;
+    FaultPlan fault;
+    SensorReplay* replay;       // Recorded inputs to replay (nullptr = model only)
+    const char* traceOutPath;   // Write the run's sensor trace here (nullptr = don't)
+    const char* consoleLines[SIM_MAX_CONSOLE_LINES];   // Console commands run after homing
+    int consoleLineCount;
+};
+
+SimulationOptions defaultSimulationOptions();
+
+struct PhaseStats {
+    uint32_t visits;
+    uint64_t totalNs;
+};
+
+// How the firmware reached a safe state after a fault
+enum SafeStateKind {
+    SAFE_NEVER,                 // Kept moving until the repair
+    SAFE_ERROR_STATE,           // Entered ERROR
+    SAFE_STOPPED                // Both carriages stopped (stalled or waiting)
+};
+
+struct FaultOutcome {
+    bool injected;
+    double injectedAtSeconds;   // Virtual time since power-on
+    SystemState injectedIn;
+    bool errorCounted;          // The firmware recorded an error counter while the fault was active
+    SafeStateKind safeState;
+    double safeSeconds;         // Injection to ERROR, or to the last step before stopping
+    bool recovered;             // A piece was produced after the repair
+    double recoverySeconds;     // Repair to the next piece
+    double downtimeSeconds;     // Injection to the next piece after the repair
+    uint32_t piecesWhileFaulty; // YESWOOD cycles while the fault was active
+    uint32_t piecesDropped;     // Cut pieces the catcher did not hold, whole run
+};
+
+struct SimulationReport {
+    double startupSeconds;      // Power-on to the first IDLE (WiFi wait + homing)
+    double productionSeconds;   // First IDLE to the end of the run
+    double wallSeconds;
+    uint32_t pieces;            // Cuts with wood (YESWOOD)
+    uint32_t emptyCuts;         // Cuts without wood (NOWOOD)
+    uint32_t yeswoodCycles;     // CUTTING entry to leaving YESWOOD
+    uint64_t cycleSumNs;
+    uint64_t cycleMinNs;
+    uint64_t cycleMaxNs;
+    uint64_t cycleP50Ns;
+    uint64_t cycleP95Ns;
+    uint32_t reloads;           // Operator RELOAD interruptions
+    uint32_t errors;            // Injected errors
+    uint32_t recoveries;        // Errors followed by another piece
+    uint64_t recoverySumNs;     // ERROR entry to the next piece
+    PhaseStats phases[SIM_STATE_COUNT];
+    uint64_t loopIterations;
+    uint64_t loopMaxNs;
+    uint64_t busyNs;            // Virtual CPU time during production (excludes delay())
+    double hostCpuSeconds;      // Host CPU spent simulating production
+    bool stalled;
+    SystemState finalState;
+    MachineObservations machine;
+    CatcherServoStats catcherServo;   // Firmware's own count (StateMachine/CatcherServo.h)
+    FaultOutcome fault;
+};
+
+bool runSimulation(const SimulationOptions& options, SimulationReport& report);
+
+// Runs count simulations in forked children, at most jobs at a time.
+// setup(index, options, context) runs in the child before its simulation
+// and may also rewrite CONFIG_TUNABLE values. completed[i] is false when
+// the child failed or the run stalled.
+typedef void (*ForkedRunSetup)(int index, SimulationOptions& options, void* context);
+void runSimulationsForked(int count, int jobs, ForkedRunSetup setup, void* context,
+                          SimulationReport reports[], bool completed[]);
+
+double piecesPerHour(const SimulationReport& report);
+double meanCycleSeconds(const SimulationReport& report);
+double meanPhaseSeconds(const SimulationReport& report, SystemState state);
+double meanRecoverySeconds(const SimulationReport& report);
+const char* safeStateName(SafeStateKind kind);
+
+void printConfiguration(FILE* out);
+void printSimulationReport(const SimulationOptions& options, const SimulationReport& report, FILE* out);
+
+#endif // SIMULATOR_H
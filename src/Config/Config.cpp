@@ -20,85 +20,111 @@ const int CATCHER_SERVO_ACTIVE_POSITION = 90;   // Position when activated (degr
 const int CUT_MOTOR_MIN_PULSE_WIDTH = 3;
 const int POSITION_MOTOR_MIN_PULSE_WIDTH = 3;
 
-// Motor step calculations and travel distances
-const int CUT_MOTOR_STEPS_PER_INCH = 500;
-const int POSITION_MOTOR_STEPS_PER_INCH = 1000; // Steps per inch for position motor
-const float CUT_TRAVEL_DISTANCE = 9.0; // inches
-const float POSITION_TRAVEL_DISTANCE = 3.4; // inches
-const float CUT_MOTOR_INCREMENTAL_MOVE_INCHES = 0.1; // Inches for incremental reverse
-const float CUT_MOTOR_MAX_INCREMENTAL_MOVE_INCHES = 0.4; // Max inches for incremental reverse before error
+// Step calculations and fixed step positions are constexpr in Config.h
 
-// Motor homing direction constants
-const int CUT_HOMING_DIRECTION = -1;
-const int POSITION_HOMING_DIRECTION = 1;
-
-// Motor homing distance constants
-const long CUT_MOTOR_HOMING_DISTANCE = 10000;      // Maximum distance to travel during homing
-const long POSITION_MOTOR_HOMING_DISTANCE = 10000; // Maximum distance to travel during homing (in steps)
-
-// Calculated motor positions
-const long CUT_MOTOR_CUT_POSITION = (long)(CUT_TRAVEL_DISTANCE * CUT_MOTOR_STEPS_PER_INCH);  // = 9.0 * 500 = 4500
-const long POSITION_MOTOR_TRAVEL_POSITION = (long)(POSITION_TRAVEL_DISTANCE * POSITION_MOTOR_STEPS_PER_INCH);  // = 3.4 * 1000 = 3400
-const float STEPS_PER_INCH_POSITION = (float)POSITION_MOTOR_STEPS_PER_INCH;  // = 1000
+// Travel distances (the active cutting recipe's)
+CONFIG_TUNABLE float CUT_TRAVEL_DISTANCE = 9.0; // inches
+CONFIG_TUNABLE float POSITION_TRAVEL_DISTANCE = 3.4; // inches
 
 //* ************************************************************************
 //* ************************ CUT MOTOR SPEED SETTINGS ********************
 //* ************************************************************************
 // Normal Cutting Operation (Cutting State)
-const float CUT_MOTOR_CUTTING_SPEED = 700;      // Speed for the cutting pass (steps/sec)
-const float CUT_MOTOR_NORMAL_ACCELERATION = 10000; // Acceleration for the cutting pass (steps/sec^2)
+CONFIG_TUNABLE float CUT_MOTOR_CUTTING_SPEED = 700;      // Speed for the cutting pass (steps/sec)
+CONFIG_TUNABLE float CUT_MOTOR_NORMAL_ACCELERATION = 10000; // Acceleration for the cutting pass (steps/sec^2)
 
 // Return Stroke (Returning State / End of Cutting State)
-const float CUT_MOTOR_RETURN_SPEED = 20000;     // Speed for returning after a cut (steps/sec)
-const float CUT_MOTOR_RETURN_ACCELERATION = 30000; // Acceleration for return moves (steps/sec^2)
+CONFIG_TUNABLE float CUT_MOTOR_RETURN_SPEED = 20000;     // Speed for returning after a cut (steps/sec)
+CONFIG_TUNABLE float CUT_MOTOR_RETURN_ACCELERATION = 30000; // Acceleration for return moves (steps/sec^2)
 
 // Homing Operation (Homing State)
-const float CUT_MOTOR_HOMING_SPEED = 1000;      // Speed for homing the cut motor (steps/sec)
+CONFIG_TUNABLE float CUT_MOTOR_HOMING_SPEED = 1000;      // Speed for homing the cut motor (steps/sec)
 
 //* ************************************************************************
 //* ************************ POSITION MOTOR SPEED SETTINGS ***************
 //* ************************************************************************
 // Normal Positioning Operation (Positioning State / Parts of Cutting State)
-const float POSITION_MOTOR_NORMAL_SPEED = 20000;    // Speed for normal positioning moves (steps/sec)
-const float POSITION_MOTOR_NORMAL_ACCELERATION = 20000; // Acceleration for normal positioning (steps/sec^2)
+CONFIG_TUNABLE float POSITION_MOTOR_NORMAL_SPEED = 20000;    // Speed for normal positioning moves (steps/sec)
+CONFIG_TUNABLE float POSITION_MOTOR_NORMAL_ACCELERATION = 20000; // Acceleration for normal positioning (steps/sec^2)
 
 // Return to Home/Start (Returning State / End of Cutting State / Homing after initial move)
-const float POSITION_MOTOR_RETURN_SPEED = 20000;    // Speed for returning to home or start position (steps/sec)
-const float POSITION_MOTOR_RETURN_ACCELERATION = 20000; // Acceleration for return moves (steps/sec^2)
+CONFIG_TUNABLE float POSITION_MOTOR_RETURN_SPEED = 20000;    // Speed for returning to home or start position (steps/sec)
+CONFIG_TUNABLE float POSITION_MOTOR_RETURN_ACCELERATION = 20000; // Acceleration for return moves (steps/sec^2)
 
 // Homing Operation (Homing State)
-const float POSITION_MOTOR_HOMING_SPEED = 1000;     // Speed for homing the position motor (steps/sec)
+CONFIG_TUNABLE float POSITION_MOTOR_HOMING_SPEED = 1000;     // Speed for homing the position motor (steps/sec)
 
 //* ************************************************************************
 //* ************************ TIMING CONFIGURATION *************************
 //* ************************************************************************
 // Servo timing configuration
-const unsigned long CATCHER_SERVO_ACTIVE_HOLD_DURATION_MS = 2000;
+CONFIG_TUNABLE unsigned long CATCHER_SERVO_ACTIVE_HOLD_DURATION_MS = 2000;   // Hold at the active position, from arrival
+CONFIG_TUNABLE unsigned long CATCHER_SERVO_MOVE_DURATION_MS = 150;   // Ramp time of a catcher move (LEDC fade), 0 = jump
+const unsigned long CATCHER_SERVO_SETTLE_MS = 60;   // Horn catch-up after the return fade, before ready
 
 // Catcher clamp timing
-const unsigned long CATCHER_CLAMP_ENGAGE_DURATION_MS = 1500; // 1.5 seconds
-
-// Cylinder timing constants
-const unsigned long CYLINDER_EXTEND_TIME = 500;  // 500ms for cylinder extension
-const unsigned long CYLINDER_RETRACT_TIME = 500; // 500ms for cylinder retraction
+CONFIG_TUNABLE unsigned long CATCHER_CLAMP_ENGAGE_DURATION_MS = 1500; // 1.5 seconds
 
-// Wood caught error check timing
-const unsigned long WOOD_CAUGHT_CHECK_DELAY_MS = 1000; // 1 second delay to check if wood was caught
+// Valve latencies - command to clamp fully extended / fully open (StateMachine/Pneumatics.h)
+CONFIG_TUNABLE unsigned long POSITION_CLAMP_EXTEND_MS = 100;
+CONFIG_TUNABLE unsigned long POSITION_CLAMP_RETRACT_MS = 80;
+CONFIG_TUNABLE unsigned long WOOD_SECURE_CLAMP_EXTEND_MS = 100;
+CONFIG_TUNABLE unsigned long WOOD_SECURE_CLAMP_RETRACT_MS = 80;
+CONFIG_TUNABLE unsigned long CATCHER_CLAMP_EXTEND_MS = 100;
+CONFIG_TUNABLE unsigned long CATCHER_CLAMP_RETRACT_MS = 80;
 
 // Cut motor homing timeout
-const unsigned long CUT_HOME_TIMEOUT = 5000; // 5 seconds timeout
+CONFIG_TUNABLE unsigned long CUT_HOME_TIMEOUT = 5000; // 5 seconds timeout
+
+// YESWOOD cut motor home check
+const unsigned long CUT_HOME_SWITCH_SETTLE_MS = 10;     // Switch given this long before it is read
+const unsigned long CUT_HOME_CONFIRM_TIMEOUT_MS = 200;  // Still open after this: cut motor home error
 
 // Position motor homing timeout
-const unsigned long POSITION_HOME_TIMEOUT = 30000; // 30 seconds timeout for position motor homing
+CONFIG_TUNABLE unsigned long POSITION_HOME_TIMEOUT = 30000; // 30 seconds timeout for position motor homing
 
 // Signal timing
-const unsigned long TA_SIGNAL_DURATION = 150; // Duration for Transfer Arm signal (ms)
+CONFIG_TUNABLE unsigned long TA_SIGNAL_DURATION = 150; // Duration for Transfer Arm signal (ms)
+
+// PUSHWOODFORWARDONE settle delays
+CONFIG_TUNABLE unsigned long PUSHWOOD_SWAP_DELAY_MS = 300;  // After swapping clamps, before advancing
+CONFIG_TUNABLE unsigned long PUSHWOOD_FINAL_DELAY_MS = 50;  // Before the final move to travel position
+
+// Fast stop
+const unsigned long LOOP_WATCHDOG_TIMEOUT_MS = 250;  // Longest loop pass while a stroke is driven
+// The input reads an open loop as pressed, so it stays ignored until the
+// machine has its loop wired; then set true (read once, at setup)
+CONFIG_TUNABLE bool EMERGENCY_STOP_INSTALLED = false;
 
 //* ************************************************************************
 //* ************************ OPERATIONAL CONSTANTS ***********************
 //* ************************************************************************
 // Catcher clamp early activation offset
-const float CATCHER_CLAMP_EARLY_ACTIVATION_OFFSET_INCHES = 1.2; 
+CONFIG_TUNABLE float CATCHER_CLAMP_EARLY_ACTIVATION_OFFSET_INCHES = 1.2; 
 
 // Catcher servo early activation offset
-const float CATCHER_SERVO_EARLY_ACTIVATION_OFFSET_INCHES = 0.85; // Early activation offset for servo rotation
\ No newline at end of file
+CONFIG_TUNABLE float CATCHER_SERVO_EARLY_ACTIVATION_OFFSET_INCHES = 0.85; // Early activation offset for servo rotation
+
+//* ************************************************************************
+//* ************************ DERIVED VALUES *******************************
+//* ************************************************************************
+// The motion plan - worked out by updateDerivedConfig(), first from
+// initConfigRegistry() in setup(), and again whenever a travel distance or
+// offset changes. The firmware reads it only from setup() on.
+long CUT_MOTOR_CUT_POSITION = 0;
+long POSITION_MOTOR_TRAVEL_POSITION = 0;
+long POSITION_MOTOR_ADVANCE_POSITION = 0;
+long POSITION_MOTOR_HOME_SWITCH_POSITION = 0;
+long CATCHER_CLAMP_ACTIVATION_POSITION = 0;
+long CATCHER_SERVO_ACTIVATION_POSITION = 0;
+
+void updateDerivedConfig() {
+    CUT_MOTOR_CUT_POSITION = inchesToSteps(CUT_TRAVEL_DISTANCE, CUT_MOTOR_STEPS_PER_INCH);
+    POSITION_MOTOR_TRAVEL_POSITION = inchesToSteps(POSITION_TRAVEL_DISTANCE, POSITION_MOTOR_STEPS_PER_INCH);
+    POSITION_MOTOR_ADVANCE_POSITION = inchesToSteps(POSITION_TRAVEL_DISTANCE - 0.1f, POSITION_MOTOR_STEPS_PER_INCH);
+    POSITION_MOTOR_HOME_SWITCH_POSITION = POSITION_MOTOR_TRAVEL_POSITION + POSITION_MOTOR_STEPS_PER_INCH;
+    CATCHER_CLAMP_ACTIVATION_POSITION =
+        CUT_MOTOR_CUT_POSITION - inchesToSteps(CATCHER_CLAMP_EARLY_ACTIVATION_OFFSET_INCHES, CUT_MOTOR_STEPS_PER_INCH);
+    CATCHER_SERVO_ACTIVATION_POSITION =
+        CUT_MOTOR_CUT_POSITION - inchesToSteps(CATCHER_SERVO_EARLY_ACTIVATION_OFFSET_INCHES, CUT_MOTOR_STEPS_PER_INCH);
+}
@@ -0,0 +1,504 @@
+#include "Config/ConfigRegistry.h"
+#include "Config/Config.h"
+#include "Console/SerialConsole.h"
+#include "StateMachine/StateMachine.h"
+#include <Preferences.h>
+#include <freertos/semphr.h>
+
+//* ************************************************************************
+//* ************************ CONFIG REGISTRY ******************************
+//* ************************************************************************
+//! Name, bounds and NVS persistence for the CONFIG_TUNABLE globals
+//! Changes from the console and the HTTP task are checked where they
+//! arrive and queued (guarded by pendingMutex); the loop task writes them
+//! between cycles, as it does a recipe selection, so the motion plan never
+//! moves under a running cycle. Every value is one aligned 32-bit word on
+//! the ESP32, so a reader on the other core sees the old or the new value.
+
+namespace {
+
+//* ************************************************************************
+//* ************************ PARAMETER TABLE ******************************
+//* ************************************************************************
+//! Bounds are what the drives, the stroke and the pneumatics allow - wider
+//! than the simulator's sweep space, narrow enough to reject a typo.
+//! Left out: POSITION_MOTOR_RETURN_ACCELERATION (moveMotorTo() always
+//! applies the normal acceleration) and the hold/cylinder/wood-caught
+//! durations nothing reads yet.
+
+const ConfigParameter CONFIG_PARAMETERS[] = {
+    // Cut motor
+    {"CUT_MOTOR_CUTTING_SPEED", "steps/s", CONFIG_FLOAT, &CUT_MOTOR_CUTTING_SPEED, 100, 2000},
+    {"CUT_MOTOR_NORMAL_ACCELERATION", "steps/s^2", CONFIG_FLOAT, &CUT_MOTOR_NORMAL_ACCELERATION, 1000, 60000},
+    {"CUT_MOTOR_RETURN_SPEED", "steps/s", CONFIG_FLOAT, &CUT_MOTOR_RETURN_SPEED, 1000, 30000},
+    {"CUT_MOTOR_RETURN_ACCELERATION", "steps/s^2", CONFIG_FLOAT, &CUT_MOTOR_RETURN_ACCELERATION, 1000, 60000},
+    {"CUT_MOTOR_HOMING_SPEED", "steps/s", CONFIG_FLOAT, &CUT_MOTOR_HOMING_SPEED, 100, 5000},
+
+    // Position motor
+    {"POSITION_MOTOR_NORMAL_SPEED", "steps/s", CONFIG_FLOAT, &POSITION_MOTOR_NORMAL_SPEED, 1000, 50000},
+    {"POSITION_MOTOR_NORMAL_ACCELERATION", "steps/s^2", CONFIG_FLOAT, &POSITION_MOTOR_NORMAL_ACCELERATION, 1000, 60000},
+    {"POSITION_MOTOR_RETURN_SPEED", "steps/s", CONFIG_FLOAT, &POSITION_MOTOR_RETURN_SPEED, 1000, 50000},
+    {"POSITION_MOTOR_HOMING_SPEED", "steps/s", CONFIG_FLOAT, &POSITION_MOTOR_HOMING_SPEED, 100, 5000},
+
+    // Activation offsets (inches before the end of the cut stroke)
+    {"CATCHER_CLAMP_EARLY_ACTIVATION_OFFSET_INCHES", "in", CONFIG_FLOAT, &CATCHER_CLAMP_EARLY_ACTIVATION_OFFSET_INCHES, 0, 8},
+    {"CATCHER_SERVO_EARLY_ACTIVATION_OFFSET_INCHES", "in", CONFIG_FLOAT, &CATCHER_SERVO_EARLY_ACTIVATION_OFFSET_INCHES, 0, 8},
+
+    // Timings
+    {"CATCHER_CLAMP_ENGAGE_DURATION_MS", "ms", CONFIG_MILLIS, &CATCHER_CLAMP_ENGAGE_DURATION_MS, 100, 10000},
+    {"CATCHER_SERVO_ACTIVE_HOLD_DURATION_MS", "ms", CONFIG_MILLIS, &CATCHER_SERVO_ACTIVE_HOLD_DURATION_MS, 100, 10000},
+    {"CATCHER_SERVO_MOVE_DURATION_MS", "ms", CONFIG_MILLIS, &CATCHER_SERVO_MOVE_DURATION_MS, 0, 1000},
+    {"POSITION_CLAMP_EXTEND_MS", "ms", CONFIG_MILLIS, &POSITION_CLAMP_EXTEND_MS, 0, 2000},
+    {"POSITION_CLAMP_RETRACT_MS", "ms", CONFIG_MILLIS, &POSITION_CLAMP_RETRACT_MS, 0, 2000},
+    {"WOOD_SECURE_CLAMP_EXTEND_MS", "ms", CONFIG_MILLIS, &WOOD_SECURE_CLAMP_EXTEND_MS, 0, 2000},
+    {"WOOD_SECURE_CLAMP_RETRACT_MS", "ms", CONFIG_MILLIS, &WOOD_SECURE_CLAMP_RETRACT_MS, 0, 2000},
+    {"CATCHER_CLAMP_EXTEND_MS", "ms", CONFIG_MILLIS, &CATCHER_CLAMP_EXTEND_MS, 0, 2000},
+    {"CATCHER_CLAMP_RETRACT_MS", "ms", CONFIG_MILLIS, &CATCHER_CLAMP_RETRACT_MS, 0, 2000},
+    {"TA_SIGNAL_DURATION", "ms", CONFIG_MILLIS, &TA_SIGNAL_DURATION, 20, 2000},
+    {"PUSHWOOD_SWAP_DELAY_MS", "ms", CONFIG_MILLIS, &PUSHWOOD_SWAP_DELAY_MS, 0, 5000},
+    {"PUSHWOOD_FINAL_DELAY_MS", "ms", CONFIG_MILLIS, &PUSHWOOD_FINAL_DELAY_MS, 0, 5000},
+    {"CUT_HOME_TIMEOUT", "ms", CONFIG_MILLIS, &CUT_HOME_TIMEOUT, 1000, 60000},
+    {"POSITION_HOME_TIMEOUT", "ms", CONFIG_MILLIS, &POSITION_HOME_TIMEOUT, 1000, 60000},
+};
+
+const int PARAMETER_COUNT = sizeof(CONFIG_PARAMETERS) / sizeof(CONFIG_PARAMETERS[0]);
+
+//* ************************************************************************
+//* ************************ PERSISTENCE **********************************
+//* ************************************************************************
+
+const char* const NVS_NAMESPACE = "sawconfig";
+const char* const NVS_VALUES_KEY = "values";
+const uint32_t STORED_CONFIG_VERSION = 1;
+
+// Layout of the NVS blob - bump STORED_CONFIG_VERSION when it changes.
+// layout is a hash of the table, so adding, removing or reordering
+// parameters invalidates old blobs instead of loading values into the
+// wrong globals.
+struct StoredConfig {
+    uint32_t version;
+    uint32_t layout;
+    uint32_t values[PARAMETER_COUNT];   // float bits or milliseconds
+};
+
+float defaults[PARAMETER_COUNT];
+
+// Guarded by pendingMutex
+SemaphoreHandle_t pendingMutex = nullptr;
+bool pendingSet[PARAMETER_COUNT] = {false};
+float pendingValues[PARAMETER_COUNT];
+bool pendingSave = false;
+volatile bool configPending = false;
+
+uint32_t tableLayoutHash() {
+    uint32_t hash = 2166136261u;   // FNV-1a
+    for (const ConfigParameter& parameter : CONFIG_PARAMETERS) {
+        for (const char* c = parameter.name; *c; c++) {
+            hash = (hash ^ (uint8_t)*c) * 16777619u;
+        }
+        hash = (hash ^ (uint8_t)parameter.type) * 16777619u;
+    }
+    return hash;
+}
+
+uint32_t storedWord(const ConfigParameter& parameter) {
+    if (parameter.type == CONFIG_MILLIS) {
+        return (uint32_t)*(unsigned long*)parameter.value;
+    }
+    uint32_t word;
+    memcpy(&word, parameter.value, sizeof(word));
+    return word;
+}
+
+float wordValue(const ConfigParameter& parameter, uint32_t word) {
+    if (parameter.type == CONFIG_MILLIS) {
+        return (float)word;
+    }
+    float value;
+    memcpy(&value, &word, sizeof(value));
+    return value;
+}
+
+void writeValue(const ConfigParameter& parameter, float value) {
+    if (parameter.type == CONFIG_MILLIS) {
+        *(unsigned long*)parameter.value = (unsigned long)value;
+    } else {
+        *(float*)parameter.value = value;
+    }
+}
+
+bool inBounds(const ConfigParameter& parameter, float value) {
+    return value >= parameter.minimum && value <= parameter.maximum;
+}
+
+//! The catcher offsets count back from the end of the current cut stroke;
+//! the activation point must land on it, after the 0.3" suction check
+//! (the same rule validateRecipe() applies to a recipe's stroke)
+bool fitsCutStroke(const ConfigParameter& parameter, float value) {
+    if (parameter.value != &CATCHER_CLAMP_EARLY_ACTIVATION_OFFSET_INCHES &&
+        parameter.value != &CATCHER_SERVO_EARLY_ACTIVATION_OFFSET_INCHES) {
+        return true;
+    }
+    return inchesToSteps(CUT_TRAVEL_DISTANCE - value, CUT_MOTOR_STEPS_PER_INCH) > CUT_MOTOR_SAFETY_CHECK_POSITION;
+}
+
+void loadSavedValues() {
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, true)) {
+        return;
+    }
+    StoredConfig stored;
+    size_t length = prefs.getBytes(NVS_VALUES_KEY, &stored, sizeof(stored));
+    prefs.end();
+    if (length == 0) {
+        return;
+    }
+    if (length != sizeof(stored) || stored.version != STORED_CONFIG_VERSION || stored.layout != tableLayoutHash()) {
+        Serial.println("Config: saved values are from another firmware layout, using defaults");
+        return;
+    }
+
+    int changed = 0;
+    for (int i = 0; i < PARAMETER_COUNT; i++) {
+        const ConfigParameter& parameter = CONFIG_PARAMETERS[i];
+        float value = wordValue(parameter, stored.values[i]);
+        //! A bound tightened since the save keeps the default
+        if (!inBounds(parameter, value) || !fitsCutStroke(parameter, value)) {
+            Serial.printf("Config: saved %s out of bounds, using default\n", parameter.name);
+            continue;
+        }
+        if (value != defaults[i]) {
+            changed++;
+        }
+        writeValue(parameter, value);
+    }
+    Serial.printf("Config: loaded saved values, %d differ from defaults\n", changed);
+}
+
+bool checkValue(const ConfigParameter& parameter, float value, char* error, size_t errorSize) {
+    if (!inBounds(parameter, value)) {
+        snprintf(error, errorSize, "%s: %g outside %g..%g %s", parameter.name, value, parameter.minimum,
+                 parameter.maximum, parameter.unit);
+        return false;
+    }
+    if (parameter.type == CONFIG_MILLIS && value != (float)(unsigned long)value) {
+        snprintf(error, errorSize, "%s: whole milliseconds only", parameter.name);
+        return false;
+    }
+    if (!fitsCutStroke(parameter, value)) {
+        snprintf(error, errorSize, "%s: %g in leaves no room on the %g in stroke", parameter.name, value,
+                 CUT_TRAVEL_DISTANCE);
+        return false;
+    }
+    return true;
+}
+
+//* ************************************************************************
+//* ************************ QUEUED CHANGES *******************************
+//* ************************************************************************
+
+// parameter == nullptr: every parameter back to its default
+void queueValue(const ConfigParameter* parameter, float value) {
+    xSemaphoreTake(pendingMutex, portMAX_DELAY);
+    for (int i = 0; i < PARAMETER_COUNT; i++) {
+        if (parameter == nullptr || parameter == &CONFIG_PARAMETERS[i]) {
+            pendingSet[i] = true;
+            pendingValues[i] = parameter == nullptr ? defaults[i] : value;
+        }
+    }
+    configPending = true;
+    xSemaphoreGive(pendingMutex);
+}
+
+void queueSave() {
+    xSemaphoreTake(pendingMutex, portMAX_DELAY);
+    pendingSave = true;
+    configPending = true;
+    xSemaphoreGive(pendingMutex);
+}
+
+const char* whenApplied() {
+    return machineIsAtRest() ? "" : " (applies when the machine is idle)";
+}
+
+//* ************************************************************************
+//* ************************ TEXT INTERFACE *******************************
+//* ************************************************************************
+
+bool parseNumber(const char* text, size_t length, float& value) {
+    char buffer[24];
+    if (length == 0 || length >= sizeof(buffer)) {
+        return false;
+    }
+    memcpy(buffer, text, length);
+    buffer[length] = '\0';
+    char* end;
+    value = strtof(buffer, &end);
+    return *end == '\0';
+}
+
+// Queues name (first nameLength chars) = the text value; prints the outcome
+void setFromText(const char* name, size_t nameLength, const char* valueText, size_t valueLength, Print& out) {
+    char nameBuffer[64];
+    if (nameLength >= sizeof(nameBuffer)) {
+        nameLength = sizeof(nameBuffer) - 1;
+    }
+    memcpy(nameBuffer, name, nameLength);
+    nameBuffer[nameLength] = '\0';
+
+    const ConfigParameter* parameter = findConfigParameter(nameBuffer);
+    if (parameter == nullptr) {
+        out.printf("Unknown parameter: %s\n", nameBuffer);
+        return;
+    }
+    float value;
+    if (!parseNumber(valueText, valueLength, value)) {
+        out.printf("%s: not a number\n", parameter->name);
+        return;
+    }
+    char error[96];
+    if (!checkValue(*parameter, value, error, sizeof(error))) {
+        out.printf("%s\n", error);
+        return;
+    }
+    queueValue(parameter, value);
+    out.printf("%s = %g %s%s\n", parameter->name, value, parameter->unit, whenApplied());
+}
+
+void resetFromText(const char* name, Print& out) {
+    if (*name == '\0') {
+        queueValue(nullptr, 0);
+        out.printf("All parameters reset to defaults (not saved)%s\n", whenApplied());
+        return;
+    }
+    const ConfigParameter* parameter = findConfigParameter(name);
+    if (parameter == nullptr) {
+        out.printf("Unknown parameter: %s\n", name);
+        return;
+    }
+    queueValue(parameter, configDefaultValue(*parameter));
+    out.printf("%s = %g %s (default, not saved)%s\n", parameter->name, configDefaultValue(*parameter),
+               parameter->unit, whenApplied());
+}
+
+void saveFromText(Print& out) {
+    queueSave();
+    out.printf("Config save queued%s\n", whenApplied());
+}
+
+void configConsoleCommand(const char* args, Print& out) {
+    if (strncmp(args, "set ", 4) == 0) {
+        const char* name = args + 4;
+        while (*name == ' ') {
+            name++;
+        }
+        size_t nameLength = strcspn(name, " ");
+        const char* value = name + nameLength;
+        while (*value == ' ') {
+            value++;
+        }
+        setFromText(name, nameLength, value, strcspn(value, " "), out);
+    } else if (strncmp(args, "get ", 4) == 0) {
+        const ConfigParameter* parameter = findConfigParameter(args + 4);
+        if (parameter == nullptr) {
+            out.printf("Unknown parameter: %s\n", args + 4);
+        } else {
+            out.printf("%s = %g %s\n", parameter->name, configValue(*parameter), parameter->unit);
+        }
+    } else if (strcmp(args, "save") == 0) {
+        saveFromText(out);
+    } else if (strncmp(args, "reset", 5) == 0) {
+        const char* name = args + 5;
+        while (*name == ' ') {
+            name++;
+        }
+        resetFromText(name, out);
+    } else {
+        renderConfigValues(out);
+    }
+    //! The console is the loop task - queued changes apply now if at rest
+    handleConfigRequests();
+}
+
+} // namespace
+
+//* ************************************************************************
+//* ************************ SETUP ****************************************
+//* ************************************************************************
+
+void initConfigRegistry() {
+    pendingMutex = xSemaphoreCreateMutex();
+    for (int i = 0; i < PARAMETER_COUNT; i++) {
+        defaults[i] = configValue(CONFIG_PARAMETERS[i]);
+    }
+    loadSavedValues();
+    //! Values may also have been written before setup() (simulator sweep)
+    updateDerivedConfig();
+    registerConsoleCommand("config", configConsoleCommand, "Tunables: 'config [get|set NAME VALUE|save|reset [NAME]]'");
+}
+
+//* ************************************************************************
+//* ************************ LOOKUP ***************************************
+//* ************************************************************************
+
+int configParameterCount() {
+    return PARAMETER_COUNT;
+}
+
+const ConfigParameter* configParameter(int index) {
+    if (index < 0 || index >= PARAMETER_COUNT) {
+        return nullptr;
+    }
+    return &CONFIG_PARAMETERS[index];
+}
+
+const ConfigParameter* findConfigParameter(const char* name) {
+    for (const ConfigParameter& parameter : CONFIG_PARAMETERS) {
+        if (strcasecmp(parameter.name, name) == 0) {
+            return &parameter;
+        }
+    }
+    return nullptr;
+}
+
+float configValue(const ConfigParameter& parameter) {
+    if (parameter.type == CONFIG_MILLIS) {
+        return (float)*(unsigned long*)parameter.value;
+    }
+    return *(float*)parameter.value;
+}
+
+float configDefaultValue(const ConfigParameter& parameter) {
+    return defaults[&parameter - CONFIG_PARAMETERS];
+}
+
+//* ************************************************************************
+//* ************************ CHANGES **************************************
+//* ************************************************************************
+
+bool setConfigValue(const ConfigParameter& parameter, float value, char* error, size_t errorSize) {
+    if (!writeConfigValue(parameter, value, error, errorSize)) {
+        return false;
+    }
+    updateDerivedConfig();
+    return true;
+}
+
+bool writeConfigValue(const ConfigParameter& parameter, float value, char* error, size_t errorSize) {
+    if (!checkValue(parameter, value, error, errorSize)) {
+        return false;
+    }
+    writeValue(parameter, value);
+    return true;
+}
+
+void resetConfigValue(const ConfigParameter* parameter) {
+    for (int i = 0; i < PARAMETER_COUNT; i++) {
+        if (parameter == nullptr || parameter == &CONFIG_PARAMETERS[i]) {
+            writeValue(CONFIG_PARAMETERS[i], defaults[i]);
+        }
+    }
+    updateDerivedConfig();
+}
+
+void handleConfigRequests() {
+    if (!configPending || !machineIsAtRest()) {
+        return;
+    }
+
+    //! Step 1: Take the queue so the HTTP task can keep adding to it
+    bool set[PARAMETER_COUNT];
+    float values[PARAMETER_COUNT];
+    xSemaphoreTake(pendingMutex, portMAX_DELAY);
+    memcpy(set, pendingSet, sizeof(set));
+    memcpy(values, pendingValues, sizeof(values));
+    bool save = pendingSave;
+    memset(pendingSet, 0, sizeof(pendingSet));
+    pendingSave = false;
+    configPending = false;
+    xSemaphoreGive(pendingMutex);
+
+    //! Step 2: Write the values, then the motion plan once. They were checked
+    //! when queued; a recipe applied since may have shortened the stroke
+    char error[96];
+    for (int i = 0; i < PARAMETER_COUNT; i++) {
+        if (set[i] && !writeConfigValue(CONFIG_PARAMETERS[i], values[i], error, sizeof(error))) {
+            Serial.printf("Config: %s, keeping %g\n", error, configValue(CONFIG_PARAMETERS[i]));
+        }
+    }
+    updateDerivedConfig();
+
+    //! Step 3: Save after every change has been applied
+    if (save) {
+        Serial.println(saveConfigValues() ? "Config saved to NVS" : "ERROR: Config NVS write failed");
+    }
+}
+
+bool saveConfigValues() {
+    StoredConfig stored;
+    stored.version = STORED_CONFIG_VERSION;
+    stored.layout = tableLayoutHash();
+    for (int i = 0; i < PARAMETER_COUNT; i++) {
+        stored.values[i] = storedWord(CONFIG_PARAMETERS[i]);
+    }
+
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false)) {
+        return false;
+    }
+    bool written = prefs.putBytes(NVS_VALUES_KEY, &stored, sizeof(stored)) == sizeof(stored);
+    prefs.end();
+    return written;
+}
+
+//* ************************************************************************
+//* ************************ RENDERING ************************************
+//* ************************************************************************
+
+void renderConfigValues(Print& out) {
+    out.print("# name value unit [min..max]; * = changed from the Config.cpp default\n");
+    for (int i = 0; i < PARAMETER_COUNT; i++) {
+        const ConfigParameter& parameter = CONFIG_PARAMETERS[i];
+        float value = configValue(parameter);
+        out.printf("%-45s %10g %-9s [%g..%g]%s\n", parameter.name, value, parameter.unit, parameter.minimum,
+                   parameter.maximum, value != defaults[i] ? " *" : "");
+    }
+    if (configPending) {
+        out.print("Pending changes apply when the machine is idle\n");
+    }
+}
+
+void handleConfigQuery(const char* query, Print& out) {
+    //! Step 1: Queue "NAME=VALUE", "reset=NAME" and "reset" in order; the
+    //! loop task applies them (handleConfigRequests())
+    bool save = false;
+    while (*query) {
+        size_t length = strcspn(query, "&");
+        const char* equals = (const char*)memchr(query, '=', length);
+        if (length == 4 && strncmp(query, "save", 4) == 0) {
+            save = true;
+        } else if (length == 5 && strncmp(query, "reset", 5) == 0) {
+            resetFromText("", out);
+        } else if (equals != nullptr && equals - query == 5 && strncmp(query, "reset", 5) == 0) {
+            char name[64];
+            size_t nameLength = length - 6 < sizeof(name) - 1 ? length - 6 : sizeof(name) - 1;
+            memcpy(name, equals + 1, nameLength);
+            name[nameLength] = '\0';
+            resetFromText(name, out);
+        } else if (equals != nullptr) {
+            setFromText(query, equals - query, equals + 1, length - (equals - query) - 1, out);
+        } else if (length > 0) {
+            out.printf("Ignored: %.*s\n", (int)length, query);
+        }
+        query += length;
+        if (*query == '&') {
+            query++;
+        }
+    }
+
+    //! Step 2: The save runs after every queued change has been applied
+    if (save) {
+        saveFromText(out);
+    }
+    renderConfigValues(out);
+}
@@ -37,6 +37,9 @@ const int FIX_POSITION_BUTTON = 41;              // Manual position adjustment b
 const int WOOD_SENSOR = 10;                      // Reads LOW when wood is detected
 const int WAS_WOOD_SUCTIONED_SENSOR = 39;        // Reads LOW when wood suction is confirmed
 
+// Emergency stop (normally closed loop to ground - input pullup)
+const int EMERGENCY_STOP_SWITCH = 7;             // Reads HIGH when pressed or the loop is broken
+
 //* ************************************************************************
 //* ************************ CLAMP PINS ***********************************
 //* ************************************************************************
@@ -0,0 +1,467 @@
+#include "Config/Recipes.h"
+#include "Config/Config.h"
+#include "Config/ConfigRegistry.h"
+#include "Console/SerialConsole.h"
+#include "StateMachine/StateMachine.h"
+#include "Metrics/PersistentCounters.h"
+#include <Preferences.h>
+#include <freertos/semphr.h>
+
+//* ************************************************************************
+//* ************************ CUTTING RECIPES ******************************
+//* ************************************************************************
+//! Recipe storage, selection and the motion plan switch
+//! The recipe list is edited from the console (loop task) and the HTTP
+//! task, so it is guarded by recipeMutex. Selection is always applied by
+//! the loop task, which owns the motors.
+
+//* ************************************************************************
+//* ************************ TRAVEL BOUNDS ********************************
+//* ************************************************************************
+const float RECIPE_MIN_CUT_TRAVEL_INCHES = 2.0f;
+const float RECIPE_MAX_CUT_TRAVEL_INCHES = 9.5f;       // Cut carriage end stop
+const float RECIPE_MIN_POSITION_TRAVEL_INCHES = 0.5f;
+const float RECIPE_MAX_POSITION_TRAVEL_INCHES = 4.0f;  // Feed cylinder stroke
+
+// External variable declarations
+extern AccelStepper positionMotor;
+extern bool isHomed;
+
+namespace {
+
+//! Registry values a recipe carries besides the two travel distances
+const char* const RECIPE_PARAMETERS[] = {
+    "CUT_MOTOR_CUTTING_SPEED",
+    "CUT_MOTOR_NORMAL_ACCELERATION",
+    "CUT_MOTOR_RETURN_SPEED",
+    "CUT_MOTOR_RETURN_ACCELERATION",
+    "POSITION_MOTOR_NORMAL_SPEED",
+    "POSITION_MOTOR_NORMAL_ACCELERATION",
+    "POSITION_MOTOR_RETURN_SPEED",
+    "CATCHER_CLAMP_EARLY_ACTIVATION_OFFSET_INCHES",
+    "CATCHER_SERVO_EARLY_ACTIVATION_OFFSET_INCHES",
+};
+
+const int RECIPE_PARAMETER_COUNT = sizeof(RECIPE_PARAMETERS) / sizeof(RECIPE_PARAMETERS[0]);
+const char* const DEFAULT_RECIPE_NAME = "default";
+
+struct Recipe {
+    char name[RECIPE_NAME_LENGTH];
+    float cutTravelInches;
+    float positionTravelInches;
+    float values[RECIPE_PARAMETER_COUNT];   // In RECIPE_PARAMETERS order
+};
+
+//* ************************************************************************
+//* ************************ PERSISTENCE **********************************
+//* ************************************************************************
+
+const char* const NVS_NAMESPACE = "sawrecipes";
+const char* const NVS_RECIPES_KEY = "recipes";
+const uint32_t STORED_RECIPES_VERSION = 1;
+
+// Layout of the NVS blob - bump STORED_RECIPES_VERSION when it changes;
+// layout hashes RECIPE_PARAMETERS so a changed list starts empty
+struct StoredRecipes {
+    uint32_t version;
+    uint32_t layout;
+    char active[RECIPE_NAME_LENGTH];
+    uint32_t count;
+    Recipe recipes[MAX_SAVED_RECIPES];
+};
+
+const ConfigParameter* recipeParameters[RECIPE_PARAMETER_COUNT];
+Recipe defaultRecipe;
+
+// Guarded by recipeMutex
+SemaphoreHandle_t recipeMutex = nullptr;
+StoredRecipes stored = {};
+char pendingName[RECIPE_NAME_LENGTH] = "";
+volatile bool recipePending = false;
+
+// Loop task only
+char activeName[RECIPE_NAME_LENGTH] = "";
+
+uint32_t recipeLayoutHash() {
+    uint32_t hash = 2166136261u;   // FNV-1a
+    for (const char* name : RECIPE_PARAMETERS) {
+        for (const char* c = name; *c; c++) {
+            hash = (hash ^ (uint8_t)*c) * 16777619u;
+        }
+        hash = (hash ^ 0xff) * 16777619u;
+    }
+    return hash;
+}
+
+// Caller holds recipeMutex
+bool writeRecipesLocked() {
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false)) {
+        return false;
+    }
+    bool written = prefs.putBytes(NVS_RECIPES_KEY, &stored, sizeof(stored)) == sizeof(stored);
+    prefs.end();
+    return written;
+}
+
+void loadRecipes() {
+    stored = {};
+    Preferences prefs;
+    if (prefs.begin(NVS_NAMESPACE, true)) {
+        StoredRecipes loaded;
+        if (prefs.getBytes(NVS_RECIPES_KEY, &loaded, sizeof(loaded)) == sizeof(loaded) &&
+            loaded.version == STORED_RECIPES_VERSION && loaded.layout == recipeLayoutHash() &&
+            loaded.count <= (uint32_t)MAX_SAVED_RECIPES) {
+            stored = loaded;
+        }
+        prefs.end();
+    }
+    stored.version = STORED_RECIPES_VERSION;
+    stored.layout = recipeLayoutHash();
+}
+
+//* ************************************************************************
+//* ************************ RECIPES **************************************
+//* ************************************************************************
+
+// Caller holds recipeMutex; nullptr if there is no such recipe
+const Recipe* findRecipeLocked(const char* name) {
+    if (strcasecmp(name, DEFAULT_RECIPE_NAME) == 0) {
+        return &defaultRecipe;
+    }
+    for (uint32_t i = 0; i < stored.count; i++) {
+        if (strcasecmp(stored.recipes[i].name, name) == 0) {
+            return &stored.recipes[i];
+        }
+    }
+    return nullptr;
+}
+
+bool validateRecipe(const Recipe& recipe, char* error, size_t errorSize) {
+    if (recipe.cutTravelInches < RECIPE_MIN_CUT_TRAVEL_INCHES || recipe.cutTravelInches > RECIPE_MAX_CUT_TRAVEL_INCHES) {
+        snprintf(error, errorSize, "stroke %g in outside %g..%g in", recipe.cutTravelInches,
+                 RECIPE_MIN_CUT_TRAVEL_INCHES, RECIPE_MAX_CUT_TRAVEL_INCHES);
+        return false;
+    }
+    if (recipe.positionTravelInches < RECIPE_MIN_POSITION_TRAVEL_INCHES ||
+        recipe.positionTravelInches > RECIPE_MAX_POSITION_TRAVEL_INCHES) {
+        snprintf(error, errorSize, "feed %g in outside %g..%g in", recipe.positionTravelInches,
+                 RECIPE_MIN_POSITION_TRAVEL_INCHES, RECIPE_MAX_POSITION_TRAVEL_INCHES);
+        return false;
+    }
+    for (int i = 0; i < RECIPE_PARAMETER_COUNT; i++) {
+        const ConfigParameter& parameter = *recipeParameters[i];
+        if (recipe.values[i] < parameter.minimum || recipe.values[i] > parameter.maximum) {
+            snprintf(error, errorSize, "%s %g outside %g..%g %s", parameter.name, recipe.values[i],
+                     parameter.minimum, parameter.maximum, parameter.unit);
+            return false;
+        }
+        //! Activation points must land on the stroke, after the 0.3" suction check
+        if (strcmp(parameter.unit, "in") == 0 &&
+            inchesToSteps(recipe.cutTravelInches - recipe.values[i], CUT_MOTOR_STEPS_PER_INCH) <= CUT_MOTOR_SAFETY_CHECK_POSITION) {
+            snprintf(error, errorSize, "%s %g in leaves no room on a %g in stroke", parameter.name,
+                     recipe.values[i], recipe.cutTravelInches);
+            return false;
+        }
+    }
+    return true;
+}
+
+void captureCurrent(Recipe& recipe, const char* name) {
+    memset(&recipe, 0, sizeof(recipe));
+    snprintf(recipe.name, sizeof(recipe.name), "%s", name);
+    recipe.cutTravelInches = CUT_TRAVEL_DISTANCE;
+    recipe.positionTravelInches = POSITION_TRAVEL_DISTANCE;
+    for (int i = 0; i < RECIPE_PARAMETER_COUNT; i++) {
+        recipe.values[i] = configValue(*recipeParameters[i]);
+    }
+}
+
+bool matchesCurrent(const Recipe& recipe) {
+    if (recipe.cutTravelInches != CUT_TRAVEL_DISTANCE || recipe.positionTravelInches != POSITION_TRAVEL_DISTANCE) {
+        return false;
+    }
+    for (int i = 0; i < RECIPE_PARAMETER_COUNT; i++) {
+        if (recipe.values[i] != configValue(*recipeParameters[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//* ************************************************************************
+//* ************************ APPLYING *************************************
+//* ************************************************************************
+
+void applyRecipe(const Recipe& recipe) {
+    //! Step 1: Keep the homed position motor where it is - a new feed moves
+    //! its origin, the homing switch stays one inch past travel
+    long newTravelPosition = inchesToSteps(recipe.positionTravelInches, POSITION_MOTOR_STEPS_PER_INCH);
+    if (isHomed && newTravelPosition != POSITION_MOTOR_TRAVEL_POSITION) {
+        sampleMotorTravel();
+        positionMotor.setCurrentPosition(positionMotor.currentPosition() + newTravelPosition - POSITION_MOTOR_TRAVEL_POSITION);
+        rebaseMotorTravel();
+    }
+
+    //! Step 2: Values (validated when the recipe was saved), written without
+    //! recomputing the plan per parameter
+    CUT_TRAVEL_DISTANCE = recipe.cutTravelInches;
+    POSITION_TRAVEL_DISTANCE = recipe.positionTravelInches;
+    char error[96];
+    for (int i = 0; i < RECIPE_PARAMETER_COUNT; i++) {
+        if (!writeConfigValue(*recipeParameters[i], recipe.values[i], error, sizeof(error))) {
+            Serial.printf("Recipe %s: %s, keeping %g\n", recipe.name, error, configValue(*recipeParameters[i]));
+        }
+    }
+
+    //! Step 3: The motion plan, once
+    updateDerivedConfig();
+    snprintf(activeName, sizeof(activeName), "%s", recipe.name);
+    Serial.printf("Recipe %s active: stroke %.2f in (%ld steps), feed %.2f in (%ld steps)\n", recipe.name,
+                  CUT_TRAVEL_DISTANCE, CUT_MOTOR_CUT_POSITION, POSITION_TRAVEL_DISTANCE, POSITION_MOTOR_TRAVEL_POSITION);
+}
+
+//* ************************************************************************
+//* ************************ EDITING **************************************
+//* ************************************************************************
+
+void saveRecipe(const char* name, const char* travelArgs, Print& out) {
+    if (*name == '\0' || strlen(name) >= (size_t)RECIPE_NAME_LENGTH || strcasecmp(name, DEFAULT_RECIPE_NAME) == 0 ||
+        strcspn(name, " &=") != strlen(name)) {
+        out.printf("Recipe name must be 1-%d characters, no spaces, not '%s'\n", RECIPE_NAME_LENGTH - 1,
+                   DEFAULT_RECIPE_NAME);
+        return;
+    }
+    Recipe recipe;
+    captureCurrent(recipe, name);
+    if (*travelArgs != '\0' && sscanf(travelArgs, "%f %f", &recipe.cutTravelInches, &recipe.positionTravelInches) != 2) {
+        out.println("Usage: recipe save NAME [stroke_in feed_in]");
+        return;
+    }
+    char error[96];
+    if (!validateRecipe(recipe, error, sizeof(error))) {
+        out.printf("Recipe %s not saved: %s\n", name, error);
+        return;
+    }
+
+    xSemaphoreTake(recipeMutex, portMAX_DELAY);
+    Recipe* slot = (Recipe*)findRecipeLocked(name);
+    if (slot == nullptr && stored.count < (uint32_t)MAX_SAVED_RECIPES) {
+        slot = &stored.recipes[stored.count++];
+    }
+    bool written = false;
+    if (slot != nullptr) {
+        *slot = recipe;
+        written = writeRecipesLocked();
+    }
+    xSemaphoreGive(recipeMutex);
+
+    if (slot == nullptr) {
+        out.printf("Recipe table full (%d saved), delete one first\n", MAX_SAVED_RECIPES);
+    } else {
+        out.printf(written ? "Recipe %s saved\n" : "ERROR: Recipe %s NVS write failed\n", name);
+    }
+}
+
+void deleteRecipe(const char* name, Print& out) {
+    xSemaphoreTake(recipeMutex, portMAX_DELAY);
+    int found = -1;
+    for (uint32_t i = 0; i < stored.count; i++) {
+        if (strcasecmp(stored.recipes[i].name, name) == 0) {
+            found = (int)i;
+        }
+    }
+    bool written = false;
+    if (found >= 0) {
+        for (uint32_t i = found; i + 1 < stored.count; i++) {
+            stored.recipes[i] = stored.recipes[i + 1];
+        }
+        stored.count--;
+        written = writeRecipesLocked();
+    }
+    xSemaphoreGive(recipeMutex);
+
+    if (found < 0) {
+        out.printf("No saved recipe %s\n", name);
+    } else {
+        out.printf(written ? "Recipe %s deleted\n" : "ERROR: Recipe %s NVS write failed\n", name);
+    }
+}
+
+void useRecipe(const char* name, Print& out) {
+    if (!requestRecipe(name)) {
+        out.printf("No recipe %s\n", name);
+    } else if (machineIsAtRest()) {
+        out.printf("Recipe %s selected\n", name);
+    } else {
+        out.printf("Recipe %s selected, applies when the machine is idle\n", name);
+    }
+}
+
+void recipeConsoleCommand(const char* args, Print& out) {
+    if (strncmp(args, "use ", 4) == 0) {
+        useRecipe(args + 4, out);
+        handleRecipeRequests();
+    } else if (strncmp(args, "save ", 5) == 0) {
+        char name[RECIPE_NAME_LENGTH + 1];
+        const char* rest = args + 5;
+        size_t length = strcspn(rest, " ");
+        snprintf(name, sizeof(name), "%.*s", (int)length, rest);
+        rest += length;
+        while (*rest == ' ') {
+            rest++;
+        }
+        saveRecipe(name, rest, out);
+    } else if (strncmp(args, "delete ", 7) == 0) {
+        deleteRecipe(args + 7, out);
+    } else {
+        renderRecipes(out);
+    }
+}
+
+void printRecipe(const Recipe& recipe, Print& out) {
+    bool active = strcasecmp(recipe.name, activeName) == 0;
+    out.printf("%c %-15s stroke %5.2f in  feed %5.2f in", active ? '*' : ' ', recipe.name, recipe.cutTravelInches,
+               recipe.positionTravelInches);
+    for (int i = 0; i < RECIPE_PARAMETER_COUNT; i++) {
+        out.printf(" %g", recipe.values[i]);
+    }
+    out.print(active && !matchesCurrent(recipe) ? "  (changed since selected)\n" : "\n");
+}
+
+} // namespace
+
+//* ************************************************************************
+//* ************************ SETUP ****************************************
+//* ************************************************************************
+
+void initRecipes() {
+    recipeMutex = xSemaphoreCreateMutex();
+    for (int i = 0; i < RECIPE_PARAMETER_COUNT; i++) {
+        recipeParameters[i] = findConfigParameter(RECIPE_PARAMETERS[i]);
+    }
+
+    //! The default recipe is Config.cpp as built, whatever config was saved
+    memset(&defaultRecipe, 0, sizeof(defaultRecipe));
+    snprintf(defaultRecipe.name, sizeof(defaultRecipe.name), "%s", DEFAULT_RECIPE_NAME);
+    defaultRecipe.cutTravelInches = CUT_TRAVEL_DISTANCE;
+    defaultRecipe.positionTravelInches = POSITION_TRAVEL_DISTANCE;
+    for (int i = 0; i < RECIPE_PARAMETER_COUNT; i++) {
+        defaultRecipe.values[i] = configDefaultValue(*recipeParameters[i]);
+    }
+
+    loadRecipes();
+    if (stored.active[0] != '\0' && strcasecmp(stored.active, DEFAULT_RECIPE_NAME) != 0) {
+        if (requestRecipe(stored.active)) {
+            handleRecipeRequests();
+        } else {
+            Serial.printf("Recipe %s no longer saved, staying on Config.cpp values\n", stored.active);
+        }
+    }
+    if (activeName[0] == '\0') {
+        snprintf(activeName, sizeof(activeName), "%s", DEFAULT_RECIPE_NAME);
+    }
+    registerConsoleCommand("recipe", recipeConsoleCommand, "Cutting recipes: 'recipe [use NAME|save NAME [stroke feed]|delete NAME]'");
+}
+
+//* ************************************************************************
+//* ************************ SELECTION ************************************
+//* ************************************************************************
+
+bool requestRecipe(const char* name) {
+    xSemaphoreTake(recipeMutex, portMAX_DELAY);
+    const Recipe* recipe = findRecipeLocked(name);
+    if (recipe != nullptr) {
+        snprintf(pendingName, sizeof(pendingName), "%s", recipe->name);
+        recipePending = true;
+    }
+    xSemaphoreGive(recipeMutex);
+    return recipe != nullptr;
+}
+
+void handleRecipeRequests() {
+    if (!recipePending || !machineIsAtRest()) {
+        return;
+    }
+
+    //! Step 1: Copy the recipe out so the HTTP task can keep editing
+    xSemaphoreTake(recipeMutex, portMAX_DELAY);
+    recipePending = false;
+    const Recipe* found = findRecipeLocked(pendingName);
+    Recipe recipe;
+    if (found != nullptr) {
+        recipe = *found;
+    }
+    xSemaphoreGive(recipeMutex);
+    if (found == nullptr) {
+        return;
+    }
+
+    //! Step 2: Apply, then remember it for the next boot
+    applyRecipe(recipe);
+    if (strcmp(stored.active, recipe.name) != 0) {
+        xSemaphoreTake(recipeMutex, portMAX_DELAY);
+        snprintf(stored.active, sizeof(stored.active), "%s", recipe.name);
+        if (!writeRecipesLocked()) {
+            Serial.println("ERROR: Active recipe NVS write failed");
+        }
+        xSemaphoreGive(recipeMutex);
+    }
+}
+
+const char* activeRecipeName() {
+    return activeName;
+}
+
+//* ************************************************************************
+//* ************************ RENDERING ************************************
+//* ************************************************************************
+
+void renderRecipes(Print& out) {
+    out.print("# * = active; values:");
+    for (const char* name : RECIPE_PARAMETERS) {
+        out.printf(" %s", name);
+    }
+    out.print("\n");
+
+    xSemaphoreTake(recipeMutex, portMAX_DELAY);
+    printRecipe(defaultRecipe, out);
+    for (uint32_t i = 0; i < stored.count; i++) {
+        printRecipe(stored.recipes[i], out);
+    }
+    bool pending = recipePending;
+    char pendingCopy[RECIPE_NAME_LENGTH];
+    strncpy(pendingCopy, pendingName, RECIPE_NAME_LENGTH);
+    xSemaphoreGive(recipeMutex);
+
+    if (pending) {
+        out.printf("Pending: %s (applies when the machine is idle)\n", pendingCopy);
+    }
+    out.printf("Motion plan (steps): cut %ld, clamp at %ld, servo at %ld, suction check at %ld; "
+               "feed %ld, advance %ld, home switch %ld\n",
+               CUT_MOTOR_CUT_POSITION, CATCHER_CLAMP_ACTIVATION_POSITION, CATCHER_SERVO_ACTIVATION_POSITION,
+               CUT_MOTOR_SAFETY_CHECK_POSITION, POSITION_MOTOR_TRAVEL_POSITION, POSITION_MOTOR_ADVANCE_POSITION,
+               POSITION_MOTOR_HOME_SWITCH_POSITION);
+}
+
+void handleRecipeQuery(const char* query, Print& out) {
+    while (*query) {
+        size_t length = strcspn(query, "&");
+        char field[RECIPE_NAME_LENGTH + 8];
+        snprintf(field, sizeof(field), "%.*s", (int)(length < sizeof(field) - 1 ? length : sizeof(field) - 1), query);
+        if (strncmp(field, "use=", 4) == 0) {
+            useRecipe(field + 4, out);
+        } else if (strncmp(field, "save=", 5) == 0) {
+            saveRecipe(field + 5, "", out);
+        } else if (strncmp(field, "delete=", 7) == 0) {
+            deleteRecipe(field + 7, out);
+        } else if (length > 0) {
+            out.printf("Ignored: %.*s\n", (int)length, query);
+        }
+        query += length;
+        if (*query == '&') {
+            query++;
+        }
+    }
+    renderRecipes(out);
+}
@@ -0,0 +1,112 @@
+#include "Console/SerialConsole.h"
+
+//* ************************************************************************
+//* ************************ SERIAL CONSOLE *******************************
+//* ************************************************************************
+//! Command table plus a non-blocking line reader
+
+namespace {
+
+struct ConsoleCommand {
+    const char* name;
+    ConsoleCommandHandler handler;
+    const char* help;
+};
+
+ConsoleCommand commands[CONSOLE_MAX_COMMANDS];
+int commandCount = 0;
+
+char lineBuffer[CONSOLE_LINE_LENGTH];
+int lineLength = 0;
+bool lineOverflow = false;
+
+void printHelp(const char* args, Print& out) {
+    (void)args;
+    out.println("Commands:");
+    for (int i = 0; i < commandCount; i++) {
+        out.printf("  %-12s %s\n", commands[i].name, commands[i].help);
+    }
+}
+
+} // namespace
+
+//* ************************************************************************
+//* ************************ SETUP ****************************************
+//* ************************************************************************
+
+void initSerialConsole() {
+    lineLength = 0;
+    lineOverflow = false;
+    registerConsoleCommand("help", printHelp, "List console commands");
+}
+
+bool registerConsoleCommand(const char* name, ConsoleCommandHandler handler, const char* help) {
+    for (int i = 0; i < commandCount; i++) {
+        if (strcmp(commands[i].name, name) == 0) {
+            commands[i].handler = handler;
+            commands[i].help = help;
+            return true;
+        }
+    }
+    if (commandCount >= CONSOLE_MAX_COMMANDS) {
+        Serial.print("ERROR: Console command table full, dropping ");
+        Serial.println(name);
+        return false;
+    }
+    commands[commandCount++] = {name, handler, help};
+    return true;
+}
+
+//* ************************************************************************
+//* ************************ COMMAND DISPATCH *****************************
+//* ************************************************************************
+
+bool executeConsoleLine(const char* line, Print& out) {
+    while (*line == ' ') {
+        line++;
+    }
+    if (*line == '\0') {
+        return true;
+    }
+
+    size_t nameLength = strcspn(line, " ");
+    const char* args = line + nameLength;
+    while (*args == ' ') {
+        args++;
+    }
+
+    for (int i = 0; i < commandCount; i++) {
+        if (strlen(commands[i].name) == nameLength && strncmp(commands[i].name, line, nameLength) == 0) {
+            commands[i].handler(args, out);
+            return true;
+        }
+    }
+    out.print("Unknown command: ");
+    out.write((const uint8_t*)line, nameLength);
+    out.println(" (try 'help')");
+    return false;
+}
+
+//* ************************************************************************
+//* ************************ RUNTIME **************************************
+//* ************************************************************************
+
+void handleSerialConsole() {
+    while (Serial.available() > 0) {
+        char c = (char)Serial.read();
+        if (c == '\r' || c == '\n') {
+            if (lineOverflow) {
+                Serial.println("ERROR: Console line too long");
+            } else if (lineLength > 0) {
+                lineBuffer[lineLength] = '\0';
+                executeConsoleLine(lineBuffer, Serial);
+            }
+            lineLength = 0;
+            lineOverflow = false;
+        } else if (lineLength < CONSOLE_LINE_LENGTH - 1) {
+            lineBuffer[lineLength++] = c;
+        } else {
+            lineOverflow = true;
+        }
+    }
+}
@@ -0,0 +1,501 @@
+#include "Control/RemoteControl.h"
+#include "Config/Recipes.h"
+#include "Console/SerialConsole.h"
+#include "Metrics/Metrics.h"
+#include "StateMachine/CatcherServo.h"
+#include "StateMachine/ErrorManager.h"
+#include <WiFi.h>
+#include <freertos/semphr.h>
+
+//* ************************************************************************
+//* ************************ REMOTE CONTROL *******************************
+//* ************************************************************************
+//! Command endpoint, mailbox and the state machine hooks
+//! The server task and the loop task meet in a one-command mailbox guarded
+//! by mailboxMutex. Everything else here (the batch, the reload hold, the
+//! posted event) belongs to the loop task; the server task only reads the
+//! batch counters and the status snapshot for "status".
+
+//* ************************************************************************
+//* ************************ REMOTE CONTROL CONFIGURATION *****************
+//* ************************************************************************
+const uint16_t REMOTE_CONTROL_PORT = 2323;
+const int REMOTE_CONTROL_CORE = 0;
+
+// External variable declarations
+extern Bounce startCycleSwitch;
+extern Bounce reloadSwitch;
+extern bool isHomed;
+
+namespace {
+
+const uint32_t REMOTE_TASK_STACK_SIZE = 4096;
+const UBaseType_t REMOTE_TASK_PRIORITY = 2;         // Ahead of the metrics server (1)
+const unsigned long REMOTE_CLIENT_POLL_MS = 2;      // While a client is connected
+const unsigned long REMOTE_IDLE_POLL_MS = 20;       // Waiting for a connection
+const unsigned long REMOTE_APPLY_TIMEOUT_MS = 250;  // Loop pass budget before a command is dropped
+const int REMOTE_LINE_LENGTH = 64;
+const int REMOTE_REPLY_LENGTH = 160;
+
+enum RemoteCommandType {
+    REMOTE_START,
+    REMOTE_STOP,
+    REMOTE_RELOAD,
+    REMOTE_ACK,
+    REMOTE_RECIPE,
+    REMOTE_STATUS,
+    REMOTE_HELP
+};
+
+struct RemoteCommandName {
+    const char* name;
+    RemoteCommandType type;
+};
+
+const RemoteCommandName REMOTE_COMMANDS[] = {
+    {"start", REMOTE_START},
+    {"stop", REMOTE_STOP},
+    {"reload", REMOTE_RELOAD},
+    {"ack", REMOTE_ACK},
+    {"recipe", REMOTE_RECIPE},
+    {"status", REMOTE_STATUS},
+    {"help", REMOTE_HELP},
+};
+
+const char* const REMOTE_HELP_TEXT = "OK commands: start [N], stop, reload on|off, ack, recipe NAME, status";
+
+struct RemoteCommand {
+    RemoteCommandType type;
+    uint32_t pieces;                    // start: 0 = until stop
+    bool on;                            // reload
+    char recipe[RECIPE_NAME_LENGTH];    // recipe
+};
+
+// Batch started by "start" - counters read by the server task for "status"
+struct RemoteBatch {
+    volatile bool active;
+    volatile bool stopRequested;
+    volatile uint32_t target;           // 0 = until stop
+    volatile uint32_t done;
+};
+
+RemoteBatch batch = {};
+volatile bool reloadHeld = false;
+RemoteEvent postedEvent = REMOTE_EVENT_NONE;
+SystemState postedEventState = IDLE;    // The event lapses once the machine leaves this state
+
+// Loop task state the server task may not read directly (the switch
+// debouncers, the recipe name), copied each pass - guarded by statusMux
+struct RemoteStatusInputs {
+    bool homed;
+    bool startSwitch;
+    bool reloadSwitch;
+    char recipe[RECIPE_NAME_LENGTH];
+};
+
+portMUX_TYPE statusMux = portMUX_INITIALIZER_UNLOCKED;
+RemoteStatusInputs statusInputs = {};
+RemoteStatusInputs loopStatusInputs = {};   // Loop task's copy, to publish only on a change
+
+// Guarded by mailboxMutex
+SemaphoreHandle_t mailboxMutex = nullptr;
+RemoteCommand mailbox;
+char mailboxReply[REMOTE_REPLY_LENGTH];
+volatile bool mailboxPending = false;
+
+WiFiServer controlServer(REMOTE_CONTROL_PORT);
+
+//* ************************************************************************
+//* ************************ PARSING **************************************
+//* ************************************************************************
+
+// False with an "ERR" reply if the line is not a command
+bool parseRemoteCommand(const char* line, RemoteCommand& command, char* reply, size_t replySize) {
+    while (*line == ' ') {
+        line++;
+    }
+    size_t nameLength = strcspn(line, " ");
+    const char* args = line + nameLength;
+    while (*args == ' ') {
+        args++;
+    }
+
+    const RemoteCommandName* found = nullptr;
+    for (const RemoteCommandName& entry : REMOTE_COMMANDS) {
+        if (strlen(entry.name) == nameLength && strncasecmp(line, entry.name, nameLength) == 0) {
+            found = &entry;
+            break;
+        }
+    }
+    if (found == nullptr) {
+        snprintf(reply, replySize, "ERR unknown command '%.*s' (help lists them)", (int)nameLength, line);
+        return false;
+    }
+
+    memset(&command, 0, sizeof(command));
+    command.type = found->type;
+    switch (command.type) {
+        case REMOTE_START:
+            if (*args != '\0') {
+                char* end = nullptr;
+                long pieces = strtol(args, &end, 10);
+                if (pieces <= 0 || *end != '\0') {
+                    snprintf(reply, replySize, "ERR start takes a piece count above 0");
+                    return false;
+                }
+                command.pieces = (uint32_t)pieces;
+            }
+            return true;
+        case REMOTE_RELOAD:
+            if (*args == '\0' || strcasecmp(args, "on") == 0) {
+                command.on = true;
+            } else if (strcasecmp(args, "off") != 0) {
+                snprintf(reply, replySize, "ERR reload takes on or off");
+                return false;
+            }
+            return true;
+        case REMOTE_RECIPE:
+            if (*args == '\0' || strlen(args) >= sizeof(command.recipe)) {
+                snprintf(reply, replySize, "ERR recipe takes a name of up to %d characters", RECIPE_NAME_LENGTH - 1);
+                return false;
+            }
+            snprintf(command.recipe, sizeof(command.recipe), "%s", args);
+            return true;
+        default:
+            return true;
+    }
+}
+
+//* ************************************************************************
+//* ************************ REPLIES **************************************
+//* ************************************************************************
+
+// Loop task - publishes the inputs "status" reports once they change
+void snapshotRemoteStatus() {
+    RemoteStatusInputs inputs;
+    inputs.homed = isHomed;
+    inputs.startSwitch = startCycleSwitch.read() == HIGH;
+    inputs.reloadSwitch = reloadSwitch.read() == HIGH;
+    if (inputs.homed == loopStatusInputs.homed && inputs.startSwitch == loopStatusInputs.startSwitch &&
+        inputs.reloadSwitch == loopStatusInputs.reloadSwitch &&
+        strcmp(activeRecipeName(), loopStatusInputs.recipe) == 0) {
+        return;
+    }
+    snprintf(inputs.recipe, sizeof(inputs.recipe), "%s", activeRecipeName());
+    loopStatusInputs = inputs;
+    portENTER_CRITICAL(&statusMux);
+    statusInputs = inputs;
+    portEXIT_CRITICAL(&statusMux);
+}
+
+// Reads only volatile counters and snapshots taken on the loop task, so it
+// is safe from the server task while the loop is busy (homing, an OTA park)
+void renderRemoteStatus(char* reply, size_t replySize) {
+    MetricsSnapshot snapshot;
+    getMetricsSnapshot(snapshot);
+    RemoteStatusInputs inputs;
+    portENTER_CRITICAL(&statusMux);
+    inputs = statusInputs;
+    portEXIT_CRITICAL(&statusMux);
+    snprintf(reply, replySize,
+             "OK state=%s homed=%d batch=%s%lu/%lu recipe=%s start_switch=%d reload_switch=%d reload_hold=%d "
+             "catcher=%s error=%s pieces=%lu",
+             getStateName(snapshot.currentState), inputs.homed ? 1 : 0, batch.stopRequested ? "stopping:" : "",
+             (unsigned long)batch.done, (unsigned long)batch.target, inputs.recipe, inputs.startSwitch ? 1 : 0,
+             inputs.reloadSwitch ? 1 : 0, reloadHeld ? 1 : 0, getCatcherServoPhaseName(getCatcherServoPhase()),
+             errorCodeName(firstActiveError()), (unsigned long)snapshot.piecesCut);
+}
+
+void postRemoteEvent(RemoteEvent event) {
+    postedEvent = event;
+    postedEventState = currentState;
+}
+
+//* ************************************************************************
+//* ************************ APPLYING *************************************
+//* ************************************************************************
+
+// Loop task only - checks the command against the current state
+void applyRemoteCommand(const RemoteCommand& command, char* reply, size_t replySize) {
+    switch (command.type) {
+        case REMOTE_START:
+            if (currentState != IDLE) {
+                snprintf(reply, replySize, "ERR cannot start in %s", getStateName(currentState));
+                return;
+            }
+            batch.active = true;
+            batch.stopRequested = false;
+            batch.target = command.pieces;
+            batch.done = 0;
+            postRemoteEvent(REMOTE_EVENT_START);
+            if (command.pieces > 0) {
+                snprintf(reply, replySize, "OK batch of %lu started", (unsigned long)command.pieces);
+            } else {
+                snprintf(reply, replySize, "OK batch started, runs until stop");
+            }
+            Serial.printf("REMOTE: %s\n", reply + 3);
+            return;
+
+        case REMOTE_STOP:
+            if (!batch.active) {
+                snprintf(reply, replySize, "OK no batch running");
+            } else {
+                batch.stopRequested = true;
+                snprintf(reply, replySize, "OK stopping after piece %lu", (unsigned long)batch.done + 1);
+                Serial.printf("REMOTE: %s\n", reply + 3);
+            }
+            if (startCycleSwitch.read() == HIGH) {
+                size_t used = strlen(reply);
+                snprintf(reply + used, replySize - used, " - start switch is ON and keeps the machine cycling");
+            }
+            return;
+
+        case REMOTE_RELOAD:
+            if (!command.on) {
+                reloadHeld = false;
+                snprintf(reply, replySize, currentState == RELOAD && reloadSwitch.read() == HIGH
+                                                  ? "OK reload released - reload switch still ON"
+                                                  : "OK reload released");
+                return;
+            }
+            if (currentState == RELOAD) {
+                reloadHeld = true;
+                snprintf(reply, replySize, "OK reload held");
+                return;
+            }
+            if (currentState != IDLE) {
+                snprintf(reply, replySize, "ERR cannot reload in %s", getStateName(currentState));
+                return;
+            }
+            reloadHeld = true;
+            postRemoteEvent(REMOTE_EVENT_RELOAD);
+            snprintf(reply, replySize, "OK reload held");
+            Serial.println("REMOTE: reload requested");
+            return;
+
+        case REMOTE_ACK:
+            if (currentState != ERROR) {
+                snprintf(reply, replySize, "ERR no error to acknowledge in %s", getStateName(currentState));
+                return;
+            }
+            postRemoteEvent(REMOTE_EVENT_ACK);
+            snprintf(reply, replySize, "OK error acknowledged");
+            Serial.println("REMOTE: error acknowledged");
+            return;
+
+        case REMOTE_RECIPE:
+            if (!requestRecipe(command.recipe)) {
+                snprintf(reply, replySize, "ERR no recipe %s", command.recipe);
+                return;
+            }
+            snprintf(reply, replySize, currentState == IDLE || currentState == STARTUP
+                                              ? "OK recipe %s selected"
+                                              : "OK recipe %s selected, applied at the end of the batch",
+                     command.recipe);
+            return;
+
+        case REMOTE_STATUS:
+            renderRemoteStatus(reply, replySize);
+            return;
+
+        case REMOTE_HELP:
+            snprintf(reply, replySize, "%s", REMOTE_HELP_TEXT);
+            return;
+    }
+}
+
+// Server task - hands the command to the loop task and waits for its reply
+void submitRemoteCommand(const RemoteCommand& command, char* reply, size_t replySize) {
+    xSemaphoreTake(mailboxMutex, portMAX_DELAY);
+    mailbox = command;
+    mailboxPending = true;
+    xSemaphoreGive(mailboxMutex);
+
+    unsigned long start = millis();
+    while (mailboxPending && millis() - start < REMOTE_APPLY_TIMEOUT_MS) {
+        vTaskDelay(1);
+    }
+
+    xSemaphoreTake(mailboxMutex, portMAX_DELAY);
+    if (mailboxPending) {
+        //! The loop is held elsewhere (homing, an OTA park) - a command
+        //! applied late could act on a state the controller never saw
+        mailboxPending = false;
+        snprintf(reply, replySize, "ERR machine busy, command dropped");
+    } else {
+        snprintf(reply, replySize, "%s", mailboxReply);
+    }
+    xSemaphoreGive(mailboxMutex);
+}
+
+void handleRemoteLine(const char* line, WiFiClient& client) {
+    char reply[REMOTE_REPLY_LENGTH];
+    RemoteCommand command;
+    if (line[0] == '\0') {
+        return;
+    }
+    if (parseRemoteCommand(line, command, reply, sizeof(reply))) {
+        if (command.type == REMOTE_STATUS) {
+            renderRemoteStatus(reply, sizeof(reply));
+        } else if (command.type == REMOTE_HELP) {
+            snprintf(reply, sizeof(reply), "%s", REMOTE_HELP_TEXT);
+        } else {
+            submitRemoteCommand(command, reply, sizeof(reply));
+        }
+    }
+    size_t length = strlen(reply);
+    reply[length] = '\n';
+    client.write((const uint8_t*)reply, length + 1);   // One segment per reply
+}
+
+//* ************************************************************************
+//* ************************ SERVER TASK **********************************
+//* ************************************************************************
+
+void remoteControlTask(void* parameter) {
+    (void)parameter;
+    bool serverStarted = false;
+    WiFiClient client;
+    char line[REMOTE_LINE_LENGTH];
+    int lineLength = 0;
+
+    for (;;) {
+        if (WiFi.status() != WL_CONNECTED) {
+            serverStarted = false;
+            client.stop();
+            vTaskDelay(pdMS_TO_TICKS(500));
+            continue;
+        }
+
+        if (!serverStarted) {
+            controlServer.begin();
+            controlServer.setNoDelay(true);
+            serverStarted = true;
+            Serial.print("Remote control listening on ");
+            Serial.print(WiFi.localIP());
+            Serial.printf(":%u\n", REMOTE_CONTROL_PORT);
+        }
+
+        //! Step 1: A new connection replaces the current one - the line
+        //! controller reconnecting after a drop must not be locked out
+        WiFiClient incoming = controlServer.available();
+        if (incoming) {
+            client.stop();
+            client = incoming;
+            client.setNoDelay(true);
+            lineLength = 0;
+        }
+
+        //! Step 2: Complete lines; an overlong line is cut, not split
+        bool received = false;
+        while (client && client.available() > 0) {
+            int c = client.read();
+            if (c < 0) {
+                break;
+            }
+            received = true;
+            if (c == '\n') {
+                line[lineLength] = '\0';
+                handleRemoteLine(line, client);
+                lineLength = 0;
+            } else if (c != '\r' && lineLength < REMOTE_LINE_LENGTH - 1) {
+                line[lineLength++] = (char)c;
+            }
+        }
+        if (client && !client.connected()) {
+            client.stop();
+        }
+
+        if (!received) {
+            vTaskDelay(pdMS_TO_TICKS(client ? REMOTE_CLIENT_POLL_MS : REMOTE_IDLE_POLL_MS));
+        }
+    }
+}
+
+//* ************************************************************************
+//* ************************ CONSOLE COMMAND ******************************
+//* ************************************************************************
+
+// Runs on the loop task, so commands apply directly
+void cycleConsoleCommand(const char* args, Print& out) {
+    char reply[REMOTE_REPLY_LENGTH];
+    RemoteCommand command;
+    if (*args == '\0') {
+        args = "status";
+    }
+    if (parseRemoteCommand(args, command, reply, sizeof(reply))) {
+        applyRemoteCommand(command, reply, sizeof(reply));
+    }
+    out.println(reply);
+}
+
+} // namespace
+
+//* ************************************************************************
+//* ************************ SETUP ****************************************
+//* ************************************************************************
+
+void initRemoteControl() {
+    mailboxMutex = xSemaphoreCreateMutex();
+    snapshotRemoteStatus();
+    registerConsoleCommand("cycle", cycleConsoleCommand,
+                           "Remote cycle commands: 'cycle [start [N]|stop|reload on|off|ack|recipe NAME|status]'");
+    xTaskCreatePinnedToCore(remoteControlTask, "remote", REMOTE_TASK_STACK_SIZE, nullptr, REMOTE_TASK_PRIORITY,
+                            nullptr, REMOTE_CONTROL_CORE);
+    Serial.printf("Remote control task started (port %u)\n", REMOTE_CONTROL_PORT);
+}
+
+//* ************************************************************************
+//* ************************ RUNTIME **************************************
+//* ************************************************************************
+
+void handleRemoteCommands() {
+    //! Step 1: Bookkeeping - a batch ends when the machine comes back to
+    //! rest or faults; the hold and an untaken event lapse with their state;
+    //! the status snapshot catches up with this pass
+    if (batch.active && (currentState == IDLE || currentState == ERROR) && postedEvent != REMOTE_EVENT_START) {
+        Serial.printf("REMOTE: batch finished after %lu pieces\n", (unsigned long)batch.done);
+        batch.active = false;
+        batch.stopRequested = false;
+    }
+    if (reloadHeld && currentState != RELOAD && postedEvent != REMOTE_EVENT_RELOAD) {
+        reloadHeld = false;
+    }
+    if (postedEvent != REMOTE_EVENT_NONE && currentState != postedEventState) {
+        postedEvent = REMOTE_EVENT_NONE;
+    }
+    snapshotRemoteStatus();
+
+    //! Step 2: A command from the server task - never wait for the mutex here
+    if (!mailboxPending || xSemaphoreTake(mailboxMutex, 0) != pdTRUE) {
+        return;
+    }
+    if (mailboxPending) {
+        applyRemoteCommand(mailbox, mailboxReply, sizeof(mailboxReply));
+        mailboxPending = false;
+    }
+    xSemaphoreGive(mailboxMutex);
+}
+
+bool takeRemoteEvent(RemoteEvent event) {
+    if (postedEvent != event || currentState != postedEventState) {
+        return false;
+    }
+    postedEvent = REMOTE_EVENT_NONE;
+    return true;
+}
+
+bool continueRemoteBatch() {
+    if (!batch.active) {
+        return false;
+    }
+    batch.done = batch.done + 1;
+    if (batch.stopRequested || (batch.target > 0 && batch.done >= batch.target)) {
+        return false;
+    }
+    return true;
+}
+
+bool remoteReloadHeld() {
+    return reloadHeld;
+}
@@ -0,0 +1,291 @@
+#include "Diagnostics/FlightRecorder.h"
+#include "StateMachine/StateMachine.h"
+#include "Metrics/Metrics.h"
+#include "Console/SerialConsole.h"
+#include <esp_system.h>
+
+//* ************************************************************************
+//* ************************ FLIGHT RECORDER ******************************
+//* ************************************************************************
+//! RTC ring validation, edge sampling and text dumps
+
+RTC_NOINIT_ATTR FlightRecorderRing flightRecorderRing;
+
+// External Bounce objects declared in main.cpp
+extern Bounce woodSensor;
+extern Bounce wasWoodSuctionedSensor;
+extern Bounce cutHomingSwitch;
+extern Bounce positionHomingSwitch;
+extern Bounce startCycleSwitch;
+extern Bounce reloadSwitch;
+extern Bounce fixPositionButton;
+
+namespace {
+
+const uint32_t FLIGHT_RECORDER_MAGIC = 0x464C5431; // "FLT1"
+const uint32_t BOOT_DUMP_EVENTS = 32;              // Printed automatically after a crash
+const int LIVE_COPY_ATTEMPTS = 4;                  // Then the copy keeps what was not overwritten
+
+// Previous run, copied out of RTC memory at boot
+FlightRecorderRing previousRun;
+bool hasPreviousRun = false;
+esp_reset_reason_t bootResetReason = ESP_RST_UNKNOWN;
+
+// Edge detection state
+Bounce* const watchedInputs[FLIGHT_SENSOR_COUNT] = {
+    &woodSensor, &wasWoodSuctionedSensor, &cutHomingSwitch, &positionHomingSwitch,
+    &startCycleSwitch, &reloadSwitch, &fixPositionButton
+};
+uint8_t lastInputLevels[FLIGHT_SENSOR_COUNT] = {0};
+bool inputsPrimed = false;
+bool moveOpen[2] = {false, false};
+
+const char* const SENSOR_NAMES[FLIGHT_SENSOR_COUNT] = {
+    "wood", "wood_suction", "cut_home", "position_home", "start_switch", "reload_switch", "fix_button"
+};
+const char* const CLAMP_NAMES[] = {"position", "wood_secure", "catcher"};
+
+AccelStepper& motorFor(uint8_t motor) {
+    return motor == CUT_MOTOR ? cutMotor : positionMotor;
+}
+
+const char* motorName(uint8_t motor) {
+    return motor == CUT_MOTOR ? "cut" : "position";
+}
+
+const char* resetReasonName(esp_reset_reason_t reason) {
+    switch (reason) {
+        case ESP_RST_POWERON: return "POWERON";
+        case ESP_RST_EXT: return "EXTERNAL";
+        case ESP_RST_SW: return "SOFTWARE";
+        case ESP_RST_PANIC: return "PANIC";
+        case ESP_RST_INT_WDT: return "INT_WDT";
+        case ESP_RST_TASK_WDT: return "TASK_WDT";
+        case ESP_RST_WDT: return "WDT";
+        case ESP_RST_DEEPSLEEP: return "DEEPSLEEP";
+        case ESP_RST_BROWNOUT: return "BROWNOUT";
+        default: return "UNKNOWN";
+    }
+}
+
+bool isCrashReset(esp_reset_reason_t reason) {
+    return reason == ESP_RST_PANIC || reason == ESP_RST_INT_WDT || reason == ESP_RST_TASK_WDT ||
+           reason == ESP_RST_WDT || reason == ESP_RST_BROWNOUT;
+}
+
+uint32_t retainedEvents(const FlightRecorderRing& ring) {
+    uint32_t head = ring.head.load();
+    return head < FLIGHT_RECORDER_CAPACITY ? head : FLIGHT_RECORDER_CAPACITY;
+}
+
+// i = 0 is the oldest retained event
+const FlightEvent& eventAt(const FlightRecorderRing& ring, uint32_t i) {
+    return ring.events[(ring.head.load() - retainedEvents(ring) + i) & (FLIGHT_RECORDER_CAPACITY - 1)];
+}
+
+uint32_t copyFromRing(const FlightRecorderRing& ring, FlightEvent* out, uint32_t maxEvents) {
+    uint32_t count = retainedEvents(ring) < maxEvents ? retainedEvents(ring) : maxEvents;
+    for (uint32_t i = 0; i < count; i++) {
+        out[i] = eventAt(ring, i);
+    }
+    return count;
+}
+
+// The loop task may record while another task copies. Records that land
+// after 'before' may overwrite the oldest events copied; the copy is retried
+// while they did, and the last attempt drops the overwritten ones
+uint32_t copyFromLiveRing(FlightEvent* out, uint32_t maxEvents) {
+    std::atomic<uint32_t>& head = flightRecorderRing.head;
+    for (int attempt = 1;; attempt++) {
+        uint32_t before = head.load(std::memory_order_acquire);
+        uint32_t retained = before < FLIGHT_RECORDER_CAPACITY - 1 ? before : FLIGHT_RECORDER_CAPACITY - 1;
+        uint32_t count = retained < maxEvents ? retained : maxEvents;
+        uint32_t first = before - retained;
+        for (uint32_t i = 0; i < count; i++) {
+            out[i] = flightRecorderRing.events[(first + i) & (FLIGHT_RECORDER_CAPACITY - 1)];
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);   // Copy done before the head is read again
+        uint32_t moved = head.load(std::memory_order_relaxed) - before;
+
+        //! Events from after + 1 - capacity on are intact (the record at
+        //! 'after' may be half written over the oldest slot)
+        uint32_t slack = FLIGHT_RECORDER_CAPACITY - 1 - retained;
+        if (moved <= slack) {
+            return count;
+        }
+        if (attempt == LIVE_COPY_ATTEMPTS) {
+            uint32_t lost = moved - slack;
+            if (lost >= count) {
+                return 0;
+            }
+            memmove(out, out + lost, (count - lost) * sizeof(FlightEvent));
+            return count - lost;
+        }
+    }
+}
+
+void printEvent(const FlightEvent& event, Print& out) {
+    out.printf("%12.3f  ", event.timeUs / 1000.0);
+    switch (event.type) {
+        case FLIGHT_BOOT:
+            out.printf("BOOT    reset=%s\n", resetReasonName((esp_reset_reason_t)event.subject));
+            break;
+        case FLIGHT_STATE:
+            out.printf("STATE   %s -> %s\n", getStateName((SystemState)event.subject),
+                       getStateName((SystemState)event.value));
+            break;
+        case FLIGHT_ERROR:
+            out.printf("ERROR   %s\n", errorCounterLabel((ErrorCounterType)event.subject));
+            break;
+        case FLIGHT_MOVE_START:
+            out.printf("MOVE    %s -> %d\n", motorName(event.subject), event.value);
+            break;
+        case FLIGHT_MOVE_END:
+            out.printf("ARRIVE  %s @ %d\n", motorName(event.subject), event.value);
+            break;
+        case FLIGHT_CLAMP:
+            out.printf("CLAMP   %s %s\n", flightClampName(event.subject),
+                       event.value ? "extend" : "retract");
+            break;
+        case FLIGHT_SENSOR:
+            out.printf("SENSOR  %s=%d\n", flightSensorName(event.subject), event.value);
+            break;
+        case FLIGHT_SERVO:
+            out.printf("SERVO   %d deg\n", event.value);
+            break;
+        case FLIGHT_SIGNAL:
+            out.printf("SIGNAL  TA=%d\n", event.value);
+            break;
+        default:
+            out.printf("?%u     %u %d\n", event.type, event.subject, event.value);
+            break;
+    }
+}
+
+// Prints the newest maxEvents events, oldest first
+void printRing(const FlightRecorderRing& ring, uint32_t maxEvents, Print& out) {
+    uint32_t available = retainedEvents(ring);
+    uint32_t first = available > maxEvents ? available - maxEvents : 0;
+    for (uint32_t i = first; i < available; i++) {
+        printEvent(eventAt(ring, i), out);
+    }
+}
+
+void flightConsoleCommand(const char* args, Print& out) {
+    (void)args;
+    renderFlightRecorderLog(out);
+}
+
+} // namespace
+
+//* ************************************************************************
+//* ************************ SETUP ****************************************
+//* ************************************************************************
+
+void initFlightRecorder() {
+    bootResetReason = esp_reset_reason();
+
+    //! Step 1: RTC memory is random after power-on - only trust it after a soft reset
+    bool ringValid = flightRecorderRing.magic == FLIGHT_RECORDER_MAGIC && bootResetReason != ESP_RST_POWERON;
+    hasPreviousRun = ringValid && flightRecorderRing.head.load() > 0;
+    if (hasPreviousRun) {
+        previousRun.magic = flightRecorderRing.magic;
+        previousRun.head.store(flightRecorderRing.head.load());
+        memcpy(previousRun.events, flightRecorderRing.events, sizeof(previousRun.events));
+    }
+
+    //! Step 2: Start a fresh ring for this run
+    flightRecorderRing.magic = FLIGHT_RECORDER_MAGIC;
+    flightRecorderRing.head.store(0);
+    recordFlightEvent(FLIGHT_BOOT, (uint8_t)bootResetReason, 0);
+
+    registerConsoleCommand("flight", flightConsoleCommand, "Dump the flight recorder (previous + current run)");
+
+    //! Step 3: After a crash, show how the previous run ended
+    if (hasPreviousRun && isCrashReset(bootResetReason)) {
+        Serial.printf("=== Flight recorder: last %u events before %s reset ===\n",
+                      (unsigned)BOOT_DUMP_EVENTS, resetReasonName(bootResetReason));
+        printRing(previousRun, BOOT_DUMP_EVENTS, Serial);
+        Serial.println("=== Full log: 'flight' on the console or /flight ===");
+    }
+}
+
+//* ************************************************************************
+//* ************************ RUNTIME **************************************
+//* ************************************************************************
+
+void recordMoveStart(uint8_t motor, long target) {
+    moveOpen[motor & 1] = true;
+    recordFlightEvent(FLIGHT_MOVE_START, motor, target);
+}
+
+void recordMoveEnd(uint8_t motor) {
+    if (moveOpen[motor & 1]) {
+        moveOpen[motor & 1] = false;
+        recordFlightEvent(FLIGHT_MOVE_END, motor, motorFor(motor).currentPosition());
+    }
+}
+
+void sampleFlightRecorder() {
+    //! Sensor edges, at the resolution the state machine sees them
+    for (int i = 0; i < FLIGHT_SENSOR_COUNT; i++) {
+        uint8_t level = watchedInputs[i]->read() ? 1 : 0;
+        if (inputsPrimed && level != lastInputLevels[i]) {
+            recordFlightEvent(FLIGHT_SENSOR, (uint8_t)i, level);
+        }
+        lastInputLevels[i] = level;
+    }
+    inputsPrimed = true;
+
+    //! Move completions
+    if (moveOpen[CUT_MOTOR] && cutMotor.distanceToGo() == 0) {
+        recordMoveEnd(CUT_MOTOR);
+    }
+    if (moveOpen[POSITION_MOTOR] && positionMotor.distanceToGo() == 0) {
+        recordMoveEnd(POSITION_MOTOR);
+    }
+}
+
+//* ************************************************************************
+//* ************************ READING **************************************
+//* ************************************************************************
+
+uint32_t copyFlightEvents(bool previous, FlightEvent* out, uint32_t maxEvents) {
+    if (previous) {
+        return hasPreviousRun ? copyFromRing(previousRun, out, maxEvents) : 0;
+    }
+    return copyFromLiveRing(out, maxEvents);
+}
+
+const char* flightSensorName(uint8_t sensor) {
+    return sensor < FLIGHT_SENSOR_COUNT ? SENSOR_NAMES[sensor] : "unknown";
+}
+
+const char* flightClampName(uint8_t clamp) {
+    return clamp < sizeof(CLAMP_NAMES) / sizeof(CLAMP_NAMES[0]) ? CLAMP_NAMES[clamp] : "unknown";
+}
+
+void renderFlightRecorderLog(Print& out) {
+    if (hasPreviousRun) {
+        out.printf("=== Previous run (%u events recorded, ended by %s reset) ===\n",
+                   (unsigned)previousRun.head.load(), resetReasonName(bootResetReason));
+        out.print("     time ms  event\n");
+        printRing(previousRun, FLIGHT_RECORDER_CAPACITY, out);
+    } else {
+        out.print("=== No previous run in RTC memory ===\n");
+    }
+    //! The live ring is copied first - printing to a client is far slower
+    //! than the loop records
+    FlightEvent* events = (FlightEvent*)malloc(sizeof(FlightEvent) * FLIGHT_RECORDER_CAPACITY);
+    if (events == nullptr) {
+        out.print("=== Current run: no memory for a copy ===\n");
+        return;
+    }
+    uint32_t count = copyFromLiveRing(events, FLIGHT_RECORDER_CAPACITY);
+    out.printf("=== Current run (%u events recorded) ===\n", (unsigned)flightRecorderRing.head.load());
+    out.print("     time ms  event\n");
+    for (uint32_t i = 0; i < count; i++) {
+        printEvent(events[i], out);
+    }
+    free(events);
+}
@@ -0,0 +1,125 @@
+#include "Diagnostics/SensorTrace.h"
+#include "Config/Pins_Definitions.h"
+#include "Console/SerialConsole.h"
+#include <esp_timer.h>
+
+//* ************************************************************************
+//* ************************ SENSOR TRACE *********************************
+//* ************************************************************************
+//! RAM ring of raw input edges and its text dump
+
+namespace {
+
+SensorTraceEdge traceRing[SENSOR_TRACE_CAPACITY];
+uint32_t traceHead = 0;        // Total edges written; index = head % capacity
+uint8_t lastPinLevels[FLIGHT_SENSOR_COUNT] = {0};
+
+void recordEdge(uint8_t input, uint8_t level, bool initial) {
+    SensorTraceEdge& edge = traceRing[traceHead & (SENSOR_TRACE_CAPACITY - 1)];
+    edge.timeUs = esp_timer_get_time();
+    edge.input = input;
+    edge.level = level;
+    edge.initial = initial ? 1 : 0;
+    traceHead++;
+}
+
+void sensorTraceConsoleCommand(const char* args, Print& out) {
+    if (strncmp(args, "clear", 5) == 0) {
+        clearSensorTrace();
+        out.println("Sensor trace cleared");
+        return;
+    }
+    renderSensorTrace(out);
+}
+
+} // namespace
+
+//* ************************************************************************
+//* ************************ SETUP ****************************************
+//* ************************************************************************
+
+void initSensorTrace() {
+    clearSensorTrace();
+    registerConsoleCommand("sensortrace", sensorTraceConsoleCommand, "Raw input edge trace for sim --replay ('sensortrace clear' restarts)");
+}
+
+void clearSensorTrace() {
+    traceHead = 0;
+    for (uint8_t i = 0; i < FLIGHT_SENSOR_COUNT; i++) {
+        lastPinLevels[i] = digitalRead(sensorTracePin(i)) ? 1 : 0;
+        recordEdge(i, lastPinLevels[i], true);
+    }
+}
+
+//* ************************************************************************
+//* ************************ RUNTIME **************************************
+//* ************************************************************************
+
+void sampleSensorTrace() {
+    for (uint8_t i = 0; i < FLIGHT_SENSOR_COUNT; i++) {
+        uint8_t level = digitalRead(sensorTracePin(i)) ? 1 : 0;
+        if (level != lastPinLevels[i]) {
+            lastPinLevels[i] = level;
+            recordEdge(i, level, false);
+        }
+    }
+}
+
+int sensorTracePin(uint8_t input) {
+    switch (input) {
+        case FLIGHT_SENSOR_WOOD: return WOOD_SENSOR;
+        case FLIGHT_SENSOR_WOOD_SUCTION: return WAS_WOOD_SUCTIONED_SENSOR;
+        case FLIGHT_SENSOR_CUT_HOME: return CUT_MOTOR_HOMING_SWITCH;
+        case FLIGHT_SENSOR_POSITION_HOME: return POSITION_MOTOR_HOMING_SWITCH;
+        case FLIGHT_SENSOR_START_SWITCH: return START_CYCLE_SWITCH;
+        case FLIGHT_SENSOR_RELOAD_SWITCH: return RELOAD_SWITCH;
+        case FLIGHT_SENSOR_FIX_BUTTON: return FIX_POSITION_BUTTON;
+        default: return -1;
+    }
+}
+
+//* ************************************************************************
+//* ************************ RENDERING ************************************
+//* ************************************************************************
+
+void renderSensorTrace(Print& out) {
+    //! Step 1: Snapshot the ring so the loop task can keep recording
+    uint32_t head = traceHead;
+    uint32_t count = head < SENSOR_TRACE_CAPACITY ? head : SENSOR_TRACE_CAPACITY;
+    SensorTraceEdge* edges = (SensorTraceEdge*)malloc(sizeof(SensorTraceEdge) * count);
+    if (edges == nullptr) {
+        out.print("# table-saw sensor trace v1\n# out of memory\n");
+        return;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        edges[i] = traceRing[(head - count + i) & (SENSOR_TRACE_CAPACITY - 1)];
+    }
+
+    out.print("# table-saw sensor trace v1\n");
+    out.print("# <time_us since boot> <input> <raw pin level>; a level holds until the input's next line\n");
+    out.printf("# %lu edges, %lu older edges overwritten\n", (unsigned long)count,
+               (unsigned long)(head - count));
+
+    //! Step 2: After a wrap, the starting levels are gone - each input was
+    //! at the opposite of its first kept edge, or is still at its current level
+    if (head > SENSOR_TRACE_CAPACITY && count > 0) {
+        for (uint8_t input = 0; input < FLIGHT_SENSOR_COUNT; input++) {
+            int level = lastPinLevels[input];
+            for (uint32_t i = 0; i < count; i++) {
+                if (edges[i].input == input) {
+                    level = edges[i].initial ? -1 : !edges[i].level;
+                    break;
+                }
+            }
+            if (level >= 0) {
+                out.printf("%lld %s %d\n", (long long)edges[0].timeUs, flightSensorName(input), level);
+            }
+        }
+    }
+
+    //! Step 3: The edges, oldest first
+    for (uint32_t i = 0; i < count; i++) {
+        out.printf("%lld %s %u\n", (long long)edges[i].timeUs, flightSensorName(edges[i].input), edges[i].level);
+    }
+    free(edges);
+}
@@ -0,0 +1,351 @@
+#include "Diagnostics/StepRateBenchmark.h"
+#include <AccelStepper.h>
+#include <Bounce2.h>
+#include <ctype.h>
+#include <math.h>
+#include "Config/Config.h"
+#include "Config/Pins_Definitions.h"
+#include "StateMachine/StateMachine.h"
+#include "StateMachine/Pneumatics.h"
+#include "StateMachine/FastStop.h"
+#include "Console/SerialConsole.h"
+
+//* ************************************************************************
+//* ************************ STEP RATE BENCHMARK **************************
+//* ************************************************************************
+//! Times the step pulses of real moves with the production AccelStepper
+//! objects. Only steps taken at the commanded speed (the cruise part of the
+//! move) count, so the ramps do not dilute the result. AccelStepper steps
+//! at most once per run() call and never catches up on a late step, so any
+//! time spent between run() calls shows up directly as a lower rate.
+
+extern AccelStepper cutMotor;
+extern AccelStepper positionMotor;
+extern Bounce startCycleSwitch;
+extern bool isHomed;
+
+namespace {
+
+// Commanded speeds tried on each axis (steps/s)
+const float BENCHMARK_SPEEDS[] = {1000, 2500, 5000, 7500, 10000, 15000, 20000, 25000, 30000, 40000, 50000};
+const int BENCHMARK_SPEED_COUNT = sizeof(BENCHMARK_SPEEDS) / sizeof(BENCHMARK_SPEEDS[0]);
+
+// A speed is sustained when the cruise rate is within this of the command
+const float SUSTAINED_RATIO = 0.98f;
+
+// Stop climbing after this many speeds in a row below the ratio
+const int MAX_FAILED_SPEEDS = 2;
+
+// The benchmark ramps reach cruise within this share of the travel, so the
+// acceleration grows with the speed (never below the configured one)
+const float RAMP_SHARE_OF_TRAVEL = 0.25f;
+
+const unsigned long MOVE_TIMEOUT_MS = 10000;
+const unsigned long DEFAULT_LOG_INTERVAL_MS = 10;
+
+struct BenchmarkAxis {
+    const char* name;
+    MotorType motor;
+    AccelStepper* stepper;
+    const long* travelSteps;
+    const float* configuredSpeed;
+    const float* configuredAcceleration;
+};
+
+const BenchmarkAxis BENCHMARK_AXES[] = {
+    {"cut", CUT_MOTOR, &cutMotor, &CUT_MOTOR_CUT_POSITION, &CUT_MOTOR_CUTTING_SPEED, &CUT_MOTOR_NORMAL_ACCELERATION},
+    {"position", POSITION_MOTOR, &positionMotor, &POSITION_MOTOR_TRAVEL_POSITION, &POSITION_MOTOR_NORMAL_SPEED,
+     &POSITION_MOTOR_NORMAL_ACCELERATION},
+};
+
+const int BENCHMARK_AXIS_COUNT = sizeof(BENCHMARK_AXES) / sizeof(BENCHMARK_AXES[0]);
+
+// Moves the firmware makes in production, as the state machine commands them
+struct ConfiguredMove {
+    const char* name;
+    MotorType motor;
+    const float* speed;
+    const float* acceleration;
+    const long* distanceSteps;
+};
+
+// Note: moveMotorTo() applies the normal acceleration to every move; only
+// moveCutMotorToHome() (YESWOOD) uses the return acceleration
+const ConfiguredMove CONFIGURED_MOVES[] = {
+    {"cut stroke", CUT_MOTOR, &CUT_MOTOR_CUTTING_SPEED, &CUT_MOTOR_NORMAL_ACCELERATION, &CUT_MOTOR_CUT_POSITION},
+    {"cut return", CUT_MOTOR, &CUT_MOTOR_RETURN_SPEED, &CUT_MOTOR_RETURN_ACCELERATION, &CUT_MOTOR_CUT_POSITION},
+    {"position advance", POSITION_MOTOR, &POSITION_MOTOR_NORMAL_SPEED, &POSITION_MOTOR_NORMAL_ACCELERATION, &POSITION_MOTOR_TRAVEL_POSITION},
+    {"position return", POSITION_MOTOR, &POSITION_MOTOR_RETURN_SPEED, &POSITION_MOTOR_NORMAL_ACCELERATION, &POSITION_MOTOR_TRAVEL_POSITION},
+};
+
+const int CONFIGURED_MOVE_COUNT = sizeof(CONFIGURED_MOVES) / sizeof(CONFIGURED_MOVES[0]);
+
+// Cruise steps and their duration, summed over the moves of one measurement
+struct CruiseTiming {
+    uint32_t intervals;
+    uint32_t micros;
+};
+
+struct SpeedResult {
+    float commanded;
+    float quietRate;        // 0 = no cruise reached or move failed
+    float loggingRate;
+};
+
+bool benchmarkPending = false;
+bool benchmarkAxisSelected[BENCHMARK_AXIS_COUNT];
+unsigned long benchmarkLogIntervalMs = DEFAULT_LOG_INTERVAL_MS;
+
+//* ************************************************************************
+//* ************************ MEASUREMENT **********************************
+//* ************************************************************************
+
+// One move, timing the steps taken at cruise. Returns false on a timeout.
+bool runTimedMove(AccelStepper& stepper, long target, float speed, unsigned long logIntervalMs,
+                  CruiseTiming& timing) {
+    stepper.moveTo(target);
+    const float cruiseSpeed = speed * 0.999f;
+    long lastPosition = stepper.currentPosition();
+    uint32_t firstCruiseUs = 0;
+    uint32_t lastCruiseUs = 0;
+    uint32_t cruiseSteps = 0;
+    unsigned long startMs = millis();
+    unsigned long lastLogMs = startMs;
+
+    while (stepper.distanceToGo() != 0) {
+        stepper.run();
+        long position = stepper.currentPosition();
+        if (position != lastPosition) {
+            lastPosition = position;
+            if (fabsf(stepper.speed()) >= cruiseSpeed) {
+                uint32_t now = micros();
+                if (cruiseSteps == 0) {
+                    firstCruiseUs = now;
+                }
+                lastCruiseUs = now;
+                cruiseSteps++;
+            }
+        }
+        if (logIntervalMs > 0 && millis() - lastLogMs >= logIntervalMs) {
+            lastLogMs = millis();
+            Serial.printf("STEPRATE: position %ld speed %.0f\n", position, stepper.speed());
+        }
+        if (millis() - startMs > MOVE_TIMEOUT_MS) {
+            stepper.setCurrentPosition(stepper.currentPosition());
+            Serial.println("STEPRATE: ERROR - move timed out");
+            return false;
+        }
+        if (fastStopTripped()) {
+            stepper.setCurrentPosition(stepper.currentPosition());
+            Serial.println("STEPRATE: ERROR - fast stop tripped");
+            return false;
+        }
+    }
+
+    if (cruiseSteps > 1) {
+        timing.intervals += cruiseSteps - 1;
+        timing.micros += lastCruiseUs - firstCruiseUs;
+    }
+    return true;
+}
+
+// Out to the end of travel and back at one speed; returns the cruise rate (0 = none)
+float measureCruiseRate(const BenchmarkAxis& axis, float speed, unsigned long logIntervalMs, bool& ok) {
+    AccelStepper& stepper = *axis.stepper;
+    float rampSteps = RAMP_SHARE_OF_TRAVEL * *axis.travelSteps;
+    float acceleration = speed * speed / (2.0f * rampSteps);
+    if (acceleration < *axis.configuredAcceleration) {
+        acceleration = *axis.configuredAcceleration;
+    }
+    stepper.setMaxSpeed(speed);
+    stepper.setAcceleration(acceleration);
+
+    CruiseTiming timing = {0, 0};
+    ok = runTimedMove(stepper, *axis.travelSteps, speed, logIntervalMs, timing) &&
+         runTimedMove(stepper, 0, speed, logIntervalMs, timing);
+    yield();
+    return timing.micros > 0 ? timing.intervals * 1e6f / timing.micros : 0.0f;
+}
+
+float highestSustained(const SpeedResult results[], int count, bool logging) {
+    float highest = 0;
+    for (int i = 0; i < count; i++) {
+        float rate = logging ? results[i].loggingRate : results[i].quietRate;
+        if (rate >= results[i].commanded * SUSTAINED_RATIO) {
+            highest = results[i].commanded;
+        }
+    }
+    return highest;
+}
+
+//* ************************************************************************
+//* ************************ REPORT ***************************************
+//* ************************************************************************
+
+void printRate(float rate, float commanded) {
+    if (rate > 0) {
+        Serial.printf(" %9.0f %6.1f%%", rate, 100.0f * rate / commanded);
+    } else {
+        Serial.printf(" %9s %7s", "-", "");
+    }
+}
+
+// Peak speed of a rest-to-rest move: the ramp may end before the commanded speed
+void printConfiguredMoves(MotorType motor, float sustainedQuiet, float sustainedLogging) {
+    for (int i = 0; i < CONFIGURED_MOVE_COUNT; i++) {
+        const ConfiguredMove& move = CONFIGURED_MOVES[i];
+        if (move.motor != motor) {
+            continue;
+        }
+        float rampPeak = sqrtf(*move.acceleration * *move.distanceSteps);
+        float peak = rampPeak < *move.speed ? rampPeak : *move.speed;
+        const char* verdict = "delivered";
+        if (peak > sustainedQuiet) {
+            verdict = "NOT DELIVERED - above the sustained rate";
+        } else if (peak > sustainedLogging) {
+            verdict = "delivered only with logging off";
+        }
+        Serial.printf("  %-17s %7.0f steps/s over %ld steps @ %.0f steps/s^2: peaks at %.0f steps/s%s - %s\n",
+                      move.name, *move.speed, *move.distanceSteps, *move.acceleration, peak,
+                      rampPeak < *move.speed ? " (ramp never reaches cruise)" : "", verdict);
+    }
+}
+
+// Unmeasured move at the configured speed and acceleration
+bool moveAndWait(const BenchmarkAxis& axis, long target) {
+    CruiseTiming unused = {0, 0};
+    axis.stepper->setMaxSpeed(*axis.configuredSpeed);
+    axis.stepper->setAcceleration(*axis.configuredAcceleration);
+    return runTimedMove(*axis.stepper, target, *axis.configuredSpeed, 0, unused);
+}
+
+void benchmarkAxis(const BenchmarkAxis& axis, unsigned long logIntervalMs) {
+    SpeedResult results[BENCHMARK_SPEED_COUNT];
+    int count = 0;
+    int failedInRow = 0;
+    long startPosition = axis.stepper->currentPosition();
+    Serial.printf("STEPRATE: %s motor, %ld steps out and back per measurement\n", axis.name, *axis.travelSteps);
+    if (startPosition != 0 && !moveAndWait(axis, 0)) {
+        return;
+    }
+
+    //! Step 1: Climb the speed ladder, quiet then logging at each speed
+    for (int i = 0; i < BENCHMARK_SPEED_COUNT && failedInRow < MAX_FAILED_SPEEDS; i++) {
+        SpeedResult& result = results[count++];
+        bool ok = true;
+        result.commanded = BENCHMARK_SPEEDS[i];
+        result.quietRate = measureCruiseRate(axis, result.commanded, 0, ok);
+        if (ok) {
+            result.loggingRate = measureCruiseRate(axis, result.commanded, logIntervalMs, ok);
+        }
+        if (!ok) {
+            result.loggingRate = 0;
+            Serial.printf("STEPRATE: %s motor stopped at %.0f steps/s\n", axis.name, result.commanded);
+            break;
+        }
+        failedInRow = result.quietRate >= result.commanded * SUSTAINED_RATIO ? 0 : failedInRow + 1;
+    }
+
+    //! Step 2: Back to where the state machine left the axis
+    moveAndWait(axis, startPosition);
+
+    //! Step 3: Report
+    Serial.printf("STEPRATE: %s motor results (logging = one line every %lu ms)\n", axis.name, logIntervalMs);
+    Serial.printf("  %9s %9s %7s %9s %7s\n", "commanded", "quiet", "", "logging", "");
+    for (int i = 0; i < count; i++) {
+        Serial.printf("  %9.0f", results[i].commanded);
+        printRate(results[i].quietRate, results[i].commanded);
+        printRate(results[i].loggingRate, results[i].commanded);
+        Serial.println();
+    }
+    float sustainedQuiet = highestSustained(results, count, false);
+    float sustainedLogging = highestSustained(results, count, true);
+    Serial.printf("STEPRATE: %s motor sustains %.0f steps/s with logging off, %.0f steps/s with logging on\n",
+                  axis.name, sustainedQuiet, sustainedLogging);
+    printConfiguredMoves(axis.motor, sustainedQuiet, sustainedLogging);
+}
+
+void runStepRateBenchmark() {
+    startCycleSwitch.update();
+    if (startCycleSwitch.read() == HIGH) {
+        Serial.println("STEPRATE: Start cycle switch is ON - turn it OFF to run the benchmark");
+        return;
+    }
+    if (!isHomed) {
+        Serial.println("STEPRATE: Machine is not homed - benchmark cancelled");
+        return;
+    }
+
+    Serial.println("STEPRATE: === Step rate benchmark - keep clear of the machine ===");
+    unsigned long startMs = millis();
+    for (int i = 0; i < BENCHMARK_AXIS_COUNT; i++) {
+        if (!benchmarkAxisSelected[i]) {
+            continue;
+        }
+        //! Carriage moves without the wood: open the position clamp for its axis
+        bool unclampWood = BENCHMARK_AXES[i].motor == POSITION_MOTOR;
+        if (unclampWood) {
+            retractPositionClamp();
+            delay(clampSettleRemainingMs(POSITION_CLAMP_ENUM));
+        }
+        benchmarkAxis(BENCHMARK_AXES[i], benchmarkLogIntervalMs);
+        if (unclampWood) {
+            extendPositionClamp();
+        }
+    }
+    Serial.printf("STEPRATE: === Done in %.1f s ===\n", (millis() - startMs) / 1000.0f);
+}
+
+void stepRateConsoleCommand(const char* args, Print& out) {
+    char axisName[16] = "";
+    unsigned long logIntervalMs = DEFAULT_LOG_INTERVAL_MS;
+    sscanf(args, "%15s %lu", axisName, &logIntervalMs);
+    if (isdigit((unsigned char)axisName[0])) {
+        logIntervalMs = strtoul(axisName, nullptr, 10);
+        axisName[0] = '\0';
+    }
+
+    bool any = false;
+    for (int i = 0; i < BENCHMARK_AXIS_COUNT; i++) {
+        benchmarkAxisSelected[i] = axisName[0] == '\0' || strcmp(axisName, BENCHMARK_AXES[i].name) == 0;
+        any = any || benchmarkAxisSelected[i];
+    }
+    if (!any) {
+        out.println("Usage: steprate [cut|position] [log interval ms]");
+        return;
+    }
+    benchmarkLogIntervalMs = logIntervalMs > 0 ? logIntervalMs : DEFAULT_LOG_INTERVAL_MS;
+    benchmarkPending = true;
+    out.println(currentState == IDLE ? "STEPRATE: Starting" : "STEPRATE: Will start when the machine is IDLE");
+}
+
+} // namespace
+
+//* ************************************************************************
+//* ************************ SETUP ****************************************
+//* ************************************************************************
+
+void initStepRateBenchmark() {
+    registerConsoleCommand("steprate", stepRateConsoleCommand, "Measure delivered step rates ('steprate cut|position [log ms]')");
+
+    //! Boot combo: fix position button + reload switch held at power-on
+    if (digitalRead(FIX_POSITION_BUTTON) == HIGH && digitalRead(RELOAD_SWITCH) == HIGH) {
+        for (int i = 0; i < BENCHMARK_AXIS_COUNT; i++) {
+            benchmarkAxisSelected[i] = true;
+        }
+        benchmarkPending = true;
+        Serial.println("STEPRATE: Boot combo held - benchmark runs after homing (release the reload switch)");
+    }
+}
+
+//* ************************************************************************
+//* ************************ RUNTIME **************************************
+//* ************************************************************************
+
+void handleStepRateBenchmark() {
+    if (!benchmarkPending || currentState != IDLE) {
+        return;
+    }
+    benchmarkPending = false;
+    runStepRateBenchmark();
+}
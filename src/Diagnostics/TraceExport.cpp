@@ -0,0 +1,260 @@
+#include "Diagnostics/TraceExport.h"
+#include "Diagnostics/FlightRecorder.h"
+#include "StateMachine/StateMachine.h"
+#include "Metrics/Metrics.h"
+#include "Console/SerialConsole.h"
+
+//* ************************************************************************
+//* ************************ CHROME TRACE EXPORT **************************
+//* ************************************************************************
+//! Streams flight recorder events as Chrome trace JSON
+//! Each actuator gets its own track (tid) with begin/end slices: the state
+//! machine, both motors (move -> arrive), each clamp (extend -> retract),
+//! the catcher servo and the Transfer Arm signal. Sensors become counter
+//! tracks. Slices still open at the end of the log are closed there.
+
+namespace {
+
+const int TRACE_PID = 1;
+
+enum TraceTrack {
+    TRACK_STATE = 1,
+    TRACK_CUT_MOTOR,
+    TRACK_POSITION_MOTOR,
+    TRACK_CLAMP_FIRST,                     // One track per clamp ID
+    TRACK_SERVO = TRACK_CLAMP_FIRST + 3,
+    TRACK_TA_SIGNAL
+};
+
+const int CLAMP_TRACK_COUNT = 3;
+
+class TraceWriter {
+   public:
+    explicit TraceWriter(Print& out) : _out(out), _first(true) {}
+
+    void begin() { _out.print("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"); }
+    void end() { _out.print("\n]}\n"); }
+
+    void threadName(int tid, const char* name) {
+        separator();
+        _out.printf("{\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":\"%s\"}}",
+                    TRACE_PID, tid, name);
+        separator();
+        _out.printf("{\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"name\":\"thread_sort_index\",\"args\":{\"sort_index\":%d}}",
+                    TRACE_PID, tid, tid);
+    }
+
+    void processName(const char* name) {
+        separator();
+        _out.printf("{\"ph\":\"M\",\"pid\":%d,\"name\":\"process_name\",\"args\":{\"name\":\"%s\"}}",
+                    TRACE_PID, name);
+    }
+
+    void beginSlice(int tid, uint64_t ts, const char* name) {
+        separator();
+        _out.printf("{\"ph\":\"B\",\"pid\":%d,\"tid\":%d,\"ts\":%llu,\"name\":\"%s\"}",
+                    TRACE_PID, tid, (unsigned long long)ts, name);
+    }
+
+    void endSlice(int tid, uint64_t ts) {
+        separator();
+        _out.printf("{\"ph\":\"E\",\"pid\":%d,\"tid\":%d,\"ts\":%llu}", TRACE_PID, tid, (unsigned long long)ts);
+    }
+
+    void instant(int tid, uint64_t ts, const char* name) {
+        separator();
+        _out.printf("{\"ph\":\"i\",\"s\":\"t\",\"pid\":%d,\"tid\":%d,\"ts\":%llu,\"name\":\"%s\"}",
+                    TRACE_PID, tid, (unsigned long long)ts, name);
+    }
+
+    void counter(uint64_t ts, const char* name, int value) {
+        separator();
+        _out.printf("{\"ph\":\"C\",\"pid\":%d,\"ts\":%llu,\"name\":\"%s\",\"args\":{\"value\":%d}}",
+                    TRACE_PID, (unsigned long long)ts, name, value);
+    }
+
+   private:
+    void separator() {
+        if (!_first) {
+            _out.print(",\n");
+        }
+        _first = false;
+    }
+
+    Print& _out;
+    bool _first;
+};
+
+// Open slices per track, closed at the end of the log if still open
+struct OpenSlices {
+    bool state;
+    bool motor[2];
+    bool clamp[CLAMP_TRACK_COUNT];
+    bool servo;
+    bool taSignal;
+};
+
+void writeEvent(TraceWriter& trace, OpenSlices& open, const FlightEvent& event, uint64_t ts) {
+    char name[48];
+    switch (event.type) {
+        case FLIGHT_BOOT:
+            trace.instant(TRACK_STATE, ts, "BOOT");
+            break;
+
+        case FLIGHT_STATE:
+            if (open.state) {
+                trace.endSlice(TRACK_STATE, ts);
+            }
+            trace.beginSlice(TRACK_STATE, ts, getStateName((SystemState)event.value));
+            open.state = true;
+            break;
+
+        case FLIGHT_ERROR:
+            snprintf(name, sizeof(name), "ERROR %s", errorCounterLabel((ErrorCounterType)event.subject));
+            trace.instant(TRACK_STATE, ts, name);
+            break;
+
+        case FLIGHT_MOVE_START: {
+            int motor = event.subject & 1;
+            int tid = motor == CUT_MOTOR ? TRACK_CUT_MOTOR : TRACK_POSITION_MOTOR;
+            if (open.motor[motor]) {
+                trace.endSlice(tid, ts); // Retargeted before arriving
+            }
+            snprintf(name, sizeof(name), "move -> %d", event.value);
+            trace.beginSlice(tid, ts, name);
+            open.motor[motor] = true;
+            break;
+        }
+
+        case FLIGHT_MOVE_END: {
+            int motor = event.subject & 1;
+            if (open.motor[motor]) {
+                trace.endSlice(motor == CUT_MOTOR ? TRACK_CUT_MOTOR : TRACK_POSITION_MOTOR, ts);
+                open.motor[motor] = false;
+            }
+            break;
+        }
+
+        case FLIGHT_CLAMP:
+            if (event.subject < CLAMP_TRACK_COUNT) {
+                int tid = TRACK_CLAMP_FIRST + event.subject;
+                if (event.value && !open.clamp[event.subject]) {
+                    trace.beginSlice(tid, ts, "extended");
+                    open.clamp[event.subject] = true;
+                } else if (!event.value && open.clamp[event.subject]) {
+                    trace.endSlice(tid, ts);
+                    open.clamp[event.subject] = false;
+                }
+            }
+            break;
+
+        case FLIGHT_SERVO:
+            trace.counter(ts, "catcher_servo_deg", event.value);
+            if (event.value != CATCHER_SERVO_HOME_POSITION && !open.servo) {
+                trace.beginSlice(TRACK_SERVO, ts, "active");
+                open.servo = true;
+            } else if (event.value == CATCHER_SERVO_HOME_POSITION && open.servo) {
+                trace.endSlice(TRACK_SERVO, ts);
+                open.servo = false;
+            }
+            break;
+
+        case FLIGHT_SIGNAL:
+            if (event.value && !open.taSignal) {
+                trace.beginSlice(TRACK_TA_SIGNAL, ts, "signal");
+                open.taSignal = true;
+            } else if (!event.value && open.taSignal) {
+                trace.endSlice(TRACK_TA_SIGNAL, ts);
+                open.taSignal = false;
+            }
+            break;
+
+        case FLIGHT_SENSOR:
+            snprintf(name, sizeof(name), "sensor %s", flightSensorName(event.subject));
+            trace.counter(ts, name, event.value);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void closeOpenSlices(TraceWriter& trace, const OpenSlices& open, uint64_t ts) {
+    if (open.state) trace.endSlice(TRACK_STATE, ts);
+    if (open.motor[CUT_MOTOR]) trace.endSlice(TRACK_CUT_MOTOR, ts);
+    if (open.motor[POSITION_MOTOR]) trace.endSlice(TRACK_POSITION_MOTOR, ts);
+    for (int i = 0; i < CLAMP_TRACK_COUNT; i++) {
+        if (open.clamp[i]) trace.endSlice(TRACK_CLAMP_FIRST + i, ts);
+    }
+    if (open.servo) trace.endSlice(TRACK_SERVO, ts);
+    if (open.taSignal) trace.endSlice(TRACK_TA_SIGNAL, ts);
+}
+
+void traceConsoleCommand(const char* args, Print& out) {
+    renderChromeTrace(out, strncmp(args, "prev", 4) == 0);
+}
+
+} // namespace
+
+//* ************************************************************************
+//* ************************ SETUP ****************************************
+//* ************************************************************************
+
+void initTraceExport() {
+    registerConsoleCommand("trace", traceConsoleCommand, "Chrome trace JSON of the flight recorder ('trace prev' for previous run)");
+}
+
+//* ************************************************************************
+//* ************************ RENDERING ************************************
+//* ************************************************************************
+
+void renderChromeTrace(Print& out, bool previousRun) {
+    //! Step 1: Snapshot the ring so the loop task can keep recording
+    FlightEvent* events = (FlightEvent*)malloc(sizeof(FlightEvent) * FLIGHT_RECORDER_CAPACITY);
+    if (events == nullptr) {
+        out.print("{\"traceEvents\":[]}\n");
+        return;
+    }
+    uint32_t count = copyFlightEvents(previousRun, events, FLIGHT_RECORDER_CAPACITY);
+
+    //! Step 2: Track metadata
+    TraceWriter trace(out);
+    trace.begin();
+    trace.processName(previousRun ? "Table saw (previous run)" : "Table saw");
+    trace.threadName(TRACK_STATE, "State machine");
+    trace.threadName(TRACK_CUT_MOTOR, "Cut motor");
+    trace.threadName(TRACK_POSITION_MOTOR, "Position motor");
+    for (int i = 0; i < CLAMP_TRACK_COUNT; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "Clamp: %s", flightClampName(i));
+        trace.threadName(TRACK_CLAMP_FIRST + i, name);
+    }
+    trace.threadName(TRACK_SERVO, "Catcher servo");
+    trace.threadName(TRACK_TA_SIGNAL, "Transfer Arm signal");
+
+    //! Step 3: Events - micros() wraps every ~71 minutes, so unwrap to 64 bits
+    OpenSlices open = {};
+    uint64_t epoch = 0;
+    uint32_t lastTimeUs = count > 0 ? events[0].timeUs : 0;
+    uint64_t ts = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (events[i].timeUs < lastTimeUs) {
+            epoch += 1ULL << 32;
+        }
+        lastTimeUs = events[i].timeUs;
+        ts = epoch + events[i].timeUs;
+        writeEvent(trace, open, events[i], ts);
+    }
+    closeOpenSlices(trace, open, ts);
+    trace.end();
+
+    free(events);
+}
+
+void renderCurrentRunTrace(Print& out) {
+    renderChromeTrace(out, false);
+}
+
+void renderPreviousRunTrace(Print& out) {
+    renderChromeTrace(out, true);
+}
@@ -0,0 +1,293 @@
+#include "Diagnostics/ValveCalibration.h"
+#include <Bounce2.h>
+#include <ctype.h>
+#include <math.h>
+#include "Config/Config.h"
+#include "Config/ConfigRegistry.h"
+#include "Config/Pins_Definitions.h"
+#include "StateMachine/StateMachine.h"
+#include "StateMachine/Pneumatics.h"
+#include "Console/SerialConsole.h"
+
+//* ************************************************************************
+//* ************************ VALVE CALIBRATION ****************************
+//* ************************************************************************
+//! Switches each clamp valve and polls the two board sensors until they
+//! have been quiet for a while. Both inputs are read raw every pass, so
+//! the resolution is one poll (a few microseconds), well below the
+//! millisecond the tunables are kept in.
+
+extern Bounce startCycleSwitch;
+extern bool isHomed;
+
+namespace {
+
+const int DEFAULT_REPETITIONS = 5;
+const int MAX_REPETITIONS = 9;
+
+// Longest latency looked for, and the quiet time that ends a measurement
+const uint32_t EDGE_WINDOW_US = 1500000;
+const uint32_t QUIET_US = 50000;
+
+// Report a latency this far off the value it replaces
+const float DRIFT_WARNING_PERCENT = 25.0f;
+
+// The settle timer counts whole millis() ticks from the valve command, so it
+// can run out up to a tick early; stored timings carry that tick
+const unsigned long SETTLE_TIMER_TICK_MS = 1;
+
+// woodSensor / wasWoodSuctionedSensor debounce interval (main.cpp)
+const uint32_t SENSOR_DEBOUNCE_US = 5000;
+
+struct CalibrationInput {
+    const char* name;
+    const int* pin;
+};
+
+const CalibrationInput INPUTS[] = {
+    {"wood sensor", &WOOD_SENSOR},
+    {"suction sensor", &WAS_WOOD_SUCTIONED_SENSOR},
+};
+
+const int INPUT_COUNT = sizeof(INPUTS) / sizeof(INPUTS[0]);
+
+struct CalibratedValve {
+    const char* name;
+    ClampType clamp;
+    const char* extendParameter;    // Config registry names
+    const char* retractParameter;
+};
+
+const CalibratedValve VALVES[] = {
+    {"position clamp", POSITION_CLAMP_ENUM, "POSITION_CLAMP_EXTEND_MS", "POSITION_CLAMP_RETRACT_MS"},
+    {"wood secure clamp", WOOD_SECURE_CLAMP_ENUM, "WOOD_SECURE_CLAMP_EXTEND_MS", "WOOD_SECURE_CLAMP_RETRACT_MS"},
+    {"catcher clamp", CATCHER_CLAMP_ENUM, "CATCHER_CLAMP_EXTEND_MS", "CATCHER_CLAMP_RETRACT_MS"},
+};
+
+const int VALVE_COUNT = sizeof(VALVES) / sizeof(VALVES[0]);
+
+// One direction of one valve over all repetitions
+struct SwitchSamples {
+    int count;                                  // Switches that produced an edge
+    uint32_t latencyUs[MAX_REPETITIONS];        // Command to first edge on any input
+    int settleCount[INPUT_COUNT];
+    uint32_t settleUs[INPUT_COUNT][MAX_REPETITIONS];   // First to last edge, per input
+};
+
+bool calibrationPending = false;
+bool calibrationCheckOnly = false;
+int calibrationRepetitions = DEFAULT_REPETITIONS;
+
+//* ************************************************************************
+//* ************************ MEASUREMENT **********************************
+//* ************************************************************************
+
+// Switches the valve and watches both inputs until they go quiet (or the
+// window ends); adds one sample if any input moved
+void switchAndWatch(ClampType clamp, bool extend, SwitchSamples& samples) {
+    int levels[INPUT_COUNT];
+    bool seen[INPUT_COUNT];
+    uint32_t firstEdgeUs[INPUT_COUNT];
+    uint32_t lastEdgeUs[INPUT_COUNT];
+    for (int i = 0; i < INPUT_COUNT; i++) {
+        levels[i] = digitalRead(*INPUTS[i].pin);
+        seen[i] = false;
+        firstEdgeUs[i] = 0;
+        lastEdgeUs[i] = 0;
+    }
+    bool anyEdge = false;
+    uint32_t firstAnyUs = 0;
+    uint32_t lastAnyUs = 0;
+
+    uint32_t startUs = micros();
+    if (extend) {
+        extendClamp(clamp);
+    } else {
+        retractClamp(clamp);
+    }
+    for (;;) {
+        uint32_t now = micros();
+        for (int i = 0; i < INPUT_COUNT; i++) {
+            int level = digitalRead(*INPUTS[i].pin);
+            if (level == levels[i]) {
+                continue;
+            }
+            levels[i] = level;
+            if (!seen[i]) {
+                seen[i] = true;
+                firstEdgeUs[i] = now;
+            }
+            lastEdgeUs[i] = now;
+            if (!anyEdge) {
+                anyEdge = true;
+                firstAnyUs = now;
+            }
+            lastAnyUs = now;
+        }
+        if ((anyEdge && now - lastAnyUs >= QUIET_US) || now - startUs >= EDGE_WINDOW_US) {
+            break;
+        }
+    }
+
+    if (!anyEdge) {
+        return;
+    }
+    samples.latencyUs[samples.count++] = firstAnyUs - startUs;
+    for (int i = 0; i < INPUT_COUNT; i++) {
+        if (seen[i]) {
+            samples.settleUs[i][samples.settleCount[i]++] = lastEdgeUs[i] - firstEdgeUs[i];
+        }
+    }
+}
+
+uint32_t median(uint32_t values[], int count) {
+    for (int i = 1; i < count; i++) {
+        uint32_t value = values[i];
+        int j = i - 1;
+        while (j >= 0 && values[j] > value) {
+            values[j + 1] = values[j];
+            j--;
+        }
+        values[j + 1] = value;
+    }
+    return values[count / 2];
+}
+
+//* ************************************************************************
+//* ************************ REPORT AND STORE *****************************
+//* ************************************************************************
+
+// Reports one direction and, with apply, writes the median into its tunable;
+// true if set
+bool reportAndApply(const CalibratedValve& valve, bool extend, SwitchSamples& samples, int repetitions,
+                    bool apply) {
+    const char* parameterName = extend ? valve.extendParameter : valve.retractParameter;
+    const ConfigParameter* parameter = findConfigParameter(parameterName);
+    unsigned long previousMs = clampLatencyMs(valve.clamp, extend);
+    const char* direction = extend ? "extend" : "retract";
+
+    if (samples.count == 0 || parameter == nullptr) {
+        Serial.printf("VALVECAL: %s %s: no signal on either sensor - keeps %lu ms\n", valve.name, direction,
+                      previousMs);
+        return false;
+    }
+    uint32_t lowUs = samples.latencyUs[0];
+    uint32_t highUs = samples.latencyUs[0];
+    for (int i = 1; i < samples.count; i++) {
+        lowUs = samples.latencyUs[i] < lowUs ? samples.latencyUs[i] : lowUs;
+        highUs = samples.latencyUs[i] > highUs ? samples.latencyUs[i] : highUs;
+    }
+    uint32_t medianUs = median(samples.latencyUs, samples.count);
+    unsigned long measuredMs = (medianUs + 999) / 1000 + SETTLE_TIMER_TICK_MS;
+    float driftPercent = previousMs > 0 ? 100.0f * ((float)measuredMs - (float)previousMs) / previousMs : 0.0f;
+    Serial.printf("VALVECAL: %s %s: %lu ms (measured %.1f..%.1f, %d/%d seen), was %lu ms (%+.0f%%)\n", valve.name,
+                  direction, measuredMs, lowUs / 1000.0f, highUs / 1000.0f, samples.count, repetitions, previousMs,
+                  driftPercent);
+    if (previousMs > 0 && fabsf(driftPercent) > DRIFT_WARNING_PERCENT) {
+        Serial.printf("VALVECAL: WARNING - %s %s is %.0f%% off its stored timing (air pressure, valve wear?)\n",
+                      valve.name, direction, driftPercent);
+    }
+
+    //! Sensor settling: chatter the debounce does not cover reaches the state machine
+    for (int i = 0; i < INPUT_COUNT; i++) {
+        if (samples.settleCount[i] == 0) {
+            continue;
+        }
+        uint32_t settleUs = median(samples.settleUs[i], samples.settleCount[i]);
+        Serial.printf("VALVECAL:   %s settles %.1f ms after the first edge%s\n", INPUTS[i].name,
+                      settleUs / 1000.0f,
+                      settleUs > SENSOR_DEBOUNCE_US ? " - WARNING: longer than its 5 ms debounce" : "");
+    }
+
+    if (!apply) {
+        return false;
+    }
+    char error[64];
+    if (!setConfigValue(*parameter, (float)measuredMs, error, sizeof(error))) {
+        Serial.printf("VALVECAL: %s not set: %s\n", parameterName, error);
+        return false;
+    }
+    return true;
+}
+
+void runValveCalibration(bool checkOnly, int repetitions) {
+    startCycleSwitch.update();
+    if (startCycleSwitch.read() == HIGH) {
+        Serial.println("VALVECAL: Start cycle switch is ON - turn it OFF to calibrate");
+        return;
+    }
+    if (!isHomed) {
+        Serial.println("VALVECAL: Machine is not homed - calibration cancelled");
+        return;
+    }
+    if (digitalRead(WOOD_SENSOR) == HIGH) {
+        Serial.println("VALVECAL: WARNING - no board at the wood sensor; the holding clamps may give no signal");
+    }
+
+    Serial.printf("VALVECAL: === Valve calibration, %d switches each way - keep clear of the machine ===\n",
+                  repetitions);
+    unsigned long startMs = millis();
+    int applied = 0;
+    for (int v = 0; v < VALVE_COUNT; v++) {
+        const CalibratedValve& valve = VALVES[v];
+        //! Out and back from where the state machine left the valve
+        bool startExtended = clampExtended(valve.clamp);
+        SwitchSamples away = {};
+        SwitchSamples back = {};
+        for (int r = 0; r < repetitions; r++) {
+            switchAndWatch(valve.clamp, !startExtended, away);
+            switchAndWatch(valve.clamp, startExtended, back);
+            yield();
+        }
+        applied += reportAndApply(valve, !startExtended, away, repetitions, !checkOnly) ? 1 : 0;
+        applied += reportAndApply(valve, startExtended, back, repetitions, !checkOnly) ? 1 : 0;
+    }
+
+    if (checkOnly) {
+        Serial.println("VALVECAL: Check only - timings unchanged");
+    } else if (applied > 0) {
+        Serial.println(saveConfigValues() ? "VALVECAL: Timings saved" : "VALVECAL: ERROR - saving the timings failed");
+    }
+    Serial.printf("VALVECAL: === Done in %.1f s ===\n", (millis() - startMs) / 1000.0f);
+}
+
+void valveCalibrationConsoleCommand(const char* args, Print& out) {
+    char mode[16] = "";
+    int repetitions = DEFAULT_REPETITIONS;
+    sscanf(args, "%15s %d", mode, &repetitions);
+    if (isdigit((unsigned char)mode[0])) {
+        repetitions = atoi(mode);
+        mode[0] = '\0';
+    }
+    if ((mode[0] != '\0' && strcmp(mode, "check") != 0) || repetitions < 1 || repetitions > MAX_REPETITIONS) {
+        out.printf("Usage: valvecal [check] [repetitions 1-%d]\n", MAX_REPETITIONS);
+        return;
+    }
+    calibrationCheckOnly = mode[0] != '\0';
+    calibrationRepetitions = repetitions;
+    calibrationPending = true;
+    out.println(currentState == IDLE ? "VALVECAL: Starting" : "VALVECAL: Will start when the machine is IDLE");
+}
+
+} // namespace
+
+//* ************************************************************************
+//* ************************ SETUP ****************************************
+//* ************************************************************************
+
+void initValveCalibration() {
+    registerConsoleCommand("valvecal", valveCalibrationConsoleCommand,
+                           "Measure clamp valve latencies ('valvecal [check] [repetitions]')");
+}
+
+//* ************************************************************************
+//* ************************ RUNTIME **************************************
+//* ************************************************************************
+
+void handleValveCalibration() {
+    if (!calibrationPending || currentState != IDLE) {
+        return;
+    }
+    calibrationPending = false;
+    runValveCalibration(calibrationCheckOnly, calibrationRepetitions);
+}
@@ -0,0 +1,247 @@
+#include "Metrics/Metrics.h"
+#include "Metrics/PersistentCounters.h"
+#include "Diagnostics/FlightRecorder.h"
+#include <esp_timer.h>
+#include <algorithm>
+
+//* ************************************************************************
+//* ************************ METRICS IMPLEMENTATION *********************
+//* ************************************************************************
+//! Production counters, cycle timing and loop-rate statistics
+//! Writers are the Arduino loop task; the only reader is the metrics server.
+//! State transitions and errors are rare, so they take the metrics lock.
+//! Loop statistics are updated every iteration and stay lock-free: each
+//! field is a single 32-bit word written by one task only.
+
+namespace {
+
+portMUX_TYPE metricsMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Production counters (guarded by metricsMux)
+uint32_t piecesCut = 0;
+uint32_t yeswoodCount = 0;
+uint32_t nowoodCount = 0;
+uint32_t errorCounts[ERROR_COUNTER_COUNT] = {0};
+
+// Cycle timing (guarded by metricsMux)
+uint32_t cycleTimesUs[CYCLE_TIME_WINDOW] = {0};
+uint32_t cycleTimeIndex = 0;
+uint32_t cyclesCompleted = 0;
+uint64_t cycleTimeSumUs = 0;
+unsigned long cycleStartUs = 0;
+bool cycleInProgress = false;
+
+// Loop statistics (single writer, lock-free)
+volatile uint32_t loopIterations = 0;
+volatile uint32_t loopPeriodSumLowUs = 0;
+volatile uint32_t loopPeriodSumHighUs = 0;
+volatile uint32_t loopPeriodMaxUs = 0;
+unsigned long lastLoopUs = 0;
+bool loopTimingStarted = false;
+
+const char* const ERROR_COUNTER_LABELS[ERROR_COUNTER_COUNT] = {
+    "wood_suction",
+    "wood_caught",
+    "cut_motor_home",
+    "position_motor_home",
+    "emergency_stop",
+    "loop_watchdog"
+};
+
+uint32_t quantileOf(uint32_t* sorted, uint32_t count, uint32_t percent) {
+    if (count == 0) {
+        return 0;
+    }
+    uint32_t rank = (count * percent + 99) / 100; // Nearest-rank method
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+} // namespace
+
+//* ************************************************************************
+//* ************************ SETUP ****************************************
+//* ************************************************************************
+
+void initMetrics() {
+    loopTimingStarted = false;
+    Serial.println("Metrics initialized");
+}
+
+//* ************************************************************************
+//* ************************ RECORDING ************************************
+//* ************************************************************************
+
+void recordLoopIteration() {
+    unsigned long now = micros();
+    uint32_t periodUs = now - lastLoopUs;
+    lastLoopUs = now;
+    if (!loopTimingStarted) {
+        // The first call measures the tail of setup(), not a loop iteration
+        loopTimingStarted = true;
+        return;
+    }
+
+    uint32_t sumLow = loopPeriodSumLowUs + periodUs;
+    if (sumLow < loopPeriodSumLowUs) {
+        loopPeriodSumHighUs = loopPeriodSumHighUs + 1;
+    }
+    loopPeriodSumLowUs = sumLow;
+    if (periodUs > loopPeriodMaxUs) {
+        loopPeriodMaxUs = periodUs;
+    }
+    loopIterations = loopIterations + 1;
+}
+
+void recordStateTransition(SystemState fromState, SystemState toState) {
+    unsigned long now = micros();
+
+    portENTER_CRITICAL(&metricsMux);
+    //! A cycle runs from entering CUTTING until YESWOOD/NOWOOD hands over
+    if (toState == CUTTING) {
+        cycleStartUs = now;
+        cycleInProgress = true;
+    }
+    bool pieceCut = fromState == CUTTING && (toState == YESWOOD || toState == NOWOOD);
+    if (pieceCut) {
+        piecesCut++;
+        if (toState == YESWOOD) {
+            yeswoodCount++;
+        } else {
+            nowoodCount++;
+        }
+    }
+    if ((fromState == YESWOOD || fromState == NOWOOD) && cycleInProgress) {
+        uint32_t cycleUs = now - cycleStartUs;
+        cycleTimesUs[cycleTimeIndex] = cycleUs;
+        cycleTimeIndex = (cycleTimeIndex + 1) % CYCLE_TIME_WINDOW;
+        cyclesCompleted++;
+        cycleTimeSumUs += cycleUs;
+        // YESWOOD -> CUTTING already restarted the clock above
+        cycleInProgress = (toState == CUTTING);
+    }
+    portEXIT_CRITICAL(&metricsMux);
+
+    if (pieceCut) {
+        persistCountCut(toState == YESWOOD);
+    }
+}
+
+void recordErrorEvent(ErrorCounterType error) {
+    if (error < 0 || error >= ERROR_COUNTER_COUNT) {
+        return;
+    }
+    portENTER_CRITICAL(&metricsMux);
+    errorCounts[error]++;
+    portEXIT_CRITICAL(&metricsMux);
+    persistCountError(error);
+    recordFlightEvent(FLIGHT_ERROR, (uint8_t)error, 0);
+}
+
+const char* errorCounterLabel(ErrorCounterType error) {
+    if (error < 0 || error >= ERROR_COUNTER_COUNT) {
+        return "unknown";
+    }
+    return ERROR_COUNTER_LABELS[error];
+}
+
+//* ************************************************************************
+//* ************************ READING **************************************
+//* ************************************************************************
+
+void getMetricsSnapshot(MetricsSnapshot& snapshot) {
+    uint32_t window[CYCLE_TIME_WINDOW];
+    uint32_t windowCount;
+
+    portENTER_CRITICAL(&metricsMux);
+    snapshot.piecesCut = piecesCut;
+    snapshot.yeswoodCount = yeswoodCount;
+    snapshot.nowoodCount = nowoodCount;
+    for (int i = 0; i < ERROR_COUNTER_COUNT; i++) {
+        snapshot.errorCounts[i] = errorCounts[i];
+    }
+    snapshot.cyclesCompleted = cyclesCompleted;
+    snapshot.cycleTimeSumUs = cycleTimeSumUs;
+    windowCount = cyclesCompleted < (uint32_t)CYCLE_TIME_WINDOW ? cyclesCompleted : CYCLE_TIME_WINDOW;
+    memcpy(window, cycleTimesUs, sizeof(window));
+    portEXIT_CRITICAL(&metricsMux);
+
+    // Sorting happens outside the lock so the loop task never waits on it
+    std::sort(window, window + windowCount);
+    snapshot.cycleTimeP50Us = quantileOf(window, windowCount, 50);
+    snapshot.cycleTimeP95Us = quantileOf(window, windowCount, 95);
+
+    snapshot.loopIterations = loopIterations;
+    snapshot.loopPeriodSumUs = ((uint64_t)loopPeriodSumHighUs << 32) | loopPeriodSumLowUs;
+    //! Max loop period is reported per scrape - a racing update may be dropped
+    snapshot.loopPeriodMaxUs = loopPeriodMaxUs;
+    loopPeriodMaxUs = 0;
+    snapshot.currentState = currentState;
+}
+
+void renderPrometheusMetrics(Print& out) {
+    MetricsSnapshot snapshot;
+    getMetricsSnapshot(snapshot);
+
+    out.print("# HELP saw_pieces_cut_total Completed cut strokes\n");
+    out.print("# TYPE saw_pieces_cut_total counter\n");
+    out.printf("saw_pieces_cut_total %u\n", (unsigned)snapshot.piecesCut);
+
+    out.print("# HELP saw_cut_outcomes_total Cut strokes by wood sensor outcome\n");
+    out.print("# TYPE saw_cut_outcomes_total counter\n");
+    out.printf("saw_cut_outcomes_total{outcome=\"yeswood\"} %u\n", (unsigned)snapshot.yeswoodCount);
+    out.printf("saw_cut_outcomes_total{outcome=\"nowood\"} %u\n", (unsigned)snapshot.nowoodCount);
+
+    out.print("# HELP saw_errors_total Detected errors by type\n");
+    out.print("# TYPE saw_errors_total counter\n");
+    for (int i = 0; i < ERROR_COUNTER_COUNT; i++) {
+        out.printf("saw_errors_total{error=\"%s\"} %u\n", ERROR_COUNTER_LABELS[i], (unsigned)snapshot.errorCounts[i]);
+    }
+
+    out.print("# HELP saw_cycle_time_seconds CUTTING to end of YESWOOD/NOWOOD, quantiles over recent cycles\n");
+    out.print("# TYPE saw_cycle_time_seconds summary\n");
+    out.printf("saw_cycle_time_seconds{quantile=\"0.5\"} %.6f\n", snapshot.cycleTimeP50Us / 1e6);
+    out.printf("saw_cycle_time_seconds{quantile=\"0.95\"} %.6f\n", snapshot.cycleTimeP95Us / 1e6);
+    out.printf("saw_cycle_time_seconds_sum %.6f\n", snapshot.cycleTimeSumUs / 1e6);
+    out.printf("saw_cycle_time_seconds_count %u\n", (unsigned)snapshot.cyclesCompleted);
+
+    out.print("# HELP saw_cycle_time_mean_seconds Mean cycle time since boot\n");
+    out.print("# TYPE saw_cycle_time_mean_seconds gauge\n");
+    out.printf("saw_cycle_time_mean_seconds %.6f\n",
+               snapshot.cyclesCompleted ? snapshot.cycleTimeSumUs / 1e6 / snapshot.cyclesCompleted : 0.0);
+
+    out.print("# HELP saw_loop_iterations_total Main loop iterations\n");
+    out.print("# TYPE saw_loop_iterations_total counter\n");
+    out.printf("saw_loop_iterations_total %u\n", (unsigned)snapshot.loopIterations);
+
+    out.print("# HELP saw_loop_time_seconds_total Time covered by main loop iterations\n");
+    out.print("# TYPE saw_loop_time_seconds_total counter\n");
+    out.printf("saw_loop_time_seconds_total %.6f\n", snapshot.loopPeriodSumUs / 1e6);
+
+    out.print("# HELP saw_loop_period_max_seconds Longest main loop iteration since the previous scrape\n");
+    out.print("# TYPE saw_loop_period_max_seconds gauge\n");
+    out.printf("saw_loop_period_max_seconds %.6f\n", snapshot.loopPeriodMaxUs / 1e6);
+
+    out.print("# HELP saw_loop_rate_hz Mean main loop rate since boot\n");
+    out.print("# TYPE saw_loop_rate_hz gauge\n");
+    out.printf("saw_loop_rate_hz %.1f\n",
+               snapshot.loopPeriodSumUs ? snapshot.loopIterations * 1e6 / snapshot.loopPeriodSumUs : 0.0);
+
+    out.print("# HELP saw_state Current state machine state\n");
+    out.print("# TYPE saw_state gauge\n");
+    for (int i = 0; i <= ERROR_RESET; i++) {
+        out.printf("saw_state{state=\"%s\"} %d\n", getStateName((SystemState)i), snapshot.currentState == i ? 1 : 0);
+    }
+
+    out.print("# HELP saw_heap_free_bytes Free heap\n");
+    out.print("# TYPE saw_heap_free_bytes gauge\n");
+    out.printf("saw_heap_free_bytes %u\n", (unsigned)ESP.getFreeHeap());
+    out.print("# HELP saw_heap_min_free_bytes Lowest free heap since boot\n");
+    out.print("# TYPE saw_heap_min_free_bytes gauge\n");
+    out.printf("saw_heap_min_free_bytes %u\n", (unsigned)ESP.getMinFreeHeap());
+
+    out.print("# HELP saw_uptime_seconds Time since boot\n");
+    out.print("# TYPE saw_uptime_seconds counter\n");
+    out.printf("saw_uptime_seconds %.3f\n", esp_timer_get_time() / 1e6);
+
+    renderPersistentMetrics(out);
+}
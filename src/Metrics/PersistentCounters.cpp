@@ -0,0 +1,357 @@
+#include "Metrics/PersistentCounters.h"
+#include "Config/Config.h"
+#include <AccelStepper.h>
+#include <Preferences.h>
+#include <esp_system.h>
+#include <freertos/semphr.h>
+
+//* ************************************************************************
+//* ************************ PERSISTENT COUNTERS **************************
+//* ************************************************************************
+//! Lifetime counters in NVS with bounded flash writes
+//! The loop task is the only writer of the session counters below. Each one
+//! is a monotonic 32-bit word, so recording is a single RAM increment with no
+//! lock. The flush task diffs them against what it last wrote and adds the
+//! difference to the stored totals - one NVS blob write per flush.
+
+//* ************************************************************************
+//* ************************ FLUSH POLICY *********************************
+//* ************************************************************************
+const unsigned long PERSIST_FLUSH_INTERVAL_MS = 5UL * 60UL * 1000UL;  // Power loss costs at most 5 minutes
+const uint32_t PERSIST_FLUSH_PIECE_THRESHOLD = 100;
+const unsigned long PERSIST_MIN_WRITE_INTERVAL_MS = 60UL * 1000UL;     // At most 1440 writes/day
+
+// External variable declarations
+extern AccelStepper cutMotor;
+extern AccelStepper positionMotor;
+
+namespace {
+
+const char* const NVS_NAMESPACE = "sawcounters";
+const char* const NVS_TOTALS_KEY = "totals";
+const uint32_t STORED_TOTALS_VERSION = 2;
+const int FLUSH_TASK_CORE = 0;
+const uint32_t FLUSH_TASK_STACK_SIZE = 4096;
+const unsigned long FLUSH_TASK_POLL_MS = 1000;
+const TickType_t SHUTDOWN_FLUSH_WAIT_TICKS = pdMS_TO_TICKS(500);
+
+// Layout of the NVS blob - bump STORED_TOTALS_VERSION when it changes
+struct StoredTotals {
+    uint32_t version;
+    uint32_t bootCount;
+    uint32_t piecesCut;
+    uint32_t yeswoodCount;
+    uint32_t nowoodCount;
+    uint32_t errorCounts[ERROR_COUNTER_COUNT];
+    uint64_t cutMotorTravelSteps;
+    uint64_t positionMotorTravelSteps;
+    uint32_t nvsWrites;
+};
+
+// Version 1 blob - four error counters, before the fast stop errors
+const int V1_ERROR_COUNTER_COUNT = 4;
+
+struct StoredTotalsV1 {
+    uint32_t version;
+    uint32_t bootCount;
+    uint32_t piecesCut;
+    uint32_t yeswoodCount;
+    uint32_t nowoodCount;
+    uint32_t errorCounts[V1_ERROR_COUNTER_COUNT];
+    uint64_t cutMotorTravelSteps;
+    uint64_t positionMotorTravelSteps;
+    uint32_t nvsWrites;
+};
+
+// Session counters (loop task writes, flush task reads)
+struct SessionCounters {
+    uint32_t boots;
+    uint32_t piecesCut;
+    uint32_t yeswoodCount;
+    uint32_t nowoodCount;
+    uint32_t errorCounts[ERROR_COUNTER_COUNT];
+    uint32_t cutMotorTravelSteps;
+    uint32_t positionMotorTravelSteps;
+};
+
+volatile SessionCounters session = {};
+long lastCutMotorPosition = 0;
+long lastPositionMotorPosition = 0;
+
+// Flush state (guarded by flushMutex)
+SemaphoreHandle_t flushMutex = nullptr;
+StoredTotals stored = {};
+SessionCounters flushed = {};
+unsigned long lastWriteMs = 0;
+volatile bool flushRequested = false;
+
+void copySession(SessionCounters& out) {
+    out.boots = session.boots;
+    out.piecesCut = session.piecesCut;
+    out.yeswoodCount = session.yeswoodCount;
+    out.nowoodCount = session.nowoodCount;
+    for (int i = 0; i < ERROR_COUNTER_COUNT; i++) {
+        out.errorCounts[i] = session.errorCounts[i];
+    }
+    out.cutMotorTravelSteps = session.cutMotorTravelSteps;
+    out.positionMotorTravelSteps = session.positionMotorTravelSteps;
+}
+
+// Totals that a flush of `current` would produce (counters wrap safely)
+StoredTotals totalsWith(const SessionCounters& current) {
+    StoredTotals totals = stored;
+    totals.bootCount += current.boots - flushed.boots;
+    totals.piecesCut += current.piecesCut - flushed.piecesCut;
+    totals.yeswoodCount += current.yeswoodCount - flushed.yeswoodCount;
+    totals.nowoodCount += current.nowoodCount - flushed.nowoodCount;
+    for (int i = 0; i < ERROR_COUNTER_COUNT; i++) {
+        totals.errorCounts[i] += current.errorCounts[i] - flushed.errorCounts[i];
+    }
+    totals.cutMotorTravelSteps += current.cutMotorTravelSteps - flushed.cutMotorTravelSteps;
+    totals.positionMotorTravelSteps += current.positionMotorTravelSteps - flushed.positionMotorTravelSteps;
+    return totals;
+}
+
+bool hasPendingCounts(const SessionCounters& current) {
+    return memcmp(&current, &flushed, sizeof(SessionCounters)) != 0;
+}
+
+// Caller holds flushMutex
+bool writeTotalsLocked() {
+    SessionCounters current;
+    copySession(current);
+    if (!hasPendingCounts(current)) {
+        return true;
+    }
+
+    StoredTotals totals = totalsWith(current);
+    totals.nvsWrites++;
+
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false)) {
+        return false;
+    }
+    bool written = prefs.putBytes(NVS_TOTALS_KEY, &totals, sizeof(totals)) == sizeof(totals);
+    prefs.end();
+
+    if (written) {
+        stored = totals;
+        flushed = current;
+        lastWriteMs = millis();
+    }
+    return written;
+}
+
+// Lifetime totals from a version 1 blob; the new error counters start at zero
+void migrateTotalsV1(const StoredTotalsV1& old) {
+    stored.bootCount = old.bootCount;
+    stored.piecesCut = old.piecesCut;
+    stored.yeswoodCount = old.yeswoodCount;
+    stored.nowoodCount = old.nowoodCount;
+    for (int i = 0; i < V1_ERROR_COUNTER_COUNT; i++) {
+        stored.errorCounts[i] = old.errorCounts[i];
+    }
+    stored.cutMotorTravelSteps = old.cutMotorTravelSteps;
+    stored.positionMotorTravelSteps = old.positionMotorTravelSteps;
+    stored.nvsWrites = old.nvsWrites;
+}
+
+void loadTotals() {
+    Preferences prefs;
+    stored = {};
+    if (prefs.begin(NVS_NAMESPACE, true)) {
+        StoredTotals loaded;
+        StoredTotalsV1 loadedV1;
+        if (prefs.getBytes(NVS_TOTALS_KEY, &loaded, sizeof(loaded)) == sizeof(loaded) &&
+            loaded.version == STORED_TOTALS_VERSION) {
+            stored = loaded;
+        } else if (prefs.getBytes(NVS_TOTALS_KEY, &loadedV1, sizeof(loadedV1)) == sizeof(loadedV1) &&
+                   loadedV1.version == 1) {
+            migrateTotalsV1(loadedV1);
+        }
+        prefs.end();
+    }
+    stored.version = STORED_TOTALS_VERSION;
+}
+
+void flushOnShutdown() {
+    flushPersistentCounters();
+}
+
+//* ************************************************************************
+//* ************************ FLUSH TASK ***********************************
+//* ************************************************************************
+
+void persistentFlushTask(void* parameter) {
+    (void)parameter;
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(FLUSH_TASK_POLL_MS));
+
+        xSemaphoreTake(flushMutex, portMAX_DELAY);
+        SessionCounters current;
+        copySession(current);
+        unsigned long sinceWrite = millis() - lastWriteMs;
+
+        //! Step 1: Is a flush due? (interval, piece threshold or explicit request)
+        bool due = hasPendingCounts(current) &&
+                   (flushRequested ||
+                    sinceWrite >= PERSIST_FLUSH_INTERVAL_MS ||
+                    current.piecesCut - flushed.piecesCut >= PERSIST_FLUSH_PIECE_THRESHOLD);
+
+        //! Step 2: Only write if the wear bound allows it
+        if (due && sinceWrite >= PERSIST_MIN_WRITE_INTERVAL_MS) {
+            if (writeTotalsLocked()) {
+                flushRequested = false;
+            } else {
+                Serial.println("Persistent counters: NVS write failed");
+            }
+        }
+        xSemaphoreGive(flushMutex);
+    }
+}
+
+} // namespace
+
+//* ************************************************************************
+//* ************************ SETUP ****************************************
+//* ************************************************************************
+
+void initPersistentCounters() {
+    flushMutex = xSemaphoreCreateMutex();
+    loadTotals();
+    session.boots = 1;
+    // The first periodic flush waits a full write interval after boot
+    lastWriteMs = millis();
+
+    esp_register_shutdown_handler(flushOnShutdown);
+    xTaskCreatePinnedToCore(persistentFlushTask, "persist", FLUSH_TASK_STACK_SIZE, nullptr,
+                            1, nullptr, FLUSH_TASK_CORE);
+
+    Serial.printf("Persistent counters loaded: boot #%u, %u pieces lifetime\n",
+                  (unsigned)(stored.bootCount + 1), (unsigned)stored.piecesCut);
+}
+
+//* ************************************************************************
+//* ************************ RECORDING ************************************
+//* ************************************************************************
+
+void persistCountCut(bool woodPresent) {
+    session.piecesCut = session.piecesCut + 1;
+    if (woodPresent) {
+        session.yeswoodCount = session.yeswoodCount + 1;
+    } else {
+        session.nowoodCount = session.nowoodCount + 1;
+    }
+}
+
+void persistCountError(ErrorCounterType error) {
+    if (error < 0 || error >= ERROR_COUNTER_COUNT) {
+        return;
+    }
+    session.errorCounts[error] = session.errorCounts[error] + 1;
+}
+
+void sampleMotorTravel() {
+    long cutPosition = cutMotor.currentPosition();
+    long positionPosition = positionMotor.currentPosition();
+    long cutDelta = cutPosition - lastCutMotorPosition;
+    long positionDelta = positionPosition - lastPositionMotorPosition;
+    lastCutMotorPosition = cutPosition;
+    lastPositionMotorPosition = positionPosition;
+
+    if (cutDelta != 0) {
+        session.cutMotorTravelSteps = session.cutMotorTravelSteps + (uint32_t)labs(cutDelta);
+    }
+    if (positionDelta != 0) {
+        session.positionMotorTravelSteps = session.positionMotorTravelSteps + (uint32_t)labs(positionDelta);
+    }
+}
+
+void rebaseMotorTravel() {
+    lastCutMotorPosition = cutMotor.currentPosition();
+    lastPositionMotorPosition = positionMotor.currentPosition();
+}
+
+//* ************************************************************************
+//* ************************ FLUSHING *************************************
+//* ************************************************************************
+
+void requestPersistentFlush() {
+    flushRequested = true;
+}
+
+void flushPersistentCounters() {
+    if (flushMutex == nullptr) {
+        return;
+    }
+    //! Forced flush ignores the wear bound - only used on OTA start and shutdown
+    if (xSemaphoreTake(flushMutex, SHUTDOWN_FLUSH_WAIT_TICKS) != pdTRUE) {
+        Serial.println("Persistent counters: flush skipped, NVS busy");
+        return;
+    }
+    if (!writeTotalsLocked()) {
+        Serial.println("Persistent counters: NVS write failed");
+    }
+    xSemaphoreGive(flushMutex);
+}
+
+//* ************************************************************************
+//* ************************ READING **************************************
+//* ************************************************************************
+
+void getPersistentTotals(PersistentTotals& totals) {
+    StoredTotals current = {};
+    if (flushMutex != nullptr && xSemaphoreTake(flushMutex, portMAX_DELAY) == pdTRUE) {
+        SessionCounters sessionNow;
+        copySession(sessionNow);
+        current = totalsWith(sessionNow);
+        xSemaphoreGive(flushMutex);
+    }
+
+    totals.bootCount = current.bootCount;
+    totals.piecesCut = current.piecesCut;
+    totals.yeswoodCount = current.yeswoodCount;
+    totals.nowoodCount = current.nowoodCount;
+    for (int i = 0; i < ERROR_COUNTER_COUNT; i++) {
+        totals.errorCounts[i] = current.errorCounts[i];
+    }
+    totals.cutMotorTravelSteps = current.cutMotorTravelSteps;
+    totals.positionMotorTravelSteps = current.positionMotorTravelSteps;
+    totals.nvsWrites = current.nvsWrites;
+}
+
+void renderPersistentMetrics(Print& out) {
+    PersistentTotals totals;
+    getPersistentTotals(totals);
+
+    out.print("# HELP saw_lifetime_pieces_cut_total Completed cut strokes across reboots\n");
+    out.print("# TYPE saw_lifetime_pieces_cut_total counter\n");
+    out.printf("saw_lifetime_pieces_cut_total %u\n", (unsigned)totals.piecesCut);
+
+    out.print("# HELP saw_lifetime_cut_outcomes_total Cut strokes by wood sensor outcome across reboots\n");
+    out.print("# TYPE saw_lifetime_cut_outcomes_total counter\n");
+    out.printf("saw_lifetime_cut_outcomes_total{outcome=\"yeswood\"} %u\n", (unsigned)totals.yeswoodCount);
+    out.printf("saw_lifetime_cut_outcomes_total{outcome=\"nowood\"} %u\n", (unsigned)totals.nowoodCount);
+
+    out.print("# HELP saw_lifetime_errors_total Detected errors by type across reboots\n");
+    out.print("# TYPE saw_lifetime_errors_total counter\n");
+    for (int i = 0; i < ERROR_COUNTER_COUNT; i++) {
+        out.printf("saw_lifetime_errors_total{error=\"%s\"} %u\n",
+                   errorCounterLabel((ErrorCounterType)i), (unsigned)totals.errorCounts[i]);
+    }
+
+    out.print("# HELP saw_lifetime_motor_travel_inches_total Cumulative motor travel across reboots\n");
+    out.print("# TYPE saw_lifetime_motor_travel_inches_total counter\n");
+    out.printf("saw_lifetime_motor_travel_inches_total{motor=\"cut\"} %.1f\n",
+               (double)totals.cutMotorTravelSteps / CUT_MOTOR_STEPS_PER_INCH);
+    out.printf("saw_lifetime_motor_travel_inches_total{motor=\"position\"} %.1f\n",
+               (double)totals.positionMotorTravelSteps / POSITION_MOTOR_STEPS_PER_INCH);
+
+    out.print("# HELP saw_boot_count Boots since the counters were first written\n");
+    out.print("# TYPE saw_boot_count counter\n");
+    out.printf("saw_boot_count %u\n", (unsigned)totals.bootCount);
+
+    out.print("# HELP saw_nvs_counter_writes_total NVS writes made by the persistent counters\n");
+    out.print("# TYPE saw_nvs_counter_writes_total counter\n");
+    out.printf("saw_nvs_counter_writes_total %u\n", (unsigned)totals.nvsWrites);
+}
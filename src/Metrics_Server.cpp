@@ -0,0 +1,263 @@
+/*
+ * Metrics_Server.cpp - Prometheus metrics endpoint for the table saw
+ *
+ * Serves production and performance counters at http://<device-ip>/metrics
+ * in the Prometheus text exposition format.
+ *
+ * The server runs in its own FreeRTOS task pinned to core 0 (the WiFi core),
+ * so accepting connections and formatting responses never runs inside the
+ * Arduino loop on core 1 where the steppers are driven.
+ *
+ * USAGE:
+ * - curl http://192.168.1.254/metrics
+ * - Prometheus scrape config: targets: ['192.168.1.254:80']
+ * - curl --data-binary @firmware.tsz http://192.168.1.254/update
+ *   (packed with "sim ota-pack", see Update/CompressedUpdate.h)
+ */
+
+#include "Metrics_Server.h"
+#include "Metrics/Metrics.h"
+#include "Diagnostics/FlightRecorder.h"
+#include "Diagnostics/TraceExport.h"
+#include "Diagnostics/SensorTrace.h"
+#include "Config/ConfigRegistry.h"
+#include "Config/Recipes.h"
+#include "Update/CompressedUpdate.h"
+#include "OTA_Manager.h"
+
+//* ************************************************************************
+//* ************************ METRICS SERVER CONFIGURATION ***************
+//* ************************************************************************
+const uint16_t METRICS_SERVER_PORT = 80;
+const int METRICS_SERVER_CORE = 0;
+const unsigned long METRICS_SERVER_POLL_MS = 20;
+
+namespace {
+
+const uint32_t METRICS_TASK_STACK_SIZE = 6144;
+const UBaseType_t METRICS_TASK_PRIORITY = 1;
+const unsigned long REQUEST_TIMEOUT_MS = 500;
+const int MAX_HEADER_LINES = 32;
+
+WiFiServer metricsServer(METRICS_SERVER_PORT);
+
+//* ************************************************************************
+//* ************************ RESPONSE BUFFERING **************************
+//* ************************************************************************
+//! Collects small prints into one TCP write per chunk
+
+class BufferedClientPrint : public Print {
+   public:
+    explicit BufferedClientPrint(WiFiClient& client) : _client(client), _used(0) {}
+    ~BufferedClientPrint() { flush(); }
+
+    size_t write(uint8_t c) override {
+        if (_used == sizeof(_buffer)) {
+            flush();
+        }
+        _buffer[_used++] = c;
+        return 1;
+    }
+
+    size_t write(const uint8_t* data, size_t size) override {
+        for (size_t i = 0; i < size; i++) {
+            write(data[i]);
+        }
+        return size;
+    }
+
+    void flush() override {
+        if (_used > 0) {
+            _client.write(_buffer, _used);
+            _used = 0;
+        }
+    }
+
+   private:
+    WiFiClient& _client;
+    uint8_t _buffer[512];
+    size_t _used;
+};
+
+//* ************************************************************************
+//* ************************ ROUTES ***************************************
+//* ************************************************************************
+
+void renderIndexPage(Print& out) {
+    out.print("Automated Table Saw - Stage 1\n");
+    out.print("/metrics  Prometheus metrics\n");
+    out.print("/flight   Flight recorder log (previous + current run)\n");
+    out.print("/trace.json           Chrome trace of the current run (ui.perfetto.dev)\n");
+    out.print("/trace-previous.json  Chrome trace of the run before the last reset\n");
+    out.print("/sensors.trace        Raw input edge trace (sim --replay)\n");
+    out.print("/config               Tunable parameters (POST /config?NAME=VALUE&save to change)\n");
+    out.print("/recipes              Cutting recipes and motion plan (POST /recipes?use=NAME to select)\n");
+    out.print("/update               POST a packed firmware image (sim ota-pack) - parks the axes, restarts\n");
+}
+
+struct HttpRoute {
+    const char* path;
+    const char* contentType;
+    void (*render)(Print& out);
+    void (*update)(const char* query, Print& out);   // POST handler, nullptr = read-only
+};
+
+const HttpRoute HTTP_ROUTES[] = {
+    {"/metrics", "text/plain; version=0.0.4", renderPrometheusMetrics, nullptr},
+    {"/flight", "text/plain", renderFlightRecorderLog, nullptr},
+    {"/trace.json", "application/json", renderCurrentRunTrace, nullptr},
+    {"/trace-previous.json", "application/json", renderPreviousRunTrace, nullptr},
+    {"/sensors.trace", "text/plain", renderSensorTrace, nullptr},
+    {"/config", "text/plain", renderConfigValues, handleConfigQuery},
+    {"/recipes", "text/plain", renderRecipes, handleRecipeQuery},
+    {"/", "text/plain", renderIndexPage, nullptr},
+};
+
+const HttpRoute* findRoute(const String& path) {
+    for (const HttpRoute& route : HTTP_ROUTES) {
+        if (path == route.path) {
+            return &route;
+        }
+    }
+    return nullptr;
+}
+
+//* ************************************************************************
+//* ************************ FIRMWARE UPLOAD ******************************
+//* ************************************************************************
+//! The body is streamed straight into the decoder, never buffered whole;
+//! the header is checked before the axes are parked, so a bad upload is
+//! answered without stopping the machine
+
+void refuseUpdateUpload(WiFiClient& client, BufferedClientPrint& out, const char* error) {
+    Serial.printf("OTA: upload refused - %s\n", error);
+    out.printf("HTTP/1.1 400 Bad Request\r\nContent-Type: text/plain\r\nConnection: close\r\n\r\n%s\n", error);
+    out.flush();
+    client.stop();
+}
+
+void handleUpdateUpload(WiFiClient& client, size_t contentLength, BufferedClientPrint& out) {
+    if (contentLength == 0) {
+        refuseUpdateUpload(client, out, "empty upload (send the image with Content-Length)");
+        return;
+    }
+    char error[96];
+    uint8_t header[COMPRESSED_IMAGE_HEADER_SIZE];
+    if (!readCompressedUpdateHeader(client, contentLength, header, error, sizeof(error))) {
+        refuseUpdateUpload(client, out, error);
+        return;
+    }
+    Serial.printf("OTA: receiving a %u byte packed image over HTTP\n", (unsigned)contentLength);
+    beginOTAUpdate();
+    bool written = receiveCompressedUpdate(client, contentLength, header, error, sizeof(error));
+    if (written) {
+        out.print("HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nConnection: close\r\n\r\nUpdate written - restarting\n");
+    } else {
+        Serial.printf("OTA: upload failed - %s\n", error);
+        out.printf("HTTP/1.1 400 Bad Request\r\nContent-Type: text/plain\r\nConnection: close\r\n\r\n%s\n", error);
+    }
+    out.flush();
+    client.stop();
+    endOTAUpdate(written);
+}
+
+//* ************************************************************************
+//* ************************ REQUEST HANDLING *****************************
+//* ************************************************************************
+
+void handleHttpClient(WiFiClient& client) {
+    client.setTimeout(REQUEST_TIMEOUT_MS);
+
+    //! Step 1: Parse request line "GET /path?query HTTP/1.1"
+    String requestLine = client.readStringUntil('\n');
+    requestLine.trim();
+    int firstSpace = requestLine.indexOf(' ');
+    int secondSpace = requestLine.indexOf(' ', firstSpace + 1);
+    String method = firstSpace > 0 ? requestLine.substring(0, firstSpace) : String();
+    String path = secondSpace > firstSpace ? requestLine.substring(firstSpace + 1, secondSpace) : String();
+    String query;
+    int queryStart = path.indexOf('?');
+    if (queryStart >= 0) {
+        query = path.substring(queryStart + 1);
+        path = path.substring(0, queryStart);
+    }
+
+    //! Step 2: Drain headers up to the blank line, keeping the body length
+    size_t contentLength = 0;
+    for (int i = 0; i < MAX_HEADER_LINES; i++) {
+        String header = client.readStringUntil('\n');
+        header.trim();
+        if (header.length() == 0) {
+            break;
+        }
+        header.toLowerCase();
+        if (header.startsWith("content-length:")) {
+            contentLength = (size_t)header.substring(15).toInt();
+        }
+    }
+
+    //! Step 3: Route and respond
+    BufferedClientPrint out(client);
+    if (method == "POST" && path == "/update") {
+        handleUpdateUpload(client, contentLength, out);
+        return;
+    }
+    const HttpRoute* route = findRoute(path);
+    bool post = method == "POST" && route != nullptr && route->update != nullptr;
+    if (route == nullptr || (method != "GET" && !post)) {
+        out.print("HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\nConnection: close\r\n\r\nNot found\n");
+    } else {
+        out.printf("HTTP/1.1 200 OK\r\nContent-Type: %s\r\nConnection: close\r\n\r\n", route->contentType);
+        if (post) {
+            route->update(query.c_str(), out);
+        } else {
+            route->render(out);
+        }
+    }
+    out.flush();
+}
+
+//* ************************************************************************
+//* ************************ SERVER TASK **********************************
+//* ************************************************************************
+
+void metricsServerTask(void* parameter) {
+    (void)parameter;
+    bool serverStarted = false;
+
+    for (;;) {
+        if (WiFi.status() != WL_CONNECTED) {
+            serverStarted = false;
+            vTaskDelay(pdMS_TO_TICKS(500));
+            continue;
+        }
+
+        if (!serverStarted) {
+            metricsServer.begin();
+            serverStarted = true;
+            Serial.print("Metrics server listening on http://");
+            Serial.print(WiFi.localIP());
+            Serial.println("/metrics");
+        }
+
+        WiFiClient client = metricsServer.available();
+        if (client) {
+            handleHttpClient(client);
+            client.stop();
+        } else {
+            vTaskDelay(pdMS_TO_TICKS(METRICS_SERVER_POLL_MS));
+        }
+    }
+}
+
+} // namespace
+
+//* ************************************************************************
+//* ************************ SETUP ****************************************
+//* ************************************************************************
+
+void initMetricsServer() {
+    xTaskCreatePinnedToCore(metricsServerTask, "metrics", METRICS_TASK_STACK_SIZE, nullptr,
+                            METRICS_TASK_PRIORITY, nullptr, METRICS_SERVER_CORE);
+    Serial.println("Metrics server task started");
+}
@@ -6,8 +6,8 @@
  * 2. Copy the platformio.ini configuration (OTA environments)
  * 3. In your main.cpp:
  *    - #include "OTA_Manager.h"
- *    - Call initOTA() in setup()
- *    - Call handleOTA() in loop()
+ *    - Call initOTA() in setup() (returns at once; WiFi connects in the background)
+ *    - Call handleOTAParkRequest() in loop() (OTA itself is serviced by the WiFi task)
  * 4. Update WiFi credentials in OTA_Manager.h if different from Everwood network
  * 5. Change IP address in platformio.ini to match your ESP32's IP
  * 
@@ -22,6 +22,12 @@
  */
 
 #include "OTA_Manager.h"
+#include <freertos/event_groups.h>
+#include "Metrics/PersistentCounters.h"
+#include "StateMachine/StateMachine.h"
+#include "StateMachine/FastStop.h"
+
+extern bool isHomed;
 
 //* ************************************************************************
 //* ************************ NETWORK CONFIGURATION **********************
@@ -30,52 +36,37 @@
 const char* WIFI_SSID = "Everwood";
 const char* WIFI_PASSWORD = "Everwood-Staff";
 
-//* ************************************************************************
-//* ************************ WIFI CONNECTION FUNCTIONS ******************
-//* ************************************************************************
+const int WIFI_TASK_CORE = 0;
+const unsigned long WIFI_CONNECT_TIMEOUT_MS = 15000;
+const unsigned long WIFI_RETRY_MIN_MS = 2000;
+const unsigned long WIFI_RETRY_MAX_MS = 60000;
+const unsigned long OTA_HANDLE_INTERVAL_MS = 50;
+const unsigned long OTA_PARK_TIMEOUT_MS = 3000;
 
-void initWiFi() {
-  Serial.println("\n=== ESP32 OTA Remote Upload Setup ===");
-  
-  //! Step 1: Connect to WiFi with timeout
-  WiFi.mode(WIFI_STA);
-  WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
-  
-  Serial.print("Connecting to WiFi");
-  unsigned long startTime = millis();
-  while (WiFi.status() != WL_CONNECTED) {
-    delay(500);
-    Serial.print(".");
-    yield(); // Prevent watchdog reset
-    
-    // Timeout after 30 seconds
-    if (millis() - startTime > 30000) {
-      Serial.println("\nWiFi connection timeout! Continuing without WiFi...");
-      return;
-    }
-  }
-  
-  Serial.println("");
-  Serial.println("WiFi connected!");
-  Serial.print("IP address: ");
-  Serial.println(WiFi.localIP());
-}
+namespace {
+
+const uint32_t WIFI_TASK_STACK_SIZE = 4096;
+const UBaseType_t WIFI_TASK_PRIORITY = 1;
+
+// Station link, set from the WiFi event handler (system event task)
+const EventBits_t LINK_UP_BIT = 1 << 0;      // Got an address
+const EventBits_t LINK_LOST_BIT = 1 << 1;    // Disconnected or lost the address
+EventGroupHandle_t linkEvents = nullptr;
+
+// WiFi task only
+bool otaStarted = false;
+
+// Update handshake: the updating task raises otaUpdateActive, the loop
+// task answers with axesParked once both motors have stopped
+volatile bool otaUpdateActive = false;
+volatile bool axesParked = false;
 
 //* ************************************************************************
 //* ************************ OTA SETUP FUNCTIONS ************************
 //* ************************************************************************
 
-void initOTA() {
-  // Initialize WiFi first
-  initWiFi();
-  
-  // Only proceed with OTA setup if WiFi is connected
-  if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("WiFi not connected - skipping OTA setup");
-    return;
-  }
-  
-  //! Step 2: Configure OTA
+void startOTA() {
+  //! Step 1: Configure OTA
   ArduinoOTA.setHostname("ESP32-Remote");
   
   ArduinoOTA.onStart([]() {
@@ -86,6 +77,7 @@ void initOTA() {
       type = "filesystem";
     }
     Serial.println("Start updating " + type);
+    beginOTAUpdate();
   });
   
   ArduinoOTA.onEnd([]() {
@@ -109,24 +101,179 @@ void initOTA() {
     } else if (error == OTA_END_ERROR) {
       Serial.println("End Failed");
     }
+    endOTAUpdate(false);
   });
   
-  //! Step 3: Start OTA service
+  //! Step 2: Start OTA service - once; its UDP listener and mDNS responder
+  //! are bound to the station interface and survive a reconnect
   ArduinoOTA.begin();
+  otaStarted = true;
   Serial.println("OTA Ready");
   Serial.println("Device ready for remote uploads!");
   Serial.print("Use IP: ");
   Serial.println(WiFi.localIP());
 }
 
+//* ************************************************************************
+//* ************************ WIFI TASK ************************************
+//* ************************************************************************
+
+// Each event replaces the other, so a late disconnect from the previous
+// attempt cannot outlive the address that follows it
+void onWiFiEvent(arduino_event_id_t event) {
+  if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+    xEventGroupClearBits(linkEvents, LINK_LOST_BIT);
+    xEventGroupSetBits(linkEvents, LINK_UP_BIT);
+  } else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED || event == ARDUINO_EVENT_WIFI_STA_LOST_IP) {
+    xEventGroupClearBits(linkEvents, LINK_UP_BIT);
+    xEventGroupSetBits(linkEvents, LINK_LOST_BIT);
+  }
+}
+
+// One connection attempt; true once the station has an address
+bool connectWiFi() {
+  WiFi.disconnect();
+  xEventGroupClearBits(linkEvents, LINK_UP_BIT | LINK_LOST_BIT);
+  WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+  EventBits_t bits = xEventGroupWaitBits(linkEvents, LINK_UP_BIT, pdFALSE, pdFALSE,
+                                         pdMS_TO_TICKS(WIFI_CONNECT_TIMEOUT_MS));
+  return (bits & LINK_UP_BIT) != 0;
+}
+
+void wifiTask(void* parameter) {
+  (void)parameter;
+  unsigned long retryDelayMs = WIFI_RETRY_MIN_MS;
+
+  for (;;) {
+    //! Step 1: Connect, backing off while the network is not there
+    if (!connectWiFi()) {
+      Serial.printf("WiFi: %s not reachable, retrying in %lu s\n", WIFI_SSID, retryDelayMs / 1000);
+      vTaskDelay(pdMS_TO_TICKS(retryDelayMs));
+      retryDelayMs *= 2;
+      if (retryDelayMs > WIFI_RETRY_MAX_MS) {
+        retryDelayMs = WIFI_RETRY_MAX_MS;
+      }
+      continue;
+    }
+    retryDelayMs = WIFI_RETRY_MIN_MS;
+    Serial.print("WiFi connected! IP address: ");
+    Serial.println(WiFi.localIP());
+
+    //! Step 2: OTA comes up with the first link
+    if (!otaStarted) {
+      startOTA();
+    }
+
+    //! Step 3: Service OTA while the link is up; the wait between handle()
+    //! calls ends early on a disconnect event, and the task reconnects
+    //! (an upload runs to completion inside handle(), on this task)
+    for (;;) {
+      ArduinoOTA.handle();
+      EventBits_t bits = xEventGroupWaitBits(linkEvents, LINK_LOST_BIT, pdFALSE, pdFALSE,
+                                             pdMS_TO_TICKS(OTA_HANDLE_INTERVAL_MS));
+      if (bits & LINK_LOST_BIT) {
+        break;
+      }
+    }
+    Serial.println("WiFi connection lost - reconnecting");
+  }
+}
+
+} // namespace
+
+//* ************************************************************************
+//* ************************ WIFI CONNECTION FUNCTIONS ******************
+//* ************************************************************************
+
+void initWiFi() {
+  //! The station is managed by the WiFi task, not by the driver's auto-reconnect;
+  //! the task sleeps on the station events instead of polling WiFi.status()
+  linkEvents = xEventGroupCreate();
+  WiFi.onEvent(onWiFiEvent);
+  WiFi.mode(WIFI_STA);
+  WiFi.setAutoReconnect(false);
+  xTaskCreatePinnedToCore(wifiTask, "wifi", WIFI_TASK_STACK_SIZE, nullptr,
+                          WIFI_TASK_PRIORITY, nullptr, WIFI_TASK_CORE);
+  Serial.printf("WiFi task started - connecting to %s in the background\n", WIFI_SSID);
+}
+
+void initOTA() {
+  Serial.println("\n=== ESP32 OTA Remote Upload Setup ===");
+  // Does not wait for the network - homing starts straight away and OTA
+  // comes up whenever WiFi does
+  initWiFi();
+}
+
+//* ************************************************************************
+//* ************************ UPDATE HANDSHAKE *****************************
+//* ************************************************************************
+
+void beginOTAUpdate() {
+  //! Step 1: Motion must be stopped before flash writes start stalling both cores
+  otaUpdateActive = true;
+  unsigned long startTime = millis();
+  while (!axesParked) {
+    if (millis() - startTime > OTA_PARK_TIMEOUT_MS) {
+      Serial.println("OTA: axes not parked in time - updating anyway");
+      break;
+    }
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+
+  //! Step 2: Save lifetime counters before the upload - the update ends in a restart
+  flushPersistentCounters();
+}
+
+void endOTAUpdate(bool success) {
+  if (success) {
+    Serial.println("OTA: update written - restarting");
+    delay(100);
+    ESP.restart();
+  }
+  // The old firmware keeps running - release the loop task
+  otaUpdateActive = false;
+}
+
+bool isOTAUpdateActive() {
+  return otaUpdateActive;
+}
+
 //* ************************************************************************
 //* ************************ OTA RUNTIME FUNCTIONS **********************
 //* ************************************************************************
 
-void handleOTA() {
-  //! Handle OTA updates only if WiFi is connected
-  if (WiFi.status() == WL_CONNECTED) {
-    ArduinoOTA.handle();
+void handleOTAParkRequest() {
+  if (!otaUpdateActive) {
+    return;
+  }
+  SystemState interruptedState = currentState;
+  pauseLoopWatchdog();  // The park and the hold below keep the loop here on purpose
+
+  //! Step 1: Decelerate both axes to a stop
+  cutMotor.stop();
+  positionMotor.stop();
+  while ((cutMotor.distanceToGo() != 0 || positionMotor.distanceToGo() != 0) && !fastStopTripped()) {
+    cutMotor.run();
+    positionMotor.run();
+    yield(); // Prevent watchdog reset
+  }
+  sampleMotorTravel();
+  axesParked = true;
+  Serial.println("OTA: axes parked - holding until the update ends");
+
+  //! Step 2: Hold the loop - a good update restarts from here
+  while (otaUpdateActive) {
+    delay(10);
+  }
+  axesParked = false;
+  Serial.println("OTA: update failed - resuming");
+
+  //! Step 3: The interrupted moves are gone, so a cycle cannot pick up
+  //! where it stopped
+  if (interruptedState != IDLE && interruptedState != ERROR) {
+    Serial.println("OTA: cycle was interrupted - re-homing");
+    isHomed = false;
+    currentState = STARTUP;
   }
 }
 
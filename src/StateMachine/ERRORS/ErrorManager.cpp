@@ -0,0 +1,365 @@
+#include "StateMachine/ErrorManager.h"
+#include "StateMachine/StateMachine.h"
+#include "StateMachine/FastStop.h"
+#include "Metrics/PersistentCounters.h"
+#include "Diagnostics/FlightRecorder.h"
+#include "Console/SerialConsole.h"
+
+//* ************************************************************************
+//* ************************ ERROR MANAGER ********************************
+//* ************************************************************************
+//! Error codes, history and recovery - see StateMachine/ErrorManager.h
+//! The loop task is the only writer. The mask is one word, so other tasks
+//! (remote status) can read it at any time; the history is only read from
+//! the console, on the loop task.
+
+volatile uint32_t activeErrorMask = 0;
+
+namespace {
+
+enum ErrorRecovery : uint8_t {
+    RECOVERY_ON_ACKNOWLEDGE,         // Nothing to wait for
+    RECOVERY_SUCTION_CLEAR,          // Suction sensor clear for INPUT_CLEAR_MS
+    RECOVERY_EMERGENCY_STOP_CLEAR,   // Emergency stop loop closed for INPUT_CLEAR_MS
+    RECOVERY_REHOME_CUT,             // Cut axis back on its home switch
+    RECOVERY_REHOME_POSITION         // Position axis on its home switch, then to travel
+};
+
+struct ErrorClass {
+    ErrorSeverity severity;
+    ErrorCounterType counter;    // Metrics counter, and the name
+    ErrorRecovery recovery;
+};
+
+const ErrorClass ERROR_CLASSES[ERROR_CODE_COUNT] = {
+    {ERROR_SEVERITY_FAULT, ERROR_COUNTER_WOOD_SUCTION, RECOVERY_SUCTION_CLEAR},
+    {ERROR_SEVERITY_CRITICAL, ERROR_COUNTER_CUT_MOTOR_HOME, RECOVERY_REHOME_CUT},
+    {ERROR_SEVERITY_CRITICAL, ERROR_COUNTER_POSITION_MOTOR_HOME, RECOVERY_REHOME_POSITION},
+    {ERROR_SEVERITY_CRITICAL, ERROR_COUNTER_EMERGENCY_STOP, RECOVERY_EMERGENCY_STOP_CLEAR},
+    {ERROR_SEVERITY_CRITICAL, ERROR_COUNTER_LOOP_WATCHDOG, RECOVERY_ON_ACKNOWLEDGE},
+};
+
+// Input recoveries: the input must stay clear this long, within the timeout
+const unsigned long INPUT_CLEAR_MS = 250;
+const unsigned long INPUT_RECOVERY_TIMEOUT_MS = 5000;
+
+// Home seek used by the motor home recoveries
+struct HomingAxis {
+    AccelStepper* motor;
+    MotorType motorType;
+    SwitchType homeSwitch;
+    int direction;
+    long distance;                 // Furthest the seek goes
+    const float* speed;
+    const unsigned long* timeoutMs;
+    const long* switchPosition;    // Coordinate at the switch
+    const long* parkPosition;      // Move here once homed (nullptr = stay)
+};
+
+const long CUT_MOTOR_SWITCH_POSITION = 0;
+
+const HomingAxis CUT_AXIS = {
+    &cutMotor, CUT_MOTOR, CUT_MOTOR_HOMING_SWITCH_TYPE, CUT_HOMING_DIRECTION, CUT_MOTOR_HOMING_DISTANCE,
+    &CUT_MOTOR_HOMING_SPEED, &CUT_HOME_TIMEOUT, &CUT_MOTOR_SWITCH_POSITION, nullptr
+};
+const HomingAxis POSITION_AXIS = {
+    &positionMotor, POSITION_MOTOR, POSITION_MOTOR_HOMING_SWITCH_TYPE, POSITION_HOMING_DIRECTION,
+    POSITION_MOTOR_HOMING_DISTANCE, &POSITION_MOTOR_HOMING_SPEED, &POSITION_HOME_TIMEOUT,
+    &POSITION_MOTOR_HOME_SWITCH_POSITION, &POSITION_MOTOR_TRAVEL_POSITION
+};
+
+enum RecoveryPhase : uint8_t {
+    PHASE_IDLE,         // Not recovering
+    PHASE_WAITING,      // Input recovery: watching the input
+    PHASE_SEEKING,      // Home recovery: moving toward the switch
+    PHASE_PARKING       // Home recovery: homed, moving to the park position
+};
+
+struct RecoveryProgress {
+    RecoveryPhase phase;
+    unsigned long startMs;     // Recovery (or seek) start
+    unsigned long markMs;      // Input recovery: last time the input was active
+};
+
+RecoveryProgress recoveries[ERROR_CODE_COUNT] = {};
+
+ErrorRecord history[ERROR_HISTORY_CAPACITY];
+uint32_t historyHead = 0;      // Total records written
+
+const char* const EVENT_NAMES[] = {"raised", "acknowledged", "recovered", "recovery failed"};
+
+void recordHistory(ErrorCode code, ErrorEventType event) {
+    ErrorRecord& record = history[historyHead & (ERROR_HISTORY_CAPACITY - 1)];
+    record.timeMs = millis();
+    record.code = code;
+    record.event = event;
+    record.state = (uint8_t)currentState;
+    historyHead++;
+}
+
+void setErrorActive(ErrorCode code, bool active) {
+    if (active) {
+        activeErrorMask |= (1UL << code);
+    } else {
+        activeErrorMask &= ~(1UL << code);
+    }
+}
+
+void finishRecovery(ErrorCode code, bool recovered) {
+    recoveries[code].phase = PHASE_IDLE;
+    recordHistory(code, recovered ? ERROR_EVENT_RECOVERED : ERROR_EVENT_RECOVERY_FAILED);
+    if (recovered) {
+        setErrorActive(code, false);
+        releaseFastStop();
+    }
+    Serial.print("ERRORS: ");
+    Serial.print(errorCodeName(code));
+    Serial.println(recovered ? " recovered" : " recovery failed - acknowledge again to retry");
+}
+
+//* ************************************************************************
+//* ************************ HOME RECOVERY ********************************
+//* ************************************************************************
+
+void seatAxisAtSwitch(const HomingAxis& axis) {
+    sampleMotorTravel();
+    axis.motor->setCurrentPosition(*axis.switchPosition);
+    rebaseMotorTravel();
+}
+
+// true once the axis is seated (no move needed), false if a seek was started
+bool startHomeRecovery(const HomingAxis& axis, RecoveryProgress& progress) {
+    progress.startMs = millis();
+    if (readLimitSwitch(axis.homeSwitch)) {
+        //! Already on the switch: re-zero in place, like the YESWOOD check
+        seatAxisAtSwitch(axis);
+        return true;
+    }
+    long target = axis.motor->currentPosition() + axis.direction * axis.distance;
+    moveMotorTo(axis.motorType, target, *axis.speed);
+    progress.phase = PHASE_SEEKING;
+    return false;
+}
+
+void startParking(const HomingAxis& axis, RecoveryProgress& progress, ErrorCode code) {
+    if (axis.parkPosition == nullptr) {
+        finishRecovery(code, true);
+        return;
+    }
+    moveMotorTo(axis.motorType, *axis.parkPosition, POSITION_MOTOR_NORMAL_SPEED);
+    progress.phase = PHASE_PARKING;
+}
+
+void updateHomeRecovery(const HomingAxis& axis, RecoveryProgress& progress, ErrorCode code) {
+    AccelStepper& motor = *axis.motor;
+    //! No motion under a latched fast stop - the seek waits for its release
+    if (fastStopTripped()) {
+        progress.startMs = millis();
+        return;
+    }
+    if (progress.phase == PHASE_SEEKING) {
+        motor.run();
+        if (readLimitSwitch(axis.homeSwitch)) {
+            motor.stop();
+            motor.setCurrentPosition(motor.currentPosition());
+            recordMoveEnd(axis.motorType);
+            seatAxisAtSwitch(axis);
+            startParking(axis, progress, code);
+        } else if (motor.distanceToGo() == 0 || millis() - progress.startMs > *axis.timeoutMs) {
+            motor.stop();
+            motor.setCurrentPosition(motor.currentPosition());
+            recordMoveEnd(axis.motorType);
+            finishRecovery(code, false);
+        }
+        return;
+    }
+    // PHASE_PARKING
+    motor.run();
+    if (motor.distanceToGo() == 0) {
+        recordMoveEnd(axis.motorType);
+        finishRecovery(code, true);
+    }
+}
+
+//* ************************************************************************
+//* ************************ RECOVERY DISPATCH ****************************
+//* ************************************************************************
+
+const HomingAxis* homingAxisFor(ErrorRecovery recovery) {
+    if (recovery == RECOVERY_REHOME_CUT) {
+        return &CUT_AXIS;
+    }
+    if (recovery == RECOVERY_REHOME_POSITION) {
+        return &POSITION_AXIS;
+    }
+    return nullptr;
+}
+
+void startRecovery(ErrorCode code) {
+    RecoveryProgress& progress = recoveries[code];
+    ErrorRecovery recovery = ERROR_CLASSES[code].recovery;
+    const HomingAxis* axis = homingAxisFor(recovery);
+    if (axis != nullptr) {
+        if (startHomeRecovery(*axis, progress)) {
+            startParking(*axis, progress, code);
+        }
+        return;
+    }
+    if (recovery == RECOVERY_SUCTION_CLEAR || recovery == RECOVERY_EMERGENCY_STOP_CLEAR) {
+        progress.phase = PHASE_WAITING;
+        progress.startMs = millis();
+        progress.markMs = progress.startMs;
+        return;
+    }
+    finishRecovery(code, true);
+}
+
+void updateInputRecovery(RecoveryProgress& progress, ErrorCode code) {
+    unsigned long now = millis();
+    bool active = ERROR_CLASSES[code].recovery == RECOVERY_SUCTION_CLEAR ? readWoodSuctionSensor()
+                                                                          : emergencyStopActive();
+    if (active) {
+        progress.markMs = now;
+    } else if (now - progress.markMs >= INPUT_CLEAR_MS) {
+        finishRecovery(code, true);
+        return;
+    }
+    if (now - progress.startMs >= INPUT_RECOVERY_TIMEOUT_MS) {
+        finishRecovery(code, false);
+    }
+}
+
+//* ************************************************************************
+//* ************************ CONSOLE **************************************
+//* ************************************************************************
+
+void errorsConsoleCommand(const char* args, Print& out) {
+    if (strncmp(args, "raise ", 6) == 0) {
+        for (int i = 0; i < ERROR_CODE_COUNT; i++) {
+            if (strcmp(args + 6, errorCodeName((ErrorCode)i)) == 0) {
+                raiseError((ErrorCode)i);
+                return;
+            }
+        }
+        out.printf("Unknown error %s\n", args + 6);
+        return;
+    }
+    if (args[0] != '\0') {
+        out.println("Usage: errors [raise <name>]");
+        return;
+    }
+    out.print("Active errors:");
+    if (!anyErrorActive()) {
+        out.print(" none");
+    }
+    for (int i = 0; i < ERROR_CODE_COUNT; i++) {
+        if (isErrorActive((ErrorCode)i)) {
+            out.printf(" %s%s", errorCodeName((ErrorCode)i), recoveries[i].phase != PHASE_IDLE ? " (recovering)" : "");
+        }
+    }
+    out.println();
+    ErrorRecord records[ERROR_HISTORY_CAPACITY];
+    uint32_t count = getErrorHistory(records, ERROR_HISTORY_CAPACITY);
+    for (uint32_t i = 0; i < count; i++) {
+        out.printf("  %10lu ms  %-20s %-16s in %s\n", (unsigned long)records[i].timeMs,
+                   errorCodeName((ErrorCode)records[i].code), EVENT_NAMES[records[i].event],
+                   getStateName((SystemState)records[i].state));
+    }
+}
+
+} // namespace
+
+//* ************************************************************************
+//* ************************ SETUP ****************************************
+//* ************************************************************************
+
+void initErrorManager() {
+    registerConsoleCommand("errors", errorsConsoleCommand, "Active errors and history ('errors raise <name>')");
+}
+
+//* ************************************************************************
+//* ************************ RAISING **************************************
+//* ************************************************************************
+
+void raiseError(ErrorCode code) {
+    if (code >= ERROR_CODE_COUNT || isErrorActive(code)) {
+        return;
+    }
+    //! Step 1: Record - the mask first, so every check from here sees it
+    setErrorActive(code, true);
+    recoveries[code].phase = PHASE_IDLE;
+    recordHistory(code, ERROR_EVENT_RAISED);
+    recordErrorEvent(ERROR_CLASSES[code].counter);
+    Serial.print("ERROR: ");
+    Serial.print(errorCodeName(code));
+    Serial.print(" raised in ");
+    Serial.println(getStateName(currentState));
+
+    //! Step 2: Safe state for the severity
+    stopCutMotor();
+    stopPositionMotor();
+    if (ERROR_CLASSES[code].severity == ERROR_SEVERITY_CRITICAL) {
+        retractAllCylinders();
+    } else {
+        retractPositionClamp();
+        retractWoodSecureClamp();
+    }
+
+    //! Step 3: Stop the cycle
+    changeState(ERROR);
+}
+
+//* ************************************************************************
+//* ************************ RECOVERY *************************************
+//* ************************************************************************
+
+void acknowledgeErrors() {
+    for (int i = 0; i < ERROR_CODE_COUNT; i++) {
+        ErrorCode code = (ErrorCode)i;
+        if (isErrorActive(code) && recoveries[i].phase == PHASE_IDLE) {
+            recordHistory(code, ERROR_EVENT_ACKNOWLEDGED);
+            startRecovery(code);
+        }
+    }
+}
+
+bool updateErrorRecovery() {
+    bool running = false;
+    for (int i = 0; i < ERROR_CODE_COUNT; i++) {
+        RecoveryProgress& progress = recoveries[i];
+        if (progress.phase == PHASE_IDLE) {
+            continue;
+        }
+        ErrorCode code = (ErrorCode)i;
+        if (progress.phase == PHASE_WAITING) {
+            updateInputRecovery(progress, code);
+        } else {
+            updateHomeRecovery(*homingAxisFor(ERROR_CLASSES[i].recovery), progress, code);
+        }
+        running = running || progress.phase != PHASE_IDLE;
+    }
+    return running;
+}
+
+//* ************************************************************************
+//* ************************ STATUS ***************************************
+//* ************************************************************************
+
+ErrorCode firstActiveError() {
+    uint32_t mask = activeErrorMask;
+    return mask == 0 ? ERROR_CODE_COUNT : (ErrorCode)__builtin_ctz(mask);
+}
+
+const char* errorCodeName(ErrorCode code) {
+    return code < ERROR_CODE_COUNT ? errorCounterLabel(ERROR_CLASSES[code].counter) : "none";
+}
+
+uint32_t getErrorHistory(ErrorRecord records[], uint32_t maxRecords) {
+    uint32_t available = historyHead < ERROR_HISTORY_CAPACITY ? historyHead : ERROR_HISTORY_CAPACITY;
+    uint32_t count = available < maxRecords ? available : maxRecords;
+    uint32_t first = historyHead - count;
+    for (uint32_t i = 0; i < count; i++) {
+        records[i] = history[(first + i) & (ERROR_HISTORY_CAPACITY - 1)];
+    }
+    return count;
+}
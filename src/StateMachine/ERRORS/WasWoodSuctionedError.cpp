@@ -1,21 +1,19 @@
 #include "StateMachine/StateMachine.h"
 #include "StateMachine/SensorFunctions.h"
+#include "StateMachine/ErrorManager.h"
 #include <Arduino.h>
 
 //* ************************************************************************
 //* ************************ WAS WOOD SUCTIONED ERROR *********************
 //* ************************************************************************
-//! Error handling for wood suction detection failures
-//! Functions for detecting, handling, and recovering from wood suction errors
+//! Error detection for wood suction failures
+//! Raised into the error manager (StateMachine/ErrorManager.h), which waits
+//! for the suction sensor to clear once the operator acknowledges
 
 // External variable declarations
-extern bool woodSuctionError;
 extern SystemState currentState;
 
-// Error state variables
-bool woodSuctionErrorDetected = false;
-unsigned long woodSuctionErrorTime = 0;
-bool woodSuctionErrorHandled = false;
+// Detection state
 unsigned long lastSuctionCheck = 0;
 
 //* ************************************************************************
@@ -29,12 +27,8 @@ void checkWoodSuctionError() {
         
         // If wood should be suctioned but sensor doesn't detect it
         if (!woodSuctioned && currentState == YESWOOD) {
-            if (!woodSuctionError) {
-                woodSuctionError = true;
-                woodSuctionErrorDetected = true;
-                woodSuctionErrorTime = millis();
-                Serial.println("ERROR: Wood suction failed - WasWoodSuctionedError detected");
-            }
+            Serial.println("ERROR: Wood suction failed");
+            raiseError(ERROR_CODE_WOOD_SUCTION);
         }
         
         lastSuctionCheck = millis();
@@ -42,40 +36,18 @@ void checkWoodSuctionError() {
 }
 
 bool isWoodSuctionErrorActive() {
-    return woodSuctionError;
+    return isErrorActive(ERROR_CODE_WOOD_SUCTION);
 }
 
 void forceTriggerWoodSuctionError() {
-    woodSuctionError = true;
-    woodSuctionErrorDetected = true;
-    woodSuctionErrorTime = millis();
     Serial.println("Wood suction error manually triggered");
+    raiseError(ERROR_CODE_WOOD_SUCTION);
 }
 
 //* ************************************************************************
 //* ************************ ERROR HANDLING *******************************
 //* ************************************************************************
 
-void handleWoodSuctionError() {
-    if (woodSuctionError && !woodSuctionErrorHandled) {
-        Serial.println("Handling wood suction error...");
-        
-        // Stop all motors immediately
-        stopCutMotor();
-        stopPositionMotor();
-        
-        // Retract safety components
-        retractPositionClamp();
-        retractWoodSecureClamp();
-        
-        // Set error LED pattern
-        turnRedLedOn();
-        
-        woodSuctionErrorHandled = true;
-        Serial.println("Wood suction error handling complete - system in safe state");
-    }
-}
-
 void handleWoodSuctionErrorLedBlink(unsigned long& lastBlinkTimeRef, bool& blinkStateRef) {
     if (millis() - lastBlinkTimeRef >= 1500) { // Blink RED every 1.5 seconds
         lastBlinkTimeRef = millis();
@@ -91,72 +63,3 @@ void handleWoodSuctionErrorLedBlink(unsigned long& lastBlinkTimeRef, bool& blink
         turnBlueLedOff();
     }
 }
-
-//* ************************************************************************
-//* ************************ ERROR RECOVERY *******************************
-//* ************************************************************************
-
-void resetWoodSuctionError() {
-    woodSuctionError = false;
-    woodSuctionErrorDetected = false;
-    woodSuctionErrorHandled = false;
-    Serial.println("Wood suction error flags reset");
-}
-
-void acknowledgeWoodSuctionError() {
-    if (woodSuctionError) {
-        Serial.println("Wood suction error acknowledged - preparing for recovery");
-        resetWoodSuctionError();
-        
-        // Return to IDLE state for manual intervention
-        if (currentState == ERROR) {
-            changeState(ERROR_RESET);
-        }
-    }
-}
-
-void attemptWoodSuctionRecovery() {
-    if (woodSuctionError) {
-        Serial.println("Attempting wood suction recovery...");
-        
-        // Recovery would need to be handled by external suction system
-        delay(2000); // Wait 2 seconds
-        
-        // Check if recovery was successful
-        if (readWoodSuctionSensor()) {
-            Serial.println("Wood suction recovery successful");
-            resetWoodSuctionError();
-        } else {
-            Serial.println("Wood suction recovery failed - manual intervention required");
-        }
-    }
-}
-
-void retractAllClampsForError() {
-    retractPositionClamp();
-    retractWoodSecureClamp();
-    Serial.println("WASWOODSUCTIONED ERROR: Position and secure clamps retracted for safety");
-}
-
-void retractAllClampsOnErrorAcknowledge() {
-    retractPositionClamp();
-    retractWoodSecureClamp();
-    Serial.println("WASWOODSUCTIONED ERROR: All clamps retracted on error acknowledgment");
-}
-
-//* ************************************************************************
-//* ************************ ERROR STATUS **********************************
-//* ************************************************************************
-
-void printWoodSuctionErrorStatus() {
-    Serial.println("=== Wood Suction Error Status ===");
-    Serial.print("Error Active: ");
-    Serial.println(woodSuctionError ? "YES" : "NO");
-    Serial.print("Error Detected: ");
-    Serial.println(woodSuctionErrorDetected ? "YES" : "NO");
-    Serial.print("Error Handled: ");
-    Serial.println(woodSuctionErrorHandled ? "YES" : "NO");
-    Serial.print("Suction Sensor State: ");
-    Serial.println(readWoodSuctionSensor() ? "ACTIVE" : "INACTIVE");
-    Serial.println("==================================");
-} 
\ No newline at end of file
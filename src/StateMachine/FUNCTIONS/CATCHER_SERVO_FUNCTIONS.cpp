@@ -0,0 +1,178 @@
+#include "StateMachine/CatcherServo.h"
+#include "StateMachine/StateMachine.h"
+#include <Servo.h>
+#include "Console/SerialConsole.h"
+#include "Diagnostics/FlightRecorder.h"
+
+//* ************************************************************************
+//* ************************ CATCHER SERVO FUNCTIONS **********************
+//* ************************************************************************
+//! Catcher servo sequence - see StateMachine/CatcherServo.h
+//! The loop task is the only writer. Other tasks (remote status) read the
+//! phase, a single word, and take the counters as they find them.
+
+// External variable declarations
+extern Servo catcherServo;
+
+namespace {
+
+volatile CatcherServoPhase phase = CATCHER_SERVO_HOME;
+unsigned long phaseStartTime = 0;      // Start of the hold or the settle
+unsigned long triggerTime = 0;         // Trigger of the sequence in progress
+bool goOutAfterReturn = false;         // Late trigger while returning
+CatcherServoStats stats = {0, 0, 0, 0};
+
+const char* const PHASE_NAMES[] = {"HOME", "MOVING_OUT", "HOLDING", "RETURNING", "SETTLING"};
+
+void startMove(int angle, CatcherServoPhase nextPhase) {
+    catcherServo.moveTo(angle, CATCHER_SERVO_MOVE_DURATION_MS);
+    recordFlightEvent(FLIGHT_SERVO, 0, angle);
+    phase = nextPhase;
+}
+
+//* ************************************************************************
+//* ************************ CONSOLE **************************************
+//* ************************************************************************
+
+void catcherConsoleCommand(const char* args, Print& out) {
+    if (strcmp(args, "fire") == 0) {
+        triggerCatcherServo();
+    } else if (strcmp(args, "home") == 0) {
+        returnCatcherServoHome();
+    } else if (args[0] != '\0') {
+        out.println("Usage: catcher [fire|home]");
+        return;
+    }
+    CatcherServoStats snapshot;
+    getCatcherServoStats(snapshot);
+    out.printf("Catcher servo: %s, %lu activations (%lu late), ready %lu ms after trigger (max %lu ms)\n",
+               getCatcherServoPhaseName(getCatcherServoPhase()), (unsigned long)snapshot.activations,
+               (unsigned long)snapshot.lateActivations, (unsigned long)snapshot.lastReadyMs,
+               (unsigned long)snapshot.maxReadyMs);
+}
+
+} // namespace
+
+//* ************************************************************************
+//* ************************ SETUP ****************************************
+//* ************************************************************************
+
+void initCatcherServo() {
+    //! A fade starts from the duty on the pin, so the channel gets a real
+    //! pulse (home) before the first move
+    if (!catcherServo.attach(CATCHER_SERVO_PIN)) {
+        Serial.println("Catcher servo: ERROR - LEDC channel setup failed, servo not driven");
+    }
+    catcherServo.write(CATCHER_SERVO_HOME_POSITION);
+    phase = CATCHER_SERVO_HOME;
+    registerConsoleCommand("catcher", catcherConsoleCommand, "Catcher servo sequence: 'catcher [fire|home]'");
+}
+
+//* ************************************************************************
+//* ************************ SEQUENCE *************************************
+//* ************************************************************************
+
+void triggerCatcherServo() {
+    unsigned long now = millis();
+    stats.activations++;
+    switch (phase) {
+        case CATCHER_SERVO_HOME:
+            triggerTime = now;
+            startMove(CATCHER_SERVO_ACTIVE_POSITION, CATCHER_SERVO_MOVING_OUT);
+            Serial.print("Catcher servo moving to ");
+            Serial.print(CATCHER_SERVO_ACTIVE_POSITION);
+            Serial.println(" degrees");
+            return;
+
+        case CATCHER_SERVO_MOVING_OUT:
+        case CATCHER_SERVO_HOLDING:
+            // Still out - the hold starts over for the new piece
+            phaseStartTime = now;
+            break;
+
+        case CATCHER_SERVO_RETURNING:
+            goOutAfterReturn = true;
+            break;
+
+        case CATCHER_SERVO_SETTLING:
+            startMove(CATCHER_SERVO_ACTIVE_POSITION, CATCHER_SERVO_MOVING_OUT);
+            break;
+    }
+    triggerTime = now;
+    stats.lateActivations++;
+    Serial.print("WARNING: Catcher servo triggered while ");
+    Serial.print(getCatcherServoPhaseName(phase));
+    Serial.println(" - not ready for this piece");
+}
+
+void returnCatcherServoHome() {
+    if (phase == CATCHER_SERVO_MOVING_OUT || phase == CATCHER_SERVO_HOLDING) {
+        // Held until the outward fade ends, like any other move
+        phaseStartTime = millis() - CATCHER_SERVO_ACTIVE_HOLD_DURATION_MS;
+        phase = CATCHER_SERVO_HOLDING;
+    }
+    goOutAfterReturn = false;
+}
+
+void updateCatcherServo() {
+    if (phase == CATCHER_SERVO_HOME) {
+        return;
+    }
+    unsigned long now = millis();
+    switch (phase) {
+        case CATCHER_SERVO_MOVING_OUT:
+            if (!catcherServo.isMoving()) {
+                phase = CATCHER_SERVO_HOLDING;
+                phaseStartTime = now;
+            }
+            break;
+
+        case CATCHER_SERVO_HOLDING:
+            if (!catcherServo.isMoving() && now - phaseStartTime >= CATCHER_SERVO_ACTIVE_HOLD_DURATION_MS) {
+                startMove(CATCHER_SERVO_HOME_POSITION, CATCHER_SERVO_RETURNING);
+            }
+            break;
+
+        case CATCHER_SERVO_RETURNING:
+            if (!catcherServo.isMoving()) {
+                if (goOutAfterReturn) {
+                    goOutAfterReturn = false;
+                    startMove(CATCHER_SERVO_ACTIVE_POSITION, CATCHER_SERVO_MOVING_OUT);
+                } else {
+                    phase = CATCHER_SERVO_SETTLING;
+                    phaseStartTime = now;
+                }
+            }
+            break;
+
+        case CATCHER_SERVO_SETTLING:
+            if (now - phaseStartTime >= CATCHER_SERVO_SETTLE_MS) {
+                phase = CATCHER_SERVO_HOME;
+                stats.lastReadyMs = now - triggerTime;
+                if (stats.lastReadyMs > stats.maxReadyMs) {
+                    stats.maxReadyMs = stats.lastReadyMs;
+                }
+                Serial.print("Catcher servo home - ready ");
+                Serial.print(stats.lastReadyMs);
+                Serial.println(" ms after trigger");
+            }
+            break;
+
+        case CATCHER_SERVO_HOME:
+            break;
+    }
+}
+
+//* ************************************************************************
+//* ************************ STATUS ***************************************
+//* ************************************************************************
+
+bool catcherServoReady() { return phase == CATCHER_SERVO_HOME; }
+
+CatcherServoPhase getCatcherServoPhase() { return phase; }
+
+const char* getCatcherServoPhaseName(CatcherServoPhase which) {
+    return (unsigned)which < sizeof(PHASE_NAMES) / sizeof(PHASE_NAMES[0]) ? PHASE_NAMES[which] : "UNKNOWN";
+}
+
+void getCatcherServoStats(CatcherServoStats& snapshot) { snapshot = stats; }
@@ -1,4 +1,7 @@
 #include "StateMachine/StateMachine.h"
+#include "StateMachine/Pneumatics.h"
+#include "StateMachine/FastStop.h"
+#include "Diagnostics/FlightRecorder.h"
 
 // External variable declarations for catcher clamp timing
 extern unsigned long catcherClampEngageTime;
@@ -8,7 +11,8 @@ extern bool catcherClampIsEngaged;
 //* ************************ CLAMPS FUNCTIONS ****************************
 //* ************************************************************************
 //! Pneumatic clamp control functions
-//! Basic pneumatic operations that can be shared across states
+//! Basic pneumatic operations that can be shared across states, and the
+//! valve latency model behind them (StateMachine/Pneumatics.h)
 //! THIS FILE CONTAINS ONLY CLAMP-RELATED FUNCTIONS
 
 // Simple clamp identifiers for state files
@@ -16,6 +20,81 @@ extern bool catcherClampIsEngaged;
 #define WOOD_SECURE_CLAMP_ID 1
 #define CATCHER_CLAMP_ID 2
 
+//* ************************************************************************
+//* ************************ VALVE LATENCY MODEL **************************
+//* ************************************************************************
+//! One entry per valve, indexed by ClampType (same order as the IDs above).
+//! The outputs come up LOW (extended) from pinMode(), settled from boot.
+
+struct PneumaticValve {
+    int pin;
+    uint8_t flightId;
+    unsigned long* extendMs;     // Config.h latencies - tunable, calibrated
+    unsigned long* retractMs;
+    bool extended;               // Last commanded position
+    unsigned long switchedAt;    // millis() of the last change
+    unsigned long latencyMs;     // Latency of the last change
+};
+
+static PneumaticValve valves[] = {
+    {POSITION_CLAMP, POSITION_CLAMP_ID, &POSITION_CLAMP_EXTEND_MS, &POSITION_CLAMP_RETRACT_MS, true, 0, 0},
+    {WOOD_SECURE_CLAMP, WOOD_SECURE_CLAMP_ID, &WOOD_SECURE_CLAMP_EXTEND_MS, &WOOD_SECURE_CLAMP_RETRACT_MS, true, 0, 0},
+    {CATCHER_CLAMP_PIN, CATCHER_CLAMP_ID, &CATCHER_CLAMP_EXTEND_MS, &CATCHER_CLAMP_RETRACT_MS, true, 0, 0},
+};
+
+// Active LOW valves; repeating the current command leaves the settle time alone.
+// A latched fast stop has forced every valve open, and they stay open until
+// it is released.
+static void switchValve(PneumaticValve& valve, bool extend) {
+    if (extend && fastStopTripped()) {
+        return;
+    }
+    digitalWrite(valve.pin, extend ? LOW : HIGH);
+    recordFlightEvent(FLIGHT_CLAMP, valve.flightId, extend ? 1 : 0);
+    if (valve.extended != extend) {
+        valve.extended = extend;
+        valve.switchedAt = millis();
+        valve.latencyMs = extend ? *valve.extendMs : *valve.retractMs;
+    }
+}
+
+bool clampExtended(ClampType clamp) {
+    return valves[clamp].extended;
+}
+
+unsigned long clampSettleRemainingMs(ClampType clamp) {
+    const PneumaticValve& valve = valves[clamp];
+    unsigned long elapsed = millis() - valve.switchedAt;
+    return elapsed >= valve.latencyMs ? 0 : valve.latencyMs - elapsed;
+}
+
+bool clampSettled(ClampType clamp) {
+    return clampSettleRemainingMs(clamp) == 0;
+}
+
+unsigned long clampLatencyMs(ClampType clamp, bool extend) {
+    return extend ? *valves[clamp].extendMs : *valves[clamp].retractMs;
+}
+
+bool holdingClampsSettled() {
+    return clampSettled(POSITION_CLAMP_ENUM) && clampSettled(WOOD_SECURE_CLAMP_ENUM);
+}
+
+bool fireClampBeforeMoveEnds(ClampType clamp, bool extend, AccelStepper& motor) {
+    if (valves[clamp].extended == extend) {
+        return true;
+    }
+    if (msUntilMoveEnds(motor) > clampLatencyMs(clamp, extend)) {
+        return false;
+    }
+    if (extend) {
+        extendClamp(clamp);
+    } else {
+        retractClamp(clamp);
+    }
+    return true;
+}
+
 //* ************************************************************************
 //* ************************ INDIVIDUAL CLAMP FUNCTIONS ******************
 //* ************************************************************************
@@ -23,36 +102,36 @@ extern bool catcherClampIsEngaged;
 
 // Position Clamp Functions
 void extendPositionClamp() {
-    digitalWrite(POSITION_CLAMP, LOW);
+    switchValve(valves[POSITION_CLAMP_ENUM], true);
     Serial.println("Position clamp extended");
 }
 
 void retractPositionClamp() {
-    digitalWrite(POSITION_CLAMP, HIGH);
+    switchValve(valves[POSITION_CLAMP_ENUM], false);
     Serial.println("Position clamp retracted");
 }
 
 // Wood Secure Clamp Functions
 void extendWoodSecureClamp() {
-    digitalWrite(WOOD_SECURE_CLAMP, LOW);
+    switchValve(valves[WOOD_SECURE_CLAMP_ENUM], true);
     Serial.println("Wood secure clamp extended");
 }
 
 void retractWoodSecureClamp() {
-    digitalWrite(WOOD_SECURE_CLAMP, HIGH);
+    switchValve(valves[WOOD_SECURE_CLAMP_ENUM], false);
     Serial.println("Wood secure clamp retracted");
 }
 
 // Catcher Clamp Functions
 void extendCatcherClamp() {
-    digitalWrite(CATCHER_CLAMP_PIN, LOW);
+    switchValve(valves[CATCHER_CLAMP_ENUM], true);
     catcherClampEngageTime = millis();
     catcherClampIsEngaged = true;
     Serial.println("Catcher clamp extended");
 }
 
 void retractCatcherClamp() {
-    digitalWrite(CATCHER_CLAMP_PIN, HIGH);
+    switchValve(valves[CATCHER_CLAMP_ENUM], false);
     catcherClampIsEngaged = false;
     Serial.println("Catcher clamp retracted");
 }
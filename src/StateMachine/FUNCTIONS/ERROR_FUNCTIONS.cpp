@@ -1,4 +1,5 @@
 #include "StateMachine/StateMachine.h"
+#include "StateMachine/ErrorManager.h"
 #include <Bounce2.h>
 
 //* ************************************************************************
@@ -22,6 +23,7 @@ void handleErrorAcknowledgement() {
         // For CUTTING state, the homePositionErrorDetected flag logic needs to remain there,
         // but the transition to ERROR_RESET can be centralized if errorAcknowledged is set.
         if (currentState == ERROR) {
+            acknowledgeErrors();
             currentState = ERROR_RESET;
             errorAcknowledged = true; // Set flag, main loop will see this for ERROR state
             Serial.println("Error acknowledged by reload switch (from ERROR state). Transitioning to ERROR_RESET.");
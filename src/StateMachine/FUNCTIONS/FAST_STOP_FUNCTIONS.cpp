@@ -0,0 +1,262 @@
+#include "StateMachine/FastStop.h"
+#include <esp_timer.h>
+#include <soc/soc.h>
+#include <soc/gpio_reg.h>
+#include "Config/Config.h"
+#include "Config/Pins_Definitions.h"
+#include "StateMachine/StateMachine.h"
+#include "StateMachine/ErrorManager.h"
+#include "Console/SerialConsole.h"
+
+extern bool isHomed;
+
+//* ************************************************************************
+//* ************************ FAST STOP FUNCTIONS **************************
+//* ************************************************************************
+//! Interrupt-side trip and loop-side bookkeeping - see StateMachine/FastStop.h
+//! The trip only touches RAM and the GPIO registers, so it is safe from a
+//! pin ISR (IRAM) and from the esp_timer task. The register writes are
+//! idempotent; two triggers at once only race on which reason is kept.
+
+volatile uint8_t fastStopReason = FAST_STOP_NONE;
+
+namespace {
+
+// One bit per pin, bank 0 = GPIO 0-31, bank 1 = GPIO 32-48
+struct GpioBankMasks {
+    uint32_t bank[2];
+};
+
+GpioBankMasks stepOutputs = {};
+GpioBankMasks valveOutputs = {};
+
+struct FastStopTrigger {
+    const char* name;
+    ErrorCode error;       // Raised by the loop once it sees the trip
+};
+
+const FastStopTrigger TRIGGERS[] = {
+    {"none", ERROR_CODE_COUNT},
+    {"emergency stop", ERROR_CODE_EMERGENCY_STOP},
+    {"suction sensor", ERROR_CODE_WOOD_SUCTION},
+    {"loop watchdog", ERROR_CODE_LOOP_WATCHDOG},
+};
+
+const uint64_t LOOP_WATCHDOG_PERIOD_US = 10000;
+const uint32_t LOOP_WATCHDOG_TIMEOUT_TICKS = LOOP_WATCHDOG_TIMEOUT_MS * 1000UL / LOOP_WATCHDOG_PERIOD_US;
+
+volatile bool suctionArmed = false;
+volatile bool loopWatchdogArmed = false;
+volatile uint32_t loopPasses = 0;      // Counted by the loop - no clock read per pass
+volatile unsigned long tripUs = 0;
+
+// Watchdog timer task only
+uint32_t lastSeenPasses = 0;
+uint32_t stalledTicks = 0;
+volatile uint32_t longestStallTicks = 0;
+
+// Loop task only
+bool tripRaised = false;           // handleFastStop() has raised the current trip
+uint32_t tripCount = 0;
+uint8_t lastTripReason = FAST_STOP_NONE;
+unsigned long lastTripMs = 0;
+
+esp_timer_handle_t loopWatchdogTimer = nullptr;
+
+void addPin(GpioBankMasks& masks, int pin) {
+    masks.bank[pin / 32] |= 1UL << (pin % 32);
+}
+
+//* ************************************************************************
+//* ************************ TRIGGERS *************************************
+//* ************************************************************************
+
+void IRAM_ATTR onEmergencyStopEdge() {
+    tripFastStop(FAST_STOP_EMERGENCY_STOP);
+}
+
+void IRAM_ATTR onSuctionEdge() {
+    if (suctionArmed) {
+        tripFastStop(FAST_STOP_SUCTION);
+    }
+}
+
+// esp_timer task - the loop has not come round for the timeout's worth of ticks
+void onLoopWatchdogTick(void* arg) {
+    (void)arg;
+    uint32_t passes = loopPasses;
+    if (!loopWatchdogArmed || passes != lastSeenPasses) {
+        lastSeenPasses = passes;
+        stalledTicks = 0;
+        return;
+    }
+    stalledTicks++;
+    if (stalledTicks > longestStallTicks) {
+        longestStallTicks = stalledTicks;
+    }
+    if (stalledTicks >= LOOP_WATCHDOG_TIMEOUT_TICKS) {
+        tripFastStop(FAST_STOP_LOOP_WATCHDOG);
+    }
+}
+
+//* ************************************************************************
+//* ************************ CONSOLE **************************************
+//* ************************************************************************
+
+void fastStopConsoleCommand(const char* args, Print& out) {
+    (void)args;
+    uint8_t reason = fastStopReason;
+    out.printf("Fast stop: %s, %u trips", reason == FAST_STOP_NONE ? "clear" : "TRIPPED", (unsigned)tripCount);
+    if (tripCount > 0) {
+        out.printf(" (last: %s at %lu ms)", TRIGGERS[lastTripReason].name, lastTripMs);
+    }
+    out.println();
+    if (reason != FAST_STOP_NONE) {
+        out.printf("  Latched: %s - step outputs off until its error recovers\n", TRIGGERS[reason].name);
+    }
+    out.printf("  Emergency stop input: %s, suction trip: %s\n",
+               !EMERGENCY_STOP_INSTALLED ? "not installed" : emergencyStopActive() ? "OPEN" : "closed",
+               suctionArmed ? "armed" : "idle");
+    out.printf("  Loop watchdog: %s, timeout %lu ms, longest watched stall %lu ms\n",
+               loopWatchdogArmed ? "armed" : "idle", LOOP_WATCHDOG_TIMEOUT_MS,
+               (unsigned long)(longestStallTicks * (LOOP_WATCHDOG_PERIOD_US / 1000)));
+}
+
+} // namespace
+
+//* ************************************************************************
+//* ************************ SETUP ****************************************
+//* ************************************************************************
+
+void initFastStop() {
+    //! Step 1: Bank masks for the outputs the trip forces
+    addPin(stepOutputs, CUT_MOTOR_PULSE_PIN);
+    addPin(stepOutputs, POSITION_MOTOR_PULSE_PIN);
+    addPin(valveOutputs, POSITION_CLAMP);
+    addPin(valveOutputs, WOOD_SECURE_CLAMP);
+    addPin(valveOutputs, CATCHER_CLAMP_PIN);
+
+    //! Step 2: Input interrupts - the emergency stop is armed from here on
+    if (EMERGENCY_STOP_INSTALLED) {
+        pinMode(EMERGENCY_STOP_SWITCH, INPUT_PULLUP);
+        attachInterrupt(digitalPinToInterrupt(EMERGENCY_STOP_SWITCH), onEmergencyStopEdge, RISING);
+    } else {
+        Serial.println("FAST STOP: Emergency stop not installed - input ignored");
+    }
+    attachInterrupt(digitalPinToInterrupt(WAS_WOOD_SUCTIONED_SENSOR), onSuctionEdge, FALLING);
+
+    //! Step 3: Loop watchdog, checked every LOOP_WATCHDOG_PERIOD_US
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = onLoopWatchdogTick;
+    timerArgs.name = "loopwdt";
+    if (esp_timer_create(&timerArgs, &loopWatchdogTimer) == ESP_OK) {
+        esp_timer_start_periodic(loopWatchdogTimer, LOOP_WATCHDOG_PERIOD_US);
+    } else {
+        Serial.println("FAST STOP: WARNING - loop watchdog timer not created");
+    }
+
+    registerConsoleCommand("faststop", fastStopConsoleCommand, "Fast stop latch, triggers and loop watchdog");
+
+    //! Step 4: A loop already open at power-on never gives an edge
+    if (emergencyStopActive()) {
+        Serial.printf("FAST STOP: Emergency stop loop open at power-on - check the NC loop on GPIO %d\n",
+                      EMERGENCY_STOP_SWITCH);
+        tripFastStop(FAST_STOP_EMERGENCY_STOP);
+    }
+}
+
+//* ************************************************************************
+//* ************************ TRIP *****************************************
+//* ************************************************************************
+
+void IRAM_ATTR tripFastStop(FastStopReason reason) {
+    if (fastStopReason != FAST_STOP_NONE) {
+        return;
+    }
+    //! Step outputs LOW first, then every valve to retracted (active LOW)
+    REG_WRITE(GPIO_OUT_W1TC_REG, stepOutputs.bank[0]);
+    REG_WRITE(GPIO_OUT1_W1TC_REG, stepOutputs.bank[1]);
+    REG_WRITE(GPIO_OUT_W1TS_REG, valveOutputs.bank[0]);
+    REG_WRITE(GPIO_OUT1_W1TS_REG, valveOutputs.bank[1]);
+    tripUs = micros();
+    fastStopReason = reason;
+}
+
+//* ************************************************************************
+//* ************************ LOOP SIDE ************************************
+//* ************************************************************************
+
+void feedLoopWatchdog() {
+    loopPasses = loopPasses + 1;
+    //! Only states that drive a stroke one run() per pass are watched;
+    //! homing, the maintenance modes and PUSHWOOD's settle delays block on purpose
+    loopWatchdogArmed = currentState == CUTTING || currentState == YESWOOD || currentState == NOWOOD;
+}
+
+void pauseLoopWatchdog() {
+    loopWatchdogArmed = false;
+}
+
+bool handleFastStop() {
+    uint8_t reason = fastStopReason;
+    if (reason == FAST_STOP_NONE || tripRaised) {
+        return false;
+    }
+    unsigned long sinceTripUs = micros() - tripUs;
+    tripRaised = true;
+    suctionArmed = false;
+    tripCount++;
+    lastTripReason = reason;
+    lastTripMs = millis();
+
+    //! Step 1: Bookkeeping in line with the outputs - both motors stopped
+    //! where they are, every clamp retracted, and the home lost
+    stopCutMotor();
+    stopPositionMotor();
+    retractAllCylinders();
+    isHomed = false;
+    Serial.printf("FAST STOP: %s - outputs forced safe %lu us before the loop saw it\n", TRIGGERS[reason].name,
+                  sinceTripUs);
+
+    //! Step 2: ERROR through the error manager
+    raiseError(TRIGGERS[reason].error);
+    return true;
+}
+
+void releaseFastStop() {
+    uint8_t reason = fastStopReason;
+    if (reason == FAST_STOP_NONE || isErrorActive(TRIGGERS[reason].error)) {
+        return;
+    }
+    //! An emergency stop pressed while latched gave no trip of its own
+    if (emergencyStopActive()) {
+        fastStopReason = FAST_STOP_EMERGENCY_STOP;
+        tripRaised = false;
+        return;
+    }
+    tripRaised = false;
+    fastStopReason = FAST_STOP_NONE;
+    Serial.println("FAST STOP: Released");
+}
+
+//* ************************************************************************
+//* ************************ SUCTION WINDOW *******************************
+//* ************************************************************************
+
+bool armSuctionFastStop() {
+    //! Armed before the check, so an edge in between is not lost
+    suctionArmed = true;
+    if (readSensor(WOOD_SUCTION_SENSOR_TYPE)) {
+        tripFastStop(FAST_STOP_SUCTION);
+        return false;
+    }
+    return true;
+}
+
+void disarmSuctionFastStop() {
+    suctionArmed = false;
+}
+
+bool emergencyStopActive() {
+    return EMERGENCY_STOP_INSTALLED && digitalRead(EMERGENCY_STOP_SWITCH) == HIGH;
+}
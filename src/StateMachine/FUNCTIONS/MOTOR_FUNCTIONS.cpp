@@ -3,6 +3,10 @@
 #include <AccelStepper.h>
 #include <Bounce2.h>
 #include "OTA_Manager.h"
+#include "StateMachine/Pneumatics.h"
+#include "StateMachine/FastStop.h"
+#include <math.h>
+#include "Diagnostics/FlightRecorder.h"
 
 //* ************************************************************************
 //* ************************ MOTOR FUNCTIONS ***************************
@@ -26,6 +30,7 @@ void moveMotorTo(MotorType motor, float position, float speed) {
             cutMotor.setMaxSpeed(speed);
             cutMotor.setAcceleration(CUT_MOTOR_NORMAL_ACCELERATION);
             cutMotor.moveTo(position);
+            recordMoveStart(CUT_MOTOR, cutMotor.targetPosition());
             Serial.print("Cut motor moving to position: ");
             Serial.print(position);
             Serial.print(" at speed: ");
@@ -35,6 +40,7 @@ void moveMotorTo(MotorType motor, float position, float speed) {
             positionMotor.setMaxSpeed(speed);
             positionMotor.setAcceleration(POSITION_MOTOR_NORMAL_ACCELERATION);
             positionMotor.moveTo(position);
+            recordMoveStart(POSITION_MOTOR, positionMotor.targetPosition());
             Serial.print("Position motor moving to position: ");
             Serial.print(position);
             Serial.print(" at speed: ");
@@ -58,6 +64,36 @@ void stopPositionMotor() {
     Serial.println("Position motor stopped");
 }
 
+//! Time left in a move, for firing valves ahead of its end (Pneumatics.h).
+//! From the current speed v the carriage accelerates toward maxSpeed, then
+//! brakes at the same rate to stop on the target; d steps left, rate a.
+unsigned long msUntilMoveEnds(AccelStepper& motor) {
+    float d = fabsf((float)motor.distanceToGo());
+    if (d == 0) {
+        return 0;
+    }
+    float v = fabsf(motor.speed());
+    float a = motor.acceleration();
+    float vMax = motor.maxSpeed();
+    if (a <= 0 || vMax <= 0) {
+        return 0;
+    }
+    float seconds;
+    if (v * v >= 2 * a * d) {
+        // Braking already: uniform deceleration to the target
+        seconds = v > 0 ? 2 * d / v : 0;
+    } else if ((2 * vMax * vMax - v * v) / (2 * a) <= d) {
+        // Reaches maxSpeed: ramp up, cruise, ramp down
+        float rampSteps = (2 * vMax * vMax - v * v) / (2 * a);
+        seconds = (vMax - v) / a + vMax / a + (d - rampSteps) / vMax;
+    } else {
+        // Triangle: peaks below maxSpeed
+        float vPeak = sqrtf((2 * a * d + v * v) / 2);
+        seconds = (vPeak - v) / a + vPeak / a;
+    }
+    return (unsigned long)(seconds * 1000.0f);
+}
+
 //* ************************************************************************
 //* ************************ SPECIALIZED MOTOR FUNCTIONS *****************
 //* ************************************************************************
@@ -67,27 +103,32 @@ void movePositionMotorToTravelWithEarlyActivation() {
     positionMotor.setMaxSpeed(POSITION_MOTOR_NORMAL_SPEED);
     positionMotor.setAcceleration(POSITION_MOTOR_NORMAL_ACCELERATION);
     positionMotor.moveTo(POSITION_MOTOR_TRAVEL_POSITION);
+    recordMoveStart(POSITION_MOTOR, POSITION_MOTOR_TRAVEL_POSITION);
     Serial.println("Position motor moving to travel position");
-    while(positionMotor.distanceToGo() != 0){
+    while(positionMotor.distanceToGo() != 0 && !fastStopTripped()){
         positionMotor.run();
         // Wait for movement completion - no early activation during position moves
     }
+    recordMoveEnd(POSITION_MOTOR);
 }
 
 void movePositionMotorToInitialAfterHoming() {
     positionMotor.setMaxSpeed(POSITION_MOTOR_NORMAL_SPEED);
     positionMotor.setAcceleration(POSITION_MOTOR_NORMAL_ACCELERATION);
     positionMotor.moveTo(0);
+    recordMoveStart(POSITION_MOTOR, 0);
     Serial.println("Position motor moving to initial position after homing");
-    while(positionMotor.distanceToGo() != 0){
+    while(positionMotor.distanceToGo() != 0 && !fastStopTripped()){
         positionMotor.run();
         // Wait for movement completion - no early activation during position moves
     }
+    recordMoveEnd(POSITION_MOTOR);
 }
 
 void moveCutMotorToHome() {
     cutMotor.setMaxSpeed(CUT_MOTOR_RETURN_SPEED);
     cutMotor.setAcceleration(CUT_MOTOR_RETURN_ACCELERATION);
     cutMotor.moveTo(0);
+    recordMoveStart(CUT_MOTOR, 0);
     Serial.println("Cut motor returning to home with return acceleration");
 }
\ No newline at end of file
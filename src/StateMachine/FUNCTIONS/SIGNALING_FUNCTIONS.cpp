@@ -1,5 +1,6 @@
 #include "StateMachine/StateMachine.h"
-#include <ESP32Servo.h>
+#include "StateMachine/CatcherServo.h"
+#include "Diagnostics/FlightRecorder.h"
 
 //* ************************************************************************
 //* ************************ SIGNALING FUNCTIONS *************************
@@ -8,11 +9,8 @@
 //! Handles Transfer Arm signals and servo coordination
 
 // External variable declarations
-extern Servo catcherServo;
 extern bool signalTAActive;
 extern unsigned long signalTAStartTime;
-extern unsigned long catcherServoActiveStartTime;
-extern bool catcherServoIsActiveAndTiming;
 
 //* ************************************************************************
 //* ************************ TRANSFER ARM SIGNALING **********************
@@ -21,21 +19,18 @@ extern bool catcherServoIsActiveAndTiming;
 void sendSignalToTA() {
     // Set the signal pin HIGH to trigger Transfer Arm (active HIGH)
     digitalWrite(TA_SIGNAL_OUT_PIN, HIGH);
+    recordFlightEvent(FLIGHT_SIGNAL, 0, HIGH);
     signalTAStartTime = millis();
     signalTAActive = true;
     Serial.println("Signal sent to Transfer Arm (TA)");
 
-    catcherServo.write(CATCHER_SERVO_ACTIVE_POSITION);
-    catcherServoActiveStartTime = millis();
-    catcherServoIsActiveAndTiming = true;
-    Serial.print("Catcher servo moved to ");
-    Serial.print(CATCHER_SERVO_ACTIVE_POSITION);
-    Serial.println(" degrees with TA signal.");
+    triggerCatcherServo();
 }
 
 void handleTASignalTiming() { 
     if (signalTAActive && millis() - signalTAStartTime >= TA_SIGNAL_DURATION) {
         digitalWrite(TA_SIGNAL_OUT_PIN, LOW); // Return to inactive state (LOW)
+        recordFlightEvent(FLIGHT_SIGNAL, 0, LOW);
         signalTAActive = false;
         Serial.println("Signal to Transfer Arm (TA) completed"); 
     }
@@ -45,20 +40,13 @@ void handleTASignalTiming() {
 //* ************************ SERVO CONTROL ********************************
 //* ************************************************************************
 
+//! The catcher sequence (CatcherServo.h) owns the servo; these start it
+//! and cut it short
+
 void activateCatcherServo() {
-    // Move catcher servo to active position
-    catcherServo.write(CATCHER_SERVO_ACTIVE_POSITION);
-    catcherServoActiveStartTime = millis();
-    catcherServoIsActiveAndTiming = true;
-    Serial.print("Catcher servo activated to ");
-    Serial.print(CATCHER_SERVO_ACTIVE_POSITION);
-    Serial.println(" degrees");
+    triggerCatcherServo();
 }
 
 void handleCatcherServoReturn() {
-    // Move catcher servo to home position
-    catcherServo.write(CATCHER_SERVO_HOME_POSITION);
-    Serial.print("Catcher servo returned to home position (");
-    Serial.print(CATCHER_SERVO_HOME_POSITION);
-    Serial.println(" degrees).");
-} 
\ No newline at end of file
+    returnCatcherServoHome();
+}
@@ -1,5 +1,6 @@
 #include "StateMachine/StateMachine.h"
-#include <ESP32Servo.h>
+#include "StateMachine/CatcherServo.h"
+#include "Diagnostics/FlightRecorder.h"
 
 //* ************************************************************************
 //* ************************ TIMING FUNCTIONS ****************************
@@ -9,9 +10,6 @@
 
 // External variable declarations
 extern AccelStepper cutMotor;
-extern Servo catcherServo;
-extern unsigned long catcherServoActiveStartTime;
-extern bool catcherServoIsActiveAndTiming;
 extern unsigned long catcherClampEngageTime;
 extern bool catcherClampIsEngaged;
 
@@ -19,18 +17,16 @@ extern bool catcherClampIsEngaged;
 //* ************************ EARLY ACTIVATION FUNCTIONS ******************
 //* ************************************************************************
 //! Early activation based on cut motor position during cutting state
+//! The checks compare steps against the precomputed activation positions;
+//! inches are only worked out for the log line when one fires
 
 void checkCatcherServoEarlyActivation() {
-    float currentCutPositionInches = (float)cutMotor.currentPosition() / CUT_MOTOR_STEPS_PER_INCH;
-    float targetCutPositionInches = CUT_TRAVEL_DISTANCE;
-    float earlyActivationPositionInches = targetCutPositionInches - CATCHER_SERVO_EARLY_ACTIVATION_OFFSET_INCHES;
+    long currentCutPosition = cutMotor.currentPosition();
     
-    if (currentCutPositionInches >= earlyActivationPositionInches && !catcherServoIsActiveAndTiming) {
-        catcherServo.write(CATCHER_SERVO_ACTIVE_POSITION);
-        catcherServoActiveStartTime = millis();
-        catcherServoIsActiveAndTiming = true;
+    if (currentCutPosition >= CATCHER_SERVO_ACTIVATION_POSITION && catcherServoReady()) {
+        triggerCatcherServo();
         Serial.print("Catcher servo early activation at cut position ");
-        Serial.print(currentCutPositionInches);
+        Serial.print((float)currentCutPosition / CUT_MOTOR_STEPS_PER_INCH);
         Serial.print(" inches (");
         Serial.print(CATCHER_SERVO_EARLY_ACTIVATION_OFFSET_INCHES);
         Serial.println(" inches before cut completion)");
@@ -38,16 +34,14 @@ void checkCatcherServoEarlyActivation() {
 }
 
 void checkCatcherClampEarlyActivation() {
-    float currentCutPositionInches = (float)cutMotor.currentPosition() / CUT_MOTOR_STEPS_PER_INCH;
-    float targetCutPositionInches = CUT_TRAVEL_DISTANCE;
-    float earlyActivationPositionInches = targetCutPositionInches - CATCHER_CLAMP_EARLY_ACTIVATION_OFFSET_INCHES;
+    long currentCutPosition = cutMotor.currentPosition();
     
-    if (currentCutPositionInches >= earlyActivationPositionInches && !catcherClampIsEngaged) {
+    if (currentCutPosition >= CATCHER_CLAMP_ACTIVATION_POSITION && !catcherClampIsEngaged) {
         extendCatcherClamp();
         catcherClampEngageTime = millis();
         catcherClampIsEngaged = true;
         Serial.print("Catcher clamp early activation at cut position ");
-        Serial.print(currentCutPositionInches);
+        Serial.print((float)currentCutPosition / CUT_MOTOR_STEPS_PER_INCH);
         Serial.print(" inches (");
         Serial.print(CATCHER_CLAMP_EARLY_ACTIVATION_OFFSET_INCHES);
         Serial.println(" inches before cut completion)");
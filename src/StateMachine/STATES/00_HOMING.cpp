@@ -1,8 +1,13 @@
 #include "StateMachine/StateMachine.h"
+#include "StateMachine/ErrorManager.h"
+#include "StateMachine/FastStop.h"
 #include "Config/Config.h"
 #include <AccelStepper.h>
 #include <Bounce2.h>
 #include "OTA_Manager.h"
+#include "Metrics/PersistentCounters.h"
+#include "Diagnostics/FlightRecorder.h"
+#include "Diagnostics/SensorTrace.h"
 
 //* ************************************************************************
 //* ************************ HOMING FUNCTIONS *****************************
@@ -59,17 +64,33 @@ void homeCutMotorBlocking(Bounce& homingSwitch, unsigned long timeout) {
 
     while (!readLimitSwitch(CUT_MOTOR_HOMING_SWITCH_TYPE)) {
         cutMotor.run();
-        //! Handle OTA updates
-        handleOTA();
+        sampleSensorTrace();
         yield(); // Prevent watchdog reset
+        //! An OTA update parks the axes from the main loop - stop here
+        if (isOTAUpdateActive()) {
+            Serial.println("Cut motor homing interrupted by OTA update");
+            cutMotor.stop();
+            recordMoveEnd(CUT_MOTOR);
+            return;
+        }
+        //! A fast stop has cut the step outputs - the loop raises it
+        if (fastStopTripped()) {
+            Serial.println("Cut motor homing stopped by a fast stop");
+            recordMoveEnd(CUT_MOTOR);
+            return;
+        }
         if (millis() - startTime > timeout) {
             Serial.println("Cut motor homing timeout!");
-            cutMotor.stop();
+            recordMoveEnd(CUT_MOTOR);
+            raiseError(ERROR_CODE_CUT_MOTOR_HOME);
             return;
         }
     }
     cutMotor.stop();
+    recordMoveEnd(CUT_MOTOR);
+    sampleMotorTravel();
     cutMotor.setCurrentPosition(0);
+    rebaseMotorTravel();
     Serial.println("Cut motor homed to position 0");
 }
 
@@ -80,17 +101,32 @@ void homePositionMotorBlocking(Bounce& homingSwitch, unsigned long timeout) {
 
     while (!readLimitSwitch(POSITION_MOTOR_HOMING_SWITCH_TYPE)) {
         positionMotor.run();
-        //! Handle OTA updates
-        handleOTA();
+        sampleSensorTrace();
         yield(); // Prevent watchdog reset
+        //! An OTA update parks the axes from the main loop - stop here
+        if (isOTAUpdateActive()) {
+            Serial.println("Position motor homing interrupted by OTA update");
+            positionMotor.stop();
+            recordMoveEnd(POSITION_MOTOR);
+            return;
+        }
+        if (fastStopTripped()) {
+            Serial.println("Position motor homing stopped by a fast stop");
+            recordMoveEnd(POSITION_MOTOR);
+            return;
+        }
         if (millis() - startTime > timeout) {
             Serial.println("Position motor homing timeout!");
-            positionMotor.stop();
+            recordMoveEnd(POSITION_MOTOR);
+            raiseError(ERROR_CODE_POSITION_MOTOR_HOME);
             return;
         }
     }
     positionMotor.stop();
-    positionMotor.setCurrentPosition(POSITION_MOTOR_TRAVEL_POSITION + 1.0 * POSITION_MOTOR_STEPS_PER_INCH);
+    recordMoveEnd(POSITION_MOTOR);
+    sampleMotorTravel();
+    positionMotor.setCurrentPosition(POSITION_MOTOR_HOME_SWITCH_POSITION);
+    rebaseMotorTravel();
     Serial.print("Position motor homed to position ");
     Serial.print(POSITION_TRAVEL_DISTANCE);
     Serial.println(" inches");
@@ -100,11 +136,13 @@ void homePositionMotorBlocking(Bounce& homingSwitch, unsigned long timeout) {
     Serial.println("Moving to travel position...");
     while(positionMotor.distanceToGo() != 0) {
         positionMotor.run();
-        //! Handle OTA updates
-        handleOTA();
         yield(); // Prevent watchdog reset
+        if (isOTAUpdateActive() || fastStopTripped()) {
+            return;
+        }
         delay(5); // Small delay to prevent excessive loop iterations
     }
+    recordMoveEnd(POSITION_MOTOR);
     Serial.println("Position motor at travel position");
 }
 
@@ -119,9 +157,15 @@ void executeCompleteHomingSequence() {
     
     // Home cut motor first
     homeCutMotorBlocking(cutHomingSwitch, CUT_HOME_TIMEOUT);
+    if (anyErrorActive() || fastStopTripped()) {
+        return;     // ERROR - not homed
+    }
     
     // Home position motor second  
     homePositionMotorBlocking(positionHomingSwitch, POSITION_HOME_TIMEOUT);
+    if (anyErrorActive() || fastStopTripped()) {
+        return;
+    }
     
     isHomed = true;
     Serial.println("=== HOMING SEQUENCE COMPLETE ===");
@@ -142,7 +186,9 @@ bool checkAndRecalibrateCutMotorHome(int attempts) {
         
         if (readLimitSwitch(CUT_MOTOR_HOMING_SWITCH_TYPE)) {
             sensorDetectedHome = true;
+            sampleMotorTravel();
             cutMotor.setCurrentPosition(0);
+            rebaseMotorTravel();
             Serial.println("Cut motor position recalibrated to 0");
             break;
         }
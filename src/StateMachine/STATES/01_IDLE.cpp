@@ -1,6 +1,6 @@
 #include "StateMachine/StateMachine.h"
 #include "Config/Config.h"
-#include "OTA_Manager.h"
+#include "Control/RemoteControl.h"
 #include <Bounce2.h>
 
 // External variable declarations
@@ -18,33 +18,22 @@ extern SystemState currentState;
 //! ************************************************************************
 //! IDLE STATE SEQUENCE:
 //! ************************************************************************
-//! STEP 1: HANDLE OTA UPDATES
-//!    - Process any pending OTA (Over-The-Air) updates
-//!    - Maintain network connectivity for remote updates
-//!
-//! STEP 2: MONITOR START CYCLE SWITCH
+//! STEP 1: MONITOR START CYCLE SWITCH
 //!    - Update start cycle switch debounce state
-//!    - Check if switch reads HIGH (active)
+//!    - Check if switch reads HIGH (active) or a remote "start" is posted
 //!    - If activated: transition to CUTTING state
 //!
-//! STEP 3: MONITOR RELOAD SWITCH
+//! STEP 2: MONITOR RELOAD SWITCH
 //!    - Update reload switch debounce state
-//!    - Check if switch reads HIGH (active)
+//!    - Check if switch reads HIGH (active) or a remote "reload" is posted
 //!    - If activated: transition to RELOAD state
 //!
-//! STEP 4: MAINTAIN IDLE STATE
+//! STEP 3: MAINTAIN IDLE STATE
 //!    - Continue monitoring if no switches activated
 //!    - System remains ready for next operation
 //!    - Lowest power consumption state
 //! ************************************************************************
-
-//* ************************************************************************
-//* ************************ OTA AND SYSTEM MONITORING *******************
-//* ************************************************************************
-
-void handleOTAInIdle() {
-    handleOTA(); // Handle any OTA updates while idle
-}
+//! OTA updates are serviced by the WiFi task, not here (see OTA_Manager.h)
 
 //* ************************************************************************
 //* ************************ SWITCH MONITORING FUNCTIONS *****************
@@ -56,6 +45,10 @@ bool checkStartCycleSwitchInIdle() {
         Serial.println("IDLE: Start cycle switch activated - transitioning to CUTTING");
         return true;
     }
+    if (takeRemoteEvent(REMOTE_EVENT_START)) {
+        Serial.println("IDLE: Remote start received - transitioning to CUTTING");
+        return true;
+    }
     return false;
 }
 
@@ -65,6 +58,10 @@ bool checkReloadSwitchInIdle() {
         Serial.println("IDLE: Reload switch activated - transitioning to RELOAD");
         return true;
     }
+    if (takeRemoteEvent(REMOTE_EVENT_RELOAD)) {
+        Serial.println("IDLE: Remote reload received - transitioning to RELOAD");
+        return true;
+    }
     return false;
 }
 
@@ -87,9 +84,6 @@ void transitionFromIdleToReload() {
 //* ************************************************************************
 
 void executeIdleMonitoring() {
-    // Handle OTA updates
-    handleOTAInIdle();
-    
     // Check start cycle switch
     if (checkStartCycleSwitchInIdle()) {
         transitionFromIdleToCutting();
@@ -2,6 +2,9 @@
 #include "Config/Config.h"
 #include <AccelStepper.h>
 #include <Bounce2.h>
+#include "StateMachine/FastStop.h"
+#include "StateMachine/CatcherServo.h"
+#include "StateMachine/Pneumatics.h"
 
 // External variable declarations
 extern AccelStepper cutMotor;
@@ -25,17 +28,22 @@ extern SystemState currentState;
 //!    - Extend wood secure clamp to hold wood firmly
 //!    - Both clamps activated simultaneously
 //!
-//! STEP 2: START CUT MOTOR MOVEMENT (ONE TIME)
+//! STEP 2: START CUT MOTOR MOVEMENT (ONE TIME, CLAMPS SETTLED)
+//!    - Wait out whatever valve latency is left on the holding clamps
+//!      (none when YESWOOD closed them ahead of its moves)
 //!    - Set cut motor speed to CUT_MOTOR_CUTTING_SPEED
 //!    - Move cut motor to CUT_MOTOR_CUT_POSITION
 //!    - Begin cutting sequence
 //!
 //! STEP 3: CONTINUOUS SAFETY AND ACTIVATION CHECKS
 //!    - Run cut motor continuously toward target
-//!    - Safety check at 0.3 inches: monitor wasWoodSuctionedSensor
-//!    - If safety violation: stop motor and enter error state
-//!    - Catcher clamp activation at early offset position
-//!    - Catcher servo activation at early offset position
+//!    - Safety check at 0.3 inches: arm the suction fast stop, which from
+//!      there trips on a wasWoodSuctionedSensor edge (StateMachine/FastStop.h)
+//!    - If the sensor is already active: trip now and enter error state
+//!    - Catcher clamp activation at early offset position (disarms the
+//!      suction fast stop - the clamp seating shakes the sensor)
+//!    - Catcher servo activation at early offset position (the servo
+//!      sequence then runs on its own - StateMachine/CatcherServo.h)
 //!
 //! STEP 4: CHECK CUT COMPLETION AND ROUTE TO NEXT STATE
 //!    - Monitor cut motor distance to go
@@ -66,28 +74,22 @@ void startCutMotorMovementForCutting() {
     Serial.println(CUT_MOTOR_CUT_POSITION);
 }
 
-bool checkCutMotorSafetyAt03Inches() {
-    // Calculate 0.3 inch position
-    float safetyCheckPosition = 0.3 * CUT_MOTOR_STEPS_PER_INCH;
-    
-    // Check if motor has reached 0.3 inches
-    if (cutMotor.currentPosition() >= safetyCheckPosition) {
-        if (readSensor(WOOD_SUCTION_SENSOR_TYPE)) {
-            Serial.println("CUTTING: SAFETY VIOLATION - Wood suctioned sensor activated at 0.3 inches");
-            cutMotor.stop();
-            // TODO: Enter waswoodsuctioned error state
-            return false;
-        }
-        Serial.println("CUTTING: Safety check passed at 0.3 inches");
+//! The per-pass checks below compare against step positions from Config.h
+//! and are file-local, so the compiler can inline them into the cutting loop
+
+static bool checkCutMotorSafetyAt03Inches() {
+    if (!armSuctionFastStop()) {
+        Serial.println("CUTTING: SAFETY VIOLATION - Wood suctioned sensor activated at 0.3 inches");
+        handleFastStop();
+        return false;
     }
+    Serial.println("CUTTING: Safety check passed at 0.3 inches");
     return true;
 }
 
-bool checkCatcherClampActivationPoint() {
-    // Calculate activation point
-    float activationPosition = CUT_MOTOR_CUT_POSITION - (CATCHER_CLAMP_EARLY_ACTIVATION_OFFSET_INCHES * CUT_MOTOR_STEPS_PER_INCH);
-    
-    if (cutMotor.currentPosition() >= activationPosition) {
+static bool checkCatcherClampActivationPoint() {
+    if (cutMotor.currentPosition() >= CATCHER_CLAMP_ACTIVATION_POSITION) {
+        disarmSuctionFastStop();
         // Use individual clamp function
         extendCatcherClamp();
         Serial.println("CUTTING: Catcher clamp activated at early activation offset");
@@ -96,13 +98,10 @@ bool checkCatcherClampActivationPoint() {
     return false;
 }
 
-bool checkCatcherServoActivationPoint() {
-    // Calculate activation point
-    float activationPosition = CUT_MOTOR_CUT_POSITION - (CATCHER_SERVO_EARLY_ACTIVATION_OFFSET_INCHES * CUT_MOTOR_STEPS_PER_INCH);
-    
-    if (cutMotor.currentPosition() >= activationPosition) {
-        // Activate catcher servo
-        // TODO: Add servo activation code
+static bool checkCatcherServoActivationPoint() {
+    if (cutMotor.currentPosition() >= CATCHER_SERVO_ACTIVATION_POSITION) {
+        // Out, hold and home run from the loop, over the return stroke
+        triggerCatcherServo();
         Serial.println("CUTTING: Catcher servo activated at early activation offset");
         return true;
     }
@@ -143,6 +142,14 @@ void executeCuttingSequence() {
     static bool catcherClampActivated = false;
     static bool catcherServoActivated = false;
     
+    if (stateJustEntered()) {
+        clampsExtended = false;
+        cutMotorStarted = false;
+        safetyChecked = false;
+        catcherClampActivated = false;
+        catcherServoActivated = false;
+    }
+    
     //! ************************************************************************
     //! STEP 1: EXTEND BOTH CLAMPS (ONE TIME)
     //! ************************************************************************
@@ -152,9 +159,12 @@ void executeCuttingSequence() {
     }
     
     //! ************************************************************************
-    //! STEP 2: START CUT MOTOR MOVEMENT (ONE TIME)
+    //! STEP 2: START CUT MOTOR MOVEMENT (ONE TIME, CLAMPS SETTLED)
     //! ************************************************************************
     if (!cutMotorStarted) {
+        if (!holdingClampsSettled()) {
+            return;
+        }
         startCutMotorMovementForCutting();
         cutMotorStarted = true;
     }
@@ -166,12 +176,14 @@ void executeCuttingSequence() {
         cutMotor.run(); // Make the motor move
         
         // Safety check at 0.3 inches
-        if (!safetyChecked) {
+        if (!safetyChecked && cutMotor.currentPosition() >= CUT_MOTOR_SAFETY_CHECK_POSITION) {
             if (!checkCutMotorSafetyAt03Inches()) {
-                // Reset state variables on error
+                // ERROR - the next cycle starts from step 1
                 clampsExtended = false;
                 cutMotorStarted = false;
                 safetyChecked = false;
+                catcherClampActivated = false;
+                catcherServoActivated = false;
                 return;
             }
             safetyChecked = true;
@@ -192,6 +204,7 @@ void executeCuttingSequence() {
     //! STEP 4: CHECK IF CUT IS COMPLETE AND ROUTE TO NEXT STATE
     //! ************************************************************************
     if (cutMotor.distanceToGo() == 0) {
+        disarmSuctionFastStop();
         Serial.println("CUTTING: Cut motor movement complete - checking wood sensor");
         checkWoodSensorForStateTransition();
         
@@ -1,5 +1,8 @@
 #include "StateMachine/StateMachine.h"
+#include "StateMachine/ErrorManager.h"
 #include "Config/Config.h"
+#include "Control/RemoteControl.h"
+#include "StateMachine/Pneumatics.h"
 #include <AccelStepper.h>
 #include <Bounce2.h>
 
@@ -29,29 +32,33 @@ extern SystemState currentState;
 //!    - Retract wood secure clamp to release wood
 //!    - Allow wood movement for advancement
 //!
-//! STEP 3: ADVANCE POSITION MOTOR (ONE TIME)
+//! STEP 3: ADVANCE POSITION MOTOR (ONE TIME, ONCE THE SECURE CLAMP IS OPEN)
 //!    - Move position motor to POSITION_TRAVEL_DISTANCE - 0.1 inches
 //!    - Advance wood to optimal positioning
 //!
-//! STEP 4: SWAP CLAMP POSITIONS (WHEN POSITION MOTOR ADVANCE COMPLETE)
-//!    - Extend wood secure clamp to hold wood
-//!    - Retract position clamp for motor return
+//! STEP 4: SWAP CLAMP POSITIONS (AROUND THE END OF THE ADVANCE)
+//!    - Extend wood secure clamp one valve latency before the advance
+//!      ends, so it closes as the carriage stops
+//!    - Retract position clamp once the secure clamp has settled
 //!    - Transfer wood control between clamps
 //!
-//! STEP 5: START POSITION MOTOR RETURN (WHEN CLAMPS SWAPPED)
+//! STEP 5: START POSITION MOTOR RETURN (WHEN CLAMPS SWAPPED AND SETTLED)
 //!    - Move position motor back to home position (0)
 //!    - Prepare for next positioning cycle
 //!
-//! STEP 6: EXTEND POSITION CLAMP (WHEN POSITION MOTOR AT HOME)
-//!    - Extend position clamp when motor reaches home
+//! STEP 6: EXTEND POSITION CLAMP (ONCE POSITION MOTOR IS HOME)
+//!    - Extend position clamp once the return has stopped; firing it
+//!      ahead would close it on the board with the carriage still moving
 //!    - Secure position for wood advancement
 //!
 //! STEP 6.5: VERIFY CUT MOTOR HOME (CONTINUOUS CHECK)
 //!    - Verify cut motor at home position
-//!    - Check cut homing switch for confirmation
-//!    - Ensure motor position accuracy
+//!    - Check cut homing switch for confirmation, CUT_HOME_SWITCH_SETTLE_MS
+//!      after the return ends
+//!    - Switch still open after CUT_HOME_CONFIRM_TIMEOUT_MS: raise the cut
+//!      motor home error (the error manager re-seats the axis)
 //!
-//! STEP 7: START FINAL ADVANCE (WHEN POSITION CLAMP EXTENDED AND CUT MOTOR VERIFIED)
+//! STEP 7: START FINAL ADVANCE (WHEN POSITION CLAMP SETTLED AND CUT MOTOR VERIFIED)
 //!    - Move position motor to final travel position
 //!    - Complete wood positioning sequence
 //!
@@ -61,8 +68,8 @@ extern SystemState currentState;
 //!
 //! STEP 9: CHECK CYCLE CONTINUATION (WHEN SEQUENCE COMPLETE)
 //!    - Monitor start cycle switch state
-//!    - If HIGH: transition to CUTTING for next cycle
-//!    - If LOW: transition to IDLE state
+//!    - If HIGH, or a remote batch wants another piece: transition to CUTTING
+//!    - Otherwise: transition to IDLE state
 //!    - Reset all state variables
 //! ************************************************************************
 
@@ -82,25 +89,36 @@ void retractSecureClampForYeswood() {
 
 void advancePositionMotorForYeswood() {
     // Move to POSITION_TRAVEL_DISTANCE - 0.1 inches
-    float targetPosition = (POSITION_TRAVEL_DISTANCE - 0.1) * POSITION_MOTOR_STEPS_PER_INCH;
-    moveMotorTo(POSITION_MOTOR, targetPosition, POSITION_MOTOR_NORMAL_SPEED);
+    moveMotorTo(POSITION_MOTOR, POSITION_MOTOR_ADVANCE_POSITION, POSITION_MOTOR_NORMAL_SPEED);
     Serial.print("YESWOOD: Position motor moving to advance position: ");
-    Serial.println(targetPosition);
+    Serial.println(POSITION_MOTOR_ADVANCE_POSITION);
 }
 
 //* ************************************************************************
 //* ************************ CLAMP SWAP OPERATIONS FOR YESWOOD ***********
 //* ************************************************************************
 
-void swapClampPositionsForYeswood() {
-    // Use individual clamp functions
-    extendWoodSecureClamp();
+//! The valves switch ahead of the moves they serve (Pneumatics.h); each
+//! returns true once its valve is switched
+
+bool extendSecureClampBeforeAdvanceEndsForYeswood() {
+    if (!fireClampBeforeMoveEnds(WOOD_SECURE_CLAMP_ENUM, true, positionMotor)) {
+        return false;
+    }
     Serial.println("YESWOOD: Secure wood clamp extended for wood transfer");
-    
+    return true;
+}
+
+bool swapClampPositionsForYeswood() {
+    // The position clamp lets go only once the secure clamp holds the wood
+    if (positionMotor.distanceToGo() != 0 || !clampSettled(WOOD_SECURE_CLAMP_ENUM)) {
+        return false;
+    }
     retractPositionClamp();
     Serial.println("YESWOOD: Position clamp retracted for wood transfer");
     
     Serial.println("YESWOOD: Clamp positions swapped for wood advancement");
+    return true;
 }
 
 void returnPositionMotorToHomeForYeswood() {
@@ -108,29 +126,50 @@ void returnPositionMotorToHomeForYeswood() {
     Serial.println("YESWOOD: Position motor returning to home position");
 }
 
-void extendPositionClampWhenHomeForYeswood() {
-    if (positionMotor.distanceToGo() == 0 && positionMotor.currentPosition() == 0) {
-        extendPositionClamp();
-        Serial.println("YESWOOD: Position clamp extended - position motor at home");
+// Not lead-fired: a position clamp closing while the carriage still runs
+// grips the board partway and drags it back with the carriage
+bool extendPositionClampAtHomeForYeswood() {
+    if (positionMotor.distanceToGo() != 0) {
+        return false;
     }
+    extendPositionClamp();
+    Serial.println("YESWOOD: Position clamp extended - position motor at home");
+    return true;
 }
 
 //* ************************************************************************
 //* ************************ CUT MOTOR HOME VERIFICATION FOR YESWOOD *****
 //* ************************************************************************
 
+// When the cut motor first reported home this cycle
+static bool cutMotorReportedHome = false;
+static unsigned long cutMotorReportedHomeAt = 0;
+
 bool checkCutMotorHomeAndSensorForYeswood() {
     // Check if cut motor is at home position
-    if (cutMotor.distanceToGo() == 0 && cutMotor.currentPosition() == 0) {
-        // Wait 10ms then check homing sensor
-        delay(10);
-        if (readLimitSwitch(CUT_MOTOR_HOMING_SWITCH_TYPE)) {
-            Serial.println("YESWOOD: Cut motor confirmed at home position");
-            return true;
-        } else {
-            Serial.println("YESWOOD: WARNING - Cut motor reports home but sensor disagrees");
-            return false;
-        }
+    if (cutMotor.distanceToGo() != 0 || cutMotor.currentPosition() != 0) {
+        return false;
+    }
+    unsigned long now = millis();
+    if (!cutMotorReportedHome) {
+        cutMotorReportedHome = true;
+        cutMotorReportedHomeAt = now;
+    }
+    // Read every pass: the switch's debounce was last updated before the
+    // stroke, so it needs the settle time of fresh samples to be trusted
+    bool switchClosed = readLimitSwitch(CUT_MOTOR_HOMING_SWITCH_TYPE);
+    if (now - cutMotorReportedHomeAt < CUT_HOME_SWITCH_SETTLE_MS) {
+        return false;
+    }
+    if (switchClosed) {
+        Serial.println("YESWOOD: Cut motor confirmed at home position");
+        cutMotorReportedHome = false;
+        return true;
+    }
+    if (now - cutMotorReportedHomeAt >= CUT_HOME_CONFIRM_TIMEOUT_MS) {
+        Serial.println("YESWOOD: ERROR - Cut motor reports home but its homing switch stays open");
+        cutMotorReportedHome = false;
+        raiseError(ERROR_CODE_CUT_MOTOR_HOME);
     }
     return false;
 }
@@ -146,10 +185,15 @@ void advancePositionMotorToTravelForYeswood() {
 
 bool checkRunCycleSwitchForYeswood() {
     startCycleSwitch.update();
+    bool remoteBatchContinues = continueRemoteBatch();   // Counts the piece even when the switch decides
     if (startCycleSwitch.read() == HIGH) {
         Serial.println("YESWOOD: Run cycle switch HIGH - continuing to CUTTING");
         currentState = CUTTING;
         return true;
+    } else if (remoteBatchContinues) {
+        Serial.println("YESWOOD: Remote batch not complete - continuing to CUTTING");
+        currentState = CUTTING;
+        return true;
     } else {
         Serial.println("YESWOOD: Run cycle switch not HIGH - returning to IDLE");
         currentState = IDLE;
@@ -165,12 +209,26 @@ void executeYeswoodSequence() {
     static bool cutMotorReturnStarted = false;
     static bool secureClampRetracted = false;
     static bool positionMotorAdvanced = false;
+    static bool secureClampExtended = false;
     static bool clampsSwapped = false;
     static bool positionMotorHomeStarted = false;
     static bool positionClampExtended = false;
     static bool cutMotorHomeVerified = false;
     static bool finalAdvanceStarted = false;
     
+    if (stateJustEntered()) {
+        cutMotorReturnStarted = false;
+        secureClampRetracted = false;
+        positionMotorAdvanced = false;
+        secureClampExtended = false;
+        clampsSwapped = false;
+        positionMotorHomeStarted = false;
+        positionClampExtended = false;
+        cutMotorHomeVerified = false;
+        finalAdvanceStarted = false;
+        cutMotorReportedHome = false;
+    }
+    
     //! ************************************************************************
     //! STEP 1: START CUT MOTOR RETURN (ONE TIME)
     //! ************************************************************************
@@ -188,39 +246,36 @@ void executeYeswoodSequence() {
     }
     
     //! ************************************************************************
-    //! STEP 3: ADVANCE POSITION MOTOR (ONE TIME)
+    //! STEP 3: ADVANCE POSITION MOTOR (ONE TIME, SECURE CLAMP OPEN)
     //! ************************************************************************
-    if (!positionMotorAdvanced) {
+    if (!positionMotorAdvanced && clampSettled(WOOD_SECURE_CLAMP_ENUM)) {
         advancePositionMotorForYeswood();
         positionMotorAdvanced = true;
     }
     
     //! ************************************************************************
-    //! STEP 4: SWAP CLAMP POSITIONS WHEN POSITION MOTOR ADVANCE COMPLETE
+    //! STEP 4: SWAP CLAMP POSITIONS AROUND THE END OF THE ADVANCE
     //! ************************************************************************
-    if (positionMotorAdvanced && !clampsSwapped) {
-        if (positionMotor.distanceToGo() == 0) {
-            swapClampPositionsForYeswood();
-            clampsSwapped = true;
-        }
+    if (positionMotorAdvanced && !secureClampExtended) {
+        secureClampExtended = extendSecureClampBeforeAdvanceEndsForYeswood();
+    }
+    if (secureClampExtended && !clampsSwapped) {
+        clampsSwapped = swapClampPositionsForYeswood();
     }
     
     //! ************************************************************************
-    //! STEP 5: START POSITION MOTOR RETURN WHEN CLAMPS SWAPPED
+    //! STEP 5: START POSITION MOTOR RETURN WHEN CLAMPS SWAPPED AND SETTLED
     //! ************************************************************************
-    if (clampsSwapped && !positionMotorHomeStarted) {
+    if (clampsSwapped && !positionMotorHomeStarted && holdingClampsSettled()) {
         returnPositionMotorToHomeForYeswood();
         positionMotorHomeStarted = true;
     }
     
     //! ************************************************************************
-    //! STEP 6: EXTEND POSITION CLAMP WHEN POSITION MOTOR AT HOME
+    //! STEP 6: EXTEND POSITION CLAMP ONCE POSITION MOTOR IS HOME
     //! ************************************************************************
     if (positionMotorHomeStarted && !positionClampExtended) {
-        extendPositionClampWhenHomeForYeswood();
-        if (positionMotor.distanceToGo() == 0 && positionMotor.currentPosition() == 0) {
-            positionClampExtended = true;
-        }
+        positionClampExtended = extendPositionClampAtHomeForYeswood();
     }
     
     //! ************************************************************************
@@ -231,9 +286,10 @@ void executeYeswoodSequence() {
     }
     
     //! ************************************************************************
-    //! STEP 7: START FINAL ADVANCE WHEN POSITION CLAMP EXTENDED AND CUT MOTOR HOME VERIFIED
+    //! STEP 7: START FINAL ADVANCE WHEN POSITION CLAMP SETTLED AND CUT MOTOR HOME VERIFIED
     //! ************************************************************************
-    if (positionClampExtended && cutMotorHomeVerified && !finalAdvanceStarted) {
+    if (positionClampExtended && cutMotorHomeVerified && !finalAdvanceStarted &&
+        positionMotor.distanceToGo() == 0 && holdingClampsSettled()) {
         advancePositionMotorToTravelForYeswood();
         finalAdvanceStarted = true;
     }
@@ -254,6 +310,7 @@ void executeYeswoodSequence() {
         cutMotorReturnStarted = false;
         secureClampRetracted = false;
         positionMotorAdvanced = false;
+        secureClampExtended = false;
         clampsSwapped = false;
         cutMotorHomeVerified = false;
         positionMotorHomeStarted = false;
@@ -1,5 +1,6 @@
 #include "StateMachine/StateMachine.h"
 #include "Config/Config.h"
+#include "StateMachine/Pneumatics.h"
 #include <AccelStepper.h>
 #include <Bounce2.h>
 
@@ -22,7 +23,7 @@ extern SystemState currentState;
 //!    - Release any remaining wood fragments
 //!    - Prepare for system reset
 //!
-//! STEP 2: MOVE POSITION MOTOR TO -1 (ONE TIME)
+//! STEP 2: MOVE POSITION MOTOR TO -1 (ONE TIME, ONCE THE SECURE CLAMP IS OPEN)
 //!    - Move position motor to -1 position (negative 1 step)
 //!    - Clear any mechanical interference
 //!    - Prepare for clamp reset sequence
@@ -38,7 +39,7 @@ extern SystemState currentState;
 //!    - Extend position clamp (restore operational state)
 //!    - Ensure proper clamp positioning
 //!
-//! STEP 5: MOVE POSITION MOTOR TO TRAVEL POSITION (ONE TIME)
+//! STEP 5: MOVE POSITION MOTOR TO TRAVEL POSITION (ONE TIME, ONCE THE CLAMP IS SETTLED)
 //!    - Move position motor to travel position
 //!    - Restore operational positioning
 //!    - Prepare for next cycle
@@ -112,6 +113,14 @@ void executeNowoodSequence() {
     static bool clampsReset = false;
     static bool positionMotorToTravel = false;
     
+    if (stateJustEntered()) {
+        secureClampRetracted = false;
+        positionMotorToNegOne = false;
+        cutMotorReturnStarted = false;
+        clampsReset = false;
+        positionMotorToTravel = false;
+    }
+    
     //! ************************************************************************
     //! STEP 1: RETRACT SECURE CLAMP (ONE TIME)
     //! ************************************************************************
@@ -121,9 +130,9 @@ void executeNowoodSequence() {
     }
     
     //! ************************************************************************
-    //! STEP 2: MOVE POSITION MOTOR TO -1 (ONE TIME)
+    //! STEP 2: MOVE POSITION MOTOR TO -1 (ONE TIME, SECURE CLAMP OPEN)
     //! ************************************************************************
-    if (!positionMotorToNegOne) {
+    if (!positionMotorToNegOne && clampSettled(WOOD_SECURE_CLAMP_ENUM)) {
         movePositionMotorToNegOneForNowood();
         positionMotorToNegOne = true;
     }
@@ -147,9 +156,9 @@ void executeNowoodSequence() {
     }
     
     //! ************************************************************************
-    //! STEP 5: MOVE POSITION MOTOR TO TRAVEL POSITION (ONE TIME)
+    //! STEP 5: MOVE POSITION MOTOR TO TRAVEL POSITION (ONE TIME, CLAMP SETTLED)
     //! ************************************************************************
-    if (clampsReset && !positionMotorToTravel) {
+    if (clampsReset && !positionMotorToTravel && clampSettled(POSITION_CLAMP_ENUM)) {
         advancePositionMotorToTravelForNowood();
         positionMotorToTravel = true;
     }
@@ -31,7 +31,7 @@ extern SystemState currentState;
 //!    - Extend wood secure clamp for wood control
 //!    - Transfer control to secure clamp
 //!
-//! STEP 4: WAIT 300MS (ONE TIME)
+//! STEP 4: WAIT PUSHWOOD_SWAP_DELAY_MS (ONE TIME)
 //!    - Allow mechanical settling time
 //!    - Ensure proper clamp engagement
 //!    - Stabilize wood position
@@ -47,7 +47,7 @@ extern SystemState currentState;
 //!    - Extend wood secure clamp
 //!    - Transfer control back to position clamp
 //!
-//! STEP 7: WAIT 50MS (ONE TIME)
+//! STEP 7: WAIT PUSHWOOD_FINAL_DELAY_MS (ONE TIME)
 //!    - Brief settling delay
 //!    - Ensure clamp engagement
 //!
@@ -104,10 +104,9 @@ void movePositionMotorToHomeForPushWood() {
 
 void advancePositionMotorForPushWood() {
     // Move to POSITION_TRAVEL_DISTANCE - 0.1 inches
-    float targetPosition = (POSITION_TRAVEL_DISTANCE - 0.1) * POSITION_MOTOR_STEPS_PER_INCH;
-    moveMotorTo(POSITION_MOTOR, targetPosition, POSITION_MOTOR_NORMAL_SPEED);
+    moveMotorTo(POSITION_MOTOR, POSITION_MOTOR_ADVANCE_POSITION, POSITION_MOTOR_NORMAL_SPEED);
     Serial.print("PUSHWOOD: Position motor moving to advance position: ");
-    Serial.println(targetPosition);
+    Serial.println(POSITION_MOTOR_ADVANCE_POSITION);
 }
 
 void movePositionMotorToFinalForPushWood() {
@@ -120,13 +119,15 @@ void movePositionMotorToFinalForPushWood() {
 //* ************************************************************************
 
 void waitForPushWoodSwapDelay() {
-    delay(300);
-    Serial.println("PUSHWOOD: 300ms delay completed");
+    delay(PUSHWOOD_SWAP_DELAY_MS);
+    Serial.print("PUSHWOOD: Swap delay completed (ms): ");
+    Serial.println(PUSHWOOD_SWAP_DELAY_MS);
 }
 
 void waitForPushWoodFinalDelay() {
-    delay(50);
-    Serial.println("PUSHWOOD: 50ms delay completed");
+    delay(PUSHWOOD_FINAL_DELAY_MS);
+    Serial.print("PUSHWOOD: Final delay completed (ms): ");
+    Serial.println(PUSHWOOD_FINAL_DELAY_MS);
 }
 
 //* ************************************************************************
@@ -152,6 +153,17 @@ void executePushWoodForwardSequence() {
     static bool finalDelayCompleted = false;
     static bool positionMotorToFinal = false;
     
+    if (stateJustEntered()) {
+        positionClampRetracted = false;
+        positionMotorToHome = false;
+        clampsSwappedToSecure = false;
+        swapDelayCompleted = false;
+        positionMotorAdvanced = false;
+        clampsSwappedToPosition = false;
+        finalDelayCompleted = false;
+        positionMotorToFinal = false;
+    }
+    
     //! ************************************************************************
     //! STEP 1: RETRACT POSITION CLAMP (ONE TIME)
     //! ************************************************************************
@@ -190,7 +202,7 @@ void executePushWoodForwardSequence() {
     }
     
     //! ************************************************************************
-    //! STEP 4: WAIT 300MS (ONE TIME)
+    //! STEP 4: WAIT PUSHWOOD_SWAP_DELAY_MS (ONE TIME)
     //! ************************************************************************
     if (clampsSwappedToSecure && !swapDelayCompleted) {
         waitForPushWoodSwapDelay();
@@ -216,7 +228,7 @@ void executePushWoodForwardSequence() {
     }
     
     //! ************************************************************************
-    //! STEP 7: WAIT 50MS (ONE TIME)
+    //! STEP 7: WAIT PUSHWOOD_FINAL_DELAY_MS (ONE TIME)
     //! ************************************************************************
     if (clampsSwappedToPosition && !finalDelayCompleted) {
         waitForPushWoodFinalDelay();
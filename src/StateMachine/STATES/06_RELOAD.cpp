@@ -1,5 +1,6 @@
 #include "StateMachine/StateMachine.h"
 #include "Config/Config.h"
+#include "Control/RemoteControl.h"
 #include <Bounce2.h>
 
 // External variable declarations
@@ -30,7 +31,7 @@ extern bool isReloadMode;
 //! STEP 3: MONITOR RELOAD SWITCH FOR EXIT CONDITION (CONTINUOUS)
 //!    - Continuously monitor reload switch state
 //!    - Update switch debounce state
-//!    - When switch reads LOW: prepare to exit reload mode
+//!    - When switch reads LOW (and no remote "reload on" holds it): prepare to exit reload mode
 //!    - User indicates reload operation complete
 //!
 //! STEP 4: RE-ENGAGE CLAMPS AND EXIT RELOAD MODE (ONE TIME)
@@ -85,7 +86,7 @@ void exitReloadMode() {
 
 bool checkReloadSwitchForExit() {
     reloadSwitch.update();
-    if (reloadSwitch.read() == LOW) {
+    if (reloadSwitch.read() == LOW && !remoteReloadHeld()) {
         Serial.println("RELOAD: Reload switch turned OFF - preparing to exit reload mode");
         return true;
     }
@@ -1,4 +1,8 @@
 #include "StateMachine/StateMachine.h"
+#include "StateMachine/ErrorManager.h"
+#include "Metrics/Metrics.h"
+#include "Diagnostics/FlightRecorder.h"
+#include "Control/RemoteControl.h"
 
 //* ************************************************************************
 //* ************************ STATE MACHINE IMPLEMENTATION ***************************
@@ -14,6 +18,39 @@ SystemState currentState = IDLE;
 SystemState previousState = IDLE;
 bool stateChanged = false;
 
+// Last state reported to metrics - states are also assigned directly by the
+// state files, so transitions are observed here rather than in changeState()
+static SystemState lastObservedState = STARTUP;
+
+// Set with every observed transition and cleared once the new state has run
+// a pass. An error, fast stop or OTA park can leave a sequence part way, so
+// the sequences start over from this rather than relying on their own end.
+static bool freshStateEntry = false;
+
+static void observeStateTransition() {
+    if (currentState != lastObservedState) {
+        recordStateTransition(lastObservedState, currentState);
+        recordFlightEvent(FLIGHT_STATE, (uint8_t)lastObservedState, currentState);
+        lastObservedState = currentState;
+        freshStateEntry = true;
+    }
+}
+
+bool stateJustEntered() {
+    return freshStateEntry;
+}
+
+const char* getStateName(SystemState state) {
+    static const char* const STATE_NAMES[] = {
+        "STARTUP", "IDLE", "HOMING", "CUTTING", "YESWOOD",
+        "NOWOOD", "PUSHWOODFORWARDONE", "RELOAD", "ERROR", "ERROR_RESET"
+    };
+    if (state < STARTUP || state > ERROR_RESET) {
+        return "UNKNOWN";
+    }
+    return STATE_NAMES[state];
+}
+
 void initializeStateMachine() {
     //* ************************************************************************
     //* ************************ STATE MACHINE INITIALIZATION ***************************
@@ -23,6 +60,7 @@ void initializeStateMachine() {
     currentState = STARTUP;
     previousState = STARTUP;
     stateChanged = false; // Start with false since we're not changing states
+    lastObservedState = STARTUP;
     
     Serial.println("State machine initialized to STARTUP");
 }
@@ -37,6 +75,7 @@ void updateStateMachine() {
     if (checkTransitionConditions()) {
         // Transition logic will be handled in checkTransitionConditions
     }
+    observeStateTransition();
     
     // Execute current state
     switch (currentState) {
@@ -74,26 +113,34 @@ void updateStateMachine() {
                 lastErrorMessage = millis();
             }
             
-            // Check for error recovery via reload switch
+            // Check for error recovery via reload switch or a remote acknowledge
             extern Bounce reloadSwitch;
             reloadSwitch.update();
-            if (reloadSwitch.read() == HIGH) {
-                Serial.println("RELOAD switch pressed - clearing error and returning to IDLE");
-                // Reset error flags
-                extern bool woodSuctionError;
-                woodSuctionError = false;
+            if (reloadSwitch.read() == HIGH || takeRemoteEvent(REMOTE_EVENT_ACK)) {
+                Serial.println("Error acknowledged - recovering");
+                acknowledgeErrors();
                 changeState(ERROR_RESET);
             }
             break;
         case ERROR_RESET:
-            // Reset from error state
-            changeState(IDLE);
+            // Recoveries run here (ErrorManager.h); IDLE once every error has cleared
+            if (updateErrorRecovery()) {
+                break;
+            }
+            if (anyErrorActive()) {
+                changeState(ERROR);
+            } else {
+                changeState(isHomed ? IDLE : HOMING);
+            }
             break;
         default:
             Serial.println("ERROR: Unknown state detected, returning to IDLE");
             changeState(IDLE);
             break;
     }
+    freshStateEntry = false;
+    
+    observeStateTransition();
     
     // Update status LED based on current state
     updateStatusLED();
@@ -182,6 +229,13 @@ bool areAllSystemsReady() {
     return true;
 }
 
+bool machineIsAtRest() {
+    if (currentState != IDLE && currentState != STARTUP) {
+        return false;
+    }
+    return cutMotor.distanceToGo() == 0 && positionMotor.distanceToGo() == 0;
+}
+
 bool isHomingComplete() {
     //* ************************************************************************
     //* ************************ HOMING COMPLETE CHECK ***************************
@@ -0,0 +1,321 @@
+#include "Update/CompressedUpdate.h"
+#include <Update.h>
+
+//* ************************************************************************
+//* ************************ COMPRESSED UPDATE ****************************
+//* ************************************************************************
+//! heatshrink stream decoder writing into Update
+//! The decoder is a small state machine over the bit stream, so a token
+//! split across two TCP reads resumes where it stopped. Decoded bytes go
+//! through the window (for back-references) and a 512 byte output buffer
+//! (for Update.write()); the image CRC is taken on the output buffer. The
+//! window starts zeroed, as in heatshrink's own decoder, whose encoder may
+//! refer to that zeroed history at the start of the stream.
+
+namespace {
+
+const char COMPRESSED_IMAGE_MAGIC[4] = {'T', 'S', 'Z', '1'};
+const unsigned long UPDATE_READ_TIMEOUT_MS = 5000;   // Longest WiFi stall an upload survives
+
+// CRC-32 (0xEDB88320) a nibble at a time - 64 bytes of table
+const uint32_t CRC32_NIBBLE_TABLE[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+void writeLittleEndian32(uint8_t* out, uint32_t value) {
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    out[2] = (uint8_t)(value >> 16);
+    out[3] = (uint8_t)(value >> 24);
+}
+
+uint32_t readLittleEndian32(const uint8_t* in) {
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+} // namespace
+
+//* ************************************************************************
+//* ************************ IMAGE FORMAT *********************************
+//* ************************************************************************
+
+void writeCompressedImageHeader(const CompressedImageHeader& header, uint8_t* out) {
+    memcpy(out, COMPRESSED_IMAGE_MAGIC, sizeof(COMPRESSED_IMAGE_MAGIC));
+    out[4] = header.windowBits;
+    out[5] = header.lookaheadBits;
+    out[6] = 0;
+    out[7] = 0;
+    writeLittleEndian32(out + 8, header.imageSize);
+    writeLittleEndian32(out + 12, header.imageCrc);
+}
+
+bool parseCompressedImageHeader(const uint8_t* in, CompressedImageHeader& header) {
+    if (memcmp(in, COMPRESSED_IMAGE_MAGIC, sizeof(COMPRESSED_IMAGE_MAGIC)) != 0 || in[6] != 0 || in[7] != 0) {
+        return false;
+    }
+    header.windowBits = in[4];
+    header.lookaheadBits = in[5];
+    header.imageSize = readLittleEndian32(in + 8);
+    header.imageCrc = readLittleEndian32(in + 12);
+    return header.windowBits >= COMPRESSED_MIN_WINDOW_BITS && header.windowBits <= COMPRESSED_MAX_WINDOW_BITS &&
+           header.lookaheadBits >= COMPRESSED_MIN_LOOKAHEAD_BITS && header.lookaheadBits < header.windowBits &&
+           header.imageSize > 0;
+}
+
+uint32_t updateCrc32(uint32_t crc, const uint8_t* data, size_t size) {
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ CRC32_NIBBLE_TABLE[crc & 0x0F];
+        crc = (crc >> 4) ^ CRC32_NIBBLE_TABLE[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+//* ************************************************************************
+//* ************************ STREAMING DECODER ****************************
+//* ************************************************************************
+
+CompressedUpdate::CompressedUpdate()
+    : _state(READ_HEADER),
+      _header(),
+      _headerUsed(0),
+      _input(nullptr),
+      _inputLeft(0),
+      _bitBuffer(0),
+      _bitCount(0),
+      _window(nullptr),
+      _windowMask(0),
+      _windowHead(0),
+      _backrefIndex(0),
+      _outputUsed(0),
+      _decoded(0),
+      _crc(0),
+      _error("no data") {}
+
+CompressedUpdate::~CompressedUpdate() {
+    if (_state != FAILED && _window != nullptr) {
+        abort();
+    }
+}
+
+bool CompressedUpdate::fail(const char* error) {
+    _error = error;
+    _state = FAILED;
+    if (Update.isRunning()) {
+        Update.abort();
+    }
+    free(_window);
+    _window = nullptr;
+    return false;
+}
+
+void CompressedUpdate::abort() {
+    fail("aborted");
+}
+
+bool CompressedUpdate::start() {
+    if (!parseCompressedImageHeader(_headerBytes, _header)) {
+        return fail("not a packed image (sim ota-pack) or unsupported window");
+    }
+    size_t windowSize = (size_t)1 << _header.windowBits;
+    _window = (uint8_t*)calloc(windowSize, 1);
+    if (_window == nullptr) {
+        return fail("no memory for the decode window");
+    }
+    _windowMask = (uint16_t)(windowSize - 1);
+    if (!Update.begin(_header.imageSize, U_FLASH)) {
+        return fail(Update.errorString());
+    }
+    _state = READ_TAG;
+    return true;
+}
+
+// MSB-first bit reader over the current chunk; false = chunk used up, the
+// bits taken so far stay in _bitBuffer for the next write()
+bool CompressedUpdate::takeBits(uint8_t count, uint16_t& value) {
+    while (_bitCount < count) {
+        if (_inputLeft == 0) {
+            return false;
+        }
+        _bitBuffer = (_bitBuffer << 8) | *_input++;
+        _inputLeft--;
+        _bitCount += 8;
+    }
+    _bitCount -= count;
+    value = (uint16_t)((_bitBuffer >> _bitCount) & ((1u << count) - 1));
+    return true;
+}
+
+bool CompressedUpdate::emit(uint8_t value) {
+    if (_decoded == _header.imageSize) {
+        return fail("stream is longer than the image");
+    }
+    _window[_windowHead] = value;
+    _windowHead = (_windowHead + 1) & _windowMask;
+    _output[_outputUsed++] = value;
+    _decoded++;
+    if (_outputUsed == sizeof(_output) && !flushOutput()) {
+        return false;
+    }
+    if (_decoded == _header.imageSize) {
+        _state = DONE;
+    }
+    return true;
+}
+
+bool CompressedUpdate::flushOutput() {
+    if (_outputUsed == 0) {
+        return true;
+    }
+    _crc = updateCrc32(_crc, _output, _outputUsed);
+    if (Update.write(_output, _outputUsed) != _outputUsed) {
+        return fail(Update.errorString());
+    }
+    _outputUsed = 0;
+    return true;
+}
+
+bool CompressedUpdate::write(const uint8_t* data, size_t size) {
+    //! Step 1: Header - the first 16 bytes, possibly over several chunks
+    while (_state == READ_HEADER && size > 0) {
+        _headerBytes[_headerUsed++] = *data++;
+        size--;
+        if (_headerUsed == COMPRESSED_IMAGE_HEADER_SIZE && !start()) {
+            return false;
+        }
+    }
+    if (_state == FAILED) {
+        return false;
+    }
+
+    //! Step 2: Tokens until the chunk runs out; bits after the last byte
+    //! of the image are the stream's padding
+    _input = data;
+    _inputLeft = size;
+    uint16_t value;
+    while (_state != DONE && _state != READ_HEADER) {
+        switch (_state) {
+            case READ_TAG:
+                if (!takeBits(1, value)) {
+                    return true;
+                }
+                _state = value ? READ_LITERAL : READ_INDEX;
+                break;
+            case READ_LITERAL:
+                if (!takeBits(8, value)) {
+                    return true;
+                }
+                _state = READ_TAG;
+                if (!emit((uint8_t)value)) {
+                    return false;
+                }
+                break;
+            case READ_INDEX:
+                if (!takeBits(_header.windowBits, value)) {
+                    return true;
+                }
+                _backrefIndex = value + 1;
+                _state = READ_COUNT;
+                break;
+            case READ_COUNT: {
+                if (!takeBits(_header.lookaheadBits, value)) {
+                    return true;
+                }
+                _state = READ_TAG;
+                for (uint32_t i = 0; i <= value; i++) {
+                    if (!emit(_window[(uint16_t)(_windowHead - _backrefIndex) & _windowMask])) {
+                        return false;
+                    }
+                }
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+bool CompressedUpdate::end() {
+    if (_state == FAILED) {
+        return false;
+    }
+    if (_state != DONE) {
+        return fail("stream ended before the image was complete");
+    }
+    if (!flushOutput()) {
+        return false;
+    }
+    if (_crc != _header.imageCrc) {
+        return fail("image CRC mismatch");
+    }
+    if (!Update.end()) {
+        return fail(Update.errorString());
+    }
+    free(_window);
+    _window = nullptr;
+    _error = nullptr;
+    return true;
+}
+
+//* ************************************************************************
+//* ************************ HTTP UPLOAD **********************************
+//* ************************************************************************
+
+bool readCompressedUpdateHeader(Stream& in, size_t length, uint8_t* header, char* error, size_t errorSize) {
+    if (length <= COMPRESSED_IMAGE_HEADER_SIZE) {
+        snprintf(error, errorSize, "upload of %u bytes is too short for a packed image", (unsigned)length);
+        return false;
+    }
+    in.setTimeout(UPDATE_READ_TIMEOUT_MS);
+    if (in.readBytes(header, COMPRESSED_IMAGE_HEADER_SIZE) != COMPRESSED_IMAGE_HEADER_SIZE) {
+        snprintf(error, errorSize, "upload stalled in the image header");
+        return false;
+    }
+    CompressedImageHeader parsed;
+    if (!parseCompressedImageHeader(header, parsed)) {
+        snprintf(error, errorSize, "not a packed image (sim ota-pack) or unsupported window");
+        return false;
+    }
+    if (parsed.imageSize > ESP.getFreeSketchSpace()) {
+        snprintf(error, errorSize, "%u byte image does not fit the %u byte OTA slot", (unsigned)parsed.imageSize,
+                 (unsigned)ESP.getFreeSketchSpace());
+        return false;
+    }
+    return true;
+}
+
+bool receiveCompressedUpdate(Stream& in, size_t length, const uint8_t* header, char* error, size_t errorSize) {
+    in.setTimeout(UPDATE_READ_TIMEOUT_MS);
+
+    CompressedUpdate update;
+    if (!update.write(header, COMPRESSED_IMAGE_HEADER_SIZE)) {
+        snprintf(error, errorSize, "%s", update.error());
+        return false;
+    }
+    uint8_t buffer[1024];
+    size_t received = COMPRESSED_IMAGE_HEADER_SIZE;
+    while (received < length) {
+        size_t wanted = length - received < sizeof(buffer) ? length - received : sizeof(buffer);
+        size_t got = in.readBytes(buffer, wanted);
+        if (got == 0) {
+            update.abort();
+            snprintf(error, errorSize, "upload stalled after %u of %u bytes", (unsigned)received, (unsigned)length);
+            return false;
+        }
+        received += got;
+        if (!update.write(buffer, got)) {
+            snprintf(error, errorSize, "%s", update.error());
+            return false;
+        }
+    }
+    if (!update.end()) {
+        snprintf(error, errorSize, "%s", update.error());
+        return false;
+    }
+    Serial.printf("OTA: %u byte image from a %u byte upload (%.0f%%)\n", (unsigned)update.imageSize(),
+                  (unsigned)length, 100.0 * length / update.imageSize());
+    return true;
+}
@@ -2,11 +2,26 @@
 #include <Bounce2.h>
 #include <AccelStepper.h>
 #include <esp_system.h>
-#include <ESP32Servo.h>
+#include <Servo.h>
 #include "Config/Config.h"
 #include "Config/Pins_Definitions.h"
 #include "StateMachine/StateMachine.h"
+#include "StateMachine/CatcherServo.h"
+#include "StateMachine/ErrorManager.h"
+#include "StateMachine/FastStop.h"
 #include "OTA_Manager.h"
+#include "Metrics_Server.h"
+#include "Metrics/Metrics.h"
+#include "Metrics/PersistentCounters.h"
+#include "Diagnostics/FlightRecorder.h"
+#include "Diagnostics/TraceExport.h"
+#include "Console/SerialConsole.h"
+#include "Diagnostics/StepRateBenchmark.h"
+#include "Diagnostics/ValveCalibration.h"
+#include "Diagnostics/SensorTrace.h"
+#include "Config/ConfigRegistry.h"
+#include "Config/Recipes.h"
+#include "Control/RemoteControl.h"
 
 //* ************************************************************************
 //* ************************ AUTOMATED TABLE SAW **************************
@@ -17,9 +32,6 @@
 // Pin definitions and configuration constants are now in Config/ header files
 
 // Timing variables (constants moved to Config/Config.h)
-unsigned long catcherServoActiveStartTime = 0;
-bool catcherServoIsActiveAndTiming = false;
-
 unsigned long catcherClampEngageTime = 0;
 bool catcherClampIsEngaged = false;
 
@@ -47,15 +59,11 @@ Bounce wasWoodSuctionedSensor = Bounce();
 bool isHomed = false;
 bool isReloadMode = false;
 bool woodPresent = false;
-bool woodSuctionError = false;
-bool wasWoodCaughtError = false; // New flag for wood caught error
 bool errorAcknowledged = false;
 bool cuttingCycleInProgress = false;
 bool continuousModeActive = false;  // New flag for continuous operation
 bool startSwitchSafe = false;       // New flag to track if start switch is safe
 bool startSwitchSafeAfterNoWood = true;  // Flag to track safety after NOWOOD state
-bool woodCaughtCheckPending = false; // Flag to indicate when a wood caught check is scheduled
-unsigned long woodCaughtCheckTime = 0; // Time when the wood caught check should occur
 
 // Timers for various operations
 unsigned long lastBlinkTime = 0;
@@ -79,10 +87,30 @@ void setup() {
   Serial.println("Automated Table Saw Control System - Stage 1");
   Serial.println("DIAGNOSTIC VERSION - Adding OTA/WiFi");
 
+  //! Serial console and flight recorder first - a crash log from the
+  //! previous run is printed here, before anything else can fail
+  initSerialConsole();
+  initFlightRecorder();
+  initTraceExport();
+
+  //! Load lifetime counters from NVS before anything can count
+  initPersistentCounters();
+
+  //! Saved tunables replace the Config.cpp defaults before any motor is set up
+  initConfigRegistry();
+  initRecipes();
+
   //! Initialize OTA functionality
   Serial.println("Initializing OTA...");
   initOTA();
   Serial.println("OTA initialization complete");
+
+  //! Initialize metrics and the HTTP metrics endpoint (served from core 0)
+  initMetrics();
+  initMetricsServer();
+
+  //! Line controller command endpoint (TCP, served from core 0)
+  initRemoteControl();
   
   //! Configure basic pin modes
   pinMode(CUT_MOTOR_PULSE_PIN, OUTPUT);
@@ -157,12 +185,28 @@ void setup() {
   wasWoodSuctionedSensor.attach(WAS_WOOD_SUCTIONED_SENSOR);
   wasWoodSuctionedSensor.interval(5);
   
-  //! Initialize servo
+  //! Initialize servo (LEDC channel at the chip's timer width, 14 bits on the S3;
+  //! catcher moves are hardware fades)
   Serial.println("Initializing servo...");
-  catcherServo.setTimerWidth(14);
-  catcherServo.attach(CATCHER_SERVO_PIN);
+  initCatcherServo();
   
   Serial.println("Switches and servo configured");
+
+  //! Raw input edge trace - starting levels are read once the pull-ups are configured
+  initSensorTrace();
+
+  //! Step rate benchmark - boot combo is read once the switch pins are configured
+  initStepRateBenchmark();
+
+  //! Valve latency calibration - console command only
+  initValveCalibration();
+
+  //! Error codes and history - console command only
+  initErrorManager();
+
+  //! Fast stop - safety input interrupts and the loop watchdog; needs the
+  //! motor, valve and sensor pins configured above
+  initFastStop();
   
   //! Initialize state machine
   Serial.println("Initializing state machine...");
@@ -187,11 +231,50 @@ void setup() {
 }
 
 void loop() {
+  // Loop-rate statistics for the metrics endpoint
+  recordLoopIteration();
+
+  // The fast stop's loop watchdog sees every pass
+  feedLoopWatchdog();
+
+  // Maintenance: a requested step rate benchmark runs here, before the state machine moves on from IDLE
+  handleStepRateBenchmark();
+
+  // Maintenance: a requested valve calibration runs here too, from IDLE
+  handleValveCalibration();
+
+  // A recipe selected over serial or the network takes effect between cycles
+  handleRecipeRequests();
+
+  // So do config changes made over serial or the network
+  handleConfigRequests();
+
+  // A command from the line controller becomes an event for the state machine below
+  handleRemoteCommands();
+
+  // An OTA update in progress parks both axes and holds the loop here
+  handleOTAParkRequest();
+
+  // A fast stop tripped since the last pass becomes an error before the state machine runs
+  handleFastStop();
+
   // Execute the state machine
   updateStateMachine();
-  
-  //! Handle OTA updates
-  handleOTA();
+
+  // Catcher servo sequence runs on its own once CUTTING fires it
+  updateCatcherServo();
+
+  // Accumulate motor travel for the lifetime counters (RAM only)
+  sampleMotorTravel();
+
+  // Sensor edges and move completions for the flight recorder
+  sampleFlightRecorder();
+
+  // Raw input edges for simulator replay
+  sampleSensorTrace();
+
+  // Serial console commands (non-blocking)
+  handleSerialConsole();
   
   // Prevent watchdog reset
   yield();